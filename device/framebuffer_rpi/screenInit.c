@@ -11,6 +11,7 @@
 #include <shell.h> /* for banner */
 #include <kernel.h>
 #include <bcm2835.h>
+#include <mmu.h>
 
 int rows;
 int cols;
@@ -55,9 +56,13 @@ int framebufferInit() {
 	frame.address = 0; //always initializes to 0x48006000
 	frame.size = 0;
 
+    /* The GPU reads and writes the structure in memory, not through the
+     * ARM's data cache.  */
+    dcache_flush(&frame, sizeof(frame));
     mailboxWrite((ulong)&frame);
 
 	ulong result = mailboxRead();
+    dcache_invalidate(&frame, sizeof(frame));
 
 	/* Error checking */
 	if (result) { //if anything but zero
@@ -8,13 +8,24 @@
 #include <stdio.h>
 
 #include <http.h>
+#include <memory.h>
 #include <network.h>
 #include <shell.h>
 #include <tcp.h>
 #include <thread.h>
+#include <workpool.h>
 
+/**
+ * What the work that ends a connection needs to know.
+ */
+struct httpKill
+{
+    uint httpdev;               /**< HTTP device of the connection      */
+    tid_typ shelltid;           /**< web shell serving the connection   */
+    uint tcpdev;                /**< TCP device of the connection       */
+};
 
-thread killHttpServer(uint, tid_typ, uint);
+static int killHttpServer(void *);
 thread httpServer(int, int);
 
 /**
@@ -61,7 +72,9 @@ thread httpServerKickStart(int netDescrp)
  */
 thread httpServer(int netDescrp, int gentcpdev)
 {
-    tid_typ shelltid, killtid;
+    tid_typ shelltid;
+    struct httpKill *killer;
+    future work;
     int tcpdev, httpdev;
     char thrname[TNMLEN];
     struct netaddr *host;
@@ -115,14 +128,31 @@ thread httpServer(int netDescrp, int gentcpdev)
         return SYSERR;
     }
 
-    /* Spawn thread that will wait for kill httpserver thread signal */
-    sprintf(thrname, "XWebKillerD_%d", (devtab[tcpdev].minor));
-    killtid = create((void *)killHttpServer, INITSTK, INITPRIO, thrname,
-                     3, httpdev, shelltid, tcpdev);
+    /* Hand the wait for the kill httpserver signal to the work pool */
+    killer = memget(sizeof(struct httpKill));
+    if (SYSERR == (int)killer)
+    {
+        kill(shelltid);
+        close(httpdev);
+        close(tcpdev);
+        return SYSERR;
+    }
+    killer->httpdev = httpdev;
+    killer->shelltid = shelltid;
+    killer->tcpdev = tcpdev;
+    work = workSubmit(killHttpServer, killer);
+    if (SYSERR == work)
+    {
+        memfree(killer, sizeof(struct httpKill));
+        kill(shelltid);
+        close(httpdev);
+        close(tcpdev);
+        return SYSERR;
+    }
+    workDetach(work);
 
-    /* Ready spawned threads */
+    /* Ready spawned thread */
     ready(shelltid, RESCHED_NO);
-    ready(killtid, RESCHED_NO);
 
     /* Open TCP device */
     if (SYSERR ==
@@ -181,17 +211,23 @@ thread httpServer(int netDescrp, int gentcpdev)
 }
 
 /**
- * Kills HTTP server spawned threads and close devices
- * @param httpdev HTTP device to close
- * @param shelltid shell thread ID to kill
- * @param tcpdev TCP device to close
- * @param servertid server thread ID to kill
- * @return thread return status
+ * Kills HTTP server spawned threads and close devices.  This runs in the
+ * work pool.
+ * @param arg struct httpKill naming the HTTP device to close, the shell
+ *            thread to kill and the TCP device to close; freed here
+ * @return OK or SYSERR
  */
-thread killHttpServer(uint httpdev, tid_typ shelltid, uint tcpdev)
+static int killHttpServer(void *arg)
 {
+    struct httpKill *killer = arg;
+    uint httpdev = killer->httpdev;
+    tid_typ shelltid = killer->shelltid;
+    uint tcpdev = killer->tcpdev;
     device *devptr;
     struct http *webptr;
+
+    memfree(killer, sizeof(struct httpKill));
+
     /* Acquire a pointer to the http device */
     devptr = (device *)&devtab[httpdev];
     if (NULL == devptr)
@@ -46,6 +46,11 @@ devcall rawClose(device *devptr)
         rawptr->icount--;
     }
 
+#ifdef UHEAP_SIZE
+    /* Release shared ring */
+    memRingFree(&rawptr->ring);
+#endif
+
     bzero(rawptr, sizeof(struct raw));  /* Clear RAW structure.         */
     restore(im);
     return OK;
@@ -51,6 +51,68 @@ devcall rawControl(device *devptr, int func, long arg1, long arg2)
         rawptr->flags &= ~(arg1);
         restore(im);
         return old;
+
+#ifdef UHEAP_SIZE
+        /* Map shared ring: arg1 = number of slots, a power of two */
+        /* return address of ring in caller's address space        */
+    case RAW_CTRL_RINGMAP:
+        if ((NULL != rawptr->ring.region)
+            || (SYSERR == memRingAlloc(&rawptr->ring, arg1, RAW_RINGSLOT)))
+        {
+            restore(im);
+            return SYSERR;
+        }
+        /* Frames now go to the ring; drop those queued for read() */
+        while (rawptr->icount > 0)
+        {
+            netFreebuf(rawptr->in[rawptr->istart]);
+            rawptr->in[rawptr->istart] = NULL;
+            rawptr->istart = (rawptr->istart + 1) % RAW_IBLEN;
+            rawptr->icount--;
+            wait(rawptr->isema);
+        }
+        restore(im);
+        return (long)rawptr->ring.user;
+
+        /* Wait until shared ring holds a frame                    */
+    case RAW_CTRL_RINGWAIT:
+        if (NULL == rawptr->ring.region)
+        {
+            restore(im);
+            return SYSERR;
+        }
+        while (memRingEmpty(&rawptr->ring))
+        {
+            rawptr->ringwait = TRUE;
+            wait(rawptr->isema);
+            /* Socket closed or ring unmapped while waiting */
+            if ((RAW_ALLOC != rawptr->state)
+                || (NULL == rawptr->ring.region))
+            {
+                restore(im);
+                return SYSERR;
+            }
+        }
+        restore(im);
+        return OK;
+
+        /* Unmap shared ring                                       */
+    case RAW_CTRL_RINGUNMAP:
+        if (NULL == rawptr->ring.region)
+        {
+            restore(im);
+            return SYSERR;
+        }
+        memRingFree(&rawptr->ring);
+        /* Release a consumer waiting for the ring */
+        if (rawptr->ringwait)
+        {
+            rawptr->ringwait = FALSE;
+            signal(rawptr->isema);
+        }
+        restore(im);
+        return OK;
+#endif
     }
 
     restore(im);
@@ -36,6 +36,15 @@ devcall rawRead(device *devptr, void *buf, uint len)
         return SYSERR;
     }
 
+#ifdef UHEAP_SIZE
+    /* Frames go to the shared ring while one is mapped */
+    if (NULL != rawptr->ring.region)
+    {
+        restore(im);
+        return SYSERR;
+    }
+#endif
+
     /* Read next packet */
     wait(rawptr->isema);
     pkt = rawptr->in[rawptr->istart];
@@ -8,11 +8,16 @@
 #include <network.h>
 #include <icmp.h>
 #include <raw.h>
+#ifdef UHEAP_SIZE
+#include <interrupt.h>
+#endif
 
 /**
  * @ingroup raw
  *
- * Process an incoming protocol other than UDP or TCP.
+ * Process an incoming protocol other than UDP or TCP.  If a user thread
+ * has mapped a shared ring, the frame is copied into it and freed rather
+ * than queued for read().
  * @param pkt pointer to the incoming packet
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
@@ -21,6 +26,12 @@ syscall rawRecv(struct packet *pkt, struct netaddr *src,
 {
     struct raw *rawptr;
     uint index;
+#ifdef UHEAP_SIZE
+    uchar *data;
+    uint dlen;
+    int result;
+    irqmask im;
+#endif
 
     /* Error check pointers */
     if ((NULL == pkt) || (NULL == src) || (NULL == dst))
@@ -39,6 +50,35 @@ syscall rawRecv(struct packet *pkt, struct netaddr *src,
         return OK;
     }
 
+#ifdef UHEAP_SIZE
+    im = disable();
+    if (NULL != rawptr->ring.region)
+    {
+        if (rawptr->flags & RAW_IHDR)
+        {
+            data = pkt->nethdr;
+            dlen = pkt->len - (pkt->nethdr - pkt->linkhdr);
+        }
+        else
+        {
+            data = pkt->curr;
+            dlen = pkt->len - (pkt->curr - pkt->linkhdr);
+        }
+
+        result = memRingPut(&rawptr->ring, data, dlen);
+        if ((OK == result) && rawptr->ringwait)
+        {
+            rawptr->ringwait = FALSE;
+            signal(rawptr->isema);
+        }
+        restore(im);
+        netFreebuf(pkt);
+        RAW_TRACE("Copied packet to ring");
+        return result;
+    }
+    restore(im);
+#endif
+
     /* Ensure there is space */
     if (rawptr->icount >= RAW_IBLEN)
     {
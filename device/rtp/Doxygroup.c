@@ -0,0 +1,17 @@
+/**
+ * @defgroup rtp RTP
+ * @ingroup devices
+ * @brief Real-time Transport Protocol driver
+ *
+ * A RTP device is opened on an open UDP device and carries one stream of
+ * 8 kHz audio.  write() sends its data as the payload of RTP packets.
+ * Received packets are held in timestamp order and read() returns each one
+ * once its playout time, a fixed delay after the time its timestamp implies,
+ * has come, so network jitter and reordering do not reach the reader.
+ * rtpReadbuf() returns the held buffer itself instead of copying it.
+ *
+ * Statistics on the remote stream are kept as packets arrive, and RTCP
+ * sender and receiver reports carry them both ways on a second UDP device,
+ * giving each end the loss, jitter and round trip time of its stream.  The
+ * rtpstat shell command shows them.
+ */
@@ -0,0 +1,103 @@
+/**
+ * @file     rtcpRecv.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <rtp.h>
+
+/**
+ * @ingroup rtp
+ *
+ * Receive a compound RTCP packet from the UDP device carrying a RTP
+ * device's reports.  A sender report's time is kept to return in our next
+ * report, and report blocks about our stream give its loss and jitter at
+ * the remote end and the round trip time.
+ * @param rtpptr RTP device the packet is for
+ * @param pkt Incoming packet, its UDP header converted to host order
+ * @return OK if RTCP packet is received properly, otherwise SYSERR
+ */
+syscall rtcpRecv(struct rtp *rtpptr, struct packet *pkt)
+{
+    const struct udpPkt *udppkt;
+    const struct rtcpPkt *rtcppkt;
+    const struct rtcpSender *sender;
+    const struct rtcpBlock *block;
+    const uchar *end;
+    uint len, size, count, lost, lsr, rtt;
+    ulong now;
+    irqmask im;
+
+    udppkt = (const struct udpPkt *)pkt->curr;
+    rtcppkt = (const struct rtcpPkt *)udppkt->data;
+    len = udppkt->len - UDP_HDR_LEN;
+
+    im = disable();
+
+    /* Make sure the RTP device wasn't closed since the demux */
+    if (RTP_OPEN != rtpptr->state)
+    {
+        restore(im);
+        netFreebuf(pkt);
+        return SYSERR;
+    }
+
+    now = rtpClock();
+    while (len >= sizeof(struct rtcpPkt))
+    {
+        size = 4 * (net2hs(rtcppkt->len) + 1);
+        if ((RTCP_V2 != (rtcppkt->control & RTCP_VER)) || (size > len))
+        {
+            RTP_TRACE("Invalid RTCP packet.");
+            break;
+        }
+        end = (const uchar *)rtcppkt + size;
+        count = rtcppkt->control & RTCP_COUNT;
+        block = (const struct rtcpBlock *)(rtcppkt + 1);
+
+        if ((RTCP_SR == rtcppkt->type)
+            && ((const uchar *)(block) + sizeof(struct rtcpSender) <= end))
+        {
+            /* Keep the middle of the sender's NTP time for our reports */
+            sender = (const struct rtcpSender *)(rtcppkt + 1);
+            rtpptr->lsr = (net2hl(sender->ntpsec) << 16)
+                | (net2hl(sender->ntpfrac) >> 16);
+            rtpptr->lsrtime = now;
+            block = (const struct rtcpBlock *)(sender + 1);
+        }
+
+        if ((RTCP_SR == rtcppkt->type) || (RTCP_RR == rtcppkt->type))
+        {
+            for (; (count > 0) && ((const uchar *)(block + 1) <= end);
+                 count--, block++)
+            {
+                if (net2hl(block->ssrc) != rtpptr->ssrc)
+                {
+                    continue;
+                }
+                lost = net2hl(block->lost);
+                rtpptr->rfraction = lost >> 24;
+                rtpptr->rlost = lost & 0xFFFFFF;
+                rtpptr->rjitter = net2hl(block->jitter);
+
+                /* Round trip time, in 1/65536 s, is the time since our
+                 * report less the time the remote held it */
+                lsr = net2hl(block->lsr);
+                if (0 != lsr)
+                {
+                    rtt = rtcpNtpMid(now) - lsr - net2hl(block->dlsr);
+                    rtpptr->rtt = ((rtt >> 6) * 1000) >> 10;
+                }
+            }
+        }
+
+        rtcppkt = (const struct rtcpPkt *)end;
+        len -= size;
+    }
+
+    restore(im);
+    netFreebuf(pkt);
+    return OK;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file     rtcpReport.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rtp.h>
+
+/**
+ * @ingroup rtp
+ *
+ * Send a RTCP report for a RTP device if one is due.  The report is a
+ * sender report once we have sent RTP, otherwise a receiver report, with a
+ * report block on the remote source if it has sent, followed by a source
+ * description giving our canonical name.  Reports are sent a random time
+ * between 0.5 and 1.5 times ::RTCP_INTERVAL apart, from rtpRead() and
+ * rtpWrite(), so a device that neither reads nor writes sends none.
+ * @param rtpptr RTP control block
+ * @return OK if a report was sent or none was due, otherwise SYSERR
+ */
+syscall rtcpReport(struct rtp *rtpptr)
+{
+    uint frame[RTCP_MAX_PKTLEN / 4];
+    struct rtcpPkt *rtcppkt;
+    struct rtcpSender *sender;
+    struct rtcpBlock *block;
+    struct udp *rtcpptr;
+    uchar *item;
+    ulong now, expected, expinterval, recvinterval;
+    long lost, lostinterval;
+    uint fraction, namelen, len;
+    irqmask im;
+
+    im = disable();
+    rtcpptr = rtpptr->rtcpptr;
+    now = rtpClock();
+    if ((RTP_OPEN != rtpptr->state) || (NULL == rtcpptr)
+        || ((long)(now - rtpptr->rtcpnext) < 0))
+    {
+        restore(im);
+        return OK;
+    }
+    rtpptr->rtcpnext = now + RTCP_INTERVAL / 2 + rand() % RTCP_INTERVAL;
+
+    /* Check if we have a specified remote port and ip */
+    if ((0 == rtcpptr->remotept) || (0 == rtcpptr->remoteip.type))
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    rtcppkt = (struct rtcpPkt *)frame;
+    rtcppkt->control = RTCP_V2;
+    rtcppkt->ssrc = hl2net(rtpptr->ssrc);
+    if (rtpptr->sentpkts > 0)
+    {
+        rtcppkt->type = RTCP_SR;
+        sender = (struct rtcpSender *)(rtcppkt + 1);
+        sender->ntpsec = hl2net(now / 1000);
+        sender->ntpfrac = hl2net((now % 1000) * (0xFFFFFFFF / 1000));
+        sender->timestamp = hl2net(rtpptr->timestamp);
+        sender->packets = hl2net(rtpptr->sentpkts);
+        sender->octets = hl2net(rtpptr->sentoctets);
+        block = (struct rtcpBlock *)(sender + 1);
+    }
+    else
+    {
+        rtcppkt->type = RTCP_RR;
+        block = (struct rtcpBlock *)(rtcppkt + 1);
+    }
+
+    /* Report on the remote source, as in RFC 3550 appendix A.3 */
+    if (rtpptr->rvalid)
+    {
+        expected = rtpExpected(rtpptr);
+        lost = expected - rtpptr->received;
+        if (lost > 0x7FFFFF)
+        {
+            lost = 0x7FFFFF;
+        }
+        else if (lost < -0x800000)
+        {
+            lost = -0x800000;
+        }
+        expinterval = expected - rtpptr->expprior;
+        rtpptr->expprior = expected;
+        recvinterval = rtpptr->received - rtpptr->recvprior;
+        rtpptr->recvprior = rtpptr->received;
+        lostinterval = expinterval - recvinterval;
+        fraction = 0;
+        if ((0 != expinterval) && (lostinterval > 0))
+        {
+            fraction = (lostinterval << 8) / expinterval;
+        }
+
+        block->ssrc = hl2net(rtpptr->rssrc);
+        block->lost = hl2net((fraction << 24) | (lost & 0xFFFFFF));
+        block->maxseq = hl2net(rtpptr->cycles + rtpptr->maxseq);
+        block->jitter = hl2net(rtpptr->jitter >> 4);
+        block->lsr = hl2net(rtpptr->lsr);
+        block->dlsr = 0;
+        if (0 != rtpptr->lsr)
+        {
+            block->dlsr = hl2net(rtcpNtpMid(now - rtpptr->lsrtime));
+        }
+        block++;
+        rtcppkt->control |= 1;
+    }
+    len = (uchar *)block - (uchar *)rtcppkt;
+    rtcppkt->len = hs2net(len / 4 - 1);
+
+    restore(im);
+
+    /* Follow with our canonical name, user@host */
+    rtcppkt = (struct rtcpPkt *)block;
+    rtcppkt->control = RTCP_V2 | 1;
+    rtcppkt->type = RTCP_SDES;
+    rtcppkt->ssrc = hl2net(rtpptr->ssrc);
+    item = (uchar *)(rtcppkt + 1);
+    item[0] = RTCP_SDES_CNAME;
+    memcpy(item + 2, "xinu@", 5);
+    netaddrsprintf((char *)item + 7, &rtcpptr->localip);
+    namelen = 5 + strlen((char *)item + 7);
+    item[1] = namelen;
+    item += 2 + namelen;
+
+    /* End the items with at least one null, up to a word boundary */
+    do
+    {
+        *item++ = RTCP_SDES_END;
+    }
+    while (0 != ((item - (uchar *)rtcppkt) & 3));
+    rtcppkt->len = hs2net((item - (uchar *)rtcppkt) / 4 - 1);
+    len += item - (uchar *)rtcppkt;
+
+    return udpSend(rtcpptr, len, frame);
+}
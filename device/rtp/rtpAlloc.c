@@ -7,9 +7,10 @@
 #include <stddef.h>
 #include <interrupt.h>
 #include <rtp.h>
-#include <udp.h>
 
 /**
+ * @ingroup rtp
+ *
  * Allocate an available rtp device.
  * @return device number for a rtp device, SYSERR if none are free
  */
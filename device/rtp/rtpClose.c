@@ -12,26 +12,41 @@
 #include <interrupt.h>
 
 /**
- * Close and clear a RTP device
+ * @ingroup rtp
+ *
+ * Close a RTP device, dropping any packets it holds, and its RTCP UDP
+ * device.  The UDP device it was opened on is left open.
  * @param devptr RTP device table entry
- * @return OK is RTP is closed properly, otherwise SYSERR
+ * @return OK if RTP is closed properly, otherwise SYSERR
  */
 devcall rtpClose(device *devptr)
 {
     struct rtp *rtpptr;
     irqmask im;
 
-    /* Setup and error check pointers to structures */
     rtpptr = &rtptab[devptr->minor];
 
     im = disable();
-    /* Free the in buffer pool */
+
+    /* Make sure RTP device is actually open */
+    if (RTP_OPEN != rtpptr->state)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    if (NULL != rtpptr->rtcpptr)
+    {
+        close(rtpptr->rtcpptr->dev->num);
+    }
+
+    /* Free the in buffer pool, and with it the held packets */
     bfpfree(rtpptr->inPool);
 
     /* Free the in semaphore */
     semfree(rtpptr->isem);
 
-    /* Clear the RTP structure and the device IO block */
+    /* Clear the RTP structure */
     bzero(rtpptr, sizeof(struct rtp));
 
     /* Set device state to free */
@@ -0,0 +1,54 @@
+/**
+ * @file     rtpControl.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <device.h>
+#include <interrupt.h>
+#include <rtp.h>
+
+/**
+ * @ingroup rtp
+ *
+ * Control function for RTP devices.
+ * @param devptr RTP device table entry
+ * @param func control function to execute
+ * @param arg1 first argument for the control function
+ * @param arg2 second argument for the control function
+ * @return the result of the control function
+ */
+devcall rtpControl(device *devptr, int func, long arg1, long arg2)
+{
+    struct rtp *rtpptr;
+    irqmask im;
+    devcall retval = SYSERR;
+
+    rtpptr = &rtptab[devptr->minor];
+
+    im = disable();
+    if (RTP_OPEN != rtpptr->state)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    switch (func)
+    {
+        /* Set playout delay in ms (arg1); return old delay */
+    case RTP_CTRL_SETDELAY:
+        retval = rtpptr->delay;
+        rtpptr->delay = arg1;
+        break;
+
+        /* Set payload type sent (arg1); return old type */
+    case RTP_CTRL_SETPT:
+        retval = rtpptr->payload;
+        rtpptr->payload = arg1 & RTP_PT;
+        break;
+    }
+
+    restore(im);
+    return retval;
+}
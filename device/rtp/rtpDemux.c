@@ -0,0 +1,33 @@
+/**
+ * @file     rtpDemux.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <rtp.h>
+
+/**
+ * @ingroup rtp
+ *
+ * Find the RTP device opened on a UDP device, or whose RTCP it carries.
+ * @param udpptr UDP device a packet arrived on
+ * @return RTP control block, NULL if the UDP device carries no RTP
+ * @pre-condition interrupts are already disabled
+ * @post-condition interrupts are still disabled
+ */
+struct rtp *rtpDemux(const struct udp *udpptr)
+{
+    uint i;
+
+    for (i = 0; i < NRTP; i++)
+    {
+        if ((RTP_OPEN == rtptab[i].state)
+            && ((rtptab[i].udpptr == udpptr)
+                || (rtptab[i].rtcpptr == udpptr)))
+        {
+            return &rtptab[i];
+        }
+    }
+    return NULL;
+}
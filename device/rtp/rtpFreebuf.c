@@ -6,10 +6,16 @@
 
 #include <stddef.h>
 #include <bufpool.h>
-#include <network.h>
 #include <rtp.h>
 
-syscall rtpFreebuf(struct rtpPkt *rtppkt)
+/**
+ * @ingroup rtp
+ *
+ * Return a packet buffer to its RTP device's pool.
+ * @param rtpbuf buffer from rtpReadbuf() or rtpGetbuf()
+ * @return OK, or SYSERR if rtpbuf is not a pool buffer
+ */
+syscall rtpFreebuf(struct rtpBuf *rtpbuf)
 {
-    return buffree(rtppkt);
+    return buffree(rtpbuf);
 }
@@ -6,21 +6,31 @@
 
 #include <stddef.h>
 #include <bufpool.h>
-#include <network.h>
-#include <stdlib.h>
 #include <rtp.h>
 
-struct rtpPkt *rtpGetbuf(struct rtp *rtpptr)
+/**
+ * @ingroup rtp
+ *
+ * Get a buffer to hold a received packet, without waiting.  The pool has a
+ * buffer for each slot of the playout buffer, less those lent by
+ * rtpReadbuf().
+ * @param rtpptr RTP control block
+ * @return buffer, or SYSERR if none is free
+ */
+struct rtpBuf *rtpGetbuf(struct rtp *rtpptr)
 {
-    struct rtpPkt *rtppkt = NULL;
+    struct rtpBuf *rtpbuf;
 
-    rtppkt = bufget(rtpptr->inPool);
-    if (SYSERR == (int)rtppkt)
+    if (semcount(bfptab[rtpptr->inPool].freebuf) <= 0)
     {
-        return (struct rtpPkt *)SYSERR;
+        return (struct rtpBuf *)SYSERR;
     }
 
-    bzero(rtppkt, NET_MAX_PKTLEN);
+    rtpbuf = bufget(rtpptr->inPool);
+    if (SYSERR == (int)rtpbuf)
+    {
+        return (struct rtpBuf *)SYSERR;
+    }
 
-    return rtppkt;
+    return rtpbuf;
 }
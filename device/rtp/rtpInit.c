@@ -8,13 +8,14 @@
 #include <device.h>
 #include <stdlib.h>
 #include <rtp.h>
-#include <udp.h>
 
 struct rtp rtptab[NRTP];
 
 /**
+ * @ingroup rtp
+ *
  * Set aside some space for a RTP device to be opened on
- * @param devptr UDP device table entry
+ * @param devptr RTP device table entry
  * @return OK
  */
 devcall rtpInit(device *devptr)
@@ -2,40 +2,41 @@
  * @file     rtpOpen.c
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #include <stddef.h>
 #include <stdlib.h>
 #include <bufpool.h>
 #include <device.h>
-#include <network.h>
 #include <rtp.h>
 #include <stdarg.h>
 #include <interrupt.h>
-#include <udp.h>
-
-static ushort allocPort(void);
 
 /**
- * Associate a RTP socket with a hardware device.
- * @param devptr RTP device table entry
- * @return OK if RTP is opened properly, otherwise SYSERR
+ * @ingroup rtp
+ *
+ * Open a RTP device on a UDP device.  From then on, packets arriving on the
+ * UDP device are read through the RTP device, which also sends through it.
+ * If a UDP device is free, RTCP reports are exchanged through it on the
+ * ports one above the UDP device's.
+ *
+ * @param devptr
+ *      Device table entry for the RTP device.
+ * @param ap One additional argument, the UDP device.  It must be open,
+ *      bound to the remote address and port, and not in passive mode.
+ *      Close the RTP device before closing the UDP device.
+ *
+ * @return ::OK if the RTP device was opened successfully; otherwise ::SYSERR.
  */
 devcall rtpOpen(device *devptr, va_list ap)
 {
-    struct rtp *rtpptr = NULL;
-    //Todo Attach to UDP Dev
-    rtpptr->sequence = 0;       // Random number        
-    rtpptr->tp = 0;
-    rtpptr->tc = 0;
-    rtpptr->senders = 0;
-    rtpptr->pmembers = 0;
-    rtpptr->members = 1;
-    rtpptr->we_sent = false;
-    //rtpptr->rtcp_bw = //specified fraction of session bandwidth
-    rtpptr->inital = true;
-    //rtpptr->avg_rtcp_size = (1/16) * //packet_size + (15/16) * rtpptr->avg_rtcp_size;
     irqmask im;
+    int retval;
+    struct rtp *rtpptr;
+    struct udp *udpptr;
+    int udpdev;
+    ushort rtcpdev;
+    int i;
 
     rtpptr = &rtptab[devptr->minor];
 
@@ -44,12 +45,35 @@ devcall rtpOpen(device *devptr, va_list ap)
     if (RTP_OPEN == rtpptr->state)
     {
         RTP_TRACE("rtp%d has already been opened.", devptr->minor);
-        restore(im);
-        return SYSERR;
+        retval = SYSERR;
+        goto out_restore;
+    }
+
+    /* Retrieve and check the UDP device */
+    udpdev = va_arg(ap, int);
+    if ((udpdev < UDP0) || (udpdev >= UDP0 + NUDP))
+    {
+        retval = SYSERR;
+        goto out_restore;
+    }
+    udpptr = &udptab[devtab[udpdev].minor];
+    if ((UDP_OPEN != udpptr->state) || (udpptr->flags & UDP_FLAG_PASSIVE))
+    {
+        retval = SYSERR;
+        goto out_restore;
+    }
+    for (i = 0; i < NRTP; i++)
+    {
+        if ((RTP_OPEN == rtptab[i].state) && (rtptab[i].udpptr == udpptr))
+        {
+            RTP_TRACE("udp%d already carries rtp%d.", udpptr->dev->minor, i);
+            retval = SYSERR;
+            goto out_restore;
+        }
     }
 
-    rtpptr->state = RTP_OPEN;
     rtpptr->dev = devptr;
+    rtpptr->udpptr = udpptr;
 
     /* Initialize incoming packet buffer */
     rtpptr->icount = 0;
@@ -57,37 +81,67 @@ devcall rtpOpen(device *devptr, va_list ap)
 
     /* Initialize the semaphore */
     rtpptr->isem = semcreate(0);
-
-    /* Parse arguments */
+    if (SYSERR == (int)rtpptr->isem)
+    {
+        retval = SYSERR;
+        goto out_restore;
+    }
 
     /* Allocate received RTP packet buffer pool */
-    rtpptr->inPool = bfpalloc(NET_MAX_PKTLEN, RTP_MAX_PKTS);
+    rtpptr->inPool = bfpalloc(sizeof(struct rtpBuf) + RTP_MAX_DATALEN,
+                              RTP_MAX_PKTS);
+    if (SYSERR == (int)rtpptr->inPool)
+    {
+        retval = SYSERR;
+        goto out_free_sem;
+    }
     RTP_TRACE("rtp%d inPool has been assigned pool ID %d.\r\n",
               devptr->minor, rtpptr->inPool);
 
-    restore(im);
-    return OK;
-}
+    /* Start the sequence number and timestamp at random values */
+    rtpptr->sequence = rand();
+    rtpptr->timestamp = (rand() << 16) ^ rand();
+    rtpptr->ssrc = (rand() << 16) ^ rand();
+    rtpptr->payload = RTP_PT_PCMU;
 
-/**
- * Allocates an unused RTP port to use as a local port
- * @return RTP port
- */
-static ushort allocPort()
-{
-    static ushort nextport = 0;
-    int i = 0;
+    /* The playout clock is set by the first packet to arrive */
+    rtpptr->synced = FALSE;
+    rtpptr->played = FALSE;
+    rtpptr->delay = RTP_DELAY;
+    rtpptr->late = 0;
+    rtpptr->dups = 0;
+    rtpptr->overruns = 0;
 
-    nextport = (nextport + 1) % (RTP_PMAX - RTP_PSTART);
-    for (i = 0; i < NRTP; i++)
+    /* Carry RTCP on the next ports up, if a UDP device is free for it */
+    rtpptr->rtcpptr = NULL;
+    rtcpdev = udpAlloc();
+    if (SYSERR != (short)rtcpdev)
     {
-        if ((rtptab[i].localpt == (nextport + RTP_PSTART))
-            || (RTP_PORT_TRACEROUTE == (nextport + RTP_PSTART)))
+        if (SYSERR == open(rtcpdev, &udpptr->localip,
+                           udpptr->remoteip.type ? &udpptr->remoteip : NULL,
+                           udpptr->localpt + 1,
+                           udpptr->remotept ? udpptr->remotept + 1 : 0))
+        {
+            udptab[devtab[rtcpdev].minor].state = UDP_FREE;
+        }
+        else
         {
-            nextport = (nextport + 1) % (RTP_PMAX - RTP_PSTART);
-            i = 0;
+            rtpptr->rtcpptr = &udptab[devtab[rtcpdev].minor];
         }
     }
+    rtpptr->rtcpnext = rtpClock() + RTCP_INTERVAL / 2;
+    rtpptr->sentpkts = 0;
+    rtpptr->sentoctets = 0;
+    rtpptr->rvalid = FALSE;
+    rtpptr->rtt = 0;
 
-    return (nextport + RTP_PSTART);
+    rtpptr->state = RTP_OPEN;
+    retval = OK;
+    goto out_restore;
+
+out_free_sem:
+    semfree(rtpptr->isem);
+out_restore:
+    restore(im);
+    return retval;
 }
@@ -0,0 +1,80 @@
+/**
+ * @file     rtpReadbuf.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <device.h>
+#include <interrupt.h>
+#include <thread.h>
+#include <rtp.h>
+
+/**
+ * @ingroup rtp
+ *
+ * Take the next packet in playout order from a RTP device without copying
+ * its payload, waiting until it is due.  A packet that arrives while
+ * waiting and plays earlier is returned instead.  The buffer is lent from
+ * the device's pool: give it back with rtpFreebuf() before closing the
+ * device.  While it is lent the device holds one packet fewer.
+ * @param descrp RTP device
+ * @return buffer holding the payload, or SYSERR if the RTP device was not
+ *         open or was closed while waiting
+ */
+struct rtpBuf *rtpReadbuf(int descrp)
+{
+    struct rtp *rtpptr;
+    struct rtpBuf *rtpbuf;
+    ulong now, due;
+    irqmask im;
+
+    if (isbadrtp(descrp))
+    {
+        return (struct rtpBuf *)SYSERR;
+    }
+    rtpptr = &rtptab[devtab[descrp].minor];
+
+    im = disable();
+
+    /* Make sure the RTP device is open */
+    if (RTP_OPEN != rtpptr->state)
+    {
+        restore(im);
+        return (struct rtpBuf *)SYSERR;
+    }
+
+    /* Wait for a packet to be held */
+    wait(rtpptr->isem);
+
+    /* Sleep until the first packet in playout order is due.  Check again
+     * after sleeping, since an earlier packet may have arrived.  */
+    while (TRUE)
+    {
+        if (RTP_OPEN != rtpptr->state)
+        {
+            restore(im);
+            return (struct rtpBuf *)SYSERR;
+        }
+        rtpbuf = rtpptr->in[rtpptr->istart];
+        due = rtpDue(rtpptr, rtpbuf->timestamp);
+        now = rtpClock();
+        if ((long)(due - now) <= 0)
+        {
+            break;
+        }
+        sleep(due - now);
+    }
+
+    /* Remove the packet; later ones are late */
+    rtpptr->istart = (rtpptr->istart + 1) % RTP_MAX_PKTS;
+    rtpptr->icount--;
+    rtpptr->lastts = rtpbuf->timestamp;
+    rtpptr->lastseq = rtpbuf->seqNum;
+    rtpptr->played = TRUE;
+
+    restore(im);
+
+    rtcpReport(rtpptr);
+    return rtpbuf;
+}
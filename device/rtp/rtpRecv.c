@@ -2,91 +2,242 @@
  * @file     rtpRecv.c
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #include <stddef.h>
 #include <string.h>
 #include <interrupt.h>
-#include <ipv4.h>
-#include <icmp.h>
 #include <rtp.h>
 
+/*
+ * TRUE if the packet with timestamp ts and sequence number seq plays before
+ * the packet held in rtpbuf.  Both numbers wrap, so they are compared by
+ * the sign of their difference.  Packets with equal timestamps play in
+ * sequence order.
+ */
+static bool rtpBefore(uint ts, ushort seq, const struct rtpBuf *rtpbuf)
+{
+    if (ts != rtpbuf->timestamp)
+    {
+        return ((int)(ts - rtpbuf->timestamp) < 0);
+    }
+    return ((short)(seq - rtpbuf->seqNum) < 0);
+}
+
+/*
+ * Update the statistics of the remote source for a packet arriving at now
+ * ms, as in RFC 3550 appendices A.1 and A.8.  The interarrival jitter is
+ * kept in timestamp units, times 16.
+ */
+static void rtpSource(struct rtp *rtpptr, uint ssrc, ushort seq, uint ts,
+                      ulong now)
+{
+    ushort udelta;
+    uint transit;
+    int d;
+
+    transit = now * RTP_TSPERMS - ts;
+    if (!rtpptr->rvalid || (ssrc != rtpptr->rssrc))
+    {
+        rtpptr->rvalid = TRUE;
+        rtpptr->rssrc = ssrc;
+        rtpptr->maxseq = seq;
+        rtpptr->baseseq = seq;
+        rtpptr->cycles = 0;
+        rtpptr->received = 0;
+        rtpptr->expprior = 0;
+        rtpptr->recvprior = 0;
+        rtpptr->transit = transit;
+        rtpptr->jitter = 0;
+        rtpptr->lsr = 0;
+    }
+
+    udelta = seq - rtpptr->maxseq;
+    if (udelta < RTP_MAXDROPOUT)
+    {
+        /* In order, with a permissible gap */
+        if (seq < rtpptr->maxseq)
+        {
+            rtpptr->cycles += 65536;
+        }
+        rtpptr->maxseq = seq;
+    }
+    else if (udelta <= 65536 - RTP_MAXMISORDER)
+    {
+        /* Too large a jump to be loss; the sender restarted its count */
+        rtpptr->maxseq = seq;
+        rtpptr->baseseq = seq;
+        rtpptr->cycles = 0;
+        rtpptr->received = 0;
+        rtpptr->expprior = 0;
+        rtpptr->recvprior = 0;
+    }
+    rtpptr->received++;
+
+    d = transit - rtpptr->transit;
+    rtpptr->transit = transit;
+    if (d < 0)
+    {
+        d = -d;
+    }
+    rtpptr->jitter += d - ((rtpptr->jitter + 8) >> 4);
+}
+
 /**
- * Receive a RTP packet and place it in the RTP device's input buffer
- * @param pkt Incoming RTP packet
- * @param src Source address
- * @param dst Destination address
+ * @ingroup rtp
+ *
+ * Receive a RTP packet from the UDP device the RTP device is open on, and
+ * hold its payload in timestamp order until it is due for playout.  The
+ * first packet sets the playout clock: each packet is due the RTP device's
+ * delay after the time its timestamp gives relative to the first one.
+ * Packets arriving after a later one has been read are dropped, as are
+ * duplicates.  The statistics RTCP reports are updated for every packet.
+ * @param rtpptr RTP device the packet is for
+ * @param pkt Incoming packet, its UDP header converted to host order
  * @return OK if RTP packet is received properly, otherwise SYSERR
  */
-syscall rtpRecv(struct packet *pkt, struct netaddr *src,
-                struct netaddr *dst)
+syscall rtpRecv(struct rtp *rtpptr, struct packet *pkt)
 {
-    struct rtpPkt *rtppkt;
-    struct rtpPktExt *rtpext;
-    struct rtp *rtpptr;
-    struct rtpPkt *tpkt;
-//#ifdef TRACE_RTP
-    //char strA[20];
-    //char strB[20];
-//#endif                          /* TRACE_RTP */
-
+    const struct udpPkt *udppkt;
+    const struct rtpPkt *rtppkt;
+    const struct rtpPktExt *rtpext;
+    struct rtpBuf *rtpbuf, *held;
+    ushort control, seq;
+    uint ts, hdrlen, len;
+    ulong now, due;
+    int i, j;
     irqmask im;
 
-    /* Point to the start of the RTP header */
-    rtppkt = (struct rtpPkt *)pkt->curr;
+    /* Point to the RTP header, which is the UDP payload */
+    udppkt = (const struct udpPkt *)pkt->curr;
+    rtppkt = (const struct rtpPkt *)udppkt->data;
+    len = udppkt->len - UDP_HDR_LEN;
 
-    if (NULL == rtppkt)
+    /* Find the payload after the CSRCs and header extension */
+    control = net2hs(rtppkt->control);
+    hdrlen = RTP_HDR_LEN + RTP_CSRC_LEN * ((control & RTP_CC) >> 8);
+    if ((len < RTP_HDR_LEN) || (RTP_V2 != (control & RTP_VER))
+        || ((control & RTP_EXT) && (len < hdrlen + RTP_EXT_LEN)))
+    {
+        RTP_TRACE("Invalid RTP packet.");
+        netFreebuf(pkt);
+        return SYSERR;
+    }
+    if (control & RTP_EXT)
+    {
+        rtpext = (const struct rtpPktExt *)((uchar *)rtppkt + hdrlen);
+        hdrlen += RTP_EXT_LEN + 4 * net2hs(rtpext->len);
+    }
+    if ((control & RTP_PAD) && (len > hdrlen))
+    {
+        len -= ((uchar *)rtppkt)[len - 1];
+    }
+    if ((len < hdrlen) || (len - hdrlen > RTP_MAX_DATALEN))
     {
-        //RTP_TRACE("Invalid RTP packet.");
+        RTP_TRACE("Invalid RTP packet length.");
         netFreebuf(pkt);
         return SYSERR;
     }
-//TODO handle rtcp intake
+
+    ts = net2hl(rtppkt->timestamp);
+    seq = net2hs(rtppkt->seqNum);
 
     im = disable();
 
-    //if (NULL == rtpptr)
-    //{
-//#ifdef TRACE_RTP
-    //RTP_TRACE("No RTP socket found for this RTP packet.");
-    //netaddrsprintf(strA, src);
-    //netaddrsprintf(strB, dst);
-    //RTP_TRACE("Source: %s:%d, Destination: %s:%d", strA,
-    //          rtppkt->srcPort, strB, rtppkt->dstPort);
-//#endif                          /* TRACE_RTP */
-    //restore(im);
-    /* Send ICMP port unreachable message */
-    //icmpDestUnreach(pkt, ICMP_PORT_UNR);
-    //netFreebuf(pkt);
-    //return SYSERR;
-    //}
-    if (rtpptr->icount >= RTP_MAX_PKTS)
+    /* Make sure the RTP device wasn't closed since the demux */
+    if (RTP_OPEN != rtpptr->state)
     {
-        //RTP_TRACE("RTP buffer is full. Dropping RTP packet.");
         restore(im);
         netFreebuf(pkt);
         return SYSERR;
     }
 
-    /* Get some buffer space to store the packet */
-    tpkt = rtpGetbuf(rtpptr);
+    now = rtpClock();
+    rtpSource(rtpptr, net2hl(rtppkt->ssrc), seq, ts, now);
+
+    if (!rtpptr->synced)
+    {
+        rtpptr->basets = ts;
+        rtpptr->basetime = now;
+        rtpptr->synced = TRUE;
+    }
+
+    /* With nothing held, a packet far off the schedule means the sender
+     * restarted its stream; restart the playout clock from it.  */
+    due = rtpDue(rtpptr, ts);
+    if ((0 == rtpptr->icount)
+        && (((long)(due - now) < -RTP_RESYNC)
+            || ((long)(due - now) > (long)rtpptr->delay + RTP_RESYNC)))
+    {
+        RTP_TRACE("Resynchronizing playout at timestamp %u.", ts);
+        rtpptr->basets = ts;
+        rtpptr->basetime = now;
+        rtpptr->played = FALSE;
+    }
+
+    /* A packet that should have played before the last one read is late */
+    if (rtpptr->played
+        && (((int)(ts - rtpptr->lastts) < 0)
+            || ((ts == rtpptr->lastts)
+                && ((short)(seq - rtpptr->lastseq) <= 0))))
+    {
+        RTP_TRACE("Late RTP packet %d dropped.", seq);
+        rtpptr->late++;
+        restore(im);
+        netFreebuf(pkt);
+        return SYSERR;
+    }
 
-    if (SYSERR == (int)tpkt)
+    if (rtpptr->icount >= RTP_MAX_PKTS)
     {
-        //RTP_TRACE("Unable to get RTP buffer from pool. Dropping packet.");
+        RTP_TRACE("RTP buffer is full. Dropping RTP packet.");
+        rtpptr->overruns++;
+        restore(im);
         netFreebuf(pkt);
         return SYSERR;
     }
 
-    /* Copy the data of the packet into the input buffer at the current 
-     * position */
-    rtpext = (struct rtpPktExt *)tpkt;
-    //TODO Fill out RTP Extension Packet
+    /* Find where the packet goes, searching from the tail since packets
+     * mostly arrive in order.  It goes after the first held packet, from
+     * the tail, that plays before it.  */
+    for (i = rtpptr->icount; i > 0; i--)
+    {
+        held = rtpptr->in[(rtpptr->istart + i - 1) % RTP_MAX_PKTS];
+        if ((held->timestamp == ts) && (held->seqNum == seq))
+        {
+            RTP_TRACE("Duplicate RTP packet %d dropped.", seq);
+            rtpptr->dups++;
+            restore(im);
+            netFreebuf(pkt);
+            return SYSERR;
+        }
+        if (!rtpBefore(ts, seq, held))
+        {
+            break;
+        }
+    }
 
-    memcpy((rtpext + 1), rtppkt, rtppkt->len);
+    /* Get some buffer space to store the payload */
+    rtpbuf = rtpGetbuf(rtpptr);
+    if (SYSERR == (int)rtpbuf)
+    {
+        RTP_TRACE("Unable to get RTP buffer from pool. Dropping packet.");
+        restore(im);
+        netFreebuf(pkt);
+        return SYSERR;
+    }
+    rtpbuf->timestamp = ts;
+    rtpbuf->seqNum = seq;
+    rtpbuf->len = len - hdrlen;
+    memcpy(rtpbuf->data, (uchar *)rtppkt + hdrlen, rtpbuf->len);
 
-    /* Store the temporary RTP packet in a FIFO buffer */
-    rtpptr->in[(rtpptr->istart + rtpptr->icount) % RTP_MAX_PKTS] = tpkt;
+    /* Make room at position i and store the packet there */
+    for (j = rtpptr->icount; j > i; j--)
+    {
+        rtpptr->in[(rtpptr->istart + j) % RTP_MAX_PKTS] =
+            rtpptr->in[(rtpptr->istart + j - 1) % RTP_MAX_PKTS];
+    }
+    rtpptr->in[(rtpptr->istart + i) % RTP_MAX_PKTS] = rtpbuf;
     rtpptr->icount++;
 
     restore(im);
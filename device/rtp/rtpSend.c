@@ -2,74 +2,44 @@
  * @file     rtpSend.c
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #include <stddef.h>
-#include <stdlib.h>
-#include <device.h>
-#include <ipv4.h>
-#include <kernel.h>
+#include <string.h>
 #include <network.h>
 #include <rtp.h>
-#include <udp.h>
 
 /**
- * Send a RTP packet across the network to a certain destination
+ * @ingroup rtp
+ *
+ * Send one RTP packet through the UDP device the RTP device is open on.
+ * The timestamp advances by one for each byte, as for 8 bit samples.
  * @param rtpptr Pointer to RTP control block
- * @param datalen Length of data to be sent
+ * @param datalen Length of data to be sent, at most ::RTP_MAX_DATALEN
  * @param buf Data to be sent
  * @return OK if packet is sent properly, otherwise SYSERR
  */
-syscall rtpSend(struct rtp *rtpptr, ushort datalen, void *buf)
+syscall rtpSend(struct rtp *rtpptr, ushort datalen, const void *buf)
 {
-    struct packet *pkt;
-    struct rtpPkt *rtppkt = NULL;
-    struct rtpPktExt *rtppktext = NULL;
+    uint frame[(RTP_HDR_LEN + RTP_MAX_DATALEN + 3) / 4];
+    struct rtpPkt *rtppkt;
     int result;
 
-    pkt = netGetbuf();
-    if (SYSERR == (int)pkt)
-    {
-        //RTP_TRACE("Failed to allocate buffer");
-        return SYSERR;
-    }
-
-    /* Set the length of the packet and set the curr pointer back that 
-     * length */
-    pkt->len = datalen;
-    /* Round the datalength to maintain word alignment */
-    pkt->curr -= (3 + (ulong)(pkt->len)) & ~0x03;
-
-    /* Copy packet plus header */
-    memcpy(pkt->curr, (rtppktext + 1), datalen);
-    rtppkt = (struct rtpPkt *)(pkt->curr);
-
-    datalen += RTP_HDR_LEN;
-    /* Set the length of the packet and set the curr pointer back that 
-     * length */
-    pkt->len = datalen;
-    /* Round the datalength to maintain word alignment */
-    pkt->curr -= (3 + (ulong)(pkt->len)) & ~0x03;
-
     /* Set RTP header fields and fill the packet with the data */
-    //TODO
-    rtppkt = (struct rtpPkt *)(pkt->curr);
-    rtppkt->control = 0;
-    rtppkt->seqNum = rtpptr->sequence;
-    rtpptr->sequence++;
-    rtppkt->timestamp =;
-    rtppkt->ssrc =;
-    rtppkt->csrc[0] =;
-
-    memcpy(rtppkt->data, buf, datalen - RTP_HDR_LEN);
-
-    /* Send the RTP packet through IP */
-    //TODO result = udpSend(pkt, &localip, &remoteip, IPv4_PROTO_RTP);
-
-    if (SYSERR == netFreebuf(pkt))
+    rtppkt = (struct rtpPkt *)frame;
+    rtppkt->control = hs2net(RTP_V2 | rtpptr->payload);
+    rtppkt->seqNum = hs2net(rtpptr->sequence);
+    rtppkt->timestamp = hl2net(rtpptr->timestamp);
+    rtppkt->ssrc = hl2net(rtpptr->ssrc);
+    memcpy(rtppkt->data, buf, datalen);
+
+    result = udpSend(rtpptr->udpptr, RTP_HDR_LEN + datalen, rtppkt);
+    if (OK == result)
     {
-        //RTP_TRACE("Failed to free buffer");
-        return SYSERR;
+        rtpptr->sequence++;
+        rtpptr->timestamp += datalen;
+        rtpptr->sentpkts++;
+        rtpptr->sentoctets += datalen;
     }
 
     return result;
@@ -2,53 +2,58 @@
  * @file     rtpWrite.c
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #include <device.h>
 #include <stddef.h>
 #include <rtp.h>
 
 /**
- * Tell a RTP device to send a packet with the specified data
+ * @ingroup rtp
+ *
+ * Send data through a RTP device, in as many packets of at most
+ * ::RTP_MAX_DATALEN bytes as it takes.  Only one thread may write to a RTP
+ * device at a time.
  * @param devptr RTP device table entry
  * @param buf Buffer of data to be sent
  * @param len Length of data to be sent
- * @return OK if the packet was sent, otherwise SYSERR
+ * @return number of bytes sent, which is less than len after an error, or
+ *         SYSERR if nothing was sent
  */
-devcall rtpWrite(device *devptr, void *buf, uint len)
+devcall rtpWrite(device *devptr, const void *buf, uint len)
 {
     struct rtp *rtpptr;
-    uchar *p = (uchar *)buf;
+    uint pktsize;
+    uint count;
 
     rtpptr = &rtptab[devptr->minor];
 
-    if (len > (RTP_MAX_DATALEN + RTP_HDR_LEN + sizeof(struct rtpPktExt)))
+    if ((RTP_OPEN != rtpptr->state) || (UDP_OPEN != rtpptr->udpptr->state))
     {
         return SYSERR;
     }
 
-    len = 0;
+    /* Check if we have a specified remote port and ip */
+    if ((0 == rtpptr->udpptr->remotept)
+        || (0 == rtpptr->udpptr->remoteip.type))
+    {
+        RTP_TRACE("No specified remote port or IP address.");
+        return SYSERR;
+    }
 
-    while (len > 0)
+    for (count = 0; count < len; count += pktsize)
     {
-        if (len > RTP_MAX_DATALEN)
+        pktsize = len - count;
+        if (pktsize > RTP_MAX_DATALEN)
         {
-            if (SYSERR == rtpSend(rtpptr, RTP_MAX_DATALEN, p))
-            {
-                return SYSERR;
-            }
-            len -= RTP_MAX_DATALEN;
-            p += RTP_MAX_DATALEN;
+            pktsize = RTP_MAX_DATALEN;
         }
-        else
+        if (OK != rtpSend(rtpptr, pktsize, (const uchar *)buf + count))
         {
-            if (SYSERR == rtpSend(rtpptr, len, p))
-            {
-                return SYSERR;
-            }
-            len = 0;
+            return (0 == count) ? SYSERR : count;
         }
     }
 
+    rtcpReport(rtpptr);
     return len;
 }
@@ -26,7 +26,7 @@ devcall tcpInit(device *devptr)
     bzero(tcbptr, sizeof(struct tcb));
     tcbptr->state = TCP_CLOSED;
     tcbptr->devstate = TCP_FREE;
-    tcbptr->mutex = semcreate(1);
+    tcbptr->mutex = mutexcreate(0);
     if (SYSERR == (int)tcbptr->mutex)
     {
         return SYSERR;
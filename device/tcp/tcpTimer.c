@@ -13,7 +13,7 @@
 #include <thread.h>
 
 struct tcpEvent tcptimertab[TCP_NEVENTS];
-semaphore tcpmutex;
+kmutex tcpmutex;
 
 static int calcElapsed(int, int);
 
@@ -35,7 +35,7 @@ thread tcpTimer(void)
 
     /* Setup timer event delta queue */
     bzero(tcptimertab, sizeof(struct tcpEvent) * TCP_NEVENTS);
-    tcpmutex = semcreate(1);
+    tcpmutex = kmutexcreate("tcptimer");
     head = &tcptimertab[TCP_EVT_HEAD];
     head->used = TRUE;
     head->next = NULL;
@@ -52,7 +52,7 @@ thread tcpTimer(void)
     while (TRUE)
     {
 //              TCP_TRACE("Tick");
-        wait(tcpmutex);
+        kmutexlock(tcpmutex);
         while ((head->next != NULL) && (elapse > 0))
         {
             first = head->next;
@@ -73,20 +73,20 @@ thread tcpTimer(void)
                 head->next = first->next;
 
                 /* Release mutex in case triggered event needs it */
-                signal(tcpmutex);
+                kmutexunlock(tcpmutex);
 
                 /* Trigger event */
                 tcpTimerTrigger(type, tcbptr);
 
                 /* Reclaim mutex */
-                wait(tcpmutex);
+                kmutexlock(tcpmutex);
 
                 /* Obtain first event (which may have changed while 
                  * mutex was released) */
                 first = head->next;
             }
         }
-        signal(tcpmutex);
+        kmutexunlock(tcpmutex);
 
         ps = disable();
         elapse = calcElapsed(lastticks, lasttime);
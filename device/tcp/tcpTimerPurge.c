@@ -23,7 +23,7 @@ devcall tcpTimerPurge(struct tcb *tcbptr, uchar type)
     struct tcpEvent *cur = NULL;
     int result = SYSERR;
 
-    wait(tcpmutex);
+    kmutexlock(tcpmutex);
     prev = &tcptimertab[TCP_EVT_HEAD];
     cur = prev->next;
     while (cur != NULL)
@@ -45,7 +45,7 @@ devcall tcpTimerPurge(struct tcb *tcbptr, uchar type)
         prev = cur;
         cur = cur->next;
     }
-    signal(tcpmutex);
+    kmutexunlock(tcpmutex);
 
     return result;
 }
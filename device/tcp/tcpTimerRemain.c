@@ -21,19 +21,19 @@ int tcpTimerRemain(struct tcb *tcbptr, uchar type)
     struct tcpEvent *cur = NULL;
     int time = 0;
 
-    wait(tcpmutex);
+    kmutexlock(tcpmutex);
     cur = tcptimertab[TCP_EVT_HEAD].next;
     while (cur != NULL)
     {
         time += cur->remain;
         if ((cur->tcbptr == tcbptr) && (cur->type == type))
         {
-            signal(tcpmutex);
+            kmutexunlock(tcpmutex);
             return time;
         }
         cur = cur->next;
     }
-    signal(tcpmutex);
+    kmutexunlock(tcpmutex);
 
     return 0;
 }
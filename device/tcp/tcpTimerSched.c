@@ -32,12 +32,12 @@ devcall tcpTimerSched(int time, struct tcb *tcbptr, uchar type)
         return SYSERR;
     }
 
-    wait(tcpmutex);
+    kmutexlock(tcpmutex);
     /* Setup timer event */
     evt = allocEvent();
     if (SYSERR == evt)
     {
-        signal(tcpmutex);
+        kmutexunlock(tcpmutex);
         return SYSERR;
     }
     evtptr = &tcptimertab[evt];
@@ -61,7 +61,7 @@ devcall tcpTimerSched(int time, struct tcb *tcbptr, uchar type)
     {
         next->remain -= time;
     }
-    signal(tcpmutex);
+    kmutexunlock(tcpmutex);
 
     return OK;
 }
@@ -11,8 +11,22 @@
 #include <shell.h>
 #include <thread.h>
 #include <telnet.h>
+#include <workpool.h>
 
-thread telnetServerKiller(ushort, ushort);
+/**
+ * Devices the killer work of a telnet device closes.  One killer serves
+ * every connection a server accepts, until the killswitch is released.
+ */
+struct telnetKill
+{
+    bool busy;                  /**< killer work has been submitted     */
+    ushort telnetdev;           /**< telnet device to close             */
+    ushort tcpdev;              /**< TCP device of current connection   */
+};
+
+static struct telnetKill telnetkill[NTELNET];
+
+static int telnetServerKiller(void *);
 
 /**
  * @ingroup telnet
@@ -27,12 +41,14 @@ thread telnetServerKiller(ushort, ushort);
 thread telnetServer(int ethdev, int port, ushort telnetdev,
                     char *shellname)
 {
-    tid_typ tid, killtid;
+    tid_typ tid;
     ushort tcpdev;
     struct netif *interface;
     struct netaddr *host;
-    char thrname[24];
+    struct telnetKill *killer;
+    future work;
     uchar buf[6];
+    irqmask im;
 
     TELNET_TRACE("ethdev %d, port %d, telnet %d", ethdev, port,
                  telnetdev);
@@ -44,6 +60,7 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
         return SYSERR;
     }
     host = &(interface->ip);
+    killer = &telnetkill[devtab[telnetdev].minor];
 
     while (TRUE)
     {
@@ -55,14 +72,31 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
                     "telnet server failed to allocate TCP device\n");
             return SYSERR;
         }
-        sprintf(thrname, "telnetSvrKill_%d", (devtab[telnetdev].minor));
-        killtid = create((void *)telnetServerKiller, INITSTK, INITPRIO,
-                         thrname, 2, telnetdev, tcpdev);
-        ready(killtid, RESCHED_YES);
+
+        /* Point the killer at this connection, submitting it to the work
+         * pool unless it is still waiting from an earlier one.  */
+        im = disable();
+        killer->telnetdev = telnetdev;
+        killer->tcpdev = tcpdev;
+        if (!killer->busy)
+        {
+            work = workSubmit(telnetServerKiller, killer);
+            if (SYSERR == work)
+            {
+                restore(im);
+                close(tcpdev);
+                close(telnetdev);
+                fprintf(stderr,
+                        "telnet server failed to start its killer\n");
+                return SYSERR;
+            }
+            workDetach(work);
+            killer->busy = TRUE;
+        }
+        restore(im);
 
         if (open(tcpdev, host, NULL, port, NULL, TCP_PASSIVE) < 0)
         {
-            kill(killtid);
             close(tcpdev);
             close(telnetdev);
             fprintf(stderr,
@@ -73,7 +107,6 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
 
         if (SYSERR == open(telnetdev, tcpdev))
         {
-            kill(killtid);
             close(tcpdev);
             close(telnetdev);
             fprintf(stderr,
@@ -105,7 +138,6 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
         {
             close(tcpdev);
             close(telnetdev);
-            kill(killtid);
             return SYSERR;
         }
         /* Clear any pending messages */
@@ -123,12 +155,10 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
         if (SYSERR == close(tcpdev))
         {
             close(telnetdev);
-            kill(killtid);
             return SYSERR;
         }
         if (SYSERR == close(telnetdev))
         {
-            kill(killtid);
             return SYSERR;
         }
     }
@@ -137,18 +167,20 @@ thread telnetServer(int ethdev, int port, ushort telnetdev,
 }
 
 /**
- * @ingroup telnet
- *
- * Kills telnet server that was spawned 
- * @param telnetdev telnet device to close
- * @param tcpdev tcp device to close
- * @return thread return status
+ * Kills telnet server that was spawned.  This runs in the work pool and
+ * closes the devices of whichever connection the server has open when the
+ * killswitch is released.
+ * @param arg struct telnetKill of the server's telnet device
+ * @return OK
  */
-thread telnetServerKiller(ushort telnetdev, ushort tcpdev)
+static int telnetServerKiller(void *arg)
 {
+    struct telnetKill *killer = arg;
+    ushort telnetdev, tcpdev;
     int minor, sem;
+    irqmask im;
 
-    minor = devtab[telnetdev].minor;
+    minor = devtab[killer->telnetdev].minor;
     sem = telnettab[minor].killswitch;
 
     /* Wait on device close semaphore */
@@ -156,6 +188,12 @@ thread telnetServerKiller(ushort telnetdev, ushort tcpdev)
 
     TELNET_TRACE("Killing server");
 
+    im = disable();
+    telnetdev = killer->telnetdev;
+    tcpdev = killer->tcpdev;
+    killer->busy = FALSE;
+    restore(im);
+
     /* Close the tcp device */
     close(tcpdev);
 
@@ -11,7 +11,8 @@
 /**
  * @ingroup tty
  *
- * Write a buffer to a tty
+ * Write a buffer to a tty.  Output is cooked into chunks that are passed to
+ * the underlying device with one write each.
  * @param devptr TTY device table entry
  * @param buf buffer of characters to output
  * @param len size of the buffer
@@ -19,19 +20,56 @@
  */
 devcall ttyWrite(device *devptr, void *buf, uint len)
 {
+    struct tty *ttyptr = NULL;
+    device *phw = NULL;
+    uchar chunk[TTY_OCHUNK];
     uchar ch = 0;
     uint count = 0;
+    uint start, n;
     uchar *buffer = buf;
 
+    /* Setup and error check pointers to structures */
+    ttyptr = &ttytab[devptr->minor];
+    phw = ttyptr->phw;
+    if (NULL == phw)
+    {
+        return SYSERR;
+    }
+
     /* Write all characters in buffer */
     while (count < len)
     {
-        ch = *buffer++;
-        if (SYSERR == ttyPutc(devptr, ch))
+        /* Cook characters into the chunk, leaving room for a '\r' */
+        start = count;
+        n = 0;
+        while ((count < len) && (n < TTY_OCHUNK - 1))
+        {
+            ch = buffer[count++];
+            switch (ch)
+            {
+                /* Newline */
+            case '\n':
+                if (ttyptr->oflags & TTY_ONLCR)
+                {
+                    chunk[n++] = '\r';
+                }
+                break;
+                /* Carriage return */
+            case '\r':
+                if (ttyptr->oflags & TTY_OCRNL)
+                {
+                    ch = '\n';
+                }
+                break;
+            }
+            chunk[n++] = ch;
+        }
+
+        /* Write chunk to underlying device */
+        if ((*phw->write) (phw, chunk, n) != (int)n)
         {
-            return SYSERR;
+            return (start > 0) ? start : SYSERR;
         }
-        count++;
     }
 
     return count;
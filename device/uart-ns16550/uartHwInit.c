@@ -27,11 +27,44 @@ devcall uartHwInit(device *devptr)
     regptr->ier = UART_IER_ERBFI | UART_IER_ETBEI | UART_IER_ELSI;
 
     /* Enable UART FIFOs, clear and set interrupt trigger level       */
-    regptr->fcr = UART_FCR_EFIFO | UART_FCR_RRESET
-        | UART_FCR_TRESET | UART_FCR_TRIG2;
+    regptr->fcr = UART_FCR_EFIFO | UART_FCR_RRESET | UART_FCR_TRESET;
+    uartHwTrigger((void *)regptr, &uarttab[devptr->minor].rxtrig,
+                  &uarttab[devptr->minor].txtrig);
 
     /* Enable processor handling of UART interrupt requests */
     interruptVector[devptr->irq] = devptr->intr;
     enable_irq(devptr->irq);
     return OK;
 }
+
+void uartHwTrigger(void *csr, uchar *rxtrig, uchar *txtrig)
+{
+    volatile struct ns16550_uart_csreg *regptr = csr;
+    uchar fcr;
+
+    /* The receive FIFO can interrupt at 1, 4, 8 or 14 bytes.  */
+    if (*rxtrig >= 14)
+    {
+        *rxtrig = 14;
+        fcr = UART_FCR_TRIG3;
+    }
+    else if (*rxtrig >= 8)
+    {
+        *rxtrig = 8;
+        fcr = UART_FCR_TRIG2;
+    }
+    else if (*rxtrig >= 4)
+    {
+        *rxtrig = 4;
+        fcr = UART_FCR_TRIG1;
+    }
+    else
+    {
+        *rxtrig = 1;
+        fcr = UART_FCR_TRIG0;
+    }
+    regptr->fcr = UART_FCR_EFIFO | fcr;
+
+    /* The transmitter always interrupts once its FIFO is empty.  */
+    *txtrig = 0;
+}
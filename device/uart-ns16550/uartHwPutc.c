@@ -12,3 +12,20 @@ void uartHwPutc(void *csr, uchar c)
 
     regptr->thr = c;
 }
+
+uint uartHwFill(void *csr, const uchar *buf, uint len)
+{
+    volatile struct ns16550_uart_csreg *regptr = csr;
+    uint count;
+
+    /* The FIFO can only be known to have room once it has emptied.  */
+    if (!(regptr->lsr & UART_LSR_THRE))
+    {
+        return 0;
+    }
+    for (count = 0; (count < len) && (count < UART_FIFO_LEN); count++)
+    {
+        regptr->thr = buf[count];
+    }
+    return count;
+}
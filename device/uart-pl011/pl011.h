@@ -141,7 +141,7 @@ struct pl011_uart_csreg
 #define PL011_ICR_CTSMIC (1<<1)  //CTS interrupt clear
 #define PL011_ICR_RIMIC  (1<<0)  //RI interrupt clear
 
-#define PL011_FIFO_LEN   8       /**< During testing on a Raspberry Pi, I could only send 8. */
+#define PL011_FIFO_LEN   16      /**< Depth of the transmit and receive FIFOs */
 
 #define PL011_BAUD_INT(x) (3000000 / (16 * (x)))
 #define PL011_BAUD_FRAC(x) (int)((((3000000.0 / (16.0 * (x)))-PL011_BAUD_INT(x))*64.0)+0.5) //9600 baud may be slightly off with this calcualtion
@@ -102,23 +102,19 @@ devcall uartHwInit(device *devptr)
     regptr->lcrh = PL011_LCRH_WLEN_8BIT;
 
     /* Allow the UART to generate interrupts only when receiving or
-     * transmitting.  */
-    regptr->imsc = PL011_IMSC_RXIM | PL011_IMSC_TXIM;
-
-    /* We have decided that we are going to leave FIFOs off for now.  Since the
-     * FIFOs are of size 16 and the lowest trigger level you can set for the
-     * receive FIFO is 1/8, the first interrupt isn't triggered until there are
-     * at least two bytes in the receive FIFO.  We want an interrupt as soon as
-     * a byte arrives */
-#if 0
+     * transmitting.  The receive timeout interrupt delivers bytes that sit in
+     * the receive FIFO below the trigger level once the line goes quiet, so
+     * a lone keystroke is not held back.  */
+    regptr->imsc = PL011_IMSC_RXIM | PL011_IMSC_TXIM | PL011_IMSC_RTIM;
+
     /* Enable UART FIFOs. */
     regptr->lcrh |= PL011_LCRH_FEN;
 
     /* Set the interrupt FIFO level select register.  This configures the amount
      * that the receive or transmit FIFOs can fill up before an interrupt is
      * generated.  */
-    regptr->ifls = PL011_IFLS_RXIFLSEL_SEVENEIGHTHS | PL011_IFLS_TXIFLSEL_EIGHTH;
-#endif
+    uartHwTrigger((void *)regptr, &uarttab[devptr->minor].rxtrig,
+                  &uarttab[devptr->minor].txtrig);
 
     /* Enable the UART, with both the receive and transmit functionality, by
      * writing to its control register.  */
@@ -130,3 +126,32 @@ devcall uartHwInit(device *devptr)
     enable_irq(devptr->irq);
     return OK;
 }
+
+/* FIFO levels selectable in the IFLS register, in eighths of the FIFO */
+static const uchar pl011_levels[] = { 1, 2, 4, 6, 7 };
+
+/* Round a trigger level down to a selectable one and return its encoding */
+static uint pl011_level(uchar *trig)
+{
+    uint i;
+
+    for (i = sizeof(pl011_levels) - 1; i > 0; i--)
+    {
+        if (*trig >= pl011_levels[i] * PL011_FIFO_LEN / 8)
+        {
+            break;
+        }
+    }
+    *trig = pl011_levels[i] * PL011_FIFO_LEN / 8;
+    return i;
+}
+
+void uartHwTrigger(void *csr, uchar *rxtrig, uchar *txtrig)
+{
+    volatile struct pl011_uart_csreg *regptr = csr;
+    uint rx, tx;
+
+    rx = pl011_level(rxtrig);
+    tx = pl011_level(txtrig);
+    regptr->ifls = (rx << 3) | tx;
+}
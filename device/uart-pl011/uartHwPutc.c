@@ -12,3 +12,15 @@ void uartHwPutc(void *csr, uchar c)
 
     regptr->dr = c;
 }
+
+uint uartHwFill(void *csr, const uchar *buf, uint len)
+{
+    volatile struct pl011_uart_csreg *regptr = csr;
+    uint count;
+
+    for (count = 0; (count < len) && !(regptr->fr & PL011_FR_TXFF); count++)
+    {
+        regptr->dr = buf[count];
+    }
+    return count;
+}
@@ -63,10 +63,7 @@ interrupt uartInterrupt(void)
              * the UART until either there are no bytes remaining or there is no
              * space remaining in the transmit FIFO.  (If FIFOs are disabled,
              * the Tx holding register acts like a FIFO of size 1, so the code
-             * still works.)  Otherwise, the UART is now idle, so set the
-             * "oidle" flag, which will allow the next call to uartWrite() to
-             * start transmitting again by writing a byte directly to the
-             * hardware.  */
+             * still works.)  */
             if (uartptr->ocount > 0)
             {
                 count = 0;
@@ -86,18 +83,25 @@ interrupt uartInterrupt(void)
                 uartptr->cout += count;
                 signaln(uartptr->osema, count);
             }
-            else
+
+            /* The transmit interrupt fires only when the FIFO drains down
+             * through the trigger level.  If the output buffer is now empty,
+             * the FIFO may not be filled past that level again, so treat the
+             * UART as idle; uartWrite() then fills the FIFO directly, as far
+             * as it has room.  */
+            if (0 == uartptr->ocount)
             {
                 uartptr->oidle = TRUE;
             }
         }
-        if (mis & PL011_MIS_RXMIS)
+        if (mis & (PL011_MIS_RXMIS | PL011_MIS_RTMIS))
         {
             /* Receive interrupt is asserted.  If FIFOs are enabled, this
              * happens when the amount of data in the receive FIFO is greater
-             * than or equal to the programmed trigger level.  If FIFOs are
-             * disabled, this happens when the Rx holding register was filled
-             * with one byte.  */
+             * than or equal to the programmed trigger level, or when data has
+             * sat below that level for 32 bit periods (receive timeout).  If
+             * FIFOs are disabled, this happens when the Rx holding register
+             * was filled with one byte.  */
 
             /* Increment number of receive interrupts received on this UART.  */
             uartptr->iirq++;
@@ -108,7 +112,7 @@ interrupt uartInterrupt(void)
             /* Read bytes from the receive FIFO until it is empty again.  (If
              * FIFOs are disabled, the Rx holding register acts as a FIFO of
              * size 1, so the code still works.)  */
-            do
+            while (!(regptr->fr & PL011_FR_RXFE))
             {
                 /* Get a byte from the UART's receive FIFO.  */
                 c = regptr->dr;
@@ -127,16 +131,20 @@ interrupt uartInterrupt(void)
                      * ignore it and increment the overrun count.  */
                     uartptr->ovrrn++;
                 }
-            } while (!(regptr->fr & PL011_FR_RXFE));
-            /* The receive interrupt will have been automatically cleared
+            }
+            /* The receive interrupts will have been automatically cleared
              * because we read bytes from the receive FIFO until it became
-             * empty.  */
+             * empty; clear the timeout explicitly in case it raced.  */
+            regptr->icr = PL011_ICR_RTIC;
 
             /* Increment cin by the number of bytes successfully buffered and
              * signal up to that many threads that are currently waiting in
              * uartRead() for buffered data to become available.  */
             uartptr->cin += count;
-            signaln(uartptr->isema, count);
+            if (count > 0)
+            {
+                signaln(uartptr->isema, count);
+            }
         }
     }
 
@@ -30,9 +30,42 @@ devcall uartHwInit(device *devptr)
 
     /* Enable UART hardware FIFOs, clear contents and set interrupt trigger level */
     outb((ulong)pucsr+UART_FCR,
-         UART_FCR_EFIFO | UART_FCR_RRESET | UART_FCR_TRESET | UART_FCR_TRIG2);
+         UART_FCR_EFIFO | UART_FCR_RRESET | UART_FCR_TRESET);
+    uartHwTrigger(pucsr, &uarttab[devptr->minor].rxtrig,
+                  &uarttab[devptr->minor].txtrig);
 
     set_handler(IRQBASE+devptr->irq, devptr->intr);
 
     return OK;
 }
+
+void uartHwTrigger(void *csr, uchar *rxtrig, uchar *txtrig)
+{
+    uchar fcr;
+
+    /* The receive FIFO can interrupt at 1, 4, 8 or 14 bytes.  */
+    if (*rxtrig >= 14)
+    {
+        *rxtrig = 14;
+        fcr = UART_FCR_TRIG3;
+    }
+    else if (*rxtrig >= 8)
+    {
+        *rxtrig = 8;
+        fcr = UART_FCR_TRIG2;
+    }
+    else if (*rxtrig >= 4)
+    {
+        *rxtrig = 4;
+        fcr = UART_FCR_TRIG1;
+    }
+    else
+    {
+        *rxtrig = 1;
+        fcr = UART_FCR_TRIG0;
+    }
+    outb((ulong)csr + UART_FCR, UART_FCR_EFIFO | fcr);
+
+    /* The transmitter always interrupts once its FIFO is empty.  */
+    *txtrig = 0;
+}
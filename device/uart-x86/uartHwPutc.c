@@ -10,3 +10,19 @@ void uartHwPutc(void *csr, uchar c)
 {
     outb((ulong)csr + UART_DATA, c);
 }
+
+uint uartHwFill(void *csr, const uchar *buf, uint len)
+{
+    uint count;
+
+    /* The FIFO can only be known to have room once it has emptied.  */
+    if (!(inb((ulong)csr + UART_LSR) & UART_LSR_THRE))
+    {
+        return 0;
+    }
+    for (count = 0; (count < len) && (count < UART_FIFO_LEN); count++)
+    {
+        outb((ulong)csr + UART_DATA, buf[count]);
+    }
+    return count;
+}
@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <uart.h>
 #include <device.h>
+#include <interrupt.h>
 
 /**
  * @ingroup uartgeneric
@@ -25,6 +26,7 @@ devcall uartControl(device *devptr, int func, long arg1, long arg2)
 {
     struct uart *uartptr;
     char old;
+    irqmask im;
 
     uartptr = &uarttab[devptr->minor];
 
@@ -71,6 +73,35 @@ devcall uartControl(device *devptr, int func, long arg1, long arg2)
     case UART_CTRL_OUTPUT_IDLE:
         return uartptr->oidle;
 
+        /* Set FIFO trigger levels: arg1 = level in bytes */
+        /* return = level the hardware was set to         */
+    case UART_CTRL_SET_RXTRIG:
+    case UART_CTRL_SET_TXTRIG:
+        if (NULL == uartptr->csr)
+        {
+            return SYSERR;
+        }
+        im = disable();
+        if (UART_CTRL_SET_RXTRIG == func)
+        {
+            uartptr->rxtrig = arg1;
+        }
+        else
+        {
+            uartptr->txtrig = arg1;
+        }
+        uartHwTrigger(uartptr->csr, &uartptr->rxtrig, &uartptr->txtrig);
+        restore(im);
+        return (UART_CTRL_SET_RXTRIG == func) ?
+            uartptr->rxtrig : uartptr->txtrig;
+
+        /* Get FIFO trigger levels: return = level in bytes */
+    case UART_CTRL_GET_RXTRIG:
+        return uartptr->rxtrig;
+
+    case UART_CTRL_GET_TXTRIG:
+        return uartptr->txtrig;
+
     }
     return SYSERR;
 }
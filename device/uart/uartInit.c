@@ -38,6 +38,10 @@ devcall uartInit(device *devptr)
     uartptr->iirq = 0;
     uartptr->oirq = 0;
 
+    /* Default FIFO trigger levels, programmed by uartHwInit().  */
+    uartptr->rxtrig = UART_RXTRIG;
+    uartptr->txtrig = UART_TXTRIG;
+
     /* Initialize the input buffer, including a semaphore for threads to wait
      * on.  */
     uartptr->isema = semcreate(0);
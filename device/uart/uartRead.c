@@ -4,6 +4,7 @@
 
 /* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
+#include <string.h>
 #include <uart.h>
 #include <interrupt.h>
 
@@ -29,8 +30,8 @@ devcall uartRead(device *devptr, void *buf, uint len)
 {
     irqmask im;
     struct uart *uartptr;
-    uint count;
-    uchar c;
+    uint count, n;
+    int taken;
 
     /* Disable interrupts and get a pointer to the UART structure.  */
     im = disable();
@@ -44,29 +45,42 @@ devcall uartRead(device *devptr, void *buf, uint len)
     }
 
     /* Attempt to read each byte requested.  */
-    for (count = 0; count < len; count++)
+    count = 0;
+    while (count < len)
     {
-        /* If the UART is in non-blocking mode, ensure there is a byte available
-         * in the input buffer from the lower half (interrupt handler).  If not,
-         * return early with a short count.  */
-        if ((uartptr->iflags & UART_IFLAG_NOBLOCK) && uartptr->icount == 0)
+        /* Claim as many bytes from the input buffer from the lower half
+         * (interrupt handler) as are available, up to the bytes remaining.
+         * If there are none, wait for one unless the UART is in non-blocking
+         * mode, in which case return early with a short count.  */
+        taken = semtake(uartptr->isema, len - count);
+        if (taken <= 0)
         {
-            break;
+            if (uartptr->iflags & UART_IFLAG_NOBLOCK)
+            {
+                break;
+            }
+            wait(uartptr->isema);
+            taken = 1 + semtake(uartptr->isema, len - count - 1);
         }
 
-        /* Wait for there to be at least one byte in the input buffer from the
-         * lower half (interrupt handler), then remove it.  */
-        wait(uartptr->isema);
-        c = uartptr->in[uartptr->istart];
-        ((uchar*)buf)[count] = c;
-        uartptr->icount--;
-        uartptr->istart = (uartptr->istart + 1) % UART_IBLEN;
+        /* Copy the bytes out of the ring buffer, in two pieces if it
+         * wraps.  */
+        n = UART_IBLEN - uartptr->istart;
+        if (n > (uint)taken)
+        {
+            n = taken;
+        }
+        memcpy((uchar *)buf + count, &uartptr->in[uartptr->istart], n);
+        memcpy((uchar *)buf + count + n, uartptr->in, taken - n);
+        uartptr->istart = (uartptr->istart + taken) % UART_IBLEN;
+        uartptr->icount -= taken;
 
-        /* If the UART is in echo mode, echo the byte back to the UART.  */
+        /* If the UART is in echo mode, echo the bytes back to the UART.  */
         if (uartptr->iflags & UART_IFLAG_ECHO)
         {
-            uartPutc(uartptr->dev, c);
+            uartWrite(uartptr->dev, (uchar *)buf + count, taken);
         }
+        count += taken;
     }
 
     /* Restore interrupts and return the number of bytes read.  */
@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <uart.h>
 
+static void uartRatio(const char *what, uint chars, uint irqs);
+
 /**
  * @ingroup uartgeneric
  *
@@ -35,6 +37,10 @@ void uartStat(ushort uartnum)
     printf("\t%8d Receiver Error Count\n", uartptr->lserr);
     printf("\t%8d Output IRQ Count\n", uartptr->oirq);
     printf("\t%8d Input IRQ Count\n", uartptr->iirq);
+    uartRatio("Output", uartptr->cout, uartptr->oirq);
+    uartRatio("Input", uartptr->cin, uartptr->iirq);
+    printf("\t%8d Input FIFO Trigger Level\n", uartptr->rxtrig);
+    printf("\t%8d Output FIFO Trigger Level\n", uartptr->txtrig);
 
     if (NULL != uartptr->csr)
     {
@@ -43,3 +49,17 @@ void uartStat(ushort uartnum)
 
     printf("\n");
 }
+
+/*
+ * Print the average number of characters moved per interrupt, to two
+ * decimal places, without overflowing on large counts.
+ */
+static void uartRatio(const char *what, uint chars, uint irqs)
+{
+    if (0 == irqs)
+    {
+        return;
+    }
+    printf("\t%5u.%02u Characters per %s IRQ\n", chars / irqs,
+           ((chars % irqs) * 100) / irqs, what);
+}
@@ -6,6 +6,7 @@
 
 #include <uart.h>
 #include <interrupt.h>
+#include <string.h>
 
 /**
  * @ingroup uartgeneric
@@ -16,7 +17,9 @@
  * internal buffer and not yet actually written to the hardware.  The UART
  * driver's lower half (interrupt handler; see uartInterrupt()) is responsible
  * for actually writing the data to the hardware.  Exception: when the UART
- * transmitter is idle, uartWrite() can directly write one byte to the hardware.
+ * transmitter is idle, uartWrite() fills its FIFO directly.
+ * Data is copied into the internal buffer in chunks as large as the free
+ * space allows, rather than one byte at a time.
  *
  * @param devptr
  *      Pointer to the device table entry for a UART.
@@ -35,7 +38,8 @@ devcall uartWrite(device *devptr, const void *buf, uint len)
 {
     irqmask im;
     struct uart *uartptr;
-    uint count;
+    uint count, tail, n;
+    int taken;
 
     /* Disable interrupts and get a pointer to the UART structure and a pointer
      * to the UART's hardware registers.  */
@@ -50,35 +54,60 @@ devcall uartWrite(device *devptr, const void *buf, uint len)
     }
 
     /* Attempt to write each byte in the buffer.  */
-    for (count = 0; count < len; count++)
+    count = 0;
+    while (count < len)
     {
-        /* Next byte to write.  */
-        uchar ch = ((const uchar *)buf)[count];
-
-        /* If the UART transmitter hardware is idle, write the byte directly to
-         * the hardware.  Otherwise, put the byte in the output buffer for the
-         * lower half (interrupt handler).  This may block if there is no space
-         * available in the output buffer.  */
+        /* If the UART transmitter hardware is idle, fill its FIFO directly.
+         * If anything is left over, the transmitter is busy and will
+         * interrupt for more, so the rest goes to the output buffer.  */
         if (uartptr->oidle)
         {
-            uartHwPutc(uartptr->csr, ch);
-            uartptr->oidle = FALSE;
-            uartptr->cout++;
+            n = uartHwFill(uartptr->csr, (const uchar *)buf + count,
+                           len - count);
+            uartptr->cout += n;
+            count += n;
+            if (count < len)
+            {
+                uartptr->oidle = FALSE;
+            }
+            continue;
         }
-        else
+
+        /* Otherwise claim as much space in the output buffer for the lower
+         * half (interrupt handler) as is free, up to the bytes remaining.  If
+         * there is none, block for one byte of space unless the UART is in
+         * non-blocking mode, in which case return early with a short count. */
+        taken = semtake(uartptr->osema, len - count);
+        if (taken <= 0)
         {
-            /* If the UART is in non-blocking mode, ensure there is space for a
-             * byte in the output buffer for the lower half (interrupt handler).
-             * If not, return early with a short count.  */
-            if ((uartptr->oflags & UART_OFLAG_NOBLOCK) &&
-                uartptr->ocount == UART_OBLEN)
+            if (uartptr->oflags & UART_OFLAG_NOBLOCK)
             {
                 break;
             }
             wait(uartptr->osema);
-            uartptr->out[(uartptr->ostart + uartptr->ocount) % UART_OBLEN] = ch;
-            uartptr->ocount++;
+
+            /* If the output buffer drained while this thread waited, the
+             * transmitter may have gone idle; give back the space and write
+             * directly to the hardware instead.  */
+            if (uartptr->oidle)
+            {
+                signal(uartptr->osema);
+                continue;
+            }
+            taken = 1 + semtake(uartptr->osema, len - count - 1);
+        }
+
+        /* Copy the chunk into the ring buffer, in two pieces if it wraps.  */
+        tail = (uartptr->ostart + uartptr->ocount) % UART_OBLEN;
+        n = UART_OBLEN - tail;
+        if (n > (uint)taken)
+        {
+            n = taken;
         }
+        memcpy(&uartptr->out[tail], (const uchar *)buf + count, n);
+        memcpy(uartptr->out, (const uchar *)buf + count + n, taken - n);
+        uartptr->ocount += taken;
+        count += taken;
     }
 
     /* Restore interrupts and return the number of bytes written.  */
@@ -10,6 +10,9 @@
 #include <ipv4.h>
 #include <icmp.h>
 #include <udp.h>
+#ifdef NRTP
+#include <rtp.h>
+#endif
 
 /**
  * @ingroup udpinternal
@@ -27,6 +30,9 @@ syscall udpRecv(struct packet *pkt, const struct netaddr *src,
     struct udpPseudoHdr *pseudo;
     struct udp *udpptr;
     struct udpPkt *tpkt;
+#ifdef NRTP
+    struct rtp *rtpptr;
+#endif
 #ifdef TRACE_UDP
     char strA[20];
     char strB[20];
@@ -85,6 +91,21 @@ syscall udpRecv(struct packet *pkt, const struct netaddr *src,
         netFreebuf(pkt);
         return SYSERR;
     }
+
+#ifdef NRTP
+    /* A RTP device open on the UDP device takes the packet instead */
+    rtpptr = rtpDemux(udpptr);
+    if (NULL != rtpptr)
+    {
+        restore(im);
+        if (udpptr == rtpptr->rtcpptr)
+        {
+            return rtcpRecv(rtpptr, pkt);
+        }
+        return rtpRecv(rtpptr, pkt);
+    }
+#endif
+
     if (udpptr->icount >= UDP_MAX_PKTS)
     {
         UDP_TRACE("UDP buffer is full. Dropping UDP packet.");
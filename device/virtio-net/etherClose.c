@@ -0,0 +1,41 @@
+/**
+ * @file etherClose.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <bufpool.h>
+#include <ether.h>
+#include <interrupt.h>
+#include <semaphore.h>
+
+/* Implementation of etherClose() for virtio; see the documentation for this
+ * function in ether.h.  */
+devcall etherClose(device *devptr)
+{
+    struct ether *ethptr;
+    irqmask im;
+
+    im = disable();
+
+    ethptr = &ethertab[devptr->minor];
+    if (ethptr->state != ETH_STATE_UP)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    /* Resetting the device stops it using the rings and their buffers.  */
+    ethptr->state = ETH_STATE_DOWN;
+    virtioSetStatus(&virtiotab[devptr->minor], 0);
+
+    /* Drop frames nobody read; their buffers go with the pool.  */
+    semtake(ethptr->isema, ethptr->icount);
+    ethptr->icount = 0;
+
+    bfpfree(ethptr->inPool);
+    bfpfree(ethptr->outPool);
+    restore(im);
+
+    return OK;
+}
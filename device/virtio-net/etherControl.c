@@ -0,0 +1,71 @@
+/**
+ * @file etherControl.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <ether.h>
+#include <network.h>
+#include <string.h>
+
+/* Implementation of etherControl() for virtio; see the documentation for this
+ * function in ether.h.  */
+/**
+ * @details
+ *
+ * virtio-specific notes:  the legacy device has no way to change its MAC
+ * address or loop frames back, so only the driver's copy of the address
+ * changes.
+ */
+devcall etherControl(device *devptr, int req, long arg1, long arg2)
+{
+    struct netaddr *addr;
+    struct ether *ethptr;
+
+    ethptr = &ethertab[devptr->minor];
+    if (NULL == ethptr->csr)
+    {
+        return SYSERR;
+    }
+
+    switch (req)
+    {
+    /* Set MAC address.  */
+    case ETH_CTRL_SET_MAC:
+        memcpy(ethptr->devAddress, (uchar *)arg1, ETH_ADDR_LEN);
+        break;
+
+    /* Get MAC address.  */
+    case ETH_CTRL_GET_MAC:
+        memcpy((uchar *)arg1, ethptr->devAddress, ETH_ADDR_LEN);
+        break;
+
+    /* Get link header length. */
+    case NET_GET_LINKHDRLEN:
+        return ETH_HDR_LEN;
+
+    /* Get MTU. */
+    case NET_GET_MTU:
+        return ETH_MTU;
+
+    /* Get hardware address.  */
+    case NET_GET_HWADDR:
+        addr = (struct netaddr *)arg1;
+        addr->type = NETADDR_ETHERNET;
+        addr->len = ETH_ADDR_LEN;
+        return etherControl(devptr, ETH_CTRL_GET_MAC, (long)addr->addr, 0);
+
+    /* Get broadcast hardware address. */
+    case NET_GET_HWBRC:
+        addr = (struct netaddr *)arg1;
+        addr->type = NETADDR_ETHERNET;
+        addr->len = ETH_ADDR_LEN;
+        memset(addr->addr, 0xFF, ETH_ADDR_LEN);
+        break;
+
+    default:
+        return SYSERR;
+    }
+
+    return OK;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file etherInit.c
+ *
+ * Initialization for virtio network devices.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <ether.h>
+#include <memory.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Global table of Ethernet devices.  */
+struct ether ethertab[NETHER];
+
+/* virtio state of each Ethernet device.  */
+struct virtio virtiotab[NETHER];
+
+/* Implementation of etherInit() for virtio; see the documentation for this
+ * function in ether.h.  */
+/**
+ * @details
+ *
+ * virtio-specific notes:  this finds the device, reads its MAC address and
+ * allocates its rings, which are sized by the device.  The device itself is
+ * left reset until etherOpen().
+ */
+devcall etherInit(device *devptr)
+{
+    struct ether *ethptr;
+    struct virtio *vio;
+    uint i;
+
+    ethptr = &ethertab[devptr->minor];
+    bzero(ethptr, sizeof(struct ether));
+    ethptr->dev = devptr;
+    ethptr->phy = devptr;
+    ethptr->state = ETH_STATE_DOWN;
+    ethptr->mtu = ETH_MTU;
+    ethptr->addressLength = ETH_ADDR_LEN;
+    ethptr->rxOffset = VIRTIO_NET_HDR_LEN;
+    ethptr->isema = semcreate(0);
+    if (isbadsem(ethptr->isema))
+    {
+        goto err;
+    }
+
+    vio = &virtiotab[devptr->minor];
+    bzero(vio, sizeof(struct virtio));
+    if (SYSERR == virtioProbe(devptr, vio))
+    {
+        kprintf("eth%d: no virtio network device found\r\n", devptr->minor);
+        goto err_free_isema;
+    }
+    ethptr->csr = (void *)vio->base;
+
+    /* Reset the device and tell it a driver has found it.  */
+    virtioSetStatus(vio, 0);
+    virtioSetStatus(vio, VIRTIO_STAT_ACKNOWLEDGE);
+
+    /* Use the device's MAC address, or make up a locally administered one
+     * if it has none.  */
+    if (virtioGetFeatures(vio) & VIRTIO_NET_F_MAC)
+    {
+        for (i = 0; i < ETH_ADDR_LEN; i++)
+        {
+            ethptr->devAddress[i] = virtioConfigRead(vio, i);
+        }
+    }
+    else
+    {
+        ethptr->devAddress[0] = 0x02;
+        ethptr->devAddress[ETH_ADDR_LEN - 1] = devptr->minor;
+    }
+
+    /* Receive frames land after a virtio-net header in each buffer, and
+     * each frame uses a chain of two descriptors.  */
+    if (SYSERR == virtqueueAlloc(vio, &vio->rxq, VIRTIO_NET_RXQ)
+        || SYSERR == virtqueueAlloc(vio, &vio->txq, VIRTIO_NET_TXQ))
+    {
+        kprintf("eth%d: ring allocation error\r\n", devptr->minor);
+        goto err_fail;
+    }
+    ethptr->rxRingSize = vio->rxq.num / 2;
+    ethptr->txRingSize = vio->txq.num / 2;
+    ethptr->rxRing = (struct dmaDescriptor *)vio->rxq.desc;
+    ethptr->txRing = (struct dmaDescriptor *)vio->txq.desc;
+    ethptr->rxBufs = memget(ethptr->rxRingSize * sizeof(struct ethPktBuffer *));
+    ethptr->txBufs = memget(ethptr->txRingSize * sizeof(struct ethPktBuffer *));
+    if (SYSERR == (int)ethptr->rxBufs || SYSERR == (int)ethptr->txBufs)
+    {
+        goto err_fail;
+    }
+
+    virtioSetStatus(vio, 0);
+    return OK;
+
+err_fail:
+    virtioSetStatus(vio, VIRTIO_STAT_FAILED);
+err_free_isema:
+    semfree(ethptr->isema);
+err:
+    return SYSERR;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file etherInterrupt.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <bufpool.h>
+#include <ether.h>
+#include <thread.h>
+
+static void rxPackets(struct ether *ethptr, struct virtio *vio);
+
+/**
+ * @ingroup etherspecific
+ *
+ * Handle an interrupt from the virtio network devices, which may share a
+ * line.  Only the receive ring interrupts.
+ */
+interrupt etherInterrupt(void)
+{
+    struct ether *ethptr;
+    struct virtio *vio;
+    uint i;
+
+    resdefer = 1;               /* defer rescheduling */
+
+    for (i = 0; i < NETHER; i++)
+    {
+        ethptr = &ethertab[i];
+        vio = &virtiotab[i];
+        if (ETH_STATE_UP != ethptr->state || 0 == vio->base)
+        {
+            continue;
+        }
+
+        ethptr->interruptStatus = virtioInterruptAck(vio);
+        if (ethptr->interruptStatus & VIRTIO_ISR_QUEUE)
+        {
+            ethptr->rxirq++;
+            rxPackets(ethptr, vio);
+        }
+    }
+
+    if (--resdefer > 0)
+    {
+        resdefer = 0;
+        resched();
+    }
+}
+
+/*
+ * Move every received frame to the input queue and give the ring a fresh
+ * buffer for it, then offer all of them to the device with one kick.  The
+ * used event asks for the next interrupt only after the last frame seen
+ * here, so frames arriving while this runs do not interrupt again.
+ */
+static void rxPackets(struct ether *ethptr, struct virtio *vio)
+{
+    struct virtqueue *vq = &vio->rxq;
+    volatile struct vringUsedElem *elem;
+    struct ethPktBuffer *pkt;
+    uint slot;
+
+    do
+    {
+        while (vq->lastUsed != vq->used->idx)
+        {
+            virtioBarrier();
+            elem = &vq->used->ring[vq->lastUsed & (vq->num - 1)];
+            slot = elem->id / 2;
+            pkt = ethptr->rxBufs[slot];
+
+            if (elem->len <= VIRTIO_NET_HDR_LEN)
+            {
+                ethptr->rxErrors++;
+            }
+            else if (ethptr->icount < ETH_IBLEN)
+            {
+                /* The pool holds a buffer for every queued frame plus a
+                 * full ring, so this does not block.  */
+                pkt->length = elem->len - VIRTIO_NET_HDR_LEN;
+                ethptr->in[(ethptr->istart + ethptr->icount) % ETH_IBLEN] =
+                    pkt;
+                ethptr->icount++;
+                signaln(ethptr->isema, 1);
+
+                pkt = bufget(ethptr->inPool);
+                pkt->buf = (uchar *)(pkt + 1);
+                pkt->data = pkt->buf + ethptr->rxOffset;
+                ethptr->rxBufs[slot] = pkt;
+                vq->desc[2 * slot].address = (ulong)pkt->buf;
+                vq->desc[2 * slot + 1].address = (ulong)pkt->data;
+            }
+            else
+            {
+                ethptr->ovrrun++;
+            }
+
+            virtqueuePost(vq, 2 * slot);
+            vq->lastUsed++;
+            ethptr->rxHead++;
+            ethptr->rxTail++;
+        }
+
+        *vq->usedEvent = vq->lastUsed;
+        virtioBarrier();
+    } while (vq->lastUsed != vq->used->idx);
+
+    virtqueueKick(vio, vq);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file etherOpen.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <bufpool.h>
+#include <ether.h>
+#include <interrupt.h>
+
+static void virtioInitChains(struct virtqueue *vq, uint16_t flags);
+
+/* Implementation of etherOpen() for virtio; see the documentation for this
+ * function in ether.h.  */
+/**
+ * @details
+ *
+ * virtio-specific notes:  every receive chain is filled with a buffer and
+ * offered to the device with a single notification.  Transmit completions
+ * do not interrupt; etherWrite() reclaims sent buffers as it goes.
+ */
+devcall etherOpen(device *devptr)
+{
+    struct ether *ethptr;
+    struct virtio *vio;
+    struct ethPktBuffer *pkt;
+    irqmask im;
+    uint i;
+    int retval = SYSERR;
+
+    im = disable();
+
+    ethptr = &ethertab[devptr->minor];
+    vio = &virtiotab[devptr->minor];
+    if (ethptr->state != ETH_STATE_DOWN)
+    {
+        goto out_restore;
+    }
+
+    ethptr->outPool = bfpalloc(VIRTIO_NET_BUF_SIZE, ethptr->txRingSize);
+    if (SYSERR == ethptr->outPool)
+    {
+        goto out_restore;
+    }
+
+    /* Enough receive buffers to refill the whole ring while the input
+     * queue is full.  */
+    ethptr->inPool = bfpalloc(VIRTIO_NET_BUF_SIZE,
+                              ethptr->rxRingSize + ETH_IBLEN);
+    if (SYSERR == ethptr->inPool)
+    {
+        goto out_free_out_pool;
+    }
+
+    /* Bring the device up from reset and agree on features.  */
+    virtioSetStatus(vio, 0);
+    virtioSetStatus(vio, VIRTIO_STAT_ACKNOWLEDGE);
+    virtioSetStatus(vio, VIRTIO_STAT_ACKNOWLEDGE | VIRTIO_STAT_DRIVER);
+    vio->features = virtioGetFeatures(vio)
+        & (VIRTIO_NET_F_MAC | VIRTIO_RING_F_EVENT_IDX);
+    virtioSetFeatures(vio, vio->features);
+
+    virtqueueStart(vio, &vio->rxq);
+    virtqueueStart(vio, &vio->txq);
+    virtioInitChains(&vio->rxq, VRING_DESC_F_WRITE);
+    virtioInitChains(&vio->txq, 0);
+
+    /* Never interrupt for sent frames.  Without event indexes the flag
+     * does it; with them the used event is parked half the index space
+     * away and kept there by etherWrite().  */
+    vio->txq.avail->flags = VRING_AVAIL_F_NO_INTERRUPT;
+    *vio->txq.usedEvent = 0x8000;
+
+    ethptr->rxHead = 0;
+    ethptr->rxTail = 0;
+    ethptr->txHead = 0;
+    ethptr->txTail = 0;
+    ethptr->istart = 0;
+    ethptr->icount = 0;
+
+    for (i = 0; i < ethptr->rxRingSize; i++)
+    {
+        pkt = bufget(ethptr->inPool);
+        pkt->buf = (uchar *)(pkt + 1);
+        pkt->data = pkt->buf + ethptr->rxOffset;
+        ethptr->rxBufs[i] = pkt;
+        vio->rxq.desc[2 * i].address = (ulong)pkt->buf;
+        vio->rxq.desc[2 * i + 1].address = (ulong)pkt->data;
+        virtqueuePost(&vio->rxq, 2 * i);
+        ethptr->rxTail++;
+    }
+    for (i = 0; i < ethptr->txRingSize; i++)
+    {
+        ethptr->txBufs[i] = NULL;
+    }
+
+    virtioSetStatus(vio, VIRTIO_STAT_ACKNOWLEDGE | VIRTIO_STAT_DRIVER
+                    | VIRTIO_STAT_DRIVER_OK);
+    virtqueueKick(vio, &vio->rxq);
+
+    ethptr->state = ETH_STATE_UP;
+    retval = OK;
+    goto out_restore;
+
+out_free_out_pool:
+    bfpfree(ethptr->outPool);
+out_restore:
+    restore(im);
+    return retval;
+}
+
+/*
+ * Link descriptors 2n and 2n + 1 of a ring into one chain per frame: the
+ * first holds the virtio-net header and the second the frame.  Only the
+ * addresses change afterwards.
+ */
+static void virtioInitChains(struct virtqueue *vq, uint16_t flags)
+{
+    uint i;
+
+    for (i = 0; i < vq->num; i += 2)
+    {
+        vq->desc[i].length = VIRTIO_NET_HDR_LEN;
+        vq->desc[i].flags = flags | VRING_DESC_F_NEXT;
+        vq->desc[i].next = i + 1;
+        vq->desc[i + 1].length = ETH_MAX_PKT_LEN;
+        vq->desc[i + 1].flags = flags;
+        vq->desc[i + 1].next = 0;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file etherRead.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <bufpool.h>
+#include <ether.h>
+#include <interrupt.h>
+#include <string.h>
+
+/* Implementation of etherRead() for virtio; see the documentation for this
+ * function in ether.h.  */
+devcall etherRead(device *devptr, void *buf, uint len)
+{
+    irqmask im;
+    struct ether *ethptr;
+    struct ethPktBuffer *pkt;
+
+    im = disable();
+
+    /* Make sure device is actually up.  */
+    ethptr = &ethertab[devptr->minor];
+    if (ethptr->state != ETH_STATE_UP)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    /* Wait for received packet to be available in the ethptr->in circular
+     * queue.  */
+    wait(ethptr->isema);
+
+    /* Remove the received packet from the circular queue.  */
+    pkt = ethptr->in[ethptr->istart];
+    ethptr->istart = (ethptr->istart + 1) % ETH_IBLEN;
+    ethptr->icount--;
+
+    /* The receive interrupt counts on a free buffer for every free slot in
+     * the input queue, so keep interrupts off until this one is back in the
+     * pool.  */
+    if (pkt->length < len)
+    {
+        len = pkt->length;
+    }
+    memcpy(buf, pkt->data, len);
+
+    buffree(pkt);
+    restore(im);
+    return len;
+}
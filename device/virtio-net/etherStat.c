@@ -0,0 +1,59 @@
+/**
+ * @file     etherStat.c
+ */
+/* Embedded Xinu, Copyright (C) 2008, 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <ether.h>
+#include <stdio.h>
+
+void etherStat(ushort minor)
+{
+    const struct ether *ethptr = &ethertab[minor];
+    const struct virtio *vio = &virtiotab[minor];
+
+    printf("eth%u:\n", minor);
+    printf("  MAC Address           %02X:%02X:%02X:%02X:%02X:%02X\n",
+           ethptr->devAddress[0], ethptr->devAddress[1],
+           ethptr->devAddress[2], ethptr->devAddress[3],
+           ethptr->devAddress[4], ethptr->devAddress[5]);
+
+    printf("  MTU                   %u\n", ethptr->mtu);
+
+    printf("  Device state");
+    switch (ethptr->state)
+    {
+        case ETH_STATE_FREE:
+            printf("          FREE\n");
+            break;
+        case ETH_STATE_UP:
+            printf("          UP\n");
+            break;
+        case ETH_STATE_DOWN:
+            printf("          DOWN\n");
+            break;
+    }
+
+    printf("  virtio base           0x%08lX irq %u\n", vio->base, vio->irq);
+    printf("  Event indexes         %s\n",
+           (vio->features & VIRTIO_RING_F_EVENT_IDX) ? "yes" : "no");
+
+    printf("  Rx ring frames        %lu\n",  ethptr->rxRingSize);
+    printf("  Rx frames             %lu\n",  ethptr->rxHead);
+    printf("  Rx interrupts         %lu\n",  ethptr->rxirq);
+    printf("  Rx kicks              %lu\n",  vio->rxq.kicks);
+    printf("  Rx packets in queue   %u\n",   ethptr->icount);
+    printf("  Rx errors             %lu\n",  ethptr->rxErrors);
+    printf("  Rx overruns           %u\n",   ethptr->ovrrun);
+
+    printf("  Tx ring frames        %lu\n",  ethptr->txRingSize);
+    printf("  Tx frames             %lu\n",  ethptr->txTail);
+    printf("  Tx in flight          %lu\n",  ethptr->txTail - ethptr->txHead);
+    printf("  Tx kicks              %lu\n",  vio->txq.kicks);
+    printf("  Tx ring full          %lu\n",  ethptr->errors);
+}
+
+void etherThroughput(ushort minor)
+{
+    printf("Throughput monitoring not implemented for virtio Ethernet\n");
+}
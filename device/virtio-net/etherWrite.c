@@ -0,0 +1,92 @@
+/**
+ * @file etherWrite.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <bufpool.h>
+#include <ether.h>
+#include <interrupt.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void txReclaim(struct ether *ethptr, struct virtqueue *vq);
+
+/* Implementation of etherWrite() for virtio; see the documentation for this
+ * function in ether.h.  */
+/**
+ * @details
+ *
+ * virtio-specific notes:  the device is only notified when it has stopped
+ * looking at the transmit ring, so back-to-back writes share a notification.
+ */
+devcall etherWrite(device *devptr, const void *buf, uint len)
+{
+    struct ether *ethptr;
+    struct virtio *vio;
+    struct ethPktBuffer *pkt;
+    irqmask im;
+    uint slot;
+
+    ethptr = &ethertab[devptr->minor];
+    vio = &virtiotab[devptr->minor];
+
+    im = disable();
+    if (ethptr->state != ETH_STATE_UP
+        || len < ETH_HEADER_LEN || len > ETH_HDR_LEN + ETH_MTU)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    /* The device may finish chains out of order, so the next slot can
+     * still be busy even when the ring is not full.  */
+    txReclaim(ethptr, &vio->txq);
+    slot = ethptr->txTail % ethptr->txRingSize;
+    if (NULL != ethptr->txBufs[slot])
+    {
+        ethptr->errors++;
+        restore(im);
+        return SYSERR;
+    }
+
+    /* A chain is free, so is its buffer.  */
+    pkt = bufget(ethptr->outPool);
+    pkt->buf = (uchar *)(pkt + 1);
+    pkt->data = pkt->buf + VIRTIO_NET_HDR_LEN;
+    pkt->length = len;
+    bzero(pkt->buf, VIRTIO_NET_HDR_LEN);
+    memcpy(pkt->data, buf, len);
+
+    ethptr->txBufs[slot] = pkt;
+    vio->txq.desc[2 * slot].address = (ulong)pkt->buf;
+    vio->txq.desc[2 * slot + 1].address = (ulong)pkt->data;
+    vio->txq.desc[2 * slot + 1].length = len;
+    virtqueuePost(&vio->txq, 2 * slot);
+    ethptr->txTail++;
+
+    virtqueueKick(vio, &vio->txq);
+    restore(im);
+
+    return len;
+}
+
+/*
+ * Free the buffers of frames the device has sent, and keep the transmit used
+ * event out of reach so sending never interrupts.
+ */
+static void txReclaim(struct ether *ethptr, struct virtqueue *vq)
+{
+    uint slot;
+
+    while (vq->lastUsed != vq->used->idx)
+    {
+        virtioBarrier();
+        slot = vq->used->ring[vq->lastUsed & (vq->num - 1)].id / 2;
+        buffree(ethptr->txBufs[slot]);
+        ethptr->txBufs[slot] = NULL;
+        vq->lastUsed++;
+        ethptr->txHead++;
+    }
+    *vq->usedEvent = vq->lastUsed + 0x8000;
+}
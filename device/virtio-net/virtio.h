@@ -0,0 +1,206 @@
+/**
+ * @file virtio.h
+ *
+ * Definitions for the legacy (version 0.9.5) virtio network device, as
+ * emulated by QEMU and other hypervisors.  The device is reached through
+ * legacy PCI I/O space when the platform has a PCI bus and through virtio-mmio
+ * registers otherwise.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _VIRTIO_H_
+#define _VIRTIO_H_
+
+#include <stddef.h>
+#include <conf.h>
+#include <device.h>
+#include <ether.h>
+#include <stdint.h>
+
+/* Device identification */
+#define VIRTIO_PCI_VENDOR       0x1AF4
+#define VIRTIO_PCI_NET          0x1000 /**< transitional network device  */
+#define VIRTIO_MMIO_MAGIC       0x74726976 /**< "virt" little endian     */
+#define VIRTIO_ID_NET           1
+
+/* Legacy PCI I/O registers, offsets from BAR0 */
+#define VIRTIO_PCI_HOST_FEATURES    0x00    /**< 32 bits, read only  */
+#define VIRTIO_PCI_GUEST_FEATURES   0x04    /**< 32 bits             */
+#define VIRTIO_PCI_QUEUE_PFN        0x08    /**< 32 bits             */
+#define VIRTIO_PCI_QUEUE_NUM        0x0C    /**< 16 bits, read only  */
+#define VIRTIO_PCI_QUEUE_SEL        0x0E    /**< 16 bits             */
+#define VIRTIO_PCI_QUEUE_NOTIFY     0x10    /**< 16 bits             */
+#define VIRTIO_PCI_STATUS           0x12    /**< 8 bits              */
+#define VIRTIO_PCI_ISR              0x13    /**< 8 bits, read clears */
+#define VIRTIO_PCI_CONFIG           0x14    /**< device config (no MSI-X) */
+
+/* Legacy virtio-mmio registers, offsets from the csr */
+#define VIRTIO_MMIO_MAGIC_VALUE     0x000
+#define VIRTIO_MMIO_VERSION         0x004
+#define VIRTIO_MMIO_DEVICE_ID       0x008
+#define VIRTIO_MMIO_HOST_FEATURES   0x010
+#define VIRTIO_MMIO_HOST_FEATURES_SEL   0x014
+#define VIRTIO_MMIO_GUEST_FEATURES  0x020
+#define VIRTIO_MMIO_GUEST_FEATURES_SEL  0x024
+#define VIRTIO_MMIO_GUEST_PAGE_SIZE 0x028
+#define VIRTIO_MMIO_QUEUE_SEL       0x030
+#define VIRTIO_MMIO_QUEUE_NUM_MAX   0x034
+#define VIRTIO_MMIO_QUEUE_NUM       0x038
+#define VIRTIO_MMIO_QUEUE_ALIGN     0x03C
+#define VIRTIO_MMIO_QUEUE_PFN       0x040
+#define VIRTIO_MMIO_QUEUE_NOTIFY    0x050
+#define VIRTIO_MMIO_INTERRUPT_STATUS    0x060
+#define VIRTIO_MMIO_INTERRUPT_ACK   0x064
+#define VIRTIO_MMIO_STATUS          0x070
+#define VIRTIO_MMIO_CONFIG          0x100
+
+/* Device status bits */
+#define VIRTIO_STAT_ACKNOWLEDGE 0x01    /**< guest has seen the device    */
+#define VIRTIO_STAT_DRIVER      0x02    /**< guest has a driver for it    */
+#define VIRTIO_STAT_DRIVER_OK   0x04    /**< driver is ready              */
+#define VIRTIO_STAT_FAILED      0x80    /**< driver gave up on the device */
+
+/* Interrupt status bits */
+#define VIRTIO_ISR_QUEUE        0x01    /**< a used ring was updated      */
+#define VIRTIO_ISR_CONFIG       0x02    /**< device config changed        */
+
+/* Feature bits */
+#define VIRTIO_NET_F_MAC        (1 << 5)    /**< config holds the MAC     */
+#define VIRTIO_RING_F_EVENT_IDX (1 << 29)   /**< used/avail event indexes */
+
+/* Queue numbers of a network device */
+#define VIRTIO_NET_RXQ          0
+#define VIRTIO_NET_TXQ          1
+
+/* Ring layout */
+#define VIRTIO_PAGE_SHIFT       12
+#define VIRTIO_RING_ALIGN       (1 << VIRTIO_PAGE_SHIFT)
+#define VIRTIO_RING_MAX         256 /**< ring size asked of virtio-mmio  */
+
+/* Descriptor flags */
+#define VRING_DESC_F_NEXT       0x1 /**< chain continues at next         */
+#define VRING_DESC_F_WRITE      0x2 /**< buffer is written by the device */
+
+#define VRING_AVAIL_F_NO_INTERRUPT  0x1 /**< driver needs no interrupts  */
+#define VRING_USED_F_NO_NOTIFY      0x1 /**< device needs no kicks       */
+
+/**
+ * Ring descriptor.  Each packet uses a chain of two: one for the
+ * virtio-net header and one for the frame.
+ */
+struct dmaDescriptor
+{
+    uint64_t address;           /**< physical address of buffer          */
+    uint32_t length;            /**< length of buffer in bytes           */
+    uint16_t flags;             /**< VRING_DESC_F_* flags                */
+    uint16_t next;              /**< next descriptor of the chain        */
+};
+
+/** Ring of descriptor chains offered to the device. */
+struct vringAvail
+{
+    uint16_t flags;             /**< VRING_AVAIL_F_* flags               */
+    uint16_t idx;               /**< where the driver puts the next entry */
+    uint16_t ring[];            /**< chain heads, then used_event        */
+};
+
+/** Descriptor chain the device is done with. */
+struct vringUsedElem
+{
+    uint32_t id;                /**< head of the chain                   */
+    uint32_t len;               /**< bytes written to the chain          */
+};
+
+/** Ring of descriptor chains returned by the device. */
+struct vringUsed
+{
+    uint16_t flags;             /**< VRING_USED_F_* flags                */
+    uint16_t idx;               /**< where the device puts the next entry */
+    struct vringUsedElem ring[]; /**< used chains, then avail_event      */
+};
+
+/** One of the device's queues and the driver's view of it. */
+struct virtqueue
+{
+    uint index;                 /**< queue number on the device          */
+    uint num;                   /**< descriptors in the ring             */
+    void *mem;                  /**< page aligned memory of the ring     */
+    uint size;                  /**< bytes of ring memory                */
+    volatile struct dmaDescriptor *desc;    /**< descriptor table        */
+    volatile struct vringAvail *avail;      /**< available ring          */
+    volatile struct vringUsed *used;        /**< used ring               */
+    volatile uint16_t *usedEvent;   /**< interrupt when used idx passes  */
+    volatile uint16_t *availEvent;  /**< kick when avail idx passes      */
+    uint16_t availIdx;          /**< avail idx not yet published         */
+    uint16_t kickIdx;           /**< avail idx at the last publish       */
+    uint16_t lastUsed;          /**< next used entry to reap             */
+    ulong kicks;                /**< notifications sent to the device    */
+};
+
+/** Header the device expects in front of each frame. */
+struct virtioNetHdr
+{
+    uint8_t flags;
+    uint8_t gsoType;
+    uint16_t hdrLen;
+    uint16_t gsoSize;
+    uint16_t csumStart;
+    uint16_t csumOffset;
+};
+
+#define VIRTIO_NET_HDR_LEN      sizeof(struct virtioNetHdr)
+
+/** Size of packet buffers: ethPktBuffer, then header, then frame. */
+#define VIRTIO_NET_BUF_SIZE     (sizeof(struct ethPktBuffer) \
+                                 + VIRTIO_NET_HDR_LEN + ETH_MAX_PKT_LEN)
+
+/** virtio state of an Ethernet device, indexed like ethertab. */
+struct virtio
+{
+    ulong base;                 /**< I/O port or register base           */
+    uchar irq;                  /**< interrupt line                      */
+    ulong features;             /**< negotiated feature bits             */
+    struct virtqueue rxq;       /**< receive queue                       */
+    struct virtqueue txq;       /**< transmit queue                      */
+};
+
+extern struct virtio virtiotab[];
+
+/*
+ * Order ring updates against each other and against the device.  Port I/O
+ * on the x86 is serializing and its stores are not reordered, so only the
+ * compiler needs restraining there.
+ */
+#if PCI_BUS
+#define virtioBarrier()     asm volatile ("" : : : "memory")
+#else
+extern void dmb(void);
+#define virtioBarrier()     dmb()
+#endif
+
+/**
+ * True if the other side asked to be told once the index moving from @old
+ * to @new passes @event.
+ */
+#define vringNeedEvent(event, new, old) \
+    ((uint16_t)((new) - (event) - 1) < (uint16_t)((new) - (old)))
+
+/* Transport, in virtioPci.c or virtioMmio.c */
+syscall virtioProbe(device *devptr, struct virtio *vio);
+uchar virtioGetStatus(struct virtio *vio);
+void virtioSetStatus(struct virtio *vio, uchar status);
+ulong virtioGetFeatures(struct virtio *vio);
+void virtioSetFeatures(struct virtio *vio, ulong features);
+uint virtioQueueMax(struct virtio *vio, uint index);
+void virtioQueueStart(struct virtio *vio, struct virtqueue *vq);
+void virtioNotify(struct virtio *vio, uint index);
+uint virtioInterruptAck(struct virtio *vio);
+uchar virtioConfigRead(struct virtio *vio, uint offset);
+
+/* Rings, in virtqueue.c */
+syscall virtqueueAlloc(struct virtio *vio, struct virtqueue *vq, uint index);
+void virtqueueStart(struct virtio *vio, struct virtqueue *vq);
+void virtqueuePost(struct virtqueue *vq, uint16_t head);
+void virtqueueKick(struct virtio *vio, struct virtqueue *vq);
+
+#endif                          /* _VIRTIO_H_ */
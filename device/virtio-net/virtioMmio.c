@@ -0,0 +1,103 @@
+/**
+ * @file virtioMmio.c
+ *
+ * Legacy virtio-mmio transport for virtio devices: registers are memory
+ * mapped at the device's csr.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <interrupt.h>
+
+#if !PCI_BUS
+
+#define VIRTIO_REG(vio, reg)  (*(volatile ulong *)((vio)->base + (reg)))
+
+/**
+ * @ingroup etherspecific
+ *
+ * Check that the csr of an Ethernet device holds a legacy virtio-mmio
+ * network device and install the device's interrupt handler.
+ * @param devptr  Ethernet device table entry
+ * @param vio     virtio state to fill in
+ * @return OK if the device was found, otherwise SYSERR
+ */
+syscall virtioProbe(device *devptr, struct virtio *vio)
+{
+    vio->base = (ulong)devptr->csr;
+    vio->irq = devptr->irq;
+
+    if (VIRTIO_MMIO_MAGIC != VIRTIO_REG(vio, VIRTIO_MMIO_MAGIC_VALUE)
+        || 1 != VIRTIO_REG(vio, VIRTIO_MMIO_VERSION)
+        || VIRTIO_ID_NET != VIRTIO_REG(vio, VIRTIO_MMIO_DEVICE_ID))
+    {
+        return SYSERR;
+    }
+
+    interruptVector[vio->irq] = devptr->intr;
+    enable_irq(vio->irq);
+    return OK;
+}
+
+uchar virtioGetStatus(struct virtio *vio)
+{
+    return VIRTIO_REG(vio, VIRTIO_MMIO_STATUS);
+}
+
+void virtioSetStatus(struct virtio *vio, uchar status)
+{
+    VIRTIO_REG(vio, VIRTIO_MMIO_STATUS) = status;
+}
+
+ulong virtioGetFeatures(struct virtio *vio)
+{
+    VIRTIO_REG(vio, VIRTIO_MMIO_HOST_FEATURES_SEL) = 0;
+    return VIRTIO_REG(vio, VIRTIO_MMIO_HOST_FEATURES);
+}
+
+void virtioSetFeatures(struct virtio *vio, ulong features)
+{
+    VIRTIO_REG(vio, VIRTIO_MMIO_GUEST_FEATURES_SEL) = 0;
+    VIRTIO_REG(vio, VIRTIO_MMIO_GUEST_FEATURES) = features;
+}
+
+/* A virtio-mmio ring may be any power of two up to the device's limit.  */
+uint virtioQueueMax(struct virtio *vio, uint index)
+{
+    uint num;
+
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_SEL) = index;
+    num = VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_NUM_MAX);
+    return (num > VIRTIO_RING_MAX) ? VIRTIO_RING_MAX : num;
+}
+
+void virtioQueueStart(struct virtio *vio, struct virtqueue *vq)
+{
+    VIRTIO_REG(vio, VIRTIO_MMIO_GUEST_PAGE_SIZE) = VIRTIO_RING_ALIGN;
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_SEL) = vq->index;
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_NUM) = vq->num;
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_ALIGN) = VIRTIO_RING_ALIGN;
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_PFN) =
+        (ulong)vq->mem >> VIRTIO_PAGE_SHIFT;
+}
+
+void virtioNotify(struct virtio *vio, uint index)
+{
+    VIRTIO_REG(vio, VIRTIO_MMIO_QUEUE_NOTIFY) = index;
+}
+
+uint virtioInterruptAck(struct virtio *vio)
+{
+    uint isr;
+
+    isr = VIRTIO_REG(vio, VIRTIO_MMIO_INTERRUPT_STATUS);
+    VIRTIO_REG(vio, VIRTIO_MMIO_INTERRUPT_ACK) = isr;
+    return isr;
+}
+
+uchar virtioConfigRead(struct virtio *vio, uint offset)
+{
+    return *(volatile uchar *)(vio->base + VIRTIO_MMIO_CONFIG + offset);
+}
+
+#endif                          /* !PCI_BUS */
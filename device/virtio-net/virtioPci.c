@@ -0,0 +1,101 @@
+/**
+ * @file virtioPci.c
+ *
+ * Legacy PCI transport for virtio devices: registers live in the I/O space
+ * at BAR0.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <interrupt.h>
+
+#if PCI_BUS
+#include <pci.h>
+
+/**
+ * @ingroup etherspecific
+ *
+ * Find the PCI function of a virtio network device, enable its I/O space
+ * and bus mastering, and install the device's interrupt handler.  The n-th
+ * Ethernet device claims the n-th virtio network function on the bus.
+ * @param devptr  Ethernet device table entry
+ * @param vio     virtio state to fill in
+ * @return OK if the device was found, otherwise SYSERR
+ */
+syscall virtioProbe(device *devptr, struct virtio *vio)
+{
+    ulong bdf, bar;
+
+    if (SYSERR == pciFindDevice(VIRTIO_PCI_VENDOR, VIRTIO_PCI_NET,
+                                devptr->minor, &bdf))
+    {
+        return SYSERR;
+    }
+
+    bar = pciConfigRead(bdf, PCI_BAR0, 4);
+    if (!(bar & PCI_BAR_IO))
+    {
+        return SYSERR;
+    }
+    vio->base = bar & PCI_BAR_IO_MASK;
+    vio->irq = pciConfigRead(bdf, PCI_INTERRUPT_LINE, 1);
+
+    pciConfigWrite(bdf, PCI_COMMAND, 2,
+                   pciConfigRead(bdf, PCI_COMMAND, 2)
+                   | PCI_COMMAND_IO | PCI_COMMAND_MASTER);
+
+    set_handler(IRQBASE + vio->irq, devptr->intr);
+    return OK;
+}
+
+uchar virtioGetStatus(struct virtio *vio)
+{
+    return inb(vio->base + VIRTIO_PCI_STATUS);
+}
+
+void virtioSetStatus(struct virtio *vio, uchar status)
+{
+    outb(vio->base + VIRTIO_PCI_STATUS, status);
+}
+
+ulong virtioGetFeatures(struct virtio *vio)
+{
+    return inl(vio->base + VIRTIO_PCI_HOST_FEATURES);
+}
+
+void virtioSetFeatures(struct virtio *vio, ulong features)
+{
+    outl(vio->base + VIRTIO_PCI_GUEST_FEATURES, features);
+}
+
+/* The legacy PCI device dictates the size of each ring.  */
+uint virtioQueueMax(struct virtio *vio, uint index)
+{
+    outw(vio->base + VIRTIO_PCI_QUEUE_SEL, index);
+    return (ushort)inw(vio->base + VIRTIO_PCI_QUEUE_NUM);
+}
+
+void virtioQueueStart(struct virtio *vio, struct virtqueue *vq)
+{
+    outw(vio->base + VIRTIO_PCI_QUEUE_SEL, vq->index);
+    outl(vio->base + VIRTIO_PCI_QUEUE_PFN,
+         (ulong)vq->mem >> VIRTIO_PAGE_SHIFT);
+}
+
+void virtioNotify(struct virtio *vio, uint index)
+{
+    outw(vio->base + VIRTIO_PCI_QUEUE_NOTIFY, index);
+}
+
+/* Reading the ISR register also acknowledges the interrupt.  */
+uint virtioInterruptAck(struct virtio *vio)
+{
+    return (uchar)inb(vio->base + VIRTIO_PCI_ISR);
+}
+
+uchar virtioConfigRead(struct virtio *vio, uint offset)
+{
+    return inb(vio->base + VIRTIO_PCI_CONFIG + offset);
+}
+
+#endif                          /* PCI_BUS */
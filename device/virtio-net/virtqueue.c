@@ -0,0 +1,135 @@
+/**
+ * @file virtqueue.c
+ *
+ * Descriptor, available and used rings shared with a virtio device.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include "virtio.h"
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @ingroup etherspecific
+ *
+ * Allocate page aligned memory for a ring of the size the device asks for.
+ * The descriptor table and available ring come first, then the used ring on
+ * the next page boundary, as the legacy interface requires.
+ * @param vio    virtio state of the device
+ * @param vq     queue to set up
+ * @param index  queue number on the device
+ * @return OK on success, otherwise SYSERR
+ */
+syscall virtqueueAlloc(struct virtio *vio, struct virtqueue *vq, uint index)
+{
+    uint num, availsize, usedsize;
+    void *mem;
+
+    /* Ring sizes must be powers of two.  */
+    num = virtioQueueMax(vio, index);
+    if (0 == num || 0 != (num & (num - 1)))
+    {
+        return SYSERR;
+    }
+
+    availsize = num * sizeof(struct dmaDescriptor)
+        + sizeof(struct vringAvail) + (num + 1) * sizeof(uint16_t);
+    availsize = (availsize + VIRTIO_RING_ALIGN - 1) & ~(VIRTIO_RING_ALIGN - 1);
+    usedsize = sizeof(struct vringUsed)
+        + num * sizeof(struct vringUsedElem) + sizeof(uint16_t);
+
+    mem = memget(availsize + usedsize + VIRTIO_RING_ALIGN);
+    if (SYSERR == (int)mem)
+    {
+        return SYSERR;
+    }
+    mem = (void *)(((ulong)mem + VIRTIO_RING_ALIGN - 1)
+                   & ~(VIRTIO_RING_ALIGN - 1));
+
+    vq->index = index;
+    vq->num = num;
+    vq->mem = mem;
+    vq->size = availsize + usedsize;
+    vq->desc = mem;
+    vq->avail = (struct vringAvail *)(vq->desc + num);
+    vq->used = (struct vringUsed *)((uchar *)mem + availsize);
+    vq->usedEvent = &vq->avail->ring[num];
+    vq->availEvent = (volatile uint16_t *)&vq->used->ring[num];
+    return OK;
+}
+
+/**
+ * @ingroup etherspecific
+ *
+ * Empty a ring and hand it to the device.
+ * @param vio  virtio state of the device
+ * @param vq   queue to start
+ */
+void virtqueueStart(struct virtio *vio, struct virtqueue *vq)
+{
+    bzero(vq->mem, vq->size);
+    vq->availIdx = 0;
+    vq->kickIdx = 0;
+    vq->lastUsed = 0;
+    virtioQueueStart(vio, vq);
+}
+
+/**
+ * @ingroup etherspecific
+ *
+ * Offer the descriptor chain starting at @p head to the device.  The device
+ * does not see it until the next virtqueueKick(), so several chains can be
+ * offered for the price of one notification.
+ * @param vq    queue to add the chain to
+ * @param head  first descriptor of the chain
+ */
+void virtqueuePost(struct virtqueue *vq, uint16_t head)
+{
+    vq->avail->ring[vq->availIdx & (vq->num - 1)] = head;
+    vq->availIdx++;
+}
+
+/**
+ * @ingroup etherspecific
+ *
+ * Publish the chains posted since the last kick and notify the device if it
+ * is waiting for them.  With event indexes the device names the avail index
+ * it wants to hear about, so a device that is still working through the
+ * ring is not interrupted again.
+ * @param vio  virtio state of the device
+ * @param vq   queue to publish
+ */
+void virtqueueKick(struct virtio *vio, struct virtqueue *vq)
+{
+    uint16_t old, new;
+    bool notify;
+
+    old = vq->kickIdx;
+    new = vq->availIdx;
+    if (old == new)
+    {
+        return;
+    }
+
+    /* Descriptors must be visible before the index that publishes them,
+     * and the index before we look at whether the device is asleep.  */
+    virtioBarrier();
+    vq->avail->idx = new;
+    vq->kickIdx = new;
+    virtioBarrier();
+
+    if (vio->features & VIRTIO_RING_F_EVENT_IDX)
+    {
+        notify = vringNeedEvent(*vq->availEvent, new, old);
+    }
+    else
+    {
+        notify = !(vq->used->flags & VRING_USED_F_NO_NOTIFY);
+    }
+    if (notify)
+    {
+        virtioNotify(vio, vq->index);
+        vq->kicks++;
+    }
+}
@@ -8,7 +8,7 @@
 #define _ARP_H_
 
 #include <stddef.h>
-#include <mailbox.h>
+#include <thread.h>
 #include <network.h>
 
 /* Tracing macros */
@@ -66,6 +66,7 @@
 
 /* ARP daemon info */
 #define ARP_NQUEUE          32    /**< Number of pkts allowed in queue  */
+#define ARP_MSG_PKT         1     /**< sendbuf() type of queued request */
 
 /*
  * ARP HEADER
@@ -110,8 +111,8 @@ struct arpEntry
 /* ARP table */
 extern struct arpEntry arptab[ARP_NENTRY];
 
-/* ARP packet queue for packets requiring reply */
-extern mailbox arpqueue;
+/* ARP daemon, queues packets requiring reply */
+extern tid_typ arpdaemon;
 
 /* ARP Function Prototypes */
 struct arpEntry *arpAlloc(void);
@@ -0,0 +1,31 @@
+/**
+ * @file atomic.h
+ * Atomic operations on memory that do not disable interrupts.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _ATOMIC_H_
+#define _ATOMIC_H_
+
+/**
+ * Atomically add to an integer in memory.  This uses a locked xadd on x86,
+ * ldrex/strex on ARM and ll/sc on MIPS, so it is atomic with respect to
+ * interrupts without disabling them.
+ * @param ptr integer to add to
+ * @param delta amount to add
+ * @return value of the integer after the add
+ */
+int atomicAdd(volatile int *ptr, int delta);
+
+/**
+ * Atomically replace an integer in memory if it holds an expected value.
+ * This uses a locked cmpxchg on x86, ldrex/strex on ARM and ll/sc on MIPS.
+ * @param ptr integer to replace
+ * @param old value the integer must hold
+ * @param new value to store in its place
+ * @return value of the integer before the operation, equal to @p old if
+ *         @p new was stored
+ */
+int atomicCas(volatile int *ptr, int old, int new);
+
+#endif                          /* _ATOMIC_H_ */
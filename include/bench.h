@@ -0,0 +1,89 @@
+/**
+ * @file bench.h
+ * Definitions relating to the Xinu benchmark suite.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stddef.h>
+
+#define BENCH_MAXITER   4096    /**< most timed iterations of a benchmark */
+#define BENCH_ITER      256     /**< default number of timed iterations   */
+#define BENCH_WARMUP    16      /**< default number of warm-up iterations */
+#define BENCH_BATCH     1       /**< default operations per timed sample  */
+
+/**
+ * Defines what a benchmark table entry looks like.  The harness calls setup
+ * once, then times op for each iteration, then calls teardown.
+ */
+struct benchcase
+{
+    char *name;                 /**< Short name of benchmark            */
+    char *desc;                 /**< What one operation measures        */
+    syscall (*setup) (void);    /**< Prepare benchmark, may be NULL     */
+    void (*op) (void);          /**< Operation being measured           */
+    void (*teardown) (void);    /**< Clean up benchmark, may be NULL    */
+};
+
+/**
+ * Results of a benchmark, in cycles of the benchmark counter per operation
+ * with the cost of reading the counter removed.
+ */
+struct benchresult
+{
+    uint iters;                 /**< number of timed samples            */
+    uint batch;                 /**< operations per sample              */
+    ulong min;                  /**< fastest sample                     */
+    ulong median;               /**< median sample                      */
+    ulong p99;                  /**< 99th percentile sample             */
+    ulong max;                  /**< slowest sample                     */
+    ulong overhead;             /**< cost of reading the counter        */
+};
+
+extern int nbench;                  /**< total number of benchmarks     */
+extern struct benchcase benchtab[]; /**< table of benchmarks            */
+extern const char benchcounter[];   /**< name of the cycle counter      */
+
+/* Benchmark harness */
+void benchCycleInit(void);
+ulong benchCycles(void);
+syscall benchRun(const struct benchcase *, uint, uint, uint,
+                 struct benchresult *);
+
+/* Benchmarks */
+syscall bench_reschedSetup(void);
+void bench_resched(void);
+void bench_reschedTeardown(void);
+syscall bench_semaphoreSetup(void);
+void bench_semaphore(void);
+void bench_semaphoreTeardown(void);
+void bench_message(void);
+syscall bench_kmutexSetup(void);
+void bench_kmutex(void);
+void bench_kmutexTeardown(void);
+void bench_memget(void);
+syscall bench_bufgetSetup(void);
+void bench_bufget(void);
+void bench_bufgetTeardown(void);
+syscall bench_sortSortedSetup(void);
+syscall bench_sortReversedSetup(void);
+syscall bench_sortRandomSetup(void);
+void bench_qsort(void);
+void bench_mergesort(void);
+void bench_sortTeardown(void);
+syscall bench_smpSerialSetup(void);
+syscall bench_smpParallelSetup(void);
+void bench_smp(void);
+void bench_smpTeardown(void);
+syscall bench_netSendSetup(void);
+void bench_netSend(void);
+void bench_netSendTeardown(void);
+syscall bench_ulawSetup(void);
+void bench_ulawEncode(void);
+void bench_ulawDecode(void);
+void bench_ulawScalar(void);
+
+#endif                          /* _BENCH_H_ */
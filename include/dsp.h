@@ -10,4 +10,8 @@
 unsigned char linear2ulaw(int);
 int ulaw2linear(unsigned char);
 
+/* Bulk conversion, ulawbulk.c */
+void ulawEncode(unsigned char *, const short *, unsigned int);
+void ulawDecode(short *, const unsigned char *, unsigned int);
+
 #endif                          /* _DSP_H_ */
@@ -0,0 +1,71 @@
+/**
+ * @file fpu.h
+ *
+ * Lazy switching of floating point and SIMD state between threads.  The
+ * unit is left disabled when a thread other than its owner is switched
+ * to, so the first floating point instruction the thread runs traps.  The
+ * trap saves the owner's registers, loads the thread's and makes it the
+ * owner.  Threads that never use floating point cost nothing extra to
+ * switch.  Interrupt handlers must not use floating point.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _FPU_H_
+#define _FPU_H_
+
+#include <conf.h>
+#include <stddef.h>
+#include <smp.h>
+
+/** A platform with a floating point unit sets USE_FPU in its xinu.conf */
+#ifndef USE_FPU
+#define USE_FPU FALSE
+#endif
+
+#if USE_FPU
+
+#if defined(_XINU_ARCH_X86_)
+#define FPU_CTXSIZE  512        /**< bytes saved by fxsave              */
+#define FPU_CTXALIGN 16         /**< alignment fxsave requires          */
+#elif defined(_XINU_ARCH_ARM_)
+#define FPU_CTXSIZE  132        /**< d0-d15 and FPSCR                   */
+#define FPU_CTXALIGN 8          /**< alignment of doubleword stores     */
+#endif
+
+/** Saved state of a thread, within the block at thrent.fpuctx */
+#define fpuarea(ctx) \
+    ((void *)(((ulong)(ctx) + FPU_CTXALIGN - 1) & ~(FPU_CTXALIGN - 1)))
+
+#if NCPU > 1
+#define fpuowner (cpuself()->fpu)
+#else
+extern tid_typ fpuowner;        /**< thread whose state is in the unit  */
+#endif
+
+extern ulong fputraps;          /**< first uses that trapped            */
+
+/* Generic lazy switching, fpu.c */
+void fpuinit(void);
+void fpuswitch(tid_typ);
+void fputrap(void);
+syscall fpuflush(tid_typ);
+void fpufree(tid_typ);
+
+/* Platform routines */
+void fpuSetup(void);
+void fpuEnable(void);
+void fpuDisable(void);
+void fpuSave(void *);
+void fpuRestore(void *);
+void fpuReset(void);
+
+#else                           /* !USE_FPU */
+
+#define fpuinit()
+#define fpuswitch(tid)
+#define fpuflush(tid) OK
+#define fpufree(tid)
+
+#endif                          /* USE_FPU */
+
+#endif                          /* _FPU_H_ */
@@ -16,6 +16,42 @@
 
 #include <stddef.h>
 
+/* Platforms providing an implementation of kexec().  */
+#if defined(_XINU_PLATFORM_ARM_RPI_) || defined(_XINU_PLATFORM_ARM_QEMU_) || \
+    defined(_XINU_PLATFORM_X86_)
+#  define HAVE_KEXEC 1
+#else
+#  define HAVE_KEXEC 0
+#endif
+
+/** Granularity, in bytes, of the copy performed by kexec().  Staged images are
+ * padded to a multiple of this so the copy loop needs no tail handling.  */
+#define KEXEC_COPY_UNIT 32
+
+/** Memory left free when sizing a staging area of unknown length, so that the
+ * loader (e.g. the TFTP receive thread) can still allocate stacks and
+ * buffers.  */
+#define KEXEC_STAGE_RESERVE (128 * 1024)
+
+/**
+ * Staging area for a kernel image that is being received incrementally.  The
+ * image is placed contiguously, exactly as kexec() will copy it, so no second
+ * copy of the image is ever needed.
+ */
+struct kexecstage
+{
+    uchar *base;        /**< start of the staged image                   */
+    uint len;           /**< number of bytes staged so far               */
+    uint maxlen;        /**< capacity of the staging area                */
+    ulong checksum;     /**< running Adler-32 checksum of staged bytes   */
+};
+
 syscall kexec(const void *kernel, uint size);
 
+syscall kexecStageInit(struct kexecstage *stage, uint maxlen);
+syscall kexecStageWrite(struct kexecstage *stage, const void *data, uint len);
+syscall kexecStageFinish(struct kexecstage *stage);
+syscall kexecStageFree(struct kexecstage *stage);
+ulong kexecChecksum(ulong checksum, const uchar *data, uint len);
+
 #endif
@@ -0,0 +1,58 @@
+/**
+ * @file kmutex.h
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _KMUTEX_H_
+#define _KMUTEX_H_
+
+#include <thread.h>
+#include <semaphore.h>
+
+#ifndef NKMUTEX
+#  define NKMUTEX 32
+#endif
+
+/* Kernel mutex state definitions */
+#define KMUTEX_FREE 0x01 /**< this kernel mutex is free */
+#define KMUTEX_USED 0x02 /**< this kernel mutex is used */
+
+#define KMUTEX_SPIN  100 /**< most spins while the owner is running */
+#define KMUTEX_NMLEN 16  /**< length of kernel mutex name           */
+
+/* Kernel mutex lock word: owner's thread ID + 1, plus one unit per waiter */
+#define KMUTEX_OWNER  0xFFFF  /**< bits holding owner's thread ID + 1   */
+#define KMUTEX_WAITER 0x10000 /**< added for each waiting thread        */
+
+/** type definition of "kmutex" */
+typedef unsigned int kmutex;
+
+/**
+ * Kernel mutex table entry
+ */
+struct kmutent
+{
+    char state;              /**< KMUTEX_FREE or KMUTEX_USED              */
+    volatile int lock;       /**< owner and waiters, changed atomically   */
+    semaphore sem;           /**< mutex semaphore that waiters block on   */
+    char name[KMUTEX_NMLEN]; /**< name of the mutex                       */
+    ulong nlock;             /**< number of acquisitions                  */
+    ulong ncontend;          /**< acquisitions that blocked               */
+    ulong nspin;             /**< acquisitions that spun, then succeeded  */
+};
+
+extern struct kmutent kmutextab[];
+
+/** Determine if a kernel mutex is invalid or not in use  */
+#define isbadkmutex(m) ((m >= NKMUTEX) || (KMUTEX_FREE == kmutextab[m].state))
+
+/** Thread holding a kernel mutex, or BADTID  */
+#define kmutexowner(mutptr) ((tid_typ)(((mutptr)->lock & KMUTEX_OWNER) - 1))
+
+/* Kernel mutex function prototypes */
+kmutex kmutexcreate(const char *);
+syscall kmutexfree(kmutex);
+syscall kmutexlock(kmutex);
+syscall kmutexunlock(kmutex);
+
+#endif /* _KMUTEX_H_ */
@@ -13,6 +13,10 @@
 #define MAILBOX_FREE     0
 #define MAILBOX_ALLOC    1
 
+/* Mailbox modes */
+#define MAILBOX_MPMC     0      /**< any number of senders and receivers */
+#define MAILBOX_SPSC     1      /**< one sender and one receiver         */
+
 /**
  * Defines what an entry in the mailbox table looks like.
  */
@@ -25,6 +29,12 @@ struct mbox
     uint start;                 /**< index into buffer of first msg     */
     uchar state;                /**< state of the mailbox               */
     int *msgs;                  /**< message queue for the mailbox      */
+    uchar mode;                 /**< MAILBOX_MPMC or MAILBOX_SPSC       */
+    volatile uint head;         /**< SPSC: messages ever sent           */
+    volatile uint tail;         /**< SPSC: messages ever received       */
+    uint mask;                  /**< SPSC: max - 1, max a power of two  */
+    volatile bool txwait;       /**< SPSC: sender blocked on full ring  */
+    volatile bool rxwait;       /**< SPSC: receiver blocked on empty    */
 };
 
 typedef uint mailbox;
@@ -35,10 +45,13 @@ extern struct mbox mboxtab[];
 
 /* Mailbox function prototypes */
 syscall mailboxAlloc(uint);
+syscall mailboxAllocSpsc(uint);
 syscall mailboxCount(mailbox);
 syscall mailboxFree(mailbox);
 syscall mailboxInit(void);
 syscall mailboxReceive(mailbox);
+syscall mailboxReceiveBatch(mailbox, int *, uint);
 syscall mailboxSend(mailbox, int);
+syscall mailboxSendBatch(mailbox, const int *, uint);
 
 #endif                          /* _MAILBOX_H_ */
@@ -0,0 +1,49 @@
+/**
+ * @file mmu.h
+ *
+ * Definitions relating to the ARM memory management unit and the L1 caches.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _MMU_H_
+#define _MMU_H_
+
+#include <stddef.h>
+
+#define MMU_SECTION_SIZE    0x00100000  /**< bytes mapped by a section  */
+#define MMU_NSECTION        4096        /**< sections in address space  */
+#define CACHE_LINE_SIZE     32          /**< bytes in an L1 cache line  */
+
+/* Bits of a first-level section descriptor in the ARMv6 format.  See B4.7
+ * "Hardware page table translation" of the ARM Architecture Reference
+ * Manual.  */
+#define MMU_SECTION         0x00002     /**< descriptor maps a section  */
+#define MMU_B               0x00004     /**< bufferable                 */
+#define MMU_C               0x00008     /**< cacheable                  */
+#define MMU_XN              0x00010     /**< execute never              */
+#define MMU_AP_RW           0x00C00     /**< read/write at any level    */
+#define MMU_TEX_NORMAL      0x01000     /**< TEX=001, normal memory     */
+
+/** Normal memory, write-back cached in L1.  */
+#define MMU_MEM_CACHED      (MMU_SECTION | MMU_AP_RW | MMU_C | MMU_B)
+/** Normal memory, not cached.  */
+#define MMU_MEM_UNCACHED    (MMU_SECTION | MMU_AP_RW | MMU_TEX_NORMAL)
+/** Shared device memory, not cached and never executed.  */
+#define MMU_MEM_DEVICE      (MMU_SECTION | MMU_AP_RW | MMU_B | MMU_XN)
+
+/* Bits of the CP15 control register.  */
+#define CTRL_MMU            0x00000001  /**< MMU enable                 */
+#define CTRL_DCACHE         0x00000004  /**< data cache enable          */
+#define CTRL_BRANCH         0x00000800  /**< branch prediction enable   */
+#define CTRL_ICACHE         0x00001000  /**< instruction cache enable   */
+#define CTRL_XP             0x00800000  /**< ARMv6 page table format    */
+
+/* MMU and cache function prototypes */
+void mmu_init(void);
+void mmu_disable(void);
+void dcache_clean(const void *addr, uint len);
+void dcache_invalidate(void *addr, uint len);
+void dcache_flush(const void *addr, uint len);
+void icache_invalidate(void);
+
+#endif                          /* _MMU_H_ */
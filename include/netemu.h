@@ -7,10 +7,113 @@
 #ifndef _NETEMU_H_
 #define _NETEMU_H_
 
+#include <stddef.h>
+#include <network.h>
+
+/* Tracing macros */
+//#define TRACE_EMU     TTY1
+#ifdef TRACE_EMU
+#include <stdio.h>
+#define EMU_TRACE(...)     { \
+		fprintf(TRACE_EMU, "%s:%d (%d) ", __FILE__, __LINE__, gettid()); \
+		fprintf(TRACE_EMU, __VA_ARGS__); \
+		fprintf(TRACE_EMU, "\n"); }
+#else
+#define EMU_TRACE(...)
+#endif
+
+/* Emulator rule table */
+#define EMU_NRULES        8        /**< Number of emulator rules        */
+#define EMU_FREE          0        /**< Rule is free                    */
+#define EMU_USED          1        /**< Rule is in use                  */
+
+/* Wildcard values for rule match fields */
+#define EMU_PROTO_ANY     0        /**< Match any IPv4 protocol         */
+#define EMU_PORT_ANY      0        /**< Match any UDP/TCP port          */
+
+/* Delay queue */
+#define EMU_NQUEUE        64       /**< Max packets held by emulator    */
+#define EMU_IDLE_WAIT     1000     /**< Daemon wakeup (ms) when idle    */
+#define EMU_RATE_LIMIT    1000     /**< Default rate queueing limit (ms)*/
+
+/* Emulator thread constants */
+#define EMU_THR_PRIO      NET_THR_PRIO  /**< Emulator thread priority   */
+#define EMU_THR_STK       NET_THR_STK   /**< Emulator thread stack size */
+
+/**
+ * Emulator rule.  A routed packet is handled by the first rule it matches;
+ * packets matching no rule are forwarded unchanged.  Probabilities are in
+ * percent, times in milliseconds and rates in bytes per second.
+ */
+struct emuRule
+{
+    ushort state;               /**< EMU_FREE or EMU_USED               */
+
+    /* Match criteria */
+    uchar proto;                /**< IPv4 protocol or EMU_PROTO_ANY     */
+    struct netaddr src;         /**< Source network                     */
+    struct netaddr srcmask;     /**< Source mask (len 0 matches any)    */
+    struct netaddr dst;         /**< Destination network                */
+    struct netaddr dstmask;     /**< Destination mask (len 0 any)       */
+    ushort srcpt;               /**< UDP/TCP source port or ANY         */
+    ushort dstpt;               /**< UDP/TCP destination port or ANY    */
+
+    /* Impairments */
+    ushort drop;                /**< Percent of packets dropped         */
+    ushort duplicate;           /**< Percent of packets duplicated      */
+    ushort corrupt;             /**< Percent of packets corrupted       */
+    ushort reorder;             /**< Percent of packets held back       */
+    uint gap;                   /**< Extra delay of held back packets   */
+    uint delay;                 /**< Base delay                         */
+    uint jitter;                /**< Max random delay added to base     */
+    uint rate;                  /**< Bandwidth limit, 0 for unlimited   */
+    uint burst;                 /**< Token bucket depth in bytes        */
+    uint limit;                 /**< Max queueing delay before drop     */
+
+    /* Token bucket state */
+    int tokens;                 /**< Bytes available (negative: owed)   */
+    ulong last;                 /**< Time tokens were last added        */
+
+    /* Statistics */
+    uint nmatch;                /**< Packets matching rule              */
+    uint ndrop;                 /**< Packets dropped randomly           */
+    uint nlimit;                /**< Packets dropped by rate limit      */
+    uint ndup;                  /**< Packets duplicated                 */
+    uint ncorrupt;              /**< Packets corrupted                  */
+    uint nreorder;              /**< Packets held back                  */
+    uint ndelay;                /**< Packets placed in delay queue      */
+};
+
+/**
+ * Packet held in the emulator delay queue.
+ */
+struct emuPending
+{
+    struct packet *pkt;         /**< Held packet                        */
+    ulong release;              /**< Time (ms) to forward the packet    */
+    struct emuPending *next;    /**< Next entry, ordered by release     */
+};
+
+extern struct emuRule emutab[EMU_NRULES];
+extern struct emuPending emuqtab[EMU_NQUEUE];
+extern struct emuPending *emuqhead;
+extern struct emuPending *emuqfree;
+extern tid_typ emutid;
+extern uint emuqfull;
+
+/* Function prototypes */
 syscall netemu(struct packet *pkt);
-syscall emuCorrupt(struct packet *pkt);
-syscall emuDelay(struct packet *pkt);
-syscall emuDrop(struct packet *pkt);
-syscall emuDuplicate(struct packet *pkt);
-syscall emuReorder(struct packet *pkt);
+syscall emuInit(void);
+thread emuDaemon(void);
+struct emuRule *emuAlloc(void);
+syscall emuFree(struct emuRule *rule);
+struct emuRule *emuMatch(struct packet *pkt);
+ulong emuNow(void);
+syscall emuDrop(struct packet *pkt, struct emuRule *rule, uint delay);
+syscall emuRate(struct packet *pkt, struct emuRule *rule, uint delay);
+syscall emuDuplicate(struct packet *pkt, struct emuRule *rule, uint delay);
+syscall emuCorrupt(struct packet *pkt, struct emuRule *rule, uint delay);
+syscall emuReorder(struct packet *pkt, struct emuRule *rule, uint delay);
+syscall emuDelay(struct packet *pkt, struct emuRule *rule, uint delay);
+
 #endif                          /* _NETEMU_H_ */
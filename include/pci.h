@@ -0,0 +1,51 @@
+/**
+ * @file pci.h
+ *
+ * PCI configuration space access through configuration mechanism #1.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _PCI_H_
+#define _PCI_H_
+
+#include <stddef.h>
+
+/* Configuration mechanism #1 I/O ports */
+#define PCI_CONFIG_ADDR     0xCF8
+#define PCI_CONFIG_DATA     0xCFC
+#define PCI_CONFIG_ENABLE   0x80000000
+
+/* Number of busses, devices per bus and functions per device */
+#define PCI_NBUS            256
+#define PCI_NDEV            32
+#define PCI_NFUNC           8
+
+/** Bus, device and function packed as in the configuration address */
+#define PCI_BDF(bus, dev, func) \
+    (((bus) << 16) | ((dev) << 11) | ((func) << 8))
+
+/* Configuration space header offsets */
+#define PCI_VENDOR_ID       0x00
+#define PCI_DEVICE_ID       0x02
+#define PCI_COMMAND         0x04
+#define PCI_HEADER_TYPE     0x0E
+#define PCI_BAR0            0x10
+#define PCI_INTERRUPT_LINE  0x3C
+
+/* Command register bits */
+#define PCI_COMMAND_IO      0x0001  /**< respond to I/O space accesses    */
+#define PCI_COMMAND_MEMORY  0x0002  /**< respond to memory space accesses */
+#define PCI_COMMAND_MASTER  0x0004  /**< allow bus mastering (DMA)        */
+
+#define PCI_HEADER_MULTI    0x80    /**< device has several functions     */
+
+/* Base address register bits */
+#define PCI_BAR_IO          0x00000001
+#define PCI_BAR_IO_MASK     0xFFFFFFFC
+#define PCI_BAR_MEM_MASK    0xFFFFFFF0
+
+ulong pciConfigRead(ulong bdf, uint offset, uint width);
+void pciConfigWrite(ulong bdf, uint offset, uint width, ulong value);
+syscall pciFindDevice(ushort vendor, ushort device, uint index, ulong *bdf);
+
+#endif                          /* _PCI_H_ */
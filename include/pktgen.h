@@ -0,0 +1,135 @@
+/**
+ * @file pktgen.h
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _PKTGEN_H_
+#define _PKTGEN_H_
+
+#include <stddef.h>
+#include <ether.h>
+#include <ethernet.h>
+#include <ipv4.h>
+#include <network.h>
+#include <thread.h>
+#include <udp.h>
+
+/* Tracing macros */
+//#define TRACE_PKTGEN     TTY1
+#ifdef TRACE_PKTGEN
+#include <stdio.h>
+#define PKTGEN_TRACE(...)     { \
+		fprintf(TRACE_PKTGEN, "%s:%d (%d) ", __FILE__, __LINE__, gettid()); \
+		fprintf(TRACE_PKTGEN, __VA_ARGS__); \
+		fprintf(TRACE_PKTGEN, "\n"); }
+#else
+#define PKTGEN_TRACE(...)
+#endif
+
+/* Stream table */
+#define PKTGEN_NSTREAM    4        /**< Number of concurrent streams    */
+#define PKTGEN_FREE       0        /**< Stream is free                  */
+#define PKTGEN_RUN        1        /**< Stream is sending               */
+#define PKTGEN_DONE       2        /**< Stream has stopped              */
+
+/* Generator constants */
+#define PKTGEN_BATCH      8        /**< Frames written per stream turn  */
+#define PKTGEN_MAGIC      0x5047656e    /**< "PGen", marks payload      */
+#define PKTGEN_MINLEN     (ETH_HDR_LEN + IPv4_HDR_LEN + UDP_HDR_LEN \
+                           + sizeof(struct pgHdr))
+#define PKTGEN_MAXLEN     (ETH_HDR_LEN + ETH_MTU)
+
+/* Sink constants */
+#define PKTGEN_NHIST      12       /**< Latency histogram buckets       */
+#define PKTGEN_SINK_PORT  9        /**< Default sink port (discard)     */
+
+/* Thread constants */
+#define PKTGEN_THR_PRIO   INITPRIO
+#define PKTGEN_THR_STK    INITSTK
+
+/**
+ * Header at the start of every generated UDP payload, in network order.
+ */
+struct pgHdr
+{
+    ulong magic;                /**< PKTGEN_MAGIC                       */
+    ulong stream;               /**< Sending stream number              */
+    ulong seq;                  /**< Sequence number within stream      */
+    ulong stamp;                /**< Send time in milliseconds          */
+};
+
+/**
+ * Packet generator stream.  Each stream owns a prebuilt frame template; only
+ * the lengths, IPv4 checksum and payload header change from frame to frame.
+ */
+struct pgStream
+{
+    ushort state;               /**< PKTGEN_FREE, _RUN or _DONE         */
+    int dev;                    /**< Ethernet device frames written to  */
+    uint minlen;                /**< Minimum frame length               */
+    uint maxlen;                /**< Maximum frame length               */
+    uint rate;                  /**< Target rate (frames/s), 0 for max  */
+    uint count;                 /**< Frames to send, 0 for unlimited    */
+
+    /* Pacing state */
+    ulong epoch;                /**< Start (ms) of current pacing second */
+    uint credit;                /**< Frames sent since epoch            */
+
+    /* Statistics */
+    ulong start;                /**< Time (ms) stream started           */
+    ulong stop;                 /**< Time (ms) stream stopped           */
+    uint seq;                   /**< Frames attempted                   */
+    uint errors;                /**< Frames the device refused          */
+    uint bytes;                 /**< Bytes written                      */
+
+    /* Frame template */
+    uint ipsum;                 /**< IPv4 header sum without length     */
+    uchar pad[2];               /**< Padding to align IPv4 header       */
+    uchar frame[PKTGEN_MAXLEN]; /**< Template frame                     */
+};
+
+/**
+ * Per-stream receive statistics kept by the sink.
+ */
+struct pgFlow
+{
+    uint nrecv;                 /**< Frames received                    */
+    uint next;                  /**< Next sequence number expected      */
+    uint nlost;                 /**< Frames missing from the sequence   */
+    uint nreorder;              /**< Frames arriving after a later one  */
+    ulong latmin;               /**< Minimum latency (ms)               */
+    ulong latmax;               /**< Maximum latency (ms)               */
+    ulong lattotal;             /**< Sum of latencies (ms)              */
+    uint hist[PKTGEN_NHIST];    /**< Latency histogram, powers of two   */
+};
+
+/**
+ * Receive-side sink for generated traffic.
+ */
+struct pgSink
+{
+    ushort state;               /**< PKTGEN_FREE or PKTGEN_RUN          */
+    int dev;                    /**< UDP device datagrams are read from */
+    tid_typ tid;                /**< Sink thread                        */
+    uint nbad;                  /**< Datagrams without a pktgen header  */
+    struct pgFlow flows[PKTGEN_NSTREAM];
+};
+
+extern struct pgStream pgtab[PKTGEN_NSTREAM];
+extern struct pgSink pgsink;
+extern tid_typ pgtid;
+
+/* Function prototypes */
+int pktgenAlloc(void);
+syscall pktgenStart(int stream, uchar *dstmac, struct netaddr *src,
+                    struct netaddr *dst, ushort srcpt, ushort dstpt);
+syscall pktgenStop(int stream);
+syscall pktgenFree(int stream);
+thread pktgen(void);
+ulong pktgenNow(void);
+syscall pktgenSinkStart(int descrp, ushort port);
+syscall pktgenSinkStop(void);
+thread pktgenSink(void);
+
+#endif                          /* _PKTGEN_H_ */
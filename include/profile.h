@@ -0,0 +1,34 @@
+/**
+ * @file profile.h
+ * Definitions relating to the statistical sampling profiler.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+#include <stddef.h>
+
+#define PROF_NSAMPLE    2048    /**< samples held by the ring buffer    */
+
+/**
+ * Defines what a profiler sample looks like.
+ */
+struct profent
+{
+    ulong pc;                   /**< address the clock interrupted      */
+    tid_typ tid;                /**< thread that was running            */
+};
+
+extern struct profent proftab[];    /**< ring buffer of samples         */
+extern bool profiling;          /**< TRUE while taking samples          */
+extern uint profinterval;       /**< ticks per sample                   */
+extern uint profhead;           /**< index of next sample to write      */
+extern ulong profcount;         /**< samples taken since profstart()    */
+
+/* Profiler function prototypes */
+syscall profstart(uint);
+syscall profstop(void);
+void profsample(void);
+
+#endif                          /* _PROFILE_H_ */
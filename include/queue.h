@@ -27,10 +27,14 @@
 #include <kernel.h>
 
 #ifndef NQENT
-
+#if NCPU > 1
+/** NQENT = 1 per thread, 2 per list, 2 per sem, 2 per extra processor */
+#define NQENT   (NTHREAD + 4 + NSEM + NSEM + 2 * (NCPU - 1))
+#else
 /** NQENT = 1 per thread, 2 per list, 2 per sem */
 #define NQENT   (NTHREAD + 4 + NSEM + NSEM)
 #endif
+#endif
 
 #define EMPTY (-2)              /**< null pointer for queues            */
 #define MAXKEY 0x7FFFFFFF       /**< max key that can be saved in queue */
@@ -49,7 +53,9 @@ struct queent
 };
 
 extern struct queent quetab[];
+#if !(NCPU > 1)
 extern qid_typ readylist;
+#endif
 
 #define quehead(q) (q)
 #define quetail(q) ((q) + 1)
@@ -76,4 +82,6 @@ int insert(tid_typ, qid_typ, int);
 int insertd(tid_typ, qid_typ, int);
 qid_typ queinit(void);
 
+#include <smp.h>
+
 #endif                          /* _QUEUE_H_ */
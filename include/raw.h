@@ -12,6 +12,9 @@
 #include <network.h>
 #include <semaphore.h>
 #include <stdarg.h>
+#ifdef UHEAP_SIZE
+#include <safemem.h>
+#endif
 
 /* Tracing macros */
 //#define TRACE_RAW     TTY1
@@ -37,12 +40,18 @@
 #define RAW_IACCEPT     0x01    /**< Set remoteip using next read pkt  */
 #define RAW_IHDR        0x02    /**< Include network layer header      */
 
+/* Shared ring */
+#define RAW_RINGSLOT    NET_MAX_PKTLEN  /**< Bytes per ring slot        */
+
 /* Output flags */
 #define RAW_OHDR        0x04    /**< Pkt already has network layer hdr */
 
 /* Control functions */
 #define RAW_CTRL_SETFLAG   1    /**< Set flags                         */
 #define RAW_CTRL_CLRFLAG   2    /**< Clear flags                       */
+#define RAW_CTRL_RINGMAP   3    /**< Map a shared ring into caller     */
+#define RAW_CTRL_RINGWAIT  4    /**< Wait for a frame in shared ring   */
+#define RAW_CTRL_RINGUNMAP 5    /**< Unmap shared ring                 */
 
 /**
  *  Raw socket control block 
@@ -66,6 +75,12 @@ struct raw
     semaphore isema;                /**< Count of input packets ready       */
 
     uchar flags;                    /**< Flags                              */
+
+#ifdef UHEAP_SIZE
+    /* Shared ring fields */
+    struct memring ring;            /**< Ring mapped by a user thread       */
+    bool ringwait;                  /**< Consumer waiting on isema          */
+#endif
 };
 
 extern struct raw rawtab[];
@@ -8,7 +8,7 @@
 #define _ROUTE_H_
 
 #include <stddef.h>
-#include <mailbox.h>
+#include <thread.h>
 #include <network.h>
 
 /* Tracing macros */
@@ -35,6 +35,7 @@
 
 /* Route daemon info */
 #define RT_NQUEUE          32      /**< Number of pkts allowed in queue */
+#define RT_MSG_PKT         1       /**< sendbuf() type of queued packet */
 
 /* Route Packet Structure */
 struct rtEntry
@@ -50,8 +51,8 @@ struct rtEntry
 /* Route table */
 extern struct rtEntry rttab[RT_NENTRY];
 
-/* Route pakcet queue for packets requiring routing */
-extern mailbox rtqueue;
+/* Route daemon, queues packets requiring routing */
+extern tid_typ rtdaemon;
 
 /* Function prototypes */
 syscall rtAdd(const struct netaddr *dst, const struct netaddr *gate,
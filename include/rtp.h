@@ -2,18 +2,22 @@
  * @file rtp.h
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #ifndef _RTP_H_
 #define _RTP_H_
 
 #include <stddef.h>
+#include <clock.h>
 #include <network.h>
 #include <ipv4.h>
 #include <semaphore.h>
 #include <stdarg.h>
 #include <udp.h>
 
+/** @ingroup rtp
+ * @{ */
+
 /* Tracing macros */
 //#define TRACE_RTP     TTY1
 #ifdef TRACE_RTP
@@ -27,44 +31,64 @@
 #endif
 
 /* RTP definitions */
-#define RTP_HDR_LEN	        12      //Minimum
-#define RTP_MAX_PKTS        100
-#define RTP_MAX_DATALEN     1450
-#define RTP_TTL             64
-
-/* RTP standard ports */
-#define RTP_PORT_RDATE          //37
-#define RTP_PORT_DNS            //53
-#define RTP_PORT_DHCPS          //67
-#define RTP_PORT_DHCPC          //68
-#define RTP_PORT_TRACEROUTE     //33434
-
-/* RTP Control Bits */
-#define RTP_VERSION		2
-#define RTP_RESET		0x8000
-#define RTP_PAD_YES		0x2000  //or
-#define RTP_PAD_NO		0x9FFF  //and
-#define RTP_EXT_YES		0x1000  //or
-#define RTP_EXT_NO		0xAFFF  //and
-#define RTP_CC_RESET	0xF0FF  //and
-#define RTP_MARK_YES	0x0080  //or
-#define RTP_MARK_NO		0xFF7F  //and
+#define RTP_HDR_LEN         12  /**< fixed header, without CSRCs        */
+#define RTP_CSRC_LEN        4   /**< bytes per contributing source      */
+#define RTP_EXT_LEN         4   /**< header extension, without its data */
+#define RTP_MAX_PKTS        32  /**< packets held for playout           */
+#define RTP_MAX_DATALEN     (UDP_MAX_DATALEN - RTP_HDR_LEN)
+
+/* Playout timing */
+#define RTP_CLOCKRATE       8000        /**< timestamp units per second */
+#define RTP_TSPERMS         (RTP_CLOCKRATE / 1000)
+#define RTP_DELAY           60  /**< default playout delay in ms        */
+#define RTP_RESYNC          1000        /**< ms off schedule to restart */
+
+/* Source statistics, as in RFC 3550 appendix A.1 */
+#define RTP_MAXDROPOUT      3000        /**< largest forward seq jump   */
+#define RTP_MAXMISORDER     100         /**< largest backward seq jump  */
+
+/* RTP payload types */
+#define RTP_PT_PCMU         0   /**< G.711 ulaw, 8000 Hz                */
+
+/* RTP control bits */
+#define RTP_VER             0xC000      /**< version                    */
+#define RTP_V2              0x8000      /**< version 2                  */
+#define RTP_PAD             0x2000      /**< padding at end of packet   */
+#define RTP_EXT             0x1000      /**< header extension follows   */
+#define RTP_CC              0x0F00      /**< number of CSRCs            */
+#define RTP_MARK            0x0080      /**< marker                     */
+#define RTP_PT              0x007F      /**< payload type               */
+
+/* RTP control functions */
+#define RTP_CTRL_SETDELAY   1   /**< Set the playout delay in ms        */
+#define RTP_CTRL_SETPT      2   /**< Set the payload type sent          */
+
+/**
+ * isbadrtp - check validity of requested RTP device
+ * @param f id number to test
+ */
+#define isbadrtp(f)  ( !(RTP0 <= (f) && (f) < (RTP0 + NRTP)) )
 
 /* RTP state constants */
 #define RTP_FREE      0
 #define RTP_ALLOC     1
 #define RTP_OPEN      2
 
-/* Local port allocation ranges */
-#define RTP_PSTART  1024   /**< start port for allocating */
-#define RTP_PMAX    65535   /**< max RTP port */
+/* RTCP packet types */
+#define RTCP_SR             200 /**< Sender report                      */
+#define RTCP_RR             201 /**< Receiver report                    */
+#define RTCP_SDES           202 /**< Source description                 */
+#define RTCP_BYE            203 /**< Goodbye                            */
+#define RTCP_APP            204 /**< Application defined                */
 
-/* RTCP Packet types */
-#define RTCP_EP		0       /**< Encyrption prefix			  */
-#define RTCP_SRRR	1       /**< Send/Receive Report		  */
-#define RTCP_ARRS	2       /**< Additional RRs				  */
-#define RTCP_SDES	3       /**< Source description time	  */
-#define RTCP_BYEAPP	4       /**< End or App Specification     */
+/* RTCP definitions */
+#define RTCP_V2             0x80        /**< version 2                  */
+#define RTCP_VER            0xC0        /**< version                    */
+#define RTCP_COUNT          0x1F        /**< reports or sources         */
+#define RTCP_SDES_END       0   /**< end of a source's items            */
+#define RTCP_SDES_CNAME     1   /**< canonical name item                */
+#define RTCP_INTERVAL       5000        /**< average ms between reports */
+#define RTCP_MAX_PKTLEN     128 /**< longest report sent                */
 
 #ifndef __ASSEMBLER__
 
@@ -78,21 +102,18 @@
  * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  * |           Synchronization Source (SSRC) Identifier            |
  * +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
- * |            Contributing Source (CSRC) Identifiers			   |
- * |							  ...				               |
+ * |            Contributing Source (CSRC) Identifiers             |
+ * |                             ...                               |
  * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  */
 
 struct rtpPkt                   /* RTP Packet Variables */
 {
-    ushort control;                             /**< RTP Control Bits 0-1: Version(2)
-								2: Padding 3:Extension 4-7: CSRC Count
-								8: Marker 9-15: Payload Type		*/
-    ushort seqNum;                  /**< RTP Sequence Number            */
-    uchar timestamp;            /**< RTP Timestamp                  */
-    uchar ssrc;                 /**< RTP Synchronization Source ID  */
-    uchar csrc[1];             /**< RTP Contributing Source ID
-								(optional) (0-15 Items 32 Bits each)*/
+    ushort control;             /**< RTP control bits                   */
+    ushort seqNum;              /**< RTP sequence number                */
+    uint timestamp;             /**< RTP timestamp                      */
+    uint ssrc;                  /**< RTP synchronization source ID      */
+    uchar data[1];              /**< CSRCs, extension and payload       */
 };
 
 /*
@@ -106,64 +127,159 @@ struct rtpPkt                   /* RTP Packet Variables */
  * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  */
 
-struct rtpPktExt                /* Exists temporarily with X in header =1 */
+struct rtpPktExt
 {
-    ushort defPro;
-    ushort len;
-    uchar headerExt;
+    ushort defPro;              /**< defined by profile                 */
+    ushort len;                 /**< length in 32 bit words             */
 };
 
 /*
+ * RTCP HEADER
+ *
+ * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * |V=2|P|   RC    |      PT       |            Length             |
+ * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ * |                     SSRC of packet sender                     |
+ * +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+ * |              Sender info (SR only), report blocks             |
+ * |                             ...                               |
+ * +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ */
+
 struct rtcpPkt
 {
-	
+    uchar control;              /**< version, padding, count            */
+    uchar type;                 /**< RTCP packet type                   */
+    ushort len;                 /**< 32 bit words after the first       */
+    uint ssrc;                  /**< SSRC of packet sender              */
 };
-*/
 
-/* RT Control Protocol Block */
+/** Sender info of a SR, which follows the header */
+struct rtcpSender
+{
+    uint ntpsec;                /**< NTP timestamp, seconds             */
+    uint ntpfrac;               /**< NTP timestamp, fraction            */
+    uint timestamp;             /**< RTP timestamp of the same instant  */
+    uint packets;               /**< packets sent                       */
+    uint octets;                /**< payload octets sent                */
+};
+
+/** Report block about one source */
+struct rtcpBlock
+{
+    uint ssrc;                  /**< source reported on                 */
+    uint lost;                  /**< fraction lost, cumulative lost     */
+    uint maxseq;                /**< extended highest sequence number   */
+    uint jitter;                /**< interarrival jitter                */
+    uint lsr;                   /**< middle of last SR NTP timestamp    */
+    uint dlsr;                  /**< delay since last SR, 1/65536 s     */
+};
+
+/** Payload of a received packet, held until its playout time */
+struct rtpBuf
+{
+    uint timestamp;             /**< RTP timestamp, host order          */
+    ushort seqNum;              /**< RTP sequence number, host order    */
+    ushort len;                 /**< bytes of payload                   */
+    uchar data[1];              /**< payload                            */
+};
+
+/* RTP Control Block */
 
 struct rtp
 {
     device *dev;                        /**< RTP device entry               */
-    struct rtpPkt *in[RTP_MAX_PKTS];    /**< Pointers to stored packets     */
+    struct udp *udpptr;                 /**< UDP device carrying packets    */
+    struct rtpBuf *in[RTP_MAX_PKTS];    /**< Held packets in playout order  */
     int inPool;                         /**< Pool of received RTP packets   */
     int icount;                         /**< Count value for input buffer   */
     int istart;                         /**< Start value for input buffer   */
     semaphore isem;                     /**< Semaphore for input buffer     */
 
-    ushort localpt;                                             /**< RTP Local Port					*/
-    ushort remotept;                                            /**< RTP Remote Port				*/
-
-    ushort clocalpt;                                            /**< RTCP Local Port, +1 localpt	*/
-    ushort cremotept;                                           /**< RTCP Remote Port, +1 remotept	*/
-
-    ushort sequence;
-    uchar state;                            /**< RTP state                      */
-    uchar tp;
-    uchar tc;
-    uchar tn;
-    int pmembers;
-    int members;
-    int senders;
-    int rtcp_bw;
-    uchar we_sent;
-    uchar avg_rtcp_size;
-    uchar initial;
+    ushort sequence;                    /**< Sequence number of next send   */
+    uint timestamp;                     /**< Timestamp of next send         */
+    uint ssrc;                          /**< Our synchronization source     */
+    uchar payload;                      /**< Payload type sent              */
+    uchar state;                        /**< RTP state                      */
+
+    bool synced;                        /**< Playout clock has been set     */
+    bool played;                        /**< A packet has been read         */
+    uint basets;                        /**< Timestamp playing at basetime  */
+    ulong basetime;                     /**< ms clock when basets arrived   */
+    uint delay;                         /**< Playout delay in ms            */
+    uint lastts;                        /**< Timestamp last read            */
+    ushort lastseq;                     /**< Sequence number last read      */
+
+    ulong late;                         /**< Dropped, arrived after playout */
+    ulong dups;                         /**< Dropped, already held          */
+    ulong overruns;                     /**< Dropped, buffer full           */
+
+    struct udp *rtcpptr;                /**< UDP device carrying RTCP       */
+    ulong rtcpnext;                     /**< ms clock time of next report   */
+    ulong sentpkts;                     /**< Packets sent                   */
+    ulong sentoctets;                   /**< Payload octets sent            */
+
+    /* The remote source, kept as in RFC 3550 appendix A */
+    bool rvalid;                        /**< A packet has arrived           */
+    uint rssrc;                         /**< Its synchronization source     */
+    ushort maxseq;                      /**< Highest sequence number        */
+    uint cycles;                        /**< Sequence wraps, times 65536    */
+    uint baseseq;                       /**< First sequence number          */
+    ulong received;                     /**< Packets received               */
+    ulong expprior;                     /**< Expected at last report        */
+    ulong recvprior;                    /**< Received at last report        */
+    uint transit;                       /**< Relative transit time          */
+    uint jitter;                        /**< Interarrival jitter, times 16  */
+    uint lsr;                           /**< Middle of its last SR time     */
+    ulong lsrtime;                      /**< ms clock when that SR arrived  */
+
+    /* What the remote reports about our stream */
+    uchar rfraction;                    /**< Fraction lost, of 256          */
+    uint rlost;                         /**< Cumulative packets lost        */
+    uint rjitter;                       /**< Jitter, timestamp units        */
+    uint rtt;                           /**< Round trip time in ms          */
 };
 
 extern struct rtp rtptab[];
 
+/**
+ * Milliseconds since boot, the clock playout times are kept in.  Callers
+ * disable interrupts so clktime and clkticks are read together.
+ */
+#define rtpClock() \
+    (clktime * 1000 + clkticks * 1000 / CLKTICKS_PER_SEC)
+
+/** ms clock time at which a packet with timestamp ts is due for playout */
+#define rtpDue(rtpptr, ts) \
+    ((rtpptr)->basetime + (rtpptr)->delay + \
+     (long)((ts) - (rtpptr)->basets) / RTP_TSPERMS)
+
+/** Middle 32 bits of the NTP timestamp for t ms, as used by RTCP */
+#define rtcpNtpMid(t) \
+    ((((t) / 1000) << 16) | ((((t) % 1000) << 16) / 1000))
+
+/** Packets expected from the remote source, from its sequence numbers */
+#define rtpExpected(rtpptr) \
+    ((rtpptr)->cycles + (rtpptr)->maxseq - (rtpptr)->baseseq + 1)
+
+/** @} */
+
 /* Function Prototypes */
 devcall rtpInit(device *);
 devcall rtpOpen(device *, va_list);
 devcall rtpClose(device *);
 devcall rtpRead(device *, void *, uint);
-devcall rtpWrite(device *, void *, uint);
+struct rtpBuf *rtpReadbuf(int);
+devcall rtpWrite(device *, const void *, uint);
+devcall rtpControl(device *, int, long, long);
 ushort rtpAlloc(void);
-syscall rtpRecv(struct packet *, struct netaddr *, struct netaddr *);
-syscall rtpSend(struct rtp *, ushort, void *);
-struct rtpPkt *rtpGetbuf(struct rtp *);
-syscall rtpFreebuf(struct rtpPkt *);
+struct rtp *rtpDemux(const struct udp *);
+syscall rtpRecv(struct rtp *, struct packet *);
+syscall rtcpRecv(struct rtp *, struct packet *);
+syscall rtcpReport(struct rtp *);
+syscall rtpSend(struct rtp *, ushort, const void *);
+struct rtpBuf *rtpGetbuf(struct rtp *);
+syscall rtpFreebuf(struct rtpBuf *);
 
 #endif                          /* __ASSEMBLER__ */
 
@@ -11,13 +11,14 @@
 
 #include <stddef.h>
 #include <conf.h>
+#include <tlb.h>
 
-#define PAGE_SIZE 4096
+#define PAGE_SIZE (1 << PAGE_SHIFT)
 
 /** Round a memory address to the upper page boundary */
-#define roundpage(x) ((4095 + (uint)(x)) & ~0x0FFF)
+#define roundpage(x) ((PAGE_SIZE - 1 + (uint)(x)) & ~(PAGE_SIZE - 1))
 /** Truncate a memory address to the lower page boundary */
-#define truncpage(x) ((uint)(x) & ~0x0FFF)
+#define truncpage(x) ((uint)(x) & ~(PAGE_SIZE - 1))
 
 /* Region allocator */
 
@@ -55,6 +56,11 @@ void memRegionReclaim(tid_typ);
 #define ENT_WRITE   0x04 /**< Page table entry is writable          */
 #define ENT_ALL     (ENT_WRITE | ENT_PRESENT | ENT_GLOBAL)
 #define ENT_USER    (ENT_WRITE | ENT_PRESENT)
+#define ENT_ZERO    0x100 /**< Zero page when first touched, not now */
+
+/* Page table entry flags */
+#define PG_ZERO     0x01 /**< Page not yet touched, zero on fault   */
+#define PG_COW      0x02 /**< Page shared read only with sharer     */
 
 /**
  * Page table entry
@@ -62,13 +68,31 @@ void memRegionReclaim(tid_typ);
 struct pgtblent
 {
     int entry;                      /**< 0: TLB entry (frame and attr) */
-    char resv[3];                   /**< 4: reserved space             */
+    uchar flags;                    /**< 4: demand-zero, copy-on-write */
+    char sharer;                    /**< 5: thread sharing page        */
+    char resv;                      /**< 6: reserved space             */
     char asid;                      /**< 7: address space identifier   */
 };
 
 extern struct pgtblent *pgtbl;      /**< system page table */
 extern uint pgtbl_nents;            /**< number of pages in page table */
 
+/*
+ * Each thread that maps user heap pages also has its own table of
+ * EntryLo values covering the heap, so a TLB refill needs no ownership
+ * check.  Tables are indexed by page number less twice asidbase.
+ */
+extern ulong *asidtab[];            /**< page table of each thread      */
+extern ulong *asidcurr;             /**< page table of current thread   */
+extern uint asidbase;               /**< first page pair of user heap   */
+extern uint asidpairs;              /**< page pairs in user heap        */
+
+/* Page fault statistics */
+extern ulong safefaults;            /**< faults resolved by safeFault   */
+extern ulong safezeromaps;          /**< pages mapped demand-zero       */
+extern ulong safezerofills;         /**< demand-zero pages touched      */
+extern ulong safecowcopies;         /**< pages copied to end sharing    */
+
 /* Prototypes for memory protection functions */
 void safeInit(void);
 int safeMap(void *, short);
@@ -76,5 +100,59 @@ int safeMapRange(void *, uint, short);
 int safeUnmap(void *);
 int safeUnmapRange(void *, uint);
 void safeKmapInit(void);
+ulong *safeAsidTable(tid_typ);
+void safeAsidFree(tid_typ);
+int safeShare(void *, tid_typ);
+int safeFault(uint, bool);
+
+/* Shared buffer rings */
+
+/**
+ * Control page at the start of a shared ring.  The producer fills slots
+ * and advances head; the consumer drains them and advances tail.  Both
+ * count forever and are reduced modulo nslots only to index a slot.
+ */
+struct memringhdr
+{
+    volatile uint head;         /**< slots filled, written by producer  */
+    volatile uint tail;         /**< slots drained, written by consumer */
+    uint nslots;                /**< number of slots, a power of two    */
+    uint slotsize;              /**< bytes per slot, length included    */
+    volatile uint drops;        /**< frames dropped while ring was full */
+};
+
+/**
+ * Slot of a shared ring, holding len bytes of data.
+ */
+struct memslot
+{
+    uint len;                   /**< bytes of data in slot              */
+    uchar data[1];              /**< first byte of data                 */
+};
+
+/** Slot n of the ring whose control page is at hdr */
+#define memringslot(hdr, n) \
+    ((struct memslot *)((uint)(hdr) + PAGE_SIZE \
+                        + ((n) & ((hdr)->nslots - 1)) * (hdr)->slotsize))
+
+/**
+ * Kernel side of a shared ring.  The control page is writable by the
+ * consumer, so the kernel keeps its own copy of everything it indexes by.
+ */
+struct memring
+{
+    struct memregion *region;   /**< memory holding the ring            */
+    struct memringhdr *kern;    /**< uncached kernel view of ring       */
+    struct memringhdr *user;    /**< consumer's view of ring            */
+    uint head;                  /**< slots filled                       */
+    uint nslots;                /**< number of slots                    */
+    uint slotsize;              /**< bytes per slot                     */
+};
+
+/* Prototypes for shared buffer rings */
+int memRingAlloc(struct memring *, uint, uint);
+int memRingPut(struct memring *, const void *, uint);
+bool memRingEmpty(struct memring *);
+void memRingFree(struct memring *);
 
 #endif                          /* _SAFEMEM_H_ */
@@ -24,6 +24,9 @@ struct sement                   /* semaphore table entry      */
     char state;                 /**< the state SFREE or SUSED */
     int count;                  /**< count for this semaphore */
     qid_typ queue;              /**< requires queue.h.        */
+    bool mutex;                 /**< TRUE for a mutex         */
+    tid_typ owner;              /**< thread holding a mutex   */
+    int ceiling;                /**< priority ceiling, or 0   */
 };
 
 extern struct sement semtab[];
@@ -36,7 +39,9 @@ syscall wait(semaphore);
 syscall signal(semaphore);
 syscall signaln(semaphore, int);
 semaphore semcreate(int);
+semaphore mutexcreate(int);
 syscall semfree(semaphore);
 syscall semcount(semaphore);
+syscall semtake(semaphore, int);
 
 #endif                          /* _SEMAPHORE_H */
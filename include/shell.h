@@ -84,6 +84,7 @@ extern ulong ncommand;               /**< number of commands in table   */
 thread shell(int, int, int);
 short lexan(char *, ushort, char *, char *[]);
 shellcmd xsh_arp(int, char *[]);
+shellcmd xsh_bench(int, char *[]);
 shellcmd xsh_clear(int, char *[]);
 shellcmd xsh_dumptlb(int, char *[]);
 shellcmd xsh_date(int, char *[]);
@@ -97,6 +98,7 @@ shellcmd xsh_kill(int, char *[]);
 shellcmd xsh_led(int, char *[]);
 shellcmd xsh_memdump(int, char *[]);
 shellcmd xsh_memstat(int, char *[]);
+shellcmd xsh_mutexstat(int, char *[]);
 shellcmd xsh_nc(int, char *[]);
 shellcmd xsh_netstat(int, char *[]);
 shellcmd xsh_netup(int, char *[]);
@@ -105,10 +107,12 @@ shellcmd xsh_netdown(int, char *[]);
 shellcmd xsh_nvram(int, char *[]);
 shellcmd xsh_ping(int, char *[]);
 shellcmd xsh_pktgen(int, char *[]);
+shellcmd xsh_prof(int, char *[]);
 shellcmd xsh_ps(int, char *[]);
 shellcmd xsh_rdate(int, char *[]);
 shellcmd xsh_reset(int, char *[]);
 shellcmd xsh_route(int, char *[]);
+shellcmd xsh_rtpstat(int, char *[]);
 shellcmd xsh_sleep(int, char *[]);
 shellcmd xsh_snoop(int, char *[]);
 shellcmd xsh_tar(int, char *[]);
@@ -118,6 +122,7 @@ shellcmd xsh_telnetserver(int, char *[]);
 shellcmd xsh_test(int, char *[]);
 shellcmd xsh_testsuite(int, char *[]);
 shellcmd xsh_timeserver(int, char *[]);
+shellcmd xsh_top(int, char *[]);
 shellcmd xsh_turtle(int, char *[]);
 shellcmd xsh_uartstat(int, char *[]);
 shellcmd xsh_udpstat(int, char *[]);
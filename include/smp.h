@@ -0,0 +1,88 @@
+/**
+ * @file smp.h
+ *
+ * Symmetric multiprocessing: per-processor state and the kernel lock.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _SMP_H_
+#define _SMP_H_
+
+/** Physical address the application processors start at.  It must be
+ * page aligned and below 1MB; the startup IPI carries it as a page number. */
+#define SMPBOOT_ADDR    0x8000
+
+/** Bytes of stack each application processor starts on  */
+#define SMPBOOT_STKSIZE 1024
+
+#ifndef __ASSEMBLER__
+
+#include <conf.h>
+#include <stddef.h>
+#include <queue.h>
+
+/** Number of processors the kernel is built for.  A platform that
+ * supports more than one defines NCPU in its xinu.conf.  */
+#ifndef NCPU
+#define NCPU 1
+#endif
+
+/* processor state constants */
+#define CPU_OFFLINE 0           /**< processor has not started          */
+#define CPU_ONLINE  1           /**< processor is running threads       */
+
+#if NCPU > 1
+
+/**
+ * Defines what an entry in the processor table looks like.  Each processor
+ * keeps the scheduler state that UP kernels keep in globals.
+ */
+struct cpuent
+{
+    struct cpuent *self;        /**< this entry, found by cpuself()     */
+    uint index;                 /**< index of this entry in cputab      */
+    uint state;                 /**< CPU_OFFLINE or CPU_ONLINE          */
+    uint apicid;                /**< interrupt controller id            */
+    tid_typ curtid;             /**< thread running on the processor    */
+    tid_typ idle;               /**< thread run when nothing is ready   */
+    qid_typ readyq;             /**< threads ready to run here          */
+    int defer;                  /**< >0 if rescheduling deferred        */
+    int nest;                   /**< >0 while in an interrupt handler   */
+    int lockdepth;              /**< times the kernel lock is held      */
+    ulong cpustamp;             /**< cycle count when last accounted    */
+    ulong nipi;                 /**< reschedule requests received       */
+    tid_typ fpu;                /**< thread owning floating point unit  */
+};
+
+extern struct cpuent cputab[];
+extern volatile uint ncpu;      /**< number of processors online        */
+
+/* The scheduler globals name the running processor's copies.  */
+#define thrcurrent (cpuself()->curtid)
+#define readylist  (cpuself()->readyq)
+#define resdefer   (cpuself()->defer)
+#define irqnest    (cpuself()->nest)
+
+/** Ready list of processor @p cpu */
+#define cpureadylist(cpu) (cputab[(cpu)].readyq)
+
+/* SMP function prototypes */
+struct cpuent *cpuself(void);
+uint getcpu(void);
+void smpinit(void);
+void smpstop(void);
+void smpresched(uint);
+void kernlock(void);
+void kernunlock(void);
+
+#else                           /* NCPU == 1 */
+
+#define ncpu 1
+#define getcpu() 0
+#define cpureadylist(cpu) (readylist)
+
+#endif                          /* NCPU > 1 */
+
+#endif                          /* __ASSEMBLER__ */
+
+#endif                          /* _SMP_H_ */
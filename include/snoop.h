@@ -11,8 +11,8 @@
 #include <arp.h>
 #include <ethernet.h>
 #include <ipv4.h>
-#include <mailbox.h>
 #include <network.h>
+#include <semaphore.h>
 #include <tcp.h>
 #include <udp.h>
 
@@ -48,6 +48,85 @@
 
 #define SNOOP_QLEN          100
 
+/* Filter program constants */
+#define SNOOP_PROG_LEN      48     /**< Max instructions in a filter   */
+
+/* Filter instruction classes, following classic BPF encoding */
+#define SNOOP_BPF_CLASS(code) ((code) & 0x07)
+#define SNOOP_BPF_LD        0x00   /**< Load accumulator               */
+#define SNOOP_BPF_LDX       0x01   /**< Load index register            */
+#define SNOOP_BPF_ALU       0x04   /**< Arithmetic on accumulator      */
+#define SNOOP_BPF_JMP       0x05   /**< Jump                           */
+#define SNOOP_BPF_RET       0x06   /**< Return capture length          */
+#define SNOOP_BPF_MISC      0x07   /**< Register transfer              */
+
+/* Load sizes */
+#define SNOOP_BPF_SIZE(code)  ((code) & 0x18)
+#define SNOOP_BPF_W         0x00   /**< 32-bit word                    */
+#define SNOOP_BPF_H         0x08   /**< 16-bit half word               */
+#define SNOOP_BPF_B         0x10   /**< Byte                           */
+
+/* Load modes */
+#define SNOOP_BPF_MODE(code)  ((code) & 0xe0)
+#define SNOOP_BPF_IMM       0x00   /**< Constant k                     */
+#define SNOOP_BPF_ABS       0x20   /**< Packet data at k               */
+#define SNOOP_BPF_IND       0x40   /**< Packet data at X + k           */
+#define SNOOP_BPF_LEN       0x80   /**< Packet length                  */
+#define SNOOP_BPF_MSH       0xa0   /**< X = 4 * (data[k] & 0xf)        */
+
+/* ALU and jump operations */
+#define SNOOP_BPF_OP(code)  ((code) & 0xf0)
+#define SNOOP_BPF_ADD       0x00
+#define SNOOP_BPF_SUB       0x10
+#define SNOOP_BPF_OR        0x40
+#define SNOOP_BPF_AND       0x50
+#define SNOOP_BPF_LSH       0x60
+#define SNOOP_BPF_RSH       0x70
+#define SNOOP_BPF_JA        0x00
+#define SNOOP_BPF_JEQ       0x10
+#define SNOOP_BPF_JGT       0x20
+#define SNOOP_BPF_JGE       0x30
+#define SNOOP_BPF_JSET      0x40
+
+/* Operand sources */
+#define SNOOP_BPF_SRC(code) ((code) & 0x08)
+#define SNOOP_BPF_K         0x00   /**< Constant k                     */
+#define SNOOP_BPF_X         0x08   /**< Index register (ALU, JMP)      */
+#define SNOOP_BPF_A         0x10   /**< Accumulator (RET)              */
+
+/* Register transfers */
+#define SNOOP_BPF_MISCOP(code) ((code) & 0xf8)
+#define SNOOP_BPF_TAX       0x00   /**< X = A                          */
+#define SNOOP_BPF_TXA       0x80   /**< A = X                          */
+
+/** Build a filter instruction that does not jump */
+#define SNOOP_STMT(code, k)          { (code), 0, 0, (k) }
+/** Build a conditional filter jump */
+#define SNOOP_JUMP(code, k, jt, jf)  { (code), (jt), (jf), (k) }
+
+/**
+ * Filter instruction.  Programs are a subset of classic BPF without scratch
+ * memory: the filter returns the number of bytes of the packet to capture,
+ * 0 to reject it.
+ */
+struct snoopInsn
+{
+    ushort code;                          /**< operation                    */
+    uchar jt;                             /**< instructions to skip if true */
+    uchar jf;                             /**< instructions to skip if false */
+    ulong k;                              /**< constant operand             */
+};
+
+/**
+ * Slot of the capture ring.  A captured packet is stored as a packet
+ * structure followed by up to slotcap bytes of data.
+ */
+struct snoopSlot
+{
+    volatile bool full;                   /**< slot holds a packet          */
+    struct packet pkt;                    /**< captured packet              */
+};
+
 struct snoop
 {
     uint caplen;                          /**< bytes of packet to capture   */
@@ -59,7 +138,17 @@ struct snoop
     struct netaddr dstaddr;               /**< destination address of pkts  */
     ushort dstport;                       /**< destination port of packets  */
 
-    mailbox queue;                        /**< mailbox for queueing packets */
+    struct snoopInsn prog[SNOOP_PROG_LEN]; /**< compiled filter program     */
+    uint proglen;                         /**< length of program, 0 if none */
+
+    uchar *ring;                          /**< ring of captured packets     */
+    uint nslots;                          /**< number of slots in ring      */
+    uint slotlen;                         /**< bytes from slot to slot      */
+    uint slotcap;                         /**< packet bytes held per slot   */
+    volatile uint head;                   /**< slots claimed by capturers   */
+    volatile uint published;              /**< claimed slots now filled     */
+    volatile uint tail;                   /**< slots released by reader     */
+    semaphore ready;                      /**< count of filled slots        */
 
     uint ncap;
     uint nmatch;
@@ -70,7 +159,11 @@ struct snoop
 /* Function prototypes */
 int snoopCapture(struct snoop *cap, struct packet *pkt);
 int snoopClose(struct snoop *cap);
+int snoopCompile(struct snoop *cap);
 bool snoopFilter(struct snoop *cap, struct packet *pkt);
+uint snoopFilterRun(const struct snoopInsn *prog, uint proglen,
+                    const uchar *data, uint len);
+int snoopFree(struct snoop *cap, struct packet *pkt);
 int snoopOpen(struct snoop *cap, char *devname);
 int snoopPrint(struct packet *pkt, char dump, char verbose);
 int snoopPrintArp(struct arpPkt *arp, char verbose);
@@ -7,6 +7,7 @@
 #define _STDIO_H_
 
 #include <compiler.h>
+#include <conf.h>
 #include <stdarg.h>
 #include <thread.h>  /* For thrtab and thrcurrent. */
 
@@ -29,6 +30,37 @@
  * Standard error  */
 #define stderr ((thrtab[thrcurrent]).fdesc[2])
 
+/* Buffering modes for setvbuf()  */
+#define _IONBF      0   /**< unbuffered, the default            */
+#define _IOLBF      1   /**< flushed at each newline            */
+#define _IOFBF      2   /**< flushed when the buffer fills      */
+
+/** Size of buffer used by the formatted output functions */
+#define BUFSIZ      128
+
+/**
+ * @ingroup libxc
+ *
+ * Output buffer of a device, set up with setvbuf().
+ */
+struct iobuf
+{
+    char *buf;          /**< buffer, NULL if unbuffered         */
+    uint size;          /**< size of buffer in bytes            */
+    uint len;           /**< bytes waiting to be written        */
+    int mode;           /**< _IONBF, _IOLBF or _IOFBF           */
+    semaphore lock;     /**< serializes use of the buffer       */
+    bool haslock;       /**< lock has been created              */
+};
+
+extern struct iobuf _iobtab[];
+
+/* Output buffering  */
+int setvbuf(int dev, char *buf, int mode, size_t size);
+int fflush(int dev);
+int _ioflush(int dev);
+int _iowrite(int dev, const char *buf, uint len);
+
 /* Formatted input  */
 int _doscan(const char *fmt, va_list ap,
             int (*getch) (int, int), int (*ungetch) (int, int),
@@ -48,6 +80,7 @@ int _doprnt(const char *format, va_list,
 	    int (*putc_func)(int, int), int putc_arg);
 
 int fprintf(int dev, const char *format, ...) __printf_format(2, 3);
+int vfprintf(int dev, const char *format, va_list ap);
 int printf(const char *format, ...) __printf_format(1, 2);
 int sprintf(char *str, const char *format, ...) __printf_format(2, 3);
 
@@ -15,6 +15,10 @@ long atol(const char *nptr);
 void bzero(void *s, size_t n);
 void qsort(void *base, size_t nmemb, size_t size,
            int (*compar)(const void *, const void*));
+int mergesort(void *base, size_t nmemb, size_t size,
+              int (*compar)(const void *, const void *));
+void *bsearch(const void *key, const void *base, size_t nmemb, size_t size,
+              int (*compar)(const void *, const void *));
 int rand(void);
 void srand(unsigned int seed);
 void *malloc(size_t size);
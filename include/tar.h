@@ -12,6 +12,14 @@
 #define TAR_FILESIZE_LEN  12
 #define TAR_FILESIZE_BASE 8
 #define TAR_FILENAME_LEN  100
+#define TAR_PREFIX_LEN    155
+#define TAR_BLOCK_SIZE    512
+
+/** longest path name (ustar prefix + '/' + name) held in a tar index */
+#define TAR_PATH_LEN      (TAR_PREFIX_LEN + 1 + TAR_FILENAME_LEN)
+
+/** number of hash chains in a tar index */
+#define TAR_NHASH         64
 
 struct ustar
 {
@@ -55,10 +63,46 @@ struct tar
 #define TAR_LINK_DIR    '5'
 #define TAR_LINK_FIFO   '6'
 
+/**
+ * Entry in a tar index, describing one member of the archive.
+ */
+struct tarentry
+{
+    char *name;                 /**< full path name, no trailing '/'    */
+    uint namelen;               /**< length of name                     */
+    uint offset;                /**< offset of header in archive        */
+    uint size;                  /**< size of member data in bytes       */
+    char typeflag;              /**< TAR_LINK_* type of member          */
+    struct tarentry *next;      /**< next entry in hash chain           */
+};
+
+/**
+ * Index of a tar archive built by tarIndexCreate().  Entries are kept
+ * sorted by name for prefix lookups and chained by hash for exact
+ * lookups.
+ */
+struct tarindex
+{
+    struct tar *archive;        /**< archive this index describes       */
+    uint nentries;              /**< number of entries in index         */
+    uint length;                /**< size of index allocation           */
+    struct tarentry *entries;   /**< entries sorted by name             */
+    struct tarentry *hash[TAR_NHASH];   /**< exact name lookup chains   */
+};
+
 /* function prototypes */
 int tarListFiles(struct tar *, char *, int);
 struct tar *tarGetFile(struct tar *, char *);
 int tarGetFilesize(struct tar *);
 int tarGetData(struct tar *, char *, uint);
+int tarFilesize(char *);
+
+struct tarindex *tarIndexCreate(struct tar *);
+syscall tarIndexFree(struct tarindex *);
+struct tarentry *tarIndexLookup(struct tarindex *, const char *);
+int tarIndexPrefix(struct tarindex *, const char *, struct tarentry **,
+                   int);
+int tarIndexDir(struct tarindex *, const char *, struct tarentry **, int);
+void *tarIndexData(struct tarindex *, struct tarentry *);
 
 #endif                          /* _TAR_H_ */
@@ -11,6 +11,7 @@
 #include <conf.h>
 #include <ethernet.h>
 #include <ipv4.h>
+#include <kmutex.h>
 #include <semaphore.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -242,7 +243,7 @@ struct tcpEvent
 };
 
 extern struct tcpEvent tcptimertab[];
-extern semaphore tcpmutex;
+extern kmutex tcpmutex;
 
 /* TCP Control Functions */
 #define TCP_CTRL_RECVBYTES 2 /**< Get number of bytes recevied */
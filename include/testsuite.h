@@ -18,6 +18,8 @@ thread test_semaphore(bool);
 thread test_semaphore2(bool);
 thread test_semaphore3(bool);
 thread test_semaphore4(bool);
+thread test_mutex(bool);
+thread test_kmutex(bool);
 thread test_procQueue(bool);
 thread test_deltaQueue(bool);
 thread test_libStdio(bool);
@@ -45,6 +47,8 @@ thread test_raw(bool);
 thread test_ip(bool);
 thread test_umemory(bool);
 thread test_tlb(bool);
+thread test_workpool(bool);
+thread test_fpu(bool);
 
 void testPass(bool, const char *);
 void testFail(bool, const char *);
@@ -12,7 +12,9 @@
 #include <semaphore.h>
 #include <debug.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <memory.h>
+#include <smp.h>
 #endif /* __ASSEMBLER__ */
 
 /* unusual value marks the top of the thread stack                      */
@@ -58,6 +60,10 @@
 /** Maximum number of local devices */
 #define NLOCDEV     10
 
+/* message passing constants */
+#define MSGWORD     0           /**< type of a message from send()      */
+#define MSGQDEPTH   1           /**< message queue depth from create()  */
+
 /* Expose sizeof(struct thrent) and offsetof(struct thrent, stkdiv) to 
  * assembly files. */
 #define THRENTSIZE 148
@@ -65,13 +71,25 @@
 
 #ifndef __ASSEMBLER__
 
+/**
+ * Defines what an entry in a thread's message queue looks like.  Messages
+ * from send() carry a word; messages from sendbuf() hand over a buffer.
+ */
+struct msgent
+{
+    int type;                   /**< MSGWORD or type given to sendbuf() */
+    message msg;                /**< message word                       */
+    void *buf;                  /**< buffer handed to the receiver      */
+    uint len;                   /**< length of buffer in bytes          */
+};
+
 /**
  * Defines what an entry in the thread table looks like.
  */
 struct thrent
 {
     uchar state;                /**< thread state: THRCURR, etc.        */
-    int prio;                   /**< thread priority                    */
+    int prio;                   /**< effective thread priority          */
     void *stkptr;               /**< saved stack pointer                */
     void *stkbase;              /**< base of run time stack             */
     ulong stklen;               /**< stack length in bytes              */
@@ -79,34 +97,66 @@ struct thrent
     irqmask intmask;            /**< saved interrupt mask               */
     semaphore sem;              /**< semaphore waiting for              */
     tid_typ parent;             /**< tid for the parent thread          */
-    message msg;                /**< message sent to this thread        */
-    bool hasmsg;                /**< nonzero iff msg is valid           */
+    struct msgent *msgq;        /**< queue of messages sent to thread   */
+    uint msgmax;                /**< capacity of message queue          */
+    uint msghead;               /**< index of oldest queued message     */
+    uint msgcount;              /**< number of queued messages          */
+    struct msgent msgslot;      /**< queue storage when msgmax is 1     */
     struct memblock memlist;    /**< free memory list of thread         */
     int fdesc[NDESC];           /**< device descriptors for thread      */
+    int basprio;                /**< priority before any inheritance    */
+    uint64_t cpucycles;         /**< cycles spent running thread        */
+    ulong nswitch;              /**< times thread was switched to       */
+    ulong nvolun;               /**< times thread blocked               */
+    ulong ninvol;               /**< times preempted while runnable     */
+    uint cpu;                   /**< processor the thread runs on       */
+    void *fpuctx;               /**< saved floating point registers     */
 };
 
 extern struct thrent thrtab[];
 extern int thrcount;            /**< currently active threads           */
+#if !(NCPU > 1)
 extern tid_typ thrcurrent;      /**< currently executing thread         */
+extern int resdefer;            /**< >0 if rescheduling deferred        */
+extern int irqnest;             /**< >0 while in an interrupt handler   */
+#endif
+extern uint64_t irqcycles;      /**< cycles spent in interrupt handlers */
+extern ulong irqcount;          /**< number of interrupts taken         */
+extern ulong irqpc;             /**< address the last interrupt hit     */
 
 /* Inter-Thread Communication prototypes */
 syscall send(tid_typ, message);
 message receive(void);
 message recvclr(void);
 message recvtime(int);
+syscall sendbuf(tid_typ, int, void *, uint);
+syscall recvbuf(int *, void **, uint *);
+syscall recvbuftime(int, int *, void **, uint *);
+syscall msgput(tid_typ, const struct msgent *);
+syscall msgtake(bool, int, struct msgent *);
 
 /* Thread management function prototypes */
 
 tid_typ create(void *procaddr, uint ssize, int priority,
                const char *name, int nargs, ...);
+tid_typ createq(void *procaddr, uint ssize, int priority, uint msgdepth,
+                const char *name, int nargs, ...);
 tid_typ gettid(void);
 syscall getprio(tid_typ);
+syscall chprio(tid_typ, int);
+syscall setcpu(tid_typ, uint);
 syscall kill(int);
 int ready(tid_typ, bool);
 int resched(void);
 syscall sleep(uint);
 syscall unsleep(tid_typ);
 syscall yield(void);
+void prioinherit(tid_typ, int);
+ulong cyclecount(void);
+void cpuaccount(void);
+void irqenter(void);
+void irqexit(void);
+void priorecompute(tid_typ);
 
 /**
  * @ingroup threads
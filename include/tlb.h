@@ -13,10 +13,30 @@
 #define TLB_EXC_START  (void *)0x80000000 /**< TLB entry vector        */
 #define TLB_EXC_LENGTH (32 * 4)           /**< 32, 4-byte instructions */
 
+/**
+ * Log2 of the page size: 12 (4KB), 14 (16KB), 16 (64KB), 18 (256KB) or
+ * 20 (1MB).  Larger pages let each TLB entry cover more of the kernel and
+ * user heaps at the cost of coarser protection; build with -DPAGE_SHIFT
+ * to change it.
+ */
+#ifndef PAGE_SHIFT
+#define PAGE_SHIFT 12
+#endif
+
+/** PageMask register value for pages of 1 << PAGE_SHIFT bytes */
+#define TLB_PAGEMASK ((((1 << PAGE_SHIFT) - 1) & ~0xFFF) << 1)
+
+#define ENTRYLO_UNCACHED 0x10             /**< uncached coherency attr */
+
 #ifndef __ASSEMBLER__
 
+extern ulong tlbrefills;    /**< misses refilled by tlbMiss         */
+extern ulong tlbslowmiss;   /**< misses handled by tlbMissHandler   */
+extern ulong tlbfaults;     /**< protection violations              */
+
 void tlbInit(void);
-void tlbMissHandler(int, int *);
+void tlbMissHandler(int, int *, int);
+void tlbFlush(void *, tid_typ);
 void dumptlb(void);
 
 #endif                          /* __ASSEMBLER__ */
@@ -41,6 +61,19 @@ void dumptlb(void);
 #define TLBREC_S8   84
 #define TLBREC_S9   88
 #define TLBREC_RA   92
-#define TLBREC_SIZE 96
+#define TLBREC_T0   96
+#define TLBREC_T1   100
+#define TLBREC_T2   104
+#define TLBREC_T3   108
+#define TLBREC_T4   112
+#define TLBREC_T5   116
+#define TLBREC_T6   120
+#define TLBREC_T7   124
+#define TLBREC_T8   128
+#define TLBREC_T9   132
+#define TLBREC_LO   136
+#define TLBREC_HI   140
+#define TLBREC_EPC  144
+#define TLBREC_SIZE 152
 
 #endif                          /* _TLB_H_ */
@@ -12,6 +12,7 @@
 #include <stddef.h>
 
 #define TTY_IBLEN           1024 /**< input buffer length               */
+#define TTY_OCHUNK          64   /**< cooked output passed per write    */
 
 /* TTY input flags */
 #define TTY_IRAW            0x01 /**< read unbuffered and uncooked      */
@@ -16,6 +16,10 @@
 
 #define UART_BAUD       115200  /**< Default console baud rate.         */
 
+/* Default FIFO interrupt trigger levels, in bytes */
+#define UART_RXTRIG     8       /**< interrupt when this many received  */
+#define UART_TXTRIG     2       /**< interrupt when this few to send    */
+
 /**
  * UART control block
  */
@@ -33,6 +37,10 @@ struct uart
     uint iirq;                  /**< Input IRQ count                    */
     uint oirq;                  /**< Output IRQ count                   */
 
+    /* Hardware FIFO interrupt trigger levels */
+    uchar rxtrig;               /**< Receive FIFO trigger level, bytes  */
+    uchar txtrig;               /**< Transmit FIFO trigger level, bytes */
+
     /* UART input fields */
     uchar iflags;               /**< Input flags                        */
     semaphore isema;            /**< Count of input bytes ready         */
@@ -66,6 +74,10 @@ extern struct uart uarttab[];
 #define UART_CTRL_CLR_OFLAG   0x0014 /**< clear output flags            */
 #define UART_CTRL_GET_OFLAG   0x0015 /**< get output flags              */
 #define UART_CTRL_OUTPUT_IDLE 0x0016 /**< determine if transmit idle    */
+#define UART_CTRL_SET_RXTRIG  0x0017 /**< set receive FIFO trigger      */
+#define UART_CTRL_GET_RXTRIG  0x0018 /**< get receive FIFO trigger      */
+#define UART_CTRL_SET_TXTRIG  0x0019 /**< set transmit FIFO trigger     */
+#define UART_CTRL_GET_TXTRIG  0x001A /**< get transmit FIFO trigger     */
 
 /* Driver functions */
 devcall uartInit(device *);
@@ -91,6 +103,24 @@ devcall uartHwInit(device *);
  */
 void uartHwPutc(void *, uchar);
 
+/**
+ * @ingroup uarthardware
+ *
+ * Immediately put as many characters into the UART's transmit FIFO as it
+ * has room for, without waiting, and return how many were put.  Zero means
+ * the transmitter is busy and will interrupt once it needs more data.
+ */
+uint uartHwFill(void *, const uchar *, uint);
+
+/**
+ * @ingroup uarthardware
+ *
+ * Program the UART's receive and transmit FIFO interrupt trigger levels.
+ * Each level, in bytes, is rounded down to one the hardware supports and
+ * the result stored back.
+ */
+void uartHwTrigger(void *, uchar *, uchar *);
+
 /**
  * @ingroup uarthardware
  *
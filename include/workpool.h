@@ -0,0 +1,72 @@
+/**
+ * @file workpool.h
+ *
+ * A pool of worker threads that runs functions submitted to it.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _WORKPOOL_H_
+#define _WORKPOOL_H_
+
+#include <stddef.h>
+#include <conf.h>
+#include <semaphore.h>
+#include <thread.h>
+
+#ifndef NWORK
+#define NWORK       32          /**< work submitted and not yet joined  */
+#endif
+#ifndef NWORKER
+#define NWORKER     8           /**< most worker threads in the pool    */
+#endif
+
+#define WORKER_STK  8192        /**< stack size of a worker thread      */
+#define WORKER_PRIO INITPRIO    /**< priority of a worker thread        */
+
+/* work states */
+#define WORK_FREE    0          /**< table entry is unused              */
+#define WORK_QUEUED  1          /**< waiting in a worker's deque        */
+#define WORK_RUNNING 2          /**< a worker is running the function   */
+#define WORK_DONE    3          /**< finished, result not yet joined    */
+
+/**
+ * Defines what an entry in the work table looks like.  A submitted
+ * function and its argument are kept here until the submitter joins the
+ * work, or until it finishes if the work is detached.
+ */
+struct workent
+{
+    uchar state;                /**< WORK_FREE, WORK_QUEUED, etc.       */
+    bool detached;              /**< entry freed when the work finishes */
+    int (*func) (void *);       /**< function to run                    */
+    void *arg;                  /**< argument passed to func            */
+    int result;                 /**< value func returned                */
+    semaphore done;             /**< signaled when func returns         */
+};
+
+/**
+ * Defines what an entry in the worker table looks like.  Each worker owns a
+ * deque of work: it pushes and pops work at the bottom, and idle workers
+ * steal the oldest work from the top.
+ */
+struct workerent
+{
+    tid_typ tid;                /**< worker thread                      */
+    uint top;                   /**< work is stolen from here           */
+    uint bottom;                /**< work is pushed and popped here     */
+    int deque[NWORK];           /**< work table indexes, mod NWORK      */
+};
+
+/** Identifies a submitted piece of work until it is joined */
+typedef int future;
+
+extern struct workent worktab[];
+extern struct workerent workertab[];
+
+/* Work pool function prototypes */
+syscall workInit(void);
+future workSubmit(int (*)(void *), void *);
+int workJoin(future);
+syscall workDetach(future);
+
+#endif                          /* _WORKPOOL_H_ */
@@ -0,0 +1,201 @@
+/**
+ * @file     ulawbulk.c
+ *
+ * Conversion of whole buffers between signed 16 bit linear samples and
+ * ulaw, giving the same results as linear2ulaw() and ulaw2linear().
+ *
+ * Decoding looks each byte up in a 256 entry table.  Encoding looks the
+ * magnitude up in a table indexed by its top 13 bits: the bias added by
+ * linear2ulaw() has its low two bits clear, so the low two bits of a
+ * sample never carry into the bits that select the exponent and mantissa.
+ * Both tables are built from the scalar routines on first use.
+ *
+ * On x86, encoding runs eight samples at a time in SSE2 registers when the
+ * processor has them.  The kernel switches SSE registers between threads
+ * (see system/fpu.c), so this must not be called from interrupt handlers.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <dsp.h>
+#include <fpu.h>
+#include <string.h>
+
+#define BIAS 0x84               /* add-in bias for 16 bit samples       */
+#define CLIP 32635              /* largest magnitude encoded            */
+
+#if USE_FPU && defined(_XINU_ARCH_X86_)
+#define ULAW_SSE2
+#define CPUID_SSE2 0x04000000   /* SSE2 present                         */
+#endif
+
+static short dectab[256];               /* ulaw byte to linear sample */
+static uchar enctab[(CLIP >> 2) + 1];   /* magnitude / 4 to ulaw byte */
+static bool tabready;
+#ifdef ULAW_SSE2
+static bool usesse2;
+static void ulawEncodeSse2(uchar *, const short *, uint);
+#endif
+
+/*
+ * Build the conversion tables.  Threads racing here build the same tables.
+ */
+static void ulawTables(void)
+{
+    int i;
+#ifdef ULAW_SSE2
+    ulong eax, ebx, ecx, edx;
+#endif
+
+    for (i = 0; i < 256; i++)
+    {
+        dectab[i] = ulaw2linear(i);
+    }
+    for (i = 0; i <= (CLIP >> 2); i++)
+    {
+        enctab[i] = linear2ulaw(i << 2);
+    }
+#ifdef ULAW_SSE2
+    asm volatile ("cpuid":"=a" (eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                  :"a"(1));
+    usesse2 = ((edx & CPUID_SSE2) != 0);
+#endif
+    tabready = TRUE;
+}
+
+/**
+ * Convert signed 16 bit linear samples to ulaw.
+ * @param dst n ulaw bytes
+ * @param src n linear samples
+ * @param n   number of samples
+ */
+void ulawEncode(uchar *dst, const short *src, uint n)
+{
+    int sample;
+    uchar ulawbyte;
+
+    if (!tabready)
+    {
+        ulawTables();
+    }
+#ifdef ULAW_SSE2
+    if (usesse2 && (n >= 8))
+    {
+        ulawEncodeSse2(dst, src, n & ~7);
+        dst += n & ~7;
+        src += n & ~7;
+        n &= 7;
+    }
+#endif
+
+    while (n-- > 0)
+    {
+        sample = *src++;
+        if (sample < 0)
+        {
+            sample = -sample;
+            if (sample > CLIP)
+            {
+                sample = CLIP;
+            }
+            /* Clear the sign bit, keeping the CCITT zero trap */
+            ulawbyte = enctab[sample >> 2] & 0x7F;
+            if (0 == ulawbyte)
+            {
+                ulawbyte = 0x02;
+            }
+        }
+        else
+        {
+            if (sample > CLIP)
+            {
+                sample = CLIP;
+            }
+            ulawbyte = enctab[sample >> 2];
+        }
+        *dst++ = ulawbyte;
+    }
+}
+
+/**
+ * Convert ulaw to signed 16 bit linear samples.
+ * @param dst n linear samples
+ * @param src n ulaw bytes
+ * @param n   number of samples
+ */
+void ulawDecode(short *dst, const uchar *src, uint n)
+{
+    if (!tabready)
+    {
+        ulawTables();
+    }
+
+    /* Unrolled so the loads of several bytes overlap */
+    while (n >= 4)
+    {
+        dst[0] = dectab[src[0]];
+        dst[1] = dectab[src[1]];
+        dst[2] = dectab[src[2]];
+        dst[3] = dectab[src[3]];
+        dst += 4;
+        src += 4;
+        n -= 4;
+    }
+    while (n-- > 0)
+    {
+        *dst++ = dectab[*src++];
+    }
+}
+
+#ifdef ULAW_SSE2
+
+typedef short v8hi __attribute__ ((vector_size(16)));
+typedef char v16qi __attribute__ ((vector_size(16)));
+
+/* Lanes of a where mask is set, else lanes of b */
+#define vsel(mask, a, b) (((a) & (mask)) | ((b) & ~(mask)))
+
+/* All lanes set to x */
+#define vdup(x) ((v8hi){ (x), (x), (x), (x), (x), (x), (x), (x) })
+
+/*
+ * Encode a multiple of eight samples the way linear2ulaw() does, with the
+ * exponent found by comparisons and the shift by it done in three steps.
+ */
+static void __attribute__ ((target("sse2")))
+    ulawEncodeSse2(uchar *dst, const short *src, uint n)
+{
+    v8hi s, neg, b, e, t, ulaw;
+    v16qi packed;
+
+    for (; n > 0; n -= 8, src += 8, dst += 8)
+    {
+        memcpy(&s, src, sizeof(s));
+
+        /* Clip before taking the magnitude, so -32768 cannot overflow */
+        s = vsel(s > vdup(CLIP), vdup(CLIP), s);
+        s = vsel(s < vdup(-CLIP), vdup(-CLIP), s);
+        neg = (s < vdup(0));
+        b = ((s ^ neg) - neg) + vdup(BIAS);
+
+        /* exponent: how many of 0x100, 0x200 .. 0x4000 b reaches */
+        e = -((b >= vdup(0x100)) + (b >= vdup(0x200)) + (b >= vdup(0x400))
+              + (b >= vdup(0x800)) + (b >= vdup(0x1000))
+              + (b >= vdup(0x2000)) + (b >= vdup(0x4000)));
+
+        /* mantissa: b >> (exponent + 3), low four bits */
+        t = b >> 3;
+        t = vsel(-(e & 1), t >> 1, t);
+        t = vsel(-((e >> 1) & 1), t >> 2, t);
+        t = vsel(-((e >> 2) & 1), t >> 4, t);
+
+        ulaw = ~((e << 4) | (t & 15)) & vdup(0xFF);
+        ulaw = vsel(neg, ulaw & vdup(0x7F), ulaw);
+        ulaw |= (ulaw == vdup(0)) & vdup(0x02);
+
+        packed = __builtin_ia32_packuswb128(ulaw, ulaw);
+        memcpy(dst, &packed, 8);
+    }
+}
+
+#endif                          /* ULAW_SSE2 */
@@ -0,0 +1,62 @@
+/**
+ * @file bsearch.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stdlib.h>
+
+/**
+ * @ingroup libxc
+ *
+ * Searches a sorted array for an element by binary search.
+ *
+ * @param key
+ *      Pointer to the element to search for.
+ * @param base
+ *      Pointer to the array to search, sorted in ascending order according to
+ *      @p compar.
+ * @param nmemb
+ *      Number of elements in the array.
+ * @param size
+ *      Size of each element in the array, in bytes.
+ * @param compar
+ *      Comparison callback function that is passed @p key and a pointer to an
+ *      element of the array.  It must return a negative value, 0, or a positive
+ *      value if the key is less than, equal to, or greater than the element,
+ *      respectively.
+ *
+ * @return
+ *      Pointer to an element of the array that compares equal to @p key, or
+ *      @c NULL if there is none.  If several elements compare equal, any of
+ *      them may be returned.
+ */
+void *bsearch(const void *key, const void *base, size_t nmemb, size_t size,
+              int (*compar)(const void *, const void *))
+{
+    const unsigned char *elem;
+    size_t lo, hi, mid;
+    int cmp;
+
+    lo = 0;
+    hi = nmemb;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        elem = (const unsigned char *)base + mid * size;
+        cmp = (*compar)(key, elem);
+        if (0 == cmp)
+        {
+            return (void *)elem;
+        }
+        else if (cmp < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return NULL;
+}
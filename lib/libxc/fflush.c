@@ -0,0 +1,81 @@
+/**
+ * @file fflush.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stdio.h>
+#include <device.h>
+
+/**
+ * @ingroup libxc
+ *
+ * Write out any output buffered for a device.
+ *
+ * @param dev
+ *      Index of the device to flush.
+ *
+ * @return
+ *      0 on success, or @c EOF on write error or invalid device.
+ */
+int fflush(int dev)
+{
+    struct iobuf *iob;
+    int ret;
+
+    if (isbaddev(dev))
+    {
+        return EOF;
+    }
+    iob = &_iobtab[dev];
+    if (_IONBF == iob->mode)
+    {
+        return 0;
+    }
+
+    wait(iob->lock);
+    ret = _ioflush(dev);
+    signal(iob->lock);
+    return (EOF == ret) ? EOF : 0;
+}
+
+/**
+ * @ingroup libxc
+ *
+ * Write the contents of a device's output buffer with a single call to
+ * write().  The caller must hold the buffer's lock.
+ *
+ * @param dev
+ *      Index of a buffered device.
+ *
+ * @return
+ *      0 on success, or @c EOF on write error, in which case the bytes not
+ *      written stay in the buffer.
+ */
+int _ioflush(int dev)
+{
+    struct iobuf *iob = &_iobtab[dev];
+    uint i;
+    int ret;
+
+    if (0 == iob->len)
+    {
+        return 0;
+    }
+
+    ret = write(dev, iob->buf, iob->len);
+    if (SYSERR == ret || EOF == ret)
+    {
+        return EOF;
+    }
+    if ((uint)ret < iob->len)
+    {
+        iob->len -= ret;
+        for (i = 0; i < iob->len; i++)
+        {
+            iob->buf[i] = iob->buf[i + ret];
+        }
+        return EOF;
+    }
+    iob->len = 0;
+    return 0;
+}
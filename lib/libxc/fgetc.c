@@ -23,6 +23,9 @@ int fgetc(int dev)
 {
     int c;
 
+    /* Show buffered output, such as a prompt, before waiting for input */
+    fflush(dev);
+
     c = getc(dev);
 
     if (c == SYSERR || c == EOF)
@@ -24,6 +24,17 @@
 int fputc(int c, int dev)
 {
     int ret;
+    char ch = c;
+
+    /* Buffered devices take the character into their buffer */
+    if (!isbaddev(dev) && (_IONBF != _iobtab[dev].mode))
+    {
+        if (EOF == _iowrite(dev, &ch, 1))
+        {
+            return EOF;
+        }
+        return (int)(unsigned char)c;
+    }
 
     ret = putc(dev, c);
     if (ret == SYSERR || ret == EOF)
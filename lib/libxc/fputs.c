@@ -4,11 +4,13 @@
 /* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
 #include <stdio.h>
+#include <string.h>
 
 /**
  * @ingroup libxc
  *
- * Writes a null-terminated string to a device.
+ * Writes a null-terminated string to a device with a single write, or into
+ * the device's output buffer if it has one.
  *
  * @param s
  *      The null terminated string to write.
@@ -20,12 +22,5 @@
  */
 int fputs(const char *s, int dev)
 {
-    for (; *s; s++)
-    {
-        if (fputc(*s, dev) == EOF)
-        {
-            return EOF;
-        }
-    }
-    return 0;
+    return _iowrite(dev, s, strlen(s));
 }
@@ -0,0 +1,80 @@
+/**
+ * @file iowrite.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stdio.h>
+#include <device.h>
+#include <string.h>
+
+/**
+ * @ingroup libxc
+ *
+ * Write bytes to a device through its output buffer, if it has one.  An
+ * unbuffered device gets a single call to write().
+ *
+ * @param dev
+ *      Index of the device to write to.
+ * @param buf
+ *      Bytes to write.
+ * @param len
+ *      Number of bytes to write.
+ *
+ * @return
+ *      0 on success, or @c EOF on write error or invalid device.
+ */
+int _iowrite(int dev, const char *buf, uint len)
+{
+    struct iobuf *iob;
+    uint n;
+    int ret;
+
+    if (isbaddev(dev))
+    {
+        return EOF;
+    }
+    if (0 == len)
+    {
+        return 0;
+    }
+
+    iob = &_iobtab[dev];
+    if (_IONBF == iob->mode)
+    {
+        ret = write(dev, buf, len);
+        return (SYSERR == ret || EOF == ret) ? EOF : 0;
+    }
+
+    wait(iob->lock);
+    if (_IONBF == iob->mode)
+    {
+        /* Buffering was turned off while waiting for the buffer */
+        signal(iob->lock);
+        ret = write(dev, buf, len);
+        return (SYSERR == ret || EOF == ret) ? EOF : 0;
+    }
+    ret = 0;
+    while (len > 0)
+    {
+        if ((iob->len == iob->size) && (EOF == _ioflush(dev)))
+        {
+            ret = EOF;
+            break;
+        }
+        n = iob->size - iob->len;
+        if (n > len)
+        {
+            n = len;
+        }
+        memcpy(iob->buf + iob->len, buf, n);
+        iob->len += n;
+        if ((_IOLBF == iob->mode) && (NULL != memchr(buf, '\n', n)))
+        {
+            ret = _ioflush(dev);
+        }
+        buf += n;
+        len -= n;
+    }
+    signal(iob->lock);
+    return ret;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file mergesort.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Runs of this many elements are insertion sorted before merging.  */
+#define MSORT_RUN   8
+
+static void merge(const unsigned char *src, unsigned char *dst,
+                  size_t left, size_t right, size_t size,
+                  int (*compar)(const void *, const void *));
+
+/**
+ * @ingroup libxc
+ *
+ * Sorts an array of data using a stable merge sort.  Elements that compare
+ * equal keep their original order.  The running time is O(n log n) in all
+ * cases, and the stack used is constant, but a temporary buffer the size of
+ * the array is taken from the kernel heap.
+ *
+ * @param base
+ *      Pointer to the array of data to sort.
+ * @param nmemb
+ *      Number of elements in the array.
+ * @param size
+ *      Size of each element in the array, in bytes.
+ * @param compar
+ *      Comparison callback function that is passed pointers to two elements in
+ *      the array.  It must return a negative value, 0, or a positive value if
+ *      the first element is less than, equal to, or greater than the second
+ *      element, respectively.
+ *
+ * @return
+ *      0 if the array was sorted, or -1 if the temporary buffer could not be
+ *      allocated, in which case the array is unchanged.
+ */
+int mergesort(void *base, size_t nmemb, size_t size,
+              int (*compar)(const void *, const void *))
+{
+    unsigned char *buf, *src, *dst, *tmp, *p1, *p2;
+    unsigned char *array = base;
+    size_t width, i, left, right, nbytes;
+    unsigned char c;
+
+    if (nmemb < 2 || 0 == size)
+    {
+        return 0;
+    }
+
+    nbytes = nmemb * size;
+    buf = memget(nbytes);
+    if (SYSERR == (int)buf)
+    {
+        return -1;
+    }
+
+    /* Insertion sort short runs in place.  An element moves only past
+     * strictly greater ones, which keeps the sort stable.  */
+    for (i = 0; i < nmemb; i += MSORT_RUN)
+    {
+        right = (nmemb - i < MSORT_RUN) ? nmemb - i : MSORT_RUN;
+        for (p1 = array + (i + 1) * size; p1 < array + (i + right) * size;
+             p1 += size)
+        {
+            for (p2 = p1; p2 > array + i * size
+                 && (*compar)(p2 - size, p2) > 0; p2 -= size)
+            {
+                for (tmp = p2 - size, left = 0; left < size; left++)
+                {
+                    c = tmp[left];
+                    tmp[left] = p2[left];
+                    p2[left] = c;
+                }
+            }
+        }
+    }
+
+    /* Merge pairs of runs, doubling the run width on each pass and moving
+     * the data back and forth between the array and the buffer.  */
+    src = array;
+    dst = buf;
+    for (width = MSORT_RUN; width < nmemb; width *= 2)
+    {
+        for (i = 0; i < nmemb; i += 2 * width)
+        {
+            left = (nmemb - i < width) ? nmemb - i : width;
+            right = (nmemb - i - left < width) ? nmemb - i - left : width;
+            merge(src + i * size, dst + i * size, left, right, size, compar);
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != array)
+    {
+        memcpy(array, src, nbytes);
+    }
+    memfree(buf, nbytes);
+    return 0;
+}
+
+/*
+ * Merges the sorted runs of @left and @right elements that start at @src into
+ * @dst.  On ties the element from the left run goes first.
+ */
+static void merge(const unsigned char *src, unsigned char *dst,
+                  size_t left, size_t right, size_t size,
+                  int (*compar)(const void *, const void *))
+{
+    const unsigned char *p1, *p2, *end1, *end2;
+
+    p1 = src;
+    end1 = src + left * size;
+    p2 = end1;
+    end2 = end1 + right * size;
+
+    /* Runs already in order are copied straight across.  */
+    if (0 == right || (*compar)(end1 - size, p2) <= 0)
+    {
+        memcpy(dst, src, (left + right) * size);
+        return;
+    }
+
+    while (p1 < end1 && p2 < end2)
+    {
+        if ((*compar)(p1, p2) <= 0)
+        {
+            memcpy(dst, p1, size);
+            p1 += size;
+        }
+        else
+        {
+            memcpy(dst, p2, size);
+            p2 += size;
+        }
+        dst += size;
+    }
+    memcpy(dst, p1, end1 - p1);
+    dst += end1 - p1;
+    memcpy(dst, p2, end2 - p2);
+}
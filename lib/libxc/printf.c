@@ -28,7 +28,7 @@ int printf(const char *format, ...)
     int ret;
 
     va_start(ap, format);
-    ret = _doprnt(format, ap, fputc, stdout);
+    ret = vfprintf(stdout, format, ap);
     va_end(ap);
 
     return ret;
@@ -5,16 +5,34 @@
 
 #include <stdlib.h>
 
-static size_t partition(void *base, size_t nmemb, size_t size,
-                        int (*compar)(const void *, const void*));
+/** Partitions of at most this many elements are insertion sorted.  */
+#define QSORT_INSERT    8
 
-static void swap_elements(void *p1, void *p2, size_t size);
+static void introsort(unsigned char *base, size_t nmemb, size_t size,
+                      int (*compar)(const void *, const void *),
+                      unsigned int depth, int words);
+
+static size_t partition(unsigned char *base, size_t nmemb, size_t size,
+                        int (*compar)(const void *, const void *), int words);
+
+static void insertion_sort(unsigned char *base, size_t nmemb, size_t size,
+                           int (*compar)(const void *, const void *),
+                           int words);
+
+static void heap_sort(unsigned char *base, size_t nmemb, size_t size,
+                      int (*compar)(const void *, const void *), int words);
+
+static void swap_elements(void *p1, void *p2, size_t size, int words);
 
 /**
  * @ingroup libxc
  *
- * Sorts an array of data using quicksort.  The average-case running time is O(n
- * log n) but the worst case running time is O(n^2).
+ * Sorts an array of data using introsort.  This is a quicksort that picks the
+ * median of the first, middle, and last elements as its pivot and insertion
+ * sorts small partitions.  If the partitioning goes badly for too long it
+ * switches to heapsort, so the worst-case running time is O(n log n).  Only the
+ * smaller side of each partition is sorted recursively, so the stack used is
+ * O(log n).  The sort is not stable; see mergesort() for a stable sort.
  *
  * @param base
  *      Pointer to the array of data to sort.
@@ -31,75 +49,216 @@ static void swap_elements(void *p1, void *p2, size_t size);
 void qsort(void *base, size_t nmemb, size_t size,
            int (*compar)(const void *, const void *))
 {
-    if (nmemb > 1)
+    unsigned int depth;
+    size_t n;
+    int words;
+
+    if (nmemb < 2 || 0 == size)
     {
-        /* Partition the array around a pivot element, then recurse on parts of
-         * the array before and after the pivot.  */
-        size_t pivot_index = partition(base, nmemb, size, compar);
-        qsort(base, pivot_index, size, compar);
-        qsort(base + (pivot_index + 1) * size, nmemb - (pivot_index + 1),
-              size, compar);
+        return;
+    }
+
+    /* Allow 2 * log2(nmemb) levels of partitioning before giving up on
+     * quicksort.  */
+    depth = 0;
+    for (n = nmemb; n > 1; n >>= 1)
+    {
+        depth += 2;
+    }
+
+    /* Swap a word at a time when every element is word aligned.  */
+    words = (0 == size % sizeof(long))
+        && (0 == (unsigned long)base % sizeof(long));
+
+    introsort(base, nmemb, size, compar, depth, words);
+}
+
+static void introsort(unsigned char *base, size_t nmemb, size_t size,
+                      int (*compar)(const void *, const void *),
+                      unsigned int depth, int words)
+{
+    size_t pivot_index, left, right;
+
+    while (nmemb > QSORT_INSERT)
+    {
+        if (0 == depth)
+        {
+            heap_sort(base, nmemb, size, compar, words);
+            return;
+        }
+        depth--;
+
+        /* Recurse on the smaller side of the pivot and loop on the larger
+         * side, so the recursion is never more than log2(nmemb) deep.  */
+        pivot_index = partition(base, nmemb, size, compar, words);
+        left = pivot_index;
+        right = nmemb - (pivot_index + 1);
+        if (left < right)
+        {
+            introsort(base, left, size, compar, depth, words);
+            base += (pivot_index + 1) * size;
+            nmemb = right;
+        }
+        else
+        {
+            introsort(base + (pivot_index + 1) * size, right, size, compar,
+                      depth, words);
+            nmemb = left;
+        }
     }
+
+    insertion_sort(base, nmemb, size, compar, words);
 }
 
 /*
- * Does quicksort partitioning on an array of length 2 or greater.  The first
- * element is taken to be the pivot.  The array is re-arranged so that all
- * elements before the pivot compare less than or equal to it and all elements
- * after the pivot compare greater than or equal to it.  The return value is the
+ * Does quicksort partitioning on an array of length 3 or greater.  The median
+ * of the first, middle, and last elements is taken to be the pivot.  The array
+ * is re-arranged so that all elements before the pivot compare less than or
+ * equal to it and all elements after the pivot compare greater than or equal
+ * to it.  Both scans stop on elements equal to the pivot, so arrays of many
+ * equal elements still split near the middle.  The return value is the
  * resulting 0-based index of the pivot.
  */
-static size_t partition(void *base, size_t nmemb, size_t size,
-                        int (*compar)(const void *, const void*))
+static size_t partition(unsigned char *base, size_t nmemb, size_t size,
+                        int (*compar)(const void *, const void *), int words)
 {
-    void *p1, *p2;
-    size_t p1_index = 1;
+    unsigned char *mid, *last, *p1, *p2;
 
-    /* Pivot is at @base.  */
-    p1 = base + size;
-    p2 = base + (nmemb * size);
-    do
+    /* Order the first, middle, and last elements, then move the median to
+     * the front to serve as the pivot.  The last element is then no less
+     * than the pivot, which stops the upward scan without a bounds check.  */
+    mid = base + (nmemb / 2) * size;
+    last = base + (nmemb - 1) * size;
+    if ((*compar)(mid, base) < 0)
     {
-        if ((*compar)(p1, base) <= 0)
+        swap_elements(mid, base, size, words);
+    }
+    if ((*compar)(last, mid) < 0)
+    {
+        swap_elements(last, mid, size, words);
+        if ((*compar)(mid, base) < 0)
+        {
+            swap_elements(mid, base, size, words);
+        }
+    }
+    swap_elements(base, mid, size, words);
+
+    p1 = base;
+    p2 = base + nmemb * size;
+    for (;;)
+    {
+        do
         {
-            /* Element at @p1 can go before pivot.  Continue onto next element.
-             * */
             p1 += size;
-            p1_index++;
+        } while ((*compar)(p1, base) < 0);
+
+        /* The pivot itself stops the downward scan.  */
+        do
+        {
+            p2 -= size;
+        } while ((*compar)(p2, base) > 0);
+
+        if (p1 >= p2)
+        {
+            break;
+        }
+        swap_elements(p1, p2, size, words);
+    }
+
+    /* Now all elements after @p2 compare greater than or equal to the pivot
+     * and the element at @p2 and all before it compare less than or equal.
+     * Finish by swapping the pivot into its final position.  */
+    swap_elements(base, p2, size, words);
+    return (p2 - base) / size;
+}
+
+/* Sorts a short array by insertion.  */
+static void insertion_sort(unsigned char *base, size_t nmemb, size_t size,
+                           int (*compar)(const void *, const void *),
+                           int words)
+{
+    unsigned char *p1, *p2, *end;
+
+    end = base + nmemb * size;
+    for (p1 = base + size; p1 < end; p1 += size)
+    {
+        for (p2 = p1; p2 > base && (*compar)(p2 - size, p2) > 0; p2 -= size)
+        {
+            swap_elements(p2 - size, p2, size, words);
+        }
+    }
+}
+
+/* Sorts an array by heapsort, used when partitioning degenerates.  */
+static void heap_sort(unsigned char *base, size_t nmemb, size_t size,
+                      int (*compar)(const void *, const void *), int words)
+{
+    size_t start, end, root, child;
+
+    /* Build a max-heap, then repeatedly move its root to the end of the
+     * array and sift the new root down into the shrunken heap.  */
+    start = nmemb / 2;
+    end = nmemb;
+    while (end > 1)
+    {
+        if (start > 0)
+        {
+            start--;
         }
         else
         {
-            /* Element at @p1 must go after pivot.  Swap it with the element at
-             * @p2, after decrementing @p2 so it points to the next element on
-             * the right end of the array.  Then, @p1 will be left unmodified so
-             * it points to the element that was previously at @p2.  */
-            p2 -= size;
-            swap_elements(p1, p2, size);
+            end--;
+            swap_elements(base, base + end * size, size, words);
         }
-    } while (p1 != p2);
-
-    /* Now, p1 == p2, and all elements left of @p1 compare less than or equal to
-     * the pivot, while all elements right of or at @p1 compare greater than or
-     * equal to the pivot.  Finish by swapping the pivot into its final position
-     * and returning its index.  */
-    p1 -= size;
-    p1_index--;
-    swap_elements(p1, base, size);
-    return p1_index;
+
+        for (root = start; (child = 2 * root + 1) < end; root = child)
+        {
+            if (child + 1 < end
+                && (*compar)(base + child * size,
+                             base + (child + 1) * size) < 0)
+            {
+                child++;
+            }
+            if ((*compar)(base + root * size, base + child * size) >= 0)
+            {
+                break;
+            }
+            swap_elements(base + root * size, base + child * size, size,
+                          words);
+        }
+    }
 }
 
-/* Swaps the two elements of the specified size, pointed to by @p1 and @p2.  */
-static void swap_elements(void *_p1, void *_p2, size_t size)
+/* Swaps the two elements of the specified size, pointed to by @p1 and @p2,
+ * a word at a time if @words is set.  */
+static void swap_elements(void *_p1, void *_p2, size_t size, int words)
 {
-    unsigned char *p1 = _p1;
-    unsigned char *p2 = _p2;
     size_t i;
-    unsigned char tmp;
 
-    for (i = 0; i < size; i++)
+    if (words)
     {
-        tmp = p1[i];
-        p1[i] = p2[i];
-        p2[i] = tmp;
+        long *p1 = _p1;
+        long *p2 = _p2;
+        long tmp;
+
+        for (i = 0; i < size / sizeof(long); i++)
+        {
+            tmp = p1[i];
+            p1[i] = p2[i];
+            p2[i] = tmp;
+        }
+    }
+    else
+    {
+        unsigned char *p1 = _p1;
+        unsigned char *p2 = _p2;
+        unsigned char tmp;
+
+        for (i = 0; i < size; i++)
+        {
+            tmp = p1[i];
+            p1[i] = p2[i];
+            p2[i] = tmp;
+        }
     }
 }
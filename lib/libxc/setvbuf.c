@@ -0,0 +1,100 @@
+/**
+ * @file setvbuf.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stdio.h>
+#include <device.h>
+
+/** Output buffers of the devices, all unbuffered to begin with */
+struct iobuf _iobtab[NDEVS];
+
+/**
+ * @ingroup libxc
+ *
+ * Set how output to a device is buffered.  Output to a line-buffered device
+ * is written whenever a newline is output, and output to a fully-buffered
+ * device only when the buffer fills or fflush() is called.  Any output
+ * already buffered is written first.  Output still buffered when a device is
+ * closed or its writer exits is lost unless fflush() is called.  A device's
+ * buffer lock is created the first time it is buffered and kept, so threads
+ * writing while buffering is turned off are not left waiting on a freed
+ * semaphore.
+ *
+ * @param dev
+ *      Index of the device whose output to buffer.
+ * @param buf
+ *      Buffer to hold output; must stay valid until the device is set back
+ *      to unbuffered.  Ignored for @c _IONBF.
+ * @param mode
+ *      @c _IONBF, @c _IOLBF, or @c _IOFBF.
+ * @param size
+ *      Size of @p buf in bytes.
+ *
+ * @return
+ *      0 on success, or @c EOF if @p dev or @p mode is invalid, @p buf is
+ *      missing, or buffered output could not be written.
+ */
+int setvbuf(int dev, char *buf, int mode, size_t size)
+{
+    struct iobuf *iob;
+
+    if (isbaddev(dev))
+    {
+        return EOF;
+    }
+    if ((_IONBF != mode) && ((_IOLBF != mode && _IOFBF != mode)
+                             || (NULL == buf) || (0 == size)))
+    {
+        return EOF;
+    }
+
+    iob = &_iobtab[dev];
+
+    /* Write out what is waiting in the old buffer before changing it */
+    if (_IONBF != iob->mode)
+    {
+        wait(iob->lock);
+        if (EOF == _ioflush(dev))
+        {
+            signal(iob->lock);
+            return EOF;
+        }
+        if (_IONBF == mode)
+        {
+            /* The lock is kept, since other threads may be waiting on it */
+            iob->mode = _IONBF;
+            iob->buf = NULL;
+            iob->size = 0;
+        }
+        else
+        {
+            iob->buf = buf;
+            iob->size = size;
+            iob->mode = mode;
+        }
+        signal(iob->lock);
+        return 0;
+    }
+
+    if (_IONBF == mode)
+    {
+        return 0;
+    }
+    if (!iob->haslock)
+    {
+        iob->lock = semcreate(1);
+        if (SYSERR == iob->lock)
+        {
+            return EOF;
+        }
+        iob->haslock = TRUE;
+    }
+    wait(iob->lock);
+    iob->buf = buf;
+    iob->size = size;
+    iob->len = 0;
+    iob->mode = mode;           /* last, so writers see a complete buffer */
+    signal(iob->lock);
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file vfprintf.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/* Formatted output collected before it is written to the device */
+struct prntbuf
+{
+    int dev;
+    uint len;
+    char buf[BUFSIZ];
+};
+
+static int prntbuf(int, int);
+
+/**
+ * @ingroup libxc
+ *
+ * Write a formatted message to a device.  The output is collected in a
+ * buffer and written with one call to write() for every ::BUFSIZ bytes,
+ * rather than one device call per character.
+ *
+ * @param dev
+ *      Index of the device to write to.
+ * @param format
+ *      The format string.  Not all standard conversion specifications are
+ *      supported by this implementation.  See _doprnt() for a description of
+ *      supported conversion specifications.
+ * @param ap
+ *      Arguments matching those in the format string.
+ *
+ * @return
+ *      The number of characters written on success, or @c EOF on failure.
+ */
+int vfprintf(int dev, const char *format, va_list ap)
+{
+    struct prntbuf pb;
+    int ret;
+
+    pb.dev = dev;
+    pb.len = 0;
+    ret = _doprnt(format, ap, prntbuf, (int)&pb);
+    if (EOF == _iowrite(dev, pb.buf, pb.len))
+    {
+        return EOF;
+    }
+    return ret;
+}
+
+/*
+ * Routine called by _doprnt() to output each character.
+ */
+static int prntbuf(int c, int _pbptr)
+{
+    struct prntbuf *pb = (struct prntbuf *)_pbptr;
+
+    if (sizeof(pb->buf) == pb->len)
+    {
+        if (EOF == _iowrite(pb->dev, pb->buf, pb->len))
+        {
+            return EOF;
+        }
+        pb->len = 0;
+    }
+    pb->buf[pb->len++] = c;
+    return (unsigned char)c;
+}
@@ -6,6 +6,8 @@
 #include <mailbox.h>
 #include <memory.h>
 
+static syscall mboxalloc(uint count, uchar mode);
+
 /**
  * @ingroup mailbox
  *
@@ -20,6 +22,43 @@
  *      are already in use or other resources could not be allocated.
  */
 syscall mailboxAlloc(uint count)
+{
+    return mboxalloc(count, MAILBOX_MPMC);
+}
+
+/**
+ * @ingroup mailbox
+ *
+ * Allocate a single-producer, single-consumer mailbox.  Such a mailbox must
+ * have at most one thread sending to it and one thread receiving from it at
+ * any time.  In exchange, messages are copied through a ring buffer with
+ * interrupts enabled.  Interrupts are disabled only once per batch, to check
+ * whether the other side is blocked, and semaphores are only used to block
+ * the sender when the ring is full or the receiver when it is empty.
+ *
+ * @param count
+ *      Minimum number of messages allowed for the mailbox.  This is rounded
+ *      up to a power of two.
+ *
+ * @return
+ *      The index of the newly allocated mailbox, or ::SYSERR if all mailboxes
+ *      are already in use or other resources could not be allocated.
+ */
+syscall mailboxAllocSpsc(uint count)
+{
+    uint size;
+
+    for (size = 1; size < count; size <<= 1)
+    {
+        if (0 == size << 1)
+        {
+            return SYSERR;
+        }
+    }
+    return mboxalloc(size, MAILBOX_SPSC);
+}
+
+static syscall mboxalloc(uint count, uchar mode)
 {
     static uint nextmbx = 0;
     uint i;
@@ -47,11 +86,18 @@ syscall mailboxAlloc(uint count)
                 break;
             }
 
-            /* initialize mailbox details and semaphores */
+            /* initialize mailbox details and semaphores; SPSC mailboxes
+             * only use the semaphores to block on a full or empty ring */
             mbxptr->count = 0;
             mbxptr->start = 0;
             mbxptr->max = count;
-            mbxptr->sender = semcreate(count);
+            mbxptr->mode = mode;
+            mbxptr->head = 0;
+            mbxptr->tail = 0;
+            mbxptr->mask = count - 1;
+            mbxptr->txwait = FALSE;
+            mbxptr->rxwait = FALSE;
+            mbxptr->sender = semcreate((MAILBOX_SPSC == mode) ? 0 : count);
             mbxptr->receiver = semcreate(0);
             if ((SYSERR == (int)mbxptr->sender) ||
                 (SYSERR == (int)mbxptr->receiver))
@@ -34,7 +34,14 @@ syscall mailboxCount(mailbox box)
     im = disable();
     if (MAILBOX_ALLOC == mbxptr->state)
     {
-        retval = mbxptr->count;
+        if (MAILBOX_SPSC == mbxptr->mode)
+        {
+            retval = mbxptr->head - mbxptr->tail;
+        }
+        else
+        {
+            retval = mbxptr->count;
+        }
     }
     else
     {
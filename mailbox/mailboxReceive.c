@@ -32,6 +32,15 @@ syscall mailboxReceive(mailbox box)
     }
 
     mbxptr = &mboxtab[box];
+    if ((MAILBOX_ALLOC == mbxptr->state) && (MAILBOX_SPSC == mbxptr->mode))
+    {
+        if (SYSERR == mailboxReceiveBatch(box, &retval, 1))
+        {
+            return SYSERR;
+        }
+        return retval;
+    }
+
     im = disable();
     retval = SYSERR;
     if (MAILBOX_ALLOC == mbxptr->state)
@@ -0,0 +1,113 @@
+/**
+ * @file mailboxReceiveBatch.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <mailbox.h>
+
+/**
+ * @ingroup mailbox
+ *
+ * Receive up to @p n messages from the specified mailbox.  Blocks until at
+ * least one message is available, then takes as many of the queued messages
+ * as fit without blocking again.  On a single-producer, single-consumer
+ * mailbox the messages are copied out of the ring with interrupts enabled;
+ * they are disabled only to wait on an empty ring and to wake a sender that
+ * is waiting for room.
+ *
+ * @param box
+ *      The index of the mailbox to receive the messages from.
+ *
+ * @param mailmsgs
+ *      Buffer to receive the messages.
+ *
+ * @param n
+ *      Maximum number of messages to receive; must be at least 1.
+ *
+ * @return
+ *      The number of messages received, or ::SYSERR if @p box did not specify
+ *      an allocated mailbox or the mailbox was freed while waiting for a
+ *      message.
+ */
+syscall mailboxReceiveBatch(mailbox box, int *mailmsgs, uint n)
+{
+    struct mbox *mbxptr;
+    volatile int *ring;
+    irqmask im;
+    uint tail, avail, i;
+
+    if (!(0 <= box && box < NMAILBOX) || (NULL == mailmsgs) || (0 == n))
+    {
+        return SYSERR;
+    }
+
+    mbxptr = &mboxtab[box];
+    im = disable();
+    if (MAILBOX_ALLOC != mbxptr->state)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    if (MAILBOX_SPSC != mbxptr->mode)
+    {
+        /* wait for the first message, then drain what is already queued */
+        wait(mbxptr->receiver);
+        for (i = 0; MAILBOX_ALLOC == mbxptr->state; i++)
+        {
+            mailmsgs[i] = mbxptr->msgs[mbxptr->start];
+            mbxptr->start = (mbxptr->start + 1) % mbxptr->max;
+            mbxptr->count--;
+            if ((i + 1 == n) || (semcount(mbxptr->receiver) <= 0))
+            {
+                signaln(mbxptr->sender, i + 1);
+                restore(im);
+                return i + 1;
+            }
+            wait(mbxptr->receiver);
+        }
+        restore(im);
+        return SYSERR;
+    }
+
+    /* ring is empty, block until the sender publishes a message */
+    while ((MAILBOX_ALLOC == mbxptr->state)
+           && (mbxptr->head == mbxptr->tail))
+    {
+        mbxptr->rxwait = TRUE;
+        wait(mbxptr->receiver);
+    }
+    restore(im);
+    if (MAILBOX_ALLOC != mbxptr->state)
+    {
+        return SYSERR;
+    }
+
+    /* only the receiver moves tail, only the sender moves head */
+    ring = mbxptr->msgs;
+    tail = mbxptr->tail;
+    avail = mbxptr->head - tail;
+    if (avail > n)
+    {
+        avail = n;
+    }
+    for (i = 0; i < avail; i++)
+    {
+        mailmsgs[i] = ring[(tail + i) & mbxptr->mask];
+    }
+    mbxptr->tail = tail + avail;
+
+    /* wake the sender if it blocked on a full ring; as in
+     * mailboxSendBatch(), test the flag only with interrupts disabled */
+    im = disable();
+    if (mbxptr->txwait)
+    {
+        mbxptr->txwait = FALSE;
+        signal(mbxptr->sender);
+    }
+    restore(im);
+
+    return avail;
+}
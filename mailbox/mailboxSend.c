@@ -35,6 +35,11 @@ syscall mailboxSend(mailbox box, int mailmsg)
     }
 
     mbxptr = &mboxtab[box];
+    if ((MAILBOX_ALLOC == mbxptr->state) && (MAILBOX_SPSC == mbxptr->mode))
+    {
+        return mailboxSendBatch(box, &mailmsg, 1);
+    }
+
     im = disable();
     retval = SYSERR;
     if (MAILBOX_ALLOC == mbxptr->state)
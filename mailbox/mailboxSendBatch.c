@@ -0,0 +1,112 @@
+/**
+ * @file mailboxSendBatch.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <mailbox.h>
+
+/**
+ * @ingroup mailbox
+ *
+ * Send several messages to the specified mailbox, in order.  On a
+ * single-producer, single-consumer mailbox the messages are copied into the
+ * ring as space allows and the receiver is woken at most once per copy; the
+ * sender only blocks while the ring is full.  On other mailboxes this is
+ * equivalent to calling mailboxSend() for each message.
+ *
+ * @param box
+ *      The index of the mailbox to send the messages to.
+ *
+ * @param mailmsgs
+ *      The messages to send.
+ *
+ * @param n
+ *      The number of messages to send.
+ *
+ * @return ::OK if all messages were enqueued, otherwise ::SYSERR.  ::SYSERR is
+ *         returned if @p box did not specify a valid allocated mailbox or if
+ *         the mailbox was freed while waiting for room in the queue, in which
+ *         case some of the messages may have been sent.
+ */
+syscall mailboxSendBatch(mailbox box, const int *mailmsgs, uint n)
+{
+    struct mbox *mbxptr;
+    volatile int *ring;
+    irqmask im;
+    uint head, room, i;
+
+    if (!(0 <= box && box < NMAILBOX) || (NULL == mailmsgs))
+    {
+        return SYSERR;
+    }
+
+    mbxptr = &mboxtab[box];
+    if (MAILBOX_ALLOC != mbxptr->state)
+    {
+        return SYSERR;
+    }
+
+    if (MAILBOX_SPSC != mbxptr->mode)
+    {
+        for (i = 0; i < n; i++)
+        {
+            if (SYSERR == mailboxSend(box, mailmsgs[i]))
+            {
+                return SYSERR;
+            }
+        }
+        return OK;
+    }
+
+    ring = mbxptr->msgs;
+    while (n > 0)
+    {
+        /* only the sender moves head, only the receiver moves tail */
+        head = mbxptr->head;
+        room = mbxptr->max - (head - mbxptr->tail);
+
+        if (0 == room)
+        {
+            /* ring is full, block until the receiver makes room */
+            im = disable();
+            while ((MAILBOX_ALLOC == mbxptr->state)
+                   && (mbxptr->head - mbxptr->tail == mbxptr->max))
+            {
+                mbxptr->txwait = TRUE;
+                wait(mbxptr->sender);
+            }
+            restore(im);
+            if (MAILBOX_ALLOC != mbxptr->state)
+            {
+                return SYSERR;
+            }
+            continue;
+        }
+
+        if (room > n)
+        {
+            room = n;
+        }
+        for (i = 0; i < room; i++)
+        {
+            ring[(head + i) & mbxptr->mask] = *mailmsgs++;
+        }
+        mbxptr->head = head + room;
+        n -= room;
+
+        /* wake the receiver if it blocked on an empty ring; the flag is
+         * only tested while holding off the receiver, which finds the ring
+         * empty and sets the flag in one step, so the wakeup is not lost */
+        im = disable();
+        if (mbxptr->rxwait)
+        {
+            mbxptr->rxwait = FALSE;
+            signal(mbxptr->receiver);
+        }
+        restore(im);
+    }
+
+    return OK;
+}
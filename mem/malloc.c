@@ -14,7 +14,8 @@
 
 /**
  * Request heap storage, record accounting information, returning pointer
- * to assigned memory region.
+ * to assigned memory region.  Whole pages of a new region other than the
+ * first are mapped demand-zero, so they cost nothing until touched.
  * @param nbytes number of bytes requested
  * @return pointer to region on success, SYSERR on failure
  */
@@ -25,6 +26,7 @@ void *malloc(uint nbytes)
     struct thrent *thread;
     struct memregion *region;
     struct memblock *prev, *curr, *leftover;
+    uint top;
 
     /* we don't allocate 0 bytes. */
     if (0 == nbytes)
@@ -106,8 +108,23 @@ void *malloc(uint nbytes)
     curr->next = curr;
     curr->length = nbytes;
 
-    /* map memory to system page table */
-    safeMapRange(curr, nbytes, ENT_USER);
+    /* map memory to system page table; whole pages holding no accounting
+     * information are zeroed when first touched rather than now */
+    top = truncpage((uint)curr + nbytes);
+    if (top > (uint)curr + PAGE_SIZE)
+    {
+        safeMapRange(curr, PAGE_SIZE, ENT_USER);
+        safeMapRange((void *)((uint)curr + PAGE_SIZE),
+                     top - (uint)curr - PAGE_SIZE, ENT_USER | ENT_ZERO);
+        if (top < (uint)curr + nbytes)
+        {
+            safeMapRange((void *)top, (uint)curr + nbytes - top, ENT_USER);
+        }
+    }
+    else
+    {
+        safeMapRange(curr, nbytes, ENT_USER);
+    }
 
     restore(im);
     return (void *)(curr + 1);
@@ -8,13 +8,16 @@
 #include <safemem.h>
 
 /**
- * Transfer a memory region from the owning thread to a new thread.
+ * Transfer a memory region from the owning thread to a new thread.  Pages
+ * already mapped are shared copy-on-write, so neither thread copies
+ * anything until one of them writes to a page (see safeShare()).
  * @param start beginning address of memory region.
  * @param tid thread id to transfer region to.
  */
 void memRegionTransfer(void *start, tid_typ tid)
 {
     struct memregion *region;
+    uint addr, end;
 
     region = memRegionValid(start);
     if (SYSERR == (int)region)
@@ -23,4 +26,10 @@ void memRegionTransfer(void *start, tid_typ tid)
     }
 
     region->thread_id = tid;
+
+    end = (uint)region->start + region->length;
+    for (addr = (uint)region->start; addr < end; addr += PAGE_SIZE)
+    {
+        safeShare((void *)addr, tid);
+    }
 }
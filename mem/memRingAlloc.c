@@ -0,0 +1,72 @@
+/**
+ * @file memRingAlloc.c
+ * Allocate a ring of buffers shared with the current thread.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <safemem.h>
+#include <mips.h>
+#include <thread.h>
+#include <stdlib.h>
+
+/**
+ * Allocate a ring of nslots buffers and map it into the address space of
+ * the current thread, which becomes its consumer.  The control page is
+ * mapped writable so the consumer can advance tail; the slots are mapped
+ * read only.  User mappings are uncached, so the kernel fills the ring
+ * through its uncached alias as well.  The region is held by the null
+ * thread so it outlives the consumer until memRingFree() is called.
+ * @param ring kernel side of ring to set up
+ * @param nslots number of slots, a power of two
+ * @param slotsize largest frame a slot must hold
+ * @return OK on success, SYSERR on failure
+ */
+int memRingAlloc(struct memring *ring, uint nslots, uint slotsize)
+{
+    struct memregion *region;
+    struct memringhdr *hdr;
+    uint length;
+
+    if ((NULL == ring) || (0 == nslots) || (0 != (nslots & (nslots - 1)))
+        || (0 == slotsize))
+    {
+        return SYSERR;
+    }
+
+    /* room for length word, keep slots word aligned */
+    slotsize = (slotsize + sizeof(uint) + 3) & ~3;
+    length = PAGE_SIZE + nslots * slotsize;
+
+    region = memRegionAlloc(length);
+    if (SYSERR == (int)region)
+    {
+        return SYSERR;
+    }
+    region->thread_id = NULLTHREAD;
+
+    if ((0 != safeMapRange(region->start, PAGE_SIZE, ENT_USER))
+        || (0 != safeMapRange((void *)((uint)region->start + PAGE_SIZE),
+                              length - PAGE_SIZE, ENT_PRESENT)))
+    {
+        safeUnmapRange(region->start, region->length);
+        memRegionRemove(region, &regalloclist);
+        memRegionInsert(region, &regfreelist);
+        return SYSERR;
+    }
+
+    hdr = (struct memringhdr *)(((uint)region->start & PMEM_MASK)
+                                | KSEG1_BASE);
+    bzero(hdr, sizeof(struct memringhdr));
+    hdr->nslots = nslots;
+    hdr->slotsize = slotsize;
+
+    ring->region = region;
+    ring->kern = hdr;
+    ring->user = (struct memringhdr *)((uint)region->start & PMEM_MASK);
+    ring->head = 0;
+    ring->nslots = nslots;
+    ring->slotsize = slotsize;
+
+    return OK;
+}
@@ -0,0 +1,18 @@
+/**
+ * @file memRingEmpty.c
+ * Check whether a shared ring has frames waiting.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <safemem.h>
+
+/**
+ * Determine whether the consumer has drained every slot of a ring.
+ * @param ring kernel side of ring
+ * @return TRUE if no frames are waiting
+ */
+bool memRingEmpty(struct memring *ring)
+{
+    return (ring->head == ring->kern->tail);
+}
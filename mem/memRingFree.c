@@ -0,0 +1,31 @@
+/**
+ * @file memRingFree.c
+ * Release a shared ring.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <safemem.h>
+#include <stdlib.h>
+
+/**
+ * Unmap a shared ring from its consumer and return its memory to the
+ * region allocator.
+ * @param ring kernel side of ring
+ */
+void memRingFree(struct memring *ring)
+{
+    struct memregion *region;
+
+    region = ring->region;
+    if (NULL == region)
+    {
+        return;
+    }
+
+    safeUnmapRange(region->start, region->length);
+    memRegionRemove(region, &regalloclist);
+    memRegionInsert(region, &regfreelist);
+
+    bzero(ring, sizeof(struct memring));
+}
@@ -0,0 +1,43 @@
+/**
+ * @file memRingPut.c
+ * Copy a frame into a shared ring.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <safemem.h>
+#include <string.h>
+
+/**
+ * Copy a frame into the next free slot of a shared ring and publish it to
+ * the consumer.  The tail written by the consumer is only compared, never
+ * used as an index, so a misbehaving consumer cannot steer the copy.
+ * Must be called with interrupts disabled.
+ * @param ring kernel side of ring
+ * @param buf frame to copy
+ * @param len length of frame
+ * @return OK on success, SYSERR if the ring is full or frame too large
+ */
+int memRingPut(struct memring *ring, const void *buf, uint len)
+{
+    struct memslot *slot;
+
+    if ((ring->head - ring->kern->tail >= ring->nslots)
+        || (len > ring->slotsize - sizeof(uint)))
+    {
+        ring->kern->drops++;
+        return SYSERR;
+    }
+
+    slot = (struct memslot *)((uint)ring->kern + PAGE_SIZE
+                              + (ring->head & (ring->nslots - 1))
+                              * ring->slotsize);
+    memcpy(slot->data, buf, len);
+    slot->len = len;
+
+    /* uncached stores complete in order, so the slot is filled first */
+    ring->head++;
+    ring->kern->head = ring->head;
+
+    return OK;
+}
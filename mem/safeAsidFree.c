@@ -0,0 +1,46 @@
+/**
+ * @file safeAsidFree.c
+ * Release the page table of a thread.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <kernel.h>
+
+#include <memory.h>
+#include <safemem.h>
+
+/**
+ * Release the table a thread's user heap pages were entered in, and end
+ * its share of pages it gave away.  Called once the thread's regions have
+ * been reclaimed.
+ * @param tid thread whose table to free
+ */
+void safeAsidFree(tid_typ tid)
+{
+    ulong *table;
+    uint index, end;
+
+    table = asidtab[tid];
+    if (NULL == table)
+    {
+        return;
+    }
+
+    end = 2 * (asidbase + asidpairs);
+    for (index = 2 * asidbase; index < end; index++)
+    {
+        if ((pgtbl[index].flags & PG_COW)
+            && ((uchar)pgtbl[index].sharer == tid))
+        {
+            pgtbl[index].flags &= ~PG_COW;
+        }
+    }
+
+    asidtab[tid] = NULL;
+    if (asidcurr == table)
+    {
+        asidcurr = NULL;
+    }
+    memfree(table, asidpairs * 2 * sizeof(ulong));
+}
@@ -0,0 +1,44 @@
+/**
+ * @file safeAsidTable.c
+ * Find or allocate the page table of a thread.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <kernel.h>
+
+#include <memory.h>
+#include <safemem.h>
+#include <thread.h>
+#include <stdlib.h>
+
+/**
+ * Find the table a thread's user heap pages are entered in, allocating
+ * an empty one if the thread has none.
+ * @param tid thread whose table to find
+ * @return pointer to table, NULL if out of memory
+ */
+ulong *safeAsidTable(tid_typ tid)
+{
+    ulong *table;
+
+    table = asidtab[tid];
+    if (NULL != table)
+    {
+        return table;
+    }
+
+    table = (ulong *)memget(asidpairs * 2 * sizeof(ulong));
+    if (SYSERR == (int)table)
+    {
+        return NULL;
+    }
+    bzero(table, asidpairs * 2 * sizeof(ulong));
+
+    asidtab[tid] = table;
+    if (tid == thrcurrent)
+    {
+        asidcurr = table;
+    }
+    return table;
+}
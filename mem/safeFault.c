@@ -0,0 +1,109 @@
+/**
+ * @file safeFault.c
+ * Populate demand-zero and copy-on-write pages.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <kernel.h>
+
+#include <safemem.h>
+#include <mips.h>
+#include <thread.h>
+#include <stdlib.h>
+#include <string.h>
+
+ulong safefaults = 0;           /**< faults resolved by safeFault */
+ulong safezeromaps = 0;         /**< pages mapped demand-zero     */
+ulong safezerofills = 0;        /**< demand-zero pages touched    */
+ulong safecowcopies = 0;        /**< pages copied to end sharing  */
+
+/**
+ * Resolve a fault by the current thread on a user heap page it has no
+ * usable entry for.  A demand-zero page is zeroed on its first touch.  A
+ * store to a shared page ends the sharing: the sharer is moved to a
+ * private copy in a region of its own and the holder keeps the frame.
+ * Frames are accessed through KSEG1, as user mappings are uncached.
+ * @param index page table index of faulting page
+ * @param store TRUE if the fault was a store
+ * @return non-zero value if the thread may not access the page
+ */
+int safeFault(uint index, bool store)
+{
+    struct pgtblent *entry, *copyent;
+    struct memregion *region;
+    ulong *table;
+    uint frame, copy;
+    tid_typ tid, sharer;
+
+    tid = thrcurrent;
+    entry = &(pgtbl[index]);
+
+    /* thread must hold or share page, and stores need a writable page */
+    if ((NULL == entry->entry)
+        || (((uchar)entry->asid != tid)
+            && (!(entry->flags & PG_COW) || ((uchar)entry->sharer != tid)))
+        || (store && !(entry->entry & ENT_WRITE)))
+    {
+        return 1;
+    }
+
+    table = safeAsidTable(tid);
+    if (NULL == table)
+    {
+        return 1;
+    }
+
+    frame = (index << PAGE_SHIFT) | KSEG1_BASE;
+    if (entry->flags & PG_ZERO)
+    {
+        bzero((void *)frame, PAGE_SIZE);
+        entry->flags &= ~PG_ZERO;
+        safezerofills++;
+    }
+
+    if ((entry->flags & PG_COW) && store)
+    {
+        /* give sharer its own copy of the frame */
+        sharer = (uchar)entry->sharer;
+        region = memRegionAlloc(PAGE_SIZE);
+        if (SYSERR == (int)region)
+        {
+            return 1;
+        }
+        region->thread_id = sharer;
+        copy = ((uint)region->start & PMEM_MASK) | KSEG1_BASE;
+        memcpy((void *)copy, (void *)frame, PAGE_SIZE);
+
+        copyent = &(pgtbl[(copy & PMEM_MASK) >> PAGE_SHIFT]);
+        copyent->entry = (copy & PMEM_MASK) >> 6 | (entry->entry & ENT_ALL);
+        copyent->asid = sharer;
+
+        if (NULL != asidtab[sharer])
+        {
+            asidtab[sharer][index - 2 * asidbase] =
+                copyent->entry | ENTRYLO_UNCACHED;
+        }
+        if (sharer != tid)
+        {
+            tlbFlush((void *)frame, sharer);
+        }
+        entry->flags &= ~PG_COW;
+        safecowcopies++;
+
+        if (sharer == tid)
+        {
+            safefaults++;
+            return 0;
+        }
+    }
+
+    /* enter page in thread's table, read only while shared */
+    table[index - 2 * asidbase] = entry->entry | ENTRYLO_UNCACHED;
+    if (entry->flags & PG_COW)
+    {
+        table[index - 2 * asidbase] &= ~ENTRYLO_DIRTY;
+    }
+    safefaults++;
+    return 0;
+}
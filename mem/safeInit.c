@@ -16,28 +16,39 @@
 struct pgtblent *pgtbl = NULL;      /**< system page table address */
 uint pgtbl_nents = 0;               /**< number of entries in page table */
 
+ulong *asidtab[NTHREAD];            /**< page table of each thread */
+ulong *asidcurr = NULL;             /**< page table of current thread */
+uint asidbase = 0;                  /**< first page pair of user heap */
+uint asidpairs = 0;                 /**< page pairs in user heap */
+
 /**
  * Initialize the memory protection subsystem.  Allocates needed memory and
- * configures initial values for page tables.
+ * configures initial values for page tables.  Must follow memRegionInit(),
+ * as the per-thread tables cover the user heap it set up.
  */
 void safeInit(void)
 {
-    uint ents_per_page;
     uint nbytes;
+    uint first, last;
 
     /* number of pages in memory */
     pgtbl_nents =
         roundpage((uint)platform.maxaddr & PMEM_MASK) / PAGE_SIZE;
 
-    /* number of entries that can fit on a single page */
-    ents_per_page = PAGE_SIZE / sizeof(struct pgtblent);
-
     /* page table size (in bytes) */
-    nbytes = (pgtbl_nents / ents_per_page) * PAGE_SIZE;
+    nbytes = roundpage(pgtbl_nents * sizeof(struct pgtblent));
 
     /* allocate memory system page table */
     pgtbl = (struct pgtblent *)memget(nbytes);
 
     /* clear page table */
     bzero(pgtbl, nbytes);
+
+    /* range of page pairs covered by per-thread tables */
+    first = (uint)regtab[0].start & PMEM_MASK;
+    last = first + regtab[0].length - 1;
+    asidbase = first >> (PAGE_SHIFT + 1);
+    asidpairs = (last >> (PAGE_SHIFT + 1)) - asidbase + 1;
+    bzero(asidtab, sizeof(asidtab));
+    asidcurr = NULL;
 }
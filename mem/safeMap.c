@@ -10,9 +10,13 @@
 #include <safemem.h>
 #include <mips.h>
 #include <thread.h>
+#include <stdlib.h>
 
 /**
- * Map a page of memory to the page table record with attributes.
+ * Map a page of memory to the page table record with attributes.  Pages
+ * of the user heap are also entered in the current thread's own table,
+ * which is allocated on its first mapping.  With ENT_ZERO, the page is
+ * left out of that table and zeroed by safeFault() when first touched.
  * @param page page to insert into page table.
  * @param attr attributes to apply to page.
  * @return non-zero value on failure.
@@ -20,7 +24,10 @@
 int safeMap(void *page, short attr)
 {
     int index;
+    uint pair;
     struct pgtblent *entry;
+    ulong *table;
+    tid_typ tid;
 
     if (NULL == pgtbl || NULL == page)
     {
@@ -28,7 +35,7 @@ int safeMap(void *page, short attr)
     }
 
     /* find index of page table entry */
-    index = (((uint)page & PMEM_MASK) >> 12);
+    index = (((uint)page & PMEM_MASK) >> PAGE_SHIFT);
     entry = &(pgtbl[index]);
 
     /* check if entry is mapped */
@@ -44,8 +51,29 @@ int safeMap(void *page, short attr)
     }
 
     /* insert entry into page table */
-    entry->entry = (uint)page >> 6 | attr;
-    entry->asid = gettid();
+    tid = gettid();
+    entry->entry = ((uint)page & PMEM_MASK) >> 6 | (attr & ENT_ALL);
+    entry->asid = tid;
+
+    /* insert entry into thread's table if it is a user heap page */
+    pair = (index >> 1) - asidbase;
+    if (!(attr & ENT_GLOBAL) && (pair < asidpairs))
+    {
+        if (attr & ENT_ZERO)
+        {
+            entry->flags = PG_ZERO;
+            safezeromaps++;
+            return 0;
+        }
+
+        table = safeAsidTable(tid);
+        if (NULL == table)
+        {
+            bzero(entry, sizeof(struct pgtblent));
+            return 1;           /* no memory for table */
+        }
+        table[index - 2 * asidbase] = entry->entry | ENTRYLO_UNCACHED;
+    }
 
 //    kprintf("Mapped 0x%08x (0x%08x) to pgtbl index %d @ 0x%08x\r\n", page, entry->frame, index, entry);
 
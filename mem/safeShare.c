@@ -0,0 +1,81 @@
+/**
+ * @file safeShare.c
+ * Share a page copy-on-write with another thread.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <kernel.h>
+
+#include <safemem.h>
+#include <mips.h>
+#include <thread.h>
+
+/**
+ * Give a mapped user heap page to another thread, leaving the thread
+ * that held it a read only view.  Both see the same frame until one of
+ * them writes to it; safeFault() then gives the old holder a private
+ * copy.  A page already shared drops the view of its older sharer.  The
+ * old holder's view lasts only as long as the new one keeps the page.
+ * @param page page to share.
+ * @param tid thread to receive the page.
+ * @return non-zero value on failure.
+ */
+int safeShare(void *page, tid_typ tid)
+{
+    uint index, pair;
+    struct pgtblent *entry;
+    ulong *table;
+    tid_typ old;
+
+    if (NULL == pgtbl || NULL == page)
+    {
+        return 1;               /* invalid */
+    }
+
+    index = (((uint)page & PMEM_MASK) >> PAGE_SHIFT);
+    pair = (index >> 1) - asidbase;
+    entry = &(pgtbl[index]);
+    if ((pair >= asidpairs) || (NULL == entry->entry)
+        || (entry->entry & ENT_GLOBAL))
+    {
+        return 1;               /* not a user heap page */
+    }
+
+    old = (uchar)entry->asid;
+    if (old == tid)
+    {
+        return 0;
+    }
+
+    table = safeAsidTable(tid);
+    if (NULL == table)
+    {
+        return 1;               /* no memory for table */
+    }
+
+    /* drop older sharer */
+    if ((entry->flags & PG_COW) && (NULL != asidtab[(uchar)entry->sharer]))
+    {
+        asidtab[(uchar)entry->sharer][index - 2 * asidbase] = 0;
+        tlbFlush(page, (uchar)entry->sharer);
+    }
+
+    /* both threads see the frame read only, untouched pages fault later */
+    index -= 2 * asidbase;
+    if (!(entry->flags & PG_ZERO))
+    {
+        table[index] = (entry->entry | ENTRYLO_UNCACHED) & ~ENTRYLO_DIRTY;
+        if (NULL != asidtab[old])
+        {
+            asidtab[old][index] = table[index];
+        }
+    }
+    tlbFlush(page, old);
+
+    entry->asid = tid;
+    entry->sharer = old;
+    entry->flags |= PG_COW;
+
+    return 0;
+}
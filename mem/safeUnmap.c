@@ -1,6 +1,7 @@
 /**
  * @file safeUnmap.c
- * Unmap a page from the page table.
+ * Unmap a page from the page table, and from the tables of the thread
+ * that mapped it and of any thread sharing it.
  *
  */
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
@@ -10,14 +11,17 @@
 #include <stdlib.h>
 
 /**
- * Unmap a page from the page table.
+ * Unmap a page from the page table, and from the tables of the thread
+ * that mapped it and of any thread sharing it.
  * @param page page to remove from page table.
  * @return non-zero value on failure.
  */
 int safeUnmap(void *page)
 {
     int index;
+    uint pair;
     struct pgtblent *entry;
+    ulong *table;
 
     if (NULL == pgtbl || NULL == page)
     {
@@ -25,15 +29,33 @@ int safeUnmap(void *page)
     }
 
     /* find index of page table entry */
-    index = (((uint)page & PMEM_MASK) >> 12);
+    index = (((uint)page & PMEM_MASK) >> PAGE_SHIFT);
     entry = &(pgtbl[index]);
 
     /* make sure entry is correctly mapped */
-    if ((entry->entry & 0xffffffc0) != ((uint)page >> 6))
+    if ((entry->entry & 0xffffffc0) != (((uint)page & PMEM_MASK) >> 6))
     {
         return 1;               /* corrupted page */
     }
 
+    /* clear entry from threads' tables */
+    pair = (index >> 1) - asidbase;
+    if (pair < asidpairs)
+    {
+        table = asidtab[(uchar)entry->asid];
+        if (NULL != table)
+        {
+            table[index - 2 * asidbase] = 0;
+            tlbFlush(page, (uchar)entry->asid);
+        }
+        table = asidtab[(uchar)entry->sharer];
+        if ((entry->flags & PG_COW) && (NULL != table))
+        {
+            table[index - 2 * asidbase] = 0;
+            tlbFlush(page, (uchar)entry->sharer);
+        }
+    }
+
     /* clear entry from page table */
     bzero(entry, sizeof(struct pgtblent));
 
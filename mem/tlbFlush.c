@@ -0,0 +1,55 @@
+/**
+ * @file     tlbFlush.c
+ * Remove a page from the Translation lookaside buffer.
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <mips.h>
+#include <tlb.h>
+
+/**
+ * Remove the TLB entry, if any, translating a page for a thread, so the
+ * next access misses and sees the thread's current table.  The entry is
+ * pointed at an unmapped KSEG0 address unique to its index, which no
+ * access can match.
+ * @param page address in page to remove
+ * @param tid thread whose translation to remove
+ */
+void tlbFlush(void *page, tid_typ tid)
+{
+    ulong entryhi, index;
+    irqmask im;
+
+    im = disable();
+
+    /* save current asid */
+    asm volatile ("mfc0 %0, $10":"=r" (entryhi));
+
+    asm volatile ("mtc0 %0, $10"::"r"
+                  (((uint)page & PMEM_MASK & ~((2 << PAGE_SHIFT) - 1))
+                   | (tid & ENTRYHI_ASID)));
+    asm volatile ("nop");
+    asm volatile ("tlbp");
+    asm volatile ("nop");
+    asm volatile ("mfc0 %0, $0":"=r" (index));
+
+    /* high bit of index is set if no entry matched */
+    if (!(index & 0x80000000))
+    {
+        asm volatile ("mtc0 %0, $10"::"r"
+                      (KSEG0_BASE + (index << (PAGE_SHIFT + 1))));
+        asm volatile ("mtc0 $0, $2");
+        asm volatile ("mtc0 $0, $3");
+        asm volatile ("nop");
+        asm volatile ("tlbwi");
+        asm volatile ("nop");
+    }
+
+    /* restore current asid */
+    asm volatile ("mtc0 %0, $10"::"r" (entryhi));
+
+    restore(im);
+}
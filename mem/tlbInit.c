@@ -13,17 +13,27 @@
 interrupt tlbMiss(void);
 interrupt tlbMissLong(void);
 
+ulong tlbrefills = 0;           /**< misses refilled by tlbMiss       */
+ulong tlbslowmiss = 0;          /**< misses handled by tlbMissHandler */
+ulong tlbfaults = 0;            /**< protection violations            */
+
 /**
  * Initialize the TLB.  This function is called at startup.  Installs
- * handler for both TLB load and store operations in normal exceptionVector
- * table, also copies the handler to the quick tlbMiss memory 0x80000000.
+ * handler for TLB load, store and modify exceptions in normal
+ * exceptionVector table, also copies the handler to the quick tlbMiss
+ * memory 0x80000000.  Every entry written uses pages of 1 << PAGE_SHIFT
+ * bytes.
  */
 void tlbInit(void)
 {
     /* Register slow TLB exception handler (KSEG2 and USEG misses) */
     exceptionVector[EXC_TLBS] = (void *)tlbMissLong;
     exceptionVector[EXC_TLBL] = (void *)tlbMissLong;
+    exceptionVector[EXC_MOD] = (void *)tlbMissLong;
 
     /* install the quick handler (for USEG mappings) */
     memcpy(TLB_EXC_START, tlbMiss, TLB_EXC_LENGTH);
+
+    /* set page size */
+    asm volatile ("mtc0 %0, $5"::"r" (TLB_PAGEMASK));
 }
@@ -7,6 +7,7 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <kernel.h>
+#include <interrupt.h>
 #include <safemem.h>
 #include <mips.h>
 #include <thread.h>
@@ -14,35 +15,74 @@
 #include <tlb.h>
 
 /**
- * Slower (C based) TLB handler, though provides an easier way to
- * understand.
+ * Slower (C based) TLB handler, reached when tlbMiss cannot refill from
+ * the current thread's table: faults outside the user heap, pages the
+ * thread has not mapped, stores to read only pages, and misses taken
+ * with exceptions already masked.  Demand-zero and copy-on-write pages
+ * are resolved by safeFault().  Global (kernel) mappings are shared by
+ * all threads.
  * @param vpn_fault faulting address
+ * @param entrylo even and odd EntryLo values to load
+ * @param cause value of the cause register
  */
-void tlbMissHandler(int vpn_fault, int *entrylo)
+void tlbMissHandler(int vpn_fault, int *entrylo, int cause)
 {
-    int index, align_index;
+    uint page, index;
+    ulong *table;
     struct pgtblent *entry;
+    int exccode;
 
-    /* determine which page of page tables entry is in */
-    index = (((uint)vpn_fault & PMEM_MASK) >> 12);
-    align_index = index & ~(0x01);
-    entry = &(pgtbl[align_index]);
+    tlbslowmiss++;
+    exccode = (cause & CAUSE_EXC) >> CAUSE_EXC_SHIFT;
 
-    index = index & 0x01;
-    /* make sure current address space is mapped address space */
-    if (entry[index].entry == NULL || entry[index].asid != thrcurrent)
+    page = (((uint)vpn_fault & PMEM_MASK) >> PAGE_SHIFT);
+    index = page - 2 * asidbase;
+
+    if (index < 2 * asidpairs)
     {
-        /* no mapping */
-        fprintf(stderr, "Memory protection violation (0x%08x).\n",
-                vpn_fault);
-        exlreset();
-        kill(thrcurrent);
-        while (1)
+        /* user heap page, must be in thread's own table */
+        table = asidtab[thrcurrent];
+        if ((NULL == table) || (0 == table[index]) || (EXC_MOD == exccode))
+        {
+            if (0 == safeFault(page, (EXC_TLBL != exccode)))
+            {
+                table = asidtab[thrcurrent];
+            }
+            else
+            {
+                table = NULL;
+            }
+        }
+        if (NULL != table)
         {
-            /* violation means thread cannot proceed */
+            index &= ~0x01;
+            entrylo[0] = table[index];
+            entrylo[1] = table[index + 1];
+            return;
+        }
+    }
+    else if (page < pgtbl_nents)
+    {
+        /* anything else must be mapped to all or to this thread */
+        entry = &(pgtbl[page & ~0x01]);
+        index = page & 0x01;
+        if ((NULL != entry[index].entry) && (EXC_MOD != exccode)
+            && ((entry[index].entry & ENT_GLOBAL)
+                || ((uchar)entry[index].asid == thrcurrent)))
+        {
+            entrylo[0] = entry[0].entry | ENTRYLO_UNCACHED;
+            entrylo[1] = entry[1].entry | ENTRYLO_UNCACHED;
+            return;
         }
     }
 
-    entrylo[0] = entry[0].entry | 0x10;
-    entrylo[1] = entry[1].entry | 0x10;
+    /* no mapping */
+    tlbfaults++;
+    fprintf(stderr, "Memory protection violation (0x%08x).\n", vpn_fault);
+    exlreset();
+    kill(thrcurrent);
+    while (1)
+    {
+        /* violation means thread cannot proceed */
+    }
 }
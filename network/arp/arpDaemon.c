@@ -6,7 +6,7 @@
 
 #include <stddef.h>
 #include <arp.h>
-#include <mailbox.h>
+#include <thread.h>
 
 /**
  * @ingroup arp
@@ -16,15 +16,16 @@
 thread arpDaemon(void)
 {
     struct packet *pkt = NULL;
+    int type;
 
     while (TRUE)
     {
-        pkt = (struct packet *)mailboxReceive(arpqueue);
-        ARP_TRACE("Daemon received ARP packet");
-        if (SYSERR == (int)pkt)
+        if ((OK != recvbuf(&type, (void **)&pkt, NULL))
+            || (ARP_MSG_PKT != type))
         {
             continue;
         }
+        ARP_TRACE("Daemon received ARP packet");
 
         arpSendReply(pkt);
 
@@ -6,12 +6,11 @@
 
 #include <stddef.h>
 #include <arp.h>
-#include <mailbox.h>
 #include <stdlib.h>
 #include <thread.h>
 
 struct arpEntry arptab[ARP_NENTRY];
-mailbox arpqueue;
+tid_typ arpdaemon;
 
 /**
  * @ingroup arp
@@ -30,17 +29,14 @@ syscall arpInit(void)
         arptab[i].state = ARP_FREE;
     }
 
-    /* Initialize ARP queue */
-    arpqueue = mailboxAlloc(ARP_NQUEUE);
-    if (SYSERR == arpqueue)
+    /* Spawn arpDaemon thread, its message queue holds pending requests */
+    arpdaemon = createq((void *)arpDaemon, ARP_THR_STK, ARP_THR_PRIO,
+                        ARP_NQUEUE, "arpDaemon", 0);
+    if (SYSERR == arpdaemon)
     {
         return SYSERR;
     }
-
-    /* Spawn arpDaemon thread */
-    ready(create
-          ((void *)arpDaemon, ARP_THR_STK, ARP_THR_PRIO, "arpDaemon", 0),
-          RESCHED_NO);
+    ready(arpdaemon, RESCHED_NO);
 
     return OK;
 }
@@ -22,6 +22,7 @@ syscall arpNotify(struct arpEntry *entry, message msg)
 {
     int i = 0;                          /**< index into ARP table         */
     irqmask im;                     /**< interrupt state              */
+    syscall result = OK;            /**< SYSERR if any send failed    */
 
     /* Error check pointers */
     if (NULL == entry)
@@ -29,14 +30,13 @@ syscall arpNotify(struct arpEntry *entry, message msg)
         return SYSERR;
     }
 
-    /* Send message to each waiting thread */
+    /* Send message to each waiting thread, even if one cannot take it */
     im = disable();
     for (i = 0; i < entry->count; i++)
     {
         if (SYSERR == send(entry->waiting[i], msg))
         {
-            restore(im);
-            return SYSERR;
+            result = SYSERR;
         }
     }
 
@@ -45,5 +45,5 @@ syscall arpNotify(struct arpEntry *entry, message msg)
     bzero(entry->waiting, sizeof(tid_typ) * ARP_NTHRWAIT);
 
     restore(im);
-    return OK;
+    return result;
 }
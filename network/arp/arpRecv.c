@@ -10,7 +10,6 @@
 #include <ethernet.h>
 #include <interrupt.h>
 #include <ipv4.h>
-#include <mailbox.h>
 #include <network.h>
 #include <string.h>
 
@@ -128,13 +127,12 @@ syscall arpRecv(struct packet *pkt)
         /* If entry is a request, send a reply */
         if (ARP_OP_RQST == net2hs(arp->op))
         {
-            if (mailboxCount(arpqueue) >= ARP_NQUEUE)
+            if (SYSERR == sendbuf(arpdaemon, ARP_MSG_PKT, pkt, pkt->len))
             {
                 restore(im);
                 netFreebuf(pkt);
                 return SYSERR;
             }
-            mailboxSend(arpqueue, (int)pkt);
             ARP_TRACE("Enqueued request for daemon to reply");
             restore(im);
             return OK;
@@ -0,0 +1,41 @@
+/*
+ * @file emuAlloc.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <netemu.h>
+#include <stdlib.h>
+
+/**
+ * @ingroup netemu
+ *
+ * Allocate an emulator rule.  The rule is cleared, matches every packet and
+ * applies no impairments until its fields are set by the caller.  Rules are
+ * matched in table order, so rules allocated earlier take precedence.
+ * @return pointer to rule, SYSERR if the table is full
+ */
+struct emuRule *emuAlloc(void)
+{
+    struct emuRule *rule;
+    irqmask im;
+    int i;
+
+    im = disable();
+    for (i = 0; i < EMU_NRULES; i++)
+    {
+        rule = &emutab[i];
+        if (EMU_FREE == rule->state)
+        {
+            bzero(rule, sizeof(struct emuRule));
+            rule->last = emuNow();
+            rule->state = EMU_USED;
+            restore(im);
+            return rule;
+        }
+    }
+    restore(im);
+    return (struct emuRule *)SYSERR;
+}
@@ -5,18 +5,39 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <network.h>
+#include <stdlib.h>
+#include <ipv4.h>
 #include <netemu.h>
-#include <route.h>
 
 /**
  * @ingroup netemu
  *
- * Corrupts packets as specified by user
+ * Corrupt packets with the probability set in the rule by flipping one bit of
+ * the payload following the IPv4 header.  The header is left intact so the
+ * packet is still routed and the error is seen by the receiving transport.
  * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
-syscall emuCorrupt(struct packet *pkt)
+syscall emuCorrupt(struct packet *pkt, struct emuRule *rule, uint delay)
 {
+    struct ipv4Pkt *ip;
+    uchar *payload;
+    int len;
 
-    return rtRecv(pkt);
+    if ((rand() % 100) < rule->corrupt)
+    {
+        ip = (struct ipv4Pkt *)pkt->nethdr;
+        payload = pkt->nethdr + ((ip->ver_ihl & IPv4_IHL) * 4);
+        len = (pkt->data + pkt->len) - payload;
+        if (len > 0)
+        {
+            EMU_TRACE("Corrupted by emulator");
+            rule->ncorrupt++;
+            payload[rand() % len] ^= 1 << (rand() % 8);
+        }
+    }
+
+    return emuReorder(pkt, rule, delay);
 }
@@ -4,28 +4,164 @@
  */
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
+#include <stddef.h>
+#include <clock.h>
+#include <interrupt.h>
 #include <network.h>
+#include <netemu.h>
+#include <route.h>
 #include <stdlib.h>
 #include <thread.h>
-#include <netemu.h>
+
 
 /**
  * @ingroup netemu
  *
- * Delay packets as specified by user
+ * Delay packets as specified by the rule.  The rule's base delay and a random
+ * jitter are added to the delay accumulated by earlier stages.  A packet with
+ * no delay is routed immediately; otherwise it is placed in the delay queue,
+ * ordered by release time, and forwarded later by emuDaemon().  The calling
+ * (network receive) thread never blocks.
  * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
-syscall emuDelay(struct packet *pkt)
+syscall emuDelay(struct packet *pkt, struct emuRule *rule, uint delay)
+{
+    struct emuPending *entry, **prev;
+    irqmask im;
+
+    delay += rule->delay;
+    if (rule->jitter > 0)
+    {
+        delay += rand() % (rule->jitter + 1);
+    }
+
+    if (0 == delay)
+    {
+        return rtRecv(pkt);
+    }
+
+    im = disable();
+
+    /* if the delay queue is full, then drop packet */
+    entry = emuqfree;
+    if (NULL == entry)
+    {
+        emuqfull++;
+        restore(im);
+        EMU_TRACE("Emulator delay queue full");
+        netFreebuf(pkt);
+        return OK;
+    }
+    emuqfree = entry->next;
+
+    entry->pkt = pkt;
+    entry->release = emuNow() + delay;
+    rule->ndelay++;
+
+    /* insert after all packets released no later than this one */
+    prev = &emuqhead;
+    while (NULL != *prev && (long)((*prev)->release - entry->release) <= 0)
+    {
+        prev = &(*prev)->next;
+    }
+    entry->next = *prev;
+    *prev = entry;
+
+    /* a new earliest release needs the daemon to shorten its wait */
+    if (entry == emuqhead && BADTID != emutid)
+    {
+        send(emutid, 0);
+    }
+
+    restore(im);
+    return OK;
+}
+
+/**
+ * @ingroup netemu
+ *
+ * Network emulator daemon.  Sleeps until the earliest release time in the
+ * delay queue (or until woken by emuDelay() for an earlier packet) and routes
+ * every packet whose time has come.
+ * @return does not return
+ */
+thread emuDaemon(void)
+{
+    struct emuPending *due, *last, *entry;
+    ulong wait;
+    irqmask im;
+
+    while (TRUE)
+    {
+        /* unlink the packets whose time has come */
+        im = disable();
+        due = NULL;
+        last = NULL;
+        while (NULL != emuqhead
+               && (long)(emuqhead->release - emuNow()) <= 0)
+        {
+            entry = emuqhead;
+            emuqhead = entry->next;
+            entry->next = NULL;
+            if (NULL == last)
+            {
+                due = entry;
+            }
+            else
+            {
+                last->next = entry;
+            }
+            last = entry;
+        }
+        restore(im);
+
+        /* route them with interrupts enabled, since routing may block */
+        for (entry = due; NULL != entry; entry = entry->next)
+        {
+            rtRecv(entry->pkt);
+        }
+
+        im = disable();
+        if (NULL != last)
+        {
+            last->next = emuqfree;
+            emuqfree = due;
+        }
+
+        wait = EMU_IDLE_WAIT;
+        if (NULL != emuqhead)
+        {
+            wait = emuqhead->release - emuNow();
+        }
+        restore(im);
+
+        /* packets may have come due while others were routed */
+        if ((long)wait > 0)
+        {
+            recvtime(wait);
+        }
+    }
+
+    return SYSERR;
+}
+
+/**
+ * @ingroup netemu
+ *
+ * Current time in milliseconds, for emulator delays.  The value wraps, so only
+ * differences between times are meaningful.
+ * @return milliseconds since boot
+ */
+ulong emuNow(void)
 {
-    /*
-       short delayTime = 100;
-       short delayPercent = 100;
-
-       if ((rand() % 100) < delayPercent)
-       {
-       sleep(delayTime);
-       }
-     */
-    return emuDuplicate(pkt);
+    ulong now;
+    irqmask im;
+
+    im = disable();
+    now = clktime * CLKTICKS_PER_SEC + clkticks;
+    restore(im);
+    return now;
 }
@@ -7,30 +7,26 @@
 #include <stdlib.h>
 #include <network.h>
 #include <netemu.h>
-#include <route.h>
-#include <date.h>
-#include <stdio.h>
-#include <udp.h>
 
 /**
  * @ingroup netemu
  *
- * Drop packets based on user settings
+ * Drop packets randomly with the probability set in the rule.
  * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
-syscall emuDrop(struct packet *pkt)
+syscall emuDrop(struct packet *pkt, struct emuRule *rule, uint delay)
 {
-    /* TODO: make this user specifiable */
-    short dropPercent = 0;
-
     /* drop packet when random value < percent to drop */
-    if ((rand() % 100) < dropPercent)
+    if ((rand() % 100) < rule->drop)
     {
-        RT_TRACE("Dropped by Emulator: %d\n");
+        EMU_TRACE("Dropped by emulator");
+        rule->ndrop++;
         netFreebuf(pkt);
         return OK;
     }
 
-    return emuDelay(pkt);
+    return emuRate(pkt, rule, delay);
 }
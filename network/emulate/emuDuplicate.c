@@ -6,37 +6,40 @@
 
 #include <network.h>
 #include <stdlib.h>
+#include <string.h>
 #include <netemu.h>
 
-//int test(struct packet *pkt, int dupes);
 /**
  * @ingroup netemu
  *
- * Duplicate packets as specified by user
+ * Duplicate packets with the probability set in the rule.  The duplicate is a
+ * copy in a separate buffer and passes through the remaining stages (and so
+ * may be corrupted or delayed) independently of the original.
  * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
-syscall emuDuplicate(struct packet *pkt)
+syscall emuDuplicate(struct packet *pkt, struct emuRule *rule, uint delay)
 {
-    /*
-       short dupePercent = 100;
-       int dupes = 2;
+    struct packet *dup;
 
-       if ((rand() % 100) < dupePercent)
-       {
-       return test(pkt, dupes);
-       }
-     */
-    return emuReorder(pkt);
-}
-
-/*
-syscall test(struct packet *pkt, int dupes)
-{
-    if (dupes == 1)
+    if ((rand() % 100) < rule->duplicate)
     {
-        return emuReorder(pkt);
+        dup = netGetbuf();
+        if (SYSERR != (int)dup)
+        {
+            EMU_TRACE("Duplicated by emulator");
+            rule->ndup++;
+            memcpy(dup->data, pkt->data, pkt->len);
+            dup->nif = pkt->nif;
+            dup->len = pkt->len;
+            dup->linkhdr = dup->data + (pkt->linkhdr - pkt->data);
+            dup->nethdr = dup->data + (pkt->nethdr - pkt->data);
+            dup->curr = dup->data + (pkt->curr - pkt->data);
+            emuCorrupt(dup, rule, delay);
+        }
     }
 
-    return (emuReorder(pkt) | test(pkt, dupes - 1));
-}*/
+    return emuCorrupt(pkt, rule, delay);
+}
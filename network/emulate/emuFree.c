@@ -0,0 +1,26 @@
+/*
+ * @file emuFree.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <netemu.h>
+
+/**
+ * @ingroup netemu
+ *
+ * Free an emulator rule.  Packets already in the delay queue are still
+ * forwarded when their time comes.
+ * @param rule pointer to rule
+ * @return OK if freed succesfully, otherwise SYSERR
+ */
+syscall emuFree(struct emuRule *rule)
+{
+    if (NULL == rule || rule < emutab || rule >= emutab + EMU_NRULES)
+    {
+        return SYSERR;
+    }
+    rule->state = EMU_FREE;
+    return OK;
+}
@@ -0,0 +1,56 @@
+/*
+ * @file emuInit.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <netemu.h>
+#include <stdlib.h>
+#include <thread.h>
+
+struct emuRule emutab[EMU_NRULES];
+struct emuPending emuqtab[EMU_NQUEUE];
+struct emuPending *emuqhead;
+struct emuPending *emuqfree;
+uint emuqfull;
+tid_typ emutid = BADTID;
+
+/**
+ * @ingroup netemu
+ *
+ * Initialize the network emulator rule table and delay queue and spawn the
+ * emulator daemon that forwards delayed packets.
+ * @return OK if initialized succesfully, otherwise SYSERR
+ */
+syscall emuInit(void)
+{
+    int i;
+
+    for (i = 0; i < EMU_NRULES; i++)
+    {
+        bzero(&emutab[i], sizeof(struct emuRule));
+        emutab[i].state = EMU_FREE;
+    }
+
+    /* Initialize delay queue */
+    emuqhead = NULL;
+    emuqfree = NULL;
+    emuqfull = 0;
+    for (i = 0; i < EMU_NQUEUE; i++)
+    {
+        emuqtab[i].next = emuqfree;
+        emuqfree = &emuqtab[i];
+    }
+
+    emutid = create((void *)emuDaemon, EMU_THR_STK, EMU_THR_PRIO,
+                    "emuDaemon", 0);
+    if (SYSERR == emutid)
+    {
+        return SYSERR;
+    }
+    ready(emutid, RESCHED_NO);
+
+    return OK;
+}
@@ -0,0 +1,86 @@
+/*
+ * @file emuMatch.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <ipv4.h>
+#include <netemu.h>
+#include <udp.h>
+
+static bool emuMatchAddr(const uchar *addr, const struct netaddr *net,
+                         const struct netaddr *mask);
+
+/**
+ * @ingroup netemu
+ *
+ * Find the first emulator rule matching a packet.  Addresses are compared
+ * under the rule masks; ports are only compared for UDP and TCP packets.
+ * @param pkt pointer to the incoming packet (nethdr must be set)
+ * @return pointer to the matching rule, NULL if no rule matches
+ */
+struct emuRule *emuMatch(struct packet *pkt)
+{
+    struct ipv4Pkt *ip;
+    struct udpPkt *ports;
+    struct emuRule *rule;
+    int i;
+
+    ip = (struct ipv4Pkt *)pkt->nethdr;
+    ports = NULL;
+    if (IPv4_PROTO_UDP == ip->proto || IPv4_PROTO_TCP == ip->proto)
+    {
+        ports = (struct udpPkt *)((uchar *)ip
+                                  + ((ip->ver_ihl & IPv4_IHL) * 4));
+    }
+
+    for (i = 0; i < EMU_NRULES; i++)
+    {
+        rule = &emutab[i];
+        if (EMU_USED != rule->state)
+        {
+            continue;
+        }
+        if (rule->proto != EMU_PROTO_ANY && rule->proto != ip->proto)
+        {
+            continue;
+        }
+        if (!emuMatchAddr(ip->src, &rule->src, &rule->srcmask)
+            || !emuMatchAddr(ip->dst, &rule->dst, &rule->dstmask))
+        {
+            continue;
+        }
+        if (rule->srcpt != EMU_PORT_ANY
+            && (NULL == ports || net2hs(ports->srcPort) != rule->srcpt))
+        {
+            continue;
+        }
+        if (rule->dstpt != EMU_PORT_ANY
+            && (NULL == ports || net2hs(ports->dstPort) != rule->dstpt))
+        {
+            continue;
+        }
+        return rule;
+    }
+    return NULL;
+}
+
+/*
+ * Compare an IPv4 address against a network under a mask.  A mask of length 0
+ * matches every address.
+ */
+static bool emuMatchAddr(const uchar *addr, const struct netaddr *net,
+                         const struct netaddr *mask)
+{
+    int i;
+
+    for (i = 0; i < mask->len; i++)
+    {
+        if ((addr[i] & mask->addr[i]) != (net->addr[i] & mask->addr[i]))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
@@ -0,0 +1,84 @@
+/*
+ * @file emuRate.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <network.h>
+#include <netemu.h>
+
+/**
+ * @ingroup netemu
+ *
+ * Limit bandwidth with a token bucket.  Tokens (bytes) accrue at the rule's
+ * rate up to its burst size.  A packet finding enough tokens passes without
+ * delay; otherwise it borrows against future tokens and is delayed until they
+ * accrue, which shapes the flow to the configured rate.  Packets that would
+ * have to wait longer than the rule's limit are dropped, as by a full queue.
+ * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
+ * @return OK if packet was processed succesfully, otherwise SYSERR
+ */
+syscall emuRate(struct packet *pkt, struct emuRule *rule, uint delay)
+{
+    ulong now, elapsed;
+    uint wait, room;
+    irqmask im;
+
+    if (0 == rule->rate)
+    {
+        return emuDuplicate(pkt, rule, delay);
+    }
+
+    im = disable();
+
+    /* add tokens for the time since they were last added */
+    now = emuNow();
+    elapsed = now - rule->last;
+    room = (int)rule->burst - rule->tokens;
+    if (elapsed / 1000 > room / rule->rate)
+    {
+        /* enough time has passed to pay off any debt and fill the bucket */
+        rule->tokens = rule->burst;
+        rule->last = now;
+    }
+    else
+    {
+        /* split the product to avoid overflow at high rates; the whole
+         * seconds cannot overflow since they accrue no more than room */
+        wait = rule->rate * (elapsed / 1000)
+            + (rule->rate / 1000) * (elapsed % 1000)
+            + ((rule->rate % 1000) * (elapsed % 1000)) / 1000;
+        if (wait > 0)
+        {
+            if (wait > room)
+            {
+                wait = room;
+            }
+            rule->tokens += wait;
+            rule->last = now;
+        }
+    }
+
+    /* time until enough tokens have accrued for this packet */
+    wait = 0;
+    if (rule->tokens < (int)pkt->len)
+    {
+        wait = ((pkt->len - rule->tokens) * 1000) / rule->rate;
+        if (wait > rule->limit)
+        {
+            restore(im);
+            EMU_TRACE("Dropped by emulator rate limit");
+            rule->nlimit++;
+            netFreebuf(pkt);
+            return OK;
+        }
+    }
+    rule->tokens -= pkt->len;
+
+    restore(im);
+    return emuDuplicate(pkt, rule, delay + wait);
+}
@@ -5,17 +5,28 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <network.h>
+#include <stdlib.h>
 #include <netemu.h>
 
 /**
  * @ingroup netemu
  *
- * Reorder packets as specified by the user
+ * Reorder packets with the probability set in the rule.  A reordered packet is
+ * held back for the rule's gap in addition to its normal delay, so packets of
+ * the same flow arriving within the gap overtake it.
  * @param pkt pointer to the incoming packet
+ * @param rule emulator rule matching the packet
+ * @param delay delay (ms) accumulated by earlier stages
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
-syscall emuReorder(struct packet *pkt)
+syscall emuReorder(struct packet *pkt, struct emuRule *rule, uint delay)
 {
+    if ((rand() % 100) < rule->reorder)
+    {
+        EMU_TRACE("Reordered by emulator");
+        rule->nreorder++;
+        delay += rule->gap;
+    }
 
-    return emuCorrupt(pkt);
+    return emuDelay(pkt, rule, delay);
 }
@@ -6,16 +6,29 @@
 
 #include <network.h>
 #include <netemu.h>
+#include <route.h>
 
 /**
  * @ingroup netemu
  *
- * Process a packet through the network emulator
+ * Process a packet through the network emulator.  The packet is matched
+ * against the emulator rules and, if a rule matches, passed through the
+ * emulator pipeline: emuDrop(), emuRate(), emuDuplicate(), emuCorrupt(),
+ * emuReorder() and finally emuDelay(), which forwards it now or holds it in
+ * the delay queue.  Packets matching no rule are routed unchanged.
  * @param pkt pointer to the incoming packet
  * @return OK if packet was processed succesfully, otherwise SYSERR
  */
 syscall netemu(struct packet *pkt)
 {
+    struct emuRule *rule;
 
-    return emuDrop(pkt);
+    rule = emuMatch(pkt);
+    if (NULL == rule)
+    {
+        return rtRecv(pkt);
+    }
+
+    rule->nmatch++;
+    return emuDrop(pkt, rule, 0);
 }
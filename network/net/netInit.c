@@ -8,6 +8,7 @@
 #include <icmp.h>
 #include <bufpool.h>
 #include <network.h>
+#include <netemu.h>
 #include <route.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -63,6 +64,14 @@ syscall netInit()
         return SYSERR;
     }
 
+#if NETEMU
+    /* Initialize network emulator */
+    if (SYSERR == emuInit())
+    {
+        return SYSERR;
+    }
+#endif                          /* NETEMU */
+
     /* Initialize TCP */
 #if NTCP
     i = create((void *)tcpTimer, INITSTK, INITPRIO, "tcpTimer", 0);
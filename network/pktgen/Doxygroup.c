@@ -0,0 +1,6 @@
+/**
+ * @defgroup pktgen Packet generator
+ * @ingroup network
+ * @brief Generate paced streams of UDP frames and measure their loss,
+ *        reordering and latency at a receiving sink.
+ */
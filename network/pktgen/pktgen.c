@@ -0,0 +1,208 @@
+/**
+ * @file pktgen.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <clock.h>
+#include <device.h>
+#include <interrupt.h>
+#include <pktgen.h>
+
+struct pgStream pgtab[PKTGEN_NSTREAM];
+tid_typ pgtid = BADTID;
+
+static uint pktgenDue(struct pgStream *pgs, ulong now);
+static void pktgenSend(struct pgStream *pgs, ulong now);
+
+/**
+ * @ingroup pktgen
+ *
+ * Packet generator engine.  A single thread serves every running stream in
+ * turn, writing up to ::PKTGEN_BATCH frames per stream before moving on so
+ * that streams share the device fairly.  Each stream is paced against the
+ * clock to its target rate; when no stream has a frame due the engine sleeps
+ * for a tick, otherwise it only yields.  The engine exits once no stream is
+ * running and is restarted by pktgenStart().
+ * @return OK when no stream is left running
+ */
+thread pktgen(void)
+{
+    struct pgStream *pgs;
+    ulong now;
+    uint n, sent;
+    bool running;
+    irqmask im;
+    int i;
+
+    while (TRUE)
+    {
+        running = FALSE;
+        sent = 0;
+        now = pktgenNow();
+        for (i = 0; i < PKTGEN_NSTREAM; i++)
+        {
+            pgs = &pgtab[i];
+            if (PKTGEN_RUN != pgs->state)
+            {
+                continue;
+            }
+            running = TRUE;
+
+            n = pktgenDue(pgs, now);
+            sent += n;
+            while (n-- > 0)
+            {
+                pktgenSend(pgs, now);
+            }
+
+            if (0 != pgs->count && pgs->seq >= pgs->count)
+            {
+                pgs->stop = pktgenNow();
+                pgs->state = PKTGEN_DONE;
+            }
+        }
+
+        if (!running)
+        {
+            /* recheck with interrupts off so pktgenStart() cannot race */
+            im = disable();
+            for (i = 0; i < PKTGEN_NSTREAM; i++)
+            {
+                if (PKTGEN_RUN == pgtab[i].state)
+                {
+                    break;
+                }
+            }
+            if (PKTGEN_NSTREAM == i)
+            {
+                pgtid = BADTID;
+                restore(im);
+                return OK;
+            }
+            restore(im);
+        }
+
+        if (0 == sent)
+        {
+            sleep(1);
+        }
+        else
+        {
+            yield();
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * @ingroup pktgen
+ *
+ * Current time in milliseconds, for packet generator timestamps and pacing.
+ * The value wraps, so only differences between times are meaningful.
+ * @return milliseconds since boot
+ */
+ulong pktgenNow(void)
+{
+    ulong now;
+    irqmask im;
+
+    im = disable();
+    now = clktime * CLKTICKS_PER_SEC + clkticks;
+    restore(im);
+    return now;
+}
+
+/*
+ * Number of frames a stream may send now.  Pacing works in one-second
+ * epochs: the frames due are those the target rate allows for the time
+ * elapsed in the epoch, less those already sent.  A stream that falls behind
+ * by more than an epoch does not try to catch up.
+ */
+static uint pktgenDue(struct pgStream *pgs, ulong now)
+{
+    ulong elapsed;
+    uint due, n;
+
+    n = PKTGEN_BATCH;
+    if (0 != pgs->rate)
+    {
+        elapsed = now - pgs->epoch;
+        if (elapsed >= 2 * CLKTICKS_PER_SEC)
+        {
+            pgs->epoch = now;
+            pgs->credit = 0;
+            elapsed = 0;
+        }
+        else if (elapsed >= CLKTICKS_PER_SEC)
+        {
+            pgs->epoch += CLKTICKS_PER_SEC;
+            elapsed -= CLKTICKS_PER_SEC;
+            pgs->credit -= (pgs->credit < pgs->rate)
+                ? pgs->credit : pgs->rate;
+        }
+
+        /* split the product to avoid overflow at high rates */
+        due = (pgs->rate / CLKTICKS_PER_SEC) * elapsed
+            + ((pgs->rate % CLKTICKS_PER_SEC) * elapsed) / CLKTICKS_PER_SEC;
+        if (due <= pgs->credit)
+        {
+            return 0;
+        }
+        if (due - pgs->credit < n)
+        {
+            n = due - pgs->credit;
+        }
+    }
+
+    if (0 != pgs->count && pgs->count - pgs->seq < n)
+    {
+        n = pgs->count - pgs->seq;
+    }
+    return n;
+}
+
+/*
+ * Write the next frame of a stream.  Only the fields that differ between
+ * frames are patched into the template; the IPv4 checksum is completed from
+ * the precomputed sum of the constant header fields.
+ */
+static void pktgenSend(struct pgStream *pgs, ulong now)
+{
+    struct ipv4Pkt *ip;
+    struct udpPkt *udp;
+    struct pgHdr *hdr;
+    uint len, sum;
+
+    ip = (struct ipv4Pkt *)(pgs->frame + ETH_HDR_LEN);
+    udp = (struct udpPkt *)(pgs->frame + ETH_HDR_LEN + IPv4_HDR_LEN);
+    hdr = (struct pgHdr *)udp->data;
+
+    len = pgs->minlen;
+    if (pgs->maxlen > pgs->minlen)
+    {
+        len += pgs->seq % (pgs->maxlen - pgs->minlen + 1);
+    }
+
+    ip->len = hs2net(len - ETH_HDR_LEN);
+    sum = pgs->ipsum + ip->len;
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum += (sum >> 16);
+    ip->chksum = ~sum;
+    udp->len = hs2net(len - ETH_HDR_LEN - IPv4_HDR_LEN);
+    hdr->seq = hl2net(pgs->seq);
+    hdr->stamp = hl2net(now);
+
+    pgs->seq++;
+    pgs->credit++;
+    if (SYSERR == write(pgs->dev, pgs->frame, len))
+    {
+        pgs->errors++;
+    }
+    else
+    {
+        pgs->bytes += len;
+    }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file pktgenAlloc.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <pktgen.h>
+#include <stdlib.h>
+
+/**
+ * @ingroup pktgen
+ *
+ * Allocate a packet generator stream.  The caller sets the stream's device,
+ * frame lengths, rate and count before starting it with pktgenStart().
+ * @return stream number, SYSERR if all streams are in use
+ */
+int pktgenAlloc(void)
+{
+    irqmask im;
+    int i;
+
+    im = disable();
+    for (i = 0; i < PKTGEN_NSTREAM; i++)
+    {
+        if (PKTGEN_FREE == pgtab[i].state)
+        {
+            bzero(&pgtab[i], sizeof(struct pgStream));
+            pgtab[i].state = PKTGEN_DONE;
+            restore(im);
+            return i;
+        }
+    }
+    restore(im);
+    return SYSERR;
+}
+
+/**
+ * @ingroup pktgen
+ *
+ * Free a packet generator stream, stopping it first if it is running.
+ * @param stream stream number
+ * @return OK if freed succesfully, otherwise SYSERR
+ */
+syscall pktgenFree(int stream)
+{
+    if (stream < 0 || stream >= PKTGEN_NSTREAM
+        || PKTGEN_FREE == pgtab[stream].state)
+    {
+        return SYSERR;
+    }
+    pktgenStop(stream);
+    pgtab[stream].state = PKTGEN_FREE;
+    return OK;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file pktgenSink.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <device.h>
+#include <interrupt.h>
+#include <pktgen.h>
+#include <stdlib.h>
+
+struct pgSink pgsink;
+
+/**
+ * @ingroup pktgen
+ *
+ * Start the receive-side sink for generated traffic.  The sink reads UDP
+ * datagrams sent to a port of an interface and keeps per-stream counts of
+ * received, lost and reordered frames and a histogram of latencies.
+ * Latencies compare the sender's timestamp against the local clock and are
+ * only meaningful when both clocks agree, e.g. for loopback traffic.
+ * @param descrp underlying device of the network interface to listen on
+ * @param port UDP port to listen on
+ * @return OK if started succesfully, otherwise SYSERR
+ */
+syscall pktgenSinkStart(int descrp, ushort port)
+{
+    struct netif *nif;
+    ushort dev;
+
+    if (PKTGEN_FREE != pgsink.state)
+    {
+        return SYSERR;
+    }
+
+    nif = netLookup(descrp);
+    if (NULL == nif)
+    {
+        return SYSERR;
+    }
+
+    dev = udpAlloc();
+    if ((ushort)SYSERR == dev)
+    {
+        return SYSERR;
+    }
+    if (SYSERR == open(dev, &nif->ip, NULL, port, NULL))
+    {
+        udptab[devtab[dev].minor].state = UDP_FREE;
+        return SYSERR;
+    }
+
+    bzero(&pgsink, sizeof(struct pgSink));
+    pgsink.dev = dev;
+    pgsink.state = PKTGEN_RUN;
+    pgsink.tid = create((void *)pktgenSink, PKTGEN_THR_STK,
+                        PKTGEN_THR_PRIO, "pktgenSink", 0);
+    if (SYSERR == pgsink.tid)
+    {
+        close(dev);
+        pgsink.state = PKTGEN_FREE;
+        return SYSERR;
+    }
+    ready(pgsink.tid, RESCHED_NO);
+
+    return OK;
+}
+
+/**
+ * @ingroup pktgen
+ *
+ * Stop the sink.  Its statistics are kept until the sink is started again.
+ * @return OK if stopped succesfully, otherwise SYSERR
+ */
+syscall pktgenSinkStop(void)
+{
+    if (PKTGEN_RUN != pgsink.state)
+    {
+        return SYSERR;
+    }
+    pgsink.state = PKTGEN_FREE;
+
+    /* closing the device wakes the sink thread, which then exits */
+    return close(pgsink.dev);
+}
+
+/**
+ * @ingroup pktgen
+ *
+ * Sink thread.  Reads datagrams until the sink device is closed and updates
+ * the statistics of the stream each one belongs to.
+ * @return OK when the sink is stopped
+ */
+thread pktgenSink(void)
+{
+    uchar buf[UDP_MAX_DATALEN];
+    struct pgHdr *hdr;
+    struct pgFlow *flow;
+    ulong stream, seq, lat;
+    int len, bucket;
+
+    hdr = (struct pgHdr *)buf;
+    while (SYSERR != (len = read(pgsink.dev, buf, UDP_MAX_DATALEN)))
+    {
+        stream = net2hl(hdr->stream);
+        if (len < (int)sizeof(struct pgHdr)
+            || PKTGEN_MAGIC != net2hl(hdr->magic)
+            || stream >= PKTGEN_NSTREAM)
+        {
+            pgsink.nbad++;
+            continue;
+        }
+        flow = &pgsink.flows[stream];
+        flow->nrecv++;
+
+        /* a gap counts as loss until the missing frames turn up late */
+        seq = net2hl(hdr->seq);
+        if (seq >= flow->next)
+        {
+            flow->nlost += seq - flow->next;
+            flow->next = seq + 1;
+        }
+        else
+        {
+            flow->nreorder++;
+            if (flow->nlost > 0)
+            {
+                flow->nlost--;
+            }
+        }
+
+        lat = pktgenNow() - net2hl(hdr->stamp);
+        if (1 == flow->nrecv || lat < flow->latmin)
+        {
+            flow->latmin = lat;
+        }
+        if (lat > flow->latmax)
+        {
+            flow->latmax = lat;
+        }
+        flow->lattotal += lat;
+
+        /* bucket n holds latencies of [2^(n-1), 2^n) ms, bucket 0 holds 0 */
+        for (bucket = 0; lat > 0 && bucket < PKTGEN_NHIST - 1; bucket++)
+        {
+            lat >>= 1;
+        }
+        flow->hist[bucket]++;
+    }
+
+    return OK;
+}
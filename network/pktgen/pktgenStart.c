@@ -0,0 +1,125 @@
+/**
+ * @file pktgenStart.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <device.h>
+#include <interrupt.h>
+#include <pktgen.h>
+
+/**
+ * @ingroup pktgen
+ *
+ * Build the frame template of a stream and start sending.  The stream's
+ * device, frame lengths, rate and count must already be set.  Every frame is
+ * a UDP datagram whose payload starts with a ::pgHdr, so a sink started with
+ * pktgenSinkStart() can measure the stream.
+ * @param stream stream number returned by pktgenAlloc()
+ * @param dstmac destination hardware address
+ * @param src source IPv4 address
+ * @param dst destination IPv4 address
+ * @param srcpt UDP source port
+ * @param dstpt UDP destination port
+ * @return OK if started succesfully, otherwise SYSERR
+ */
+syscall pktgenStart(int stream, uchar *dstmac, struct netaddr *src,
+                    struct netaddr *dst, ushort srcpt, ushort dstpt)
+{
+    struct pgStream *pgs;
+    struct etherPkt *eth;
+    struct ipv4Pkt *ip;
+    struct udpPkt *udp;
+    struct pgHdr *hdr;
+    ushort *word;
+    uint i;
+    irqmask im;
+
+    if (stream < 0 || stream >= PKTGEN_NSTREAM)
+    {
+        return SYSERR;
+    }
+    pgs = &pgtab[stream];
+    if (PKTGEN_DONE != pgs->state || isbaddev(pgs->dev)
+        || pgs->minlen < PKTGEN_MINLEN || pgs->maxlen > PKTGEN_MAXLEN
+        || pgs->minlen > pgs->maxlen)
+    {
+        return SYSERR;
+    }
+
+    /* Ethernet */
+    eth = (struct etherPkt *)pgs->frame;
+    memcpy(eth->dst, dstmac, ETH_ADDR_LEN);
+    if (SYSERR == control(pgs->dev, ETH_CTRL_GET_MAC, (long)eth->src, 0))
+    {
+        return SYSERR;
+    }
+    eth->type = hs2net(ETHER_TYPE_IPv4);
+
+    /* IPv4, length and checksum are filled in per frame */
+    ip = (struct ipv4Pkt *)(pgs->frame + ETH_HDR_LEN);
+    ip->ver_ihl = (IPv4_VERSION << 4) | (IPv4_HDR_LEN >> 2);
+    ip->tos = IPv4_TOS_ROUTINE;
+    ip->len = 0;
+    ip->id = 0;
+    ip->flags_froff = 0;
+    ip->ttl = IPv4_TTL;
+    ip->proto = IPv4_PROTO_UDP;
+    ip->chksum = 0;
+    memcpy(ip->src, src->addr, IPv4_ADDR_LEN);
+    memcpy(ip->dst, dst->addr, IPv4_ADDR_LEN);
+
+    /* sum the constant header words once for every frame */
+    pgs->ipsum = 0;
+    word = (ushort *)ip;
+    for (i = 0; i < IPv4_HDR_LEN / 2; i++)
+    {
+        pgs->ipsum += word[i];
+    }
+
+    /* UDP, without checksum */
+    udp = (struct udpPkt *)(pgs->frame + ETH_HDR_LEN + IPv4_HDR_LEN);
+    udp->srcPort = hs2net(srcpt);
+    udp->dstPort = hs2net(dstpt);
+    udp->len = 0;
+    udp->chksum = 0;
+
+    /* pktgen header, then a fixed fill pattern */
+    hdr = (struct pgHdr *)udp->data;
+    hdr->magic = hl2net(PKTGEN_MAGIC);
+    hdr->stream = hl2net(stream);
+    hdr->seq = 0;
+    hdr->stamp = 0;
+    for (i = PKTGEN_MINLEN; i < pgs->maxlen; i++)
+    {
+        pgs->frame[i] = i;
+    }
+
+    im = disable();
+    pgs->start = pktgenNow();
+    pgs->stop = 0;
+    pgs->epoch = pgs->start;
+    pgs->credit = 0;
+    pgs->seq = 0;
+    pgs->errors = 0;
+    pgs->bytes = 0;
+    pgs->state = PKTGEN_RUN;
+
+    if (BADTID == pgtid)
+    {
+        pgtid = create((void *)pktgen, PKTGEN_THR_STK, PKTGEN_THR_PRIO,
+                       "pktgen", 0);
+        if (SYSERR == pgtid)
+        {
+            pgtid = BADTID;
+            pgs->state = PKTGEN_DONE;
+            restore(im);
+            return SYSERR;
+        }
+        ready(pgtid, RESCHED_NO);
+    }
+    restore(im);
+
+    return OK;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file pktgenStop.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <interrupt.h>
+#include <pktgen.h>
+
+/**
+ * @ingroup pktgen
+ *
+ * Stop a packet generator stream.  Its statistics are kept until the stream
+ * is freed or restarted.
+ * @param stream stream number
+ * @return OK if stopped succesfully, otherwise SYSERR
+ */
+syscall pktgenStop(int stream)
+{
+    struct pgStream *pgs;
+    irqmask im;
+
+    if (stream < 0 || stream >= PKTGEN_NSTREAM)
+    {
+        return SYSERR;
+    }
+    pgs = &pgtab[stream];
+
+    im = disable();
+    if (PKTGEN_RUN != pgs->state)
+    {
+        restore(im);
+        return SYSERR;
+    }
+    pgs->stop = pktgenNow();
+    pgs->state = PKTGEN_DONE;
+    restore(im);
+    return OK;
+}
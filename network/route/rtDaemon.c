@@ -5,7 +5,6 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <stddef.h>
-#include <mailbox.h>
 #include <network.h>
 #include <route.h>
 #include <thread.h>
@@ -18,16 +17,17 @@
 thread rtDaemon(void)
 {
     struct packet *pkt = NULL;
+    int type;
 
     while (TRUE)
     {
-        pkt = (struct packet *)mailboxReceive(rtqueue);
-        RT_TRACE("Daemon received packet");
-        if (SYSERR == (int)pkt)
+        if ((OK != recvbuf(&type, (void **)&pkt, NULL))
+            || (RT_MSG_PKT != type))
         {
-            RT_TRACE("Daemon received packet has an error");
+            RT_TRACE("Daemon received message that is not a packet");
             continue;
         }
+        RT_TRACE("Daemon received packet");
 
         rtSend(pkt);
         if (SYSERR == netFreebuf(pkt))
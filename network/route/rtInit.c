@@ -5,14 +5,13 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <stddef.h>
-#include <mailbox.h>
 #include <network.h>
 #include <route.h>
 #include <stdlib.h>
 #include <thread.h>
 
 struct rtEntry rttab[RT_NENTRY];
-mailbox rtqueue;
+tid_typ rtdaemon;
 
 /**
  * @ingroup route
@@ -31,17 +30,14 @@ syscall rtInit(void)
         rttab[i].state = RT_FREE;
     }
 
-    /* Initialize route queue */
-    rtqueue = mailboxAlloc(RT_NQUEUE);
-    if (SYSERR == rtqueue)
+    /* Spawn rtDaemon thread, its message queue holds pending packets */
+    rtdaemon = createq((void *)rtDaemon, RT_THR_STK, RT_THR_PRIO,
+                       RT_NQUEUE, "rtDaemon", 0);
+    if (SYSERR == rtdaemon)
     {
         return SYSERR;
     }
-
-    /* Spawn rtDameon thread */
-    ready(create
-          ((void *)rtDaemon, RT_THR_STK, RT_THR_PRIO, "rtDaemon", 0),
-          RESCHED_NO);
+    ready(rtdaemon, RESCHED_NO);
 
     return OK;
 }
@@ -6,7 +6,7 @@
 
 #include <stddef.h>
 #include <interrupt.h>
-#include <mailbox.h>
+#include <thread.h>
 #include <network.h>
 #include <route.h>
 
@@ -23,9 +23,9 @@ syscall rtRecv(struct packet *pkt)
         return SYSERR;
     }
 
-    /* If route queue is full, then drop packet */
+    /* Hand packet to route daemon, dropping it if the queue is full */
     im = disable();
-    if (mailboxCount(rtqueue) >= RT_NQUEUE)
+    if (SYSERR == sendbuf(rtdaemon, RT_MSG_PKT, pkt, pkt->len))
     {
         restore(im);
         RT_TRACE("Route queue full");
@@ -33,15 +33,6 @@ syscall rtRecv(struct packet *pkt)
         return OK;
     }
 
-    /* Place packet in queue */
-    if (SYSERR == mailboxSend(rtqueue, (int)pkt))
-    {
-        restore(im);
-        RT_TRACE("Failed to enqueue packet");
-        netFreebuf(pkt);
-        return SYSERR;
-    }
-
     restore(im);
     RT_TRACE("Enqueued packet for routing");
     return OK;
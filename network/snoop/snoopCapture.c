@@ -4,18 +4,25 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <stddef.h>
+#include <interrupt.h>
 #include <snoop.h>
 
 /**
  * @ingroup snoop
  *
- * Captures a network packet from a network interface.
+ * Captures a network packet from a network interface.  The packet is run
+ * through the capture's filter program, which also decides how many bytes to
+ * capture, and a matching packet is copied into the next free slot of the
+ * capture ring.  Interrupts are only disabled long enough to claim the slot
+ * and to publish it, not while copying, so the caller (usually netRecv() or netSend()) never blocks and no network
+ * buffers are used.
  * @return OK if capture was successful, otherwise SYSERR
  */
 int snoopCapture(struct snoop *cap, struct packet *pkt)
 {
-    struct packet *buf;
-    int len;
+    struct snoopSlot *slot;
+    uint len, n;
+    irqmask im;
 
     /* Error check pointers */
     if ((NULL == cap) || (NULL == pkt))
@@ -29,7 +36,8 @@ int snoopCapture(struct snoop *cap, struct packet *pkt)
     cap->ncap++;
 
     /* Check if packet matches capture filter, if not return OK */
-    if (FALSE == snoopFilter(cap, pkt))
+    len = snoopFilterRun(cap->prog, cap->proglen, pkt->curr, pkt->len);
+    if (0 == len)
     {
         SNOOP_TRACE("Packet does not match filter");
         return OK;
@@ -38,40 +46,61 @@ int snoopCapture(struct snoop *cap, struct packet *pkt)
     /* Increment count of packets matching filter */
     cap->nmatch++;
 
-    /* Try to get a buffer to put packet into */
-    buf = netGetbuf();
-    if (SYSERR == (int)buf)
+    /* Claim the next slot of the ring */
+    im = disable();
+    if (cap->head - cap->tail >= cap->nslots)
     {
-        SNOOP_TRACE("Failed to get buffer");
+        cap->novrn++;
+        restore(im);
+        SNOOP_TRACE("Capture queue full");
         return SYSERR;
     }
+    slot = (struct snoopSlot *)(cap->ring
+                                + (cap->head % cap->nslots) * cap->slotlen);
+    cap->head++;
+    restore(im);
 
-    /* Copy packet header into buffer */
-    memcpy(buf, pkt, sizeof(struct packet));
-
-    /* Copy packet contents into buffer */
-    len = pkt->len;
-    if (len > cap->caplen)
+    /* Copy packet contents into slot */
+    if (len > pkt->len)
+    {
+        len = pkt->len;
+    }
+    if ((0 != cap->caplen) && (len > cap->caplen))
     {
         len = cap->caplen;
     }
-    memcpy(buf->data, pkt->curr, len);
-    buf->curr = buf->data;
+    if (len > cap->slotcap)
+    {
+        len = cap->slotcap;
+    }
+    slot->pkt.nif = pkt->nif;
+    slot->pkt.len = len;
+    slot->pkt.linkhdr = slot->pkt.data;
+    slot->pkt.nethdr = NULL;
+    slot->pkt.curr = slot->pkt.data;
+    memcpy(slot->pkt.data, pkt->curr, len);
 
-    /* Queue packet */
-    if (mailboxCount(cap->queue) >= SNOOP_QLEN)
+    /* Publish filled slots to the reader in the order they were claimed,
+     * so the slot the reader takes next is always full */
+    n = 0;
+    im = disable();
+    slot->full = TRUE;
+    while (cap->published != cap->head)
     {
-        netFreebuf(buf);
-        cap->novrn++;
-        SNOOP_TRACE("Capture queue full");
-        return SYSERR;
+        slot = (struct snoopSlot *)(cap->ring + (cap->published % cap->nslots)
+                                    * cap->slotlen);
+        if (!slot->full)
+        {
+            break;
+        }
+        cap->published++;
+        n++;
     }
-    if (SYSERR == mailboxSend(cap->queue, (int)buf))
+    if (n > 0)
     {
-        netFreebuf(buf);
-        SNOOP_TRACE("Failed to enqueue packet");
-        return SYSERR;
+        signaln(cap->ready, n);
     }
+    restore(im);
 
     return OK;
 }
@@ -5,8 +5,10 @@
 
 #include <stddef.h>
 #include <interrupt.h>
+#include <memory.h>
 #include <network.h>
 #include <snoop.h>
+#include <thread.h>
 
 /**
  * @ingroup snoop
@@ -17,7 +19,6 @@
  */
 int snoopClose(struct snoop *cap)
 {
-    struct packet *pkt;
     int i;
     irqmask im;
 
@@ -40,18 +41,16 @@ int snoopClose(struct snoop *cap)
 #endif
     restore(im);
 
-    /* Free queued packets */
-    while (mailboxCount(cap->queue) > 0)
+    /* Capturers that claimed a slot before the capture was removed may
+     * still be copying into the ring; let them finish */
+    while (cap->published != cap->head)
     {
-        pkt = (struct packet *)mailboxReceive(cap->queue);
-        if (SYSERR == netFreebuf(pkt))
-        {
-            return SYSERR;
-        }
+        sleep(1);
     }
 
-    /* Free mailbox */
-    if (SYSERR == mailboxFree(cap->queue))
+    /* Free capture ring, along with any packets still in it */
+    if ((SYSERR == semfree(cap->ready))
+        || (SYSERR == memfree(cap->ring, cap->nslots * cap->slotlen)))
     {
         return SYSERR;
     }
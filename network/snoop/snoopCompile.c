@@ -0,0 +1,241 @@
+/* @file snoopCompile.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <arp.h>
+#include <ipv4.h>
+#include <network.h>
+#include <snoop.h>
+
+/* Offsets of fields from start of an Ethernet frame */
+#define OFF_ETHTYPE     12
+#define OFF_ARP_LENS    (ETH_HDR_LEN + 4)       /* hwalen and pralen */
+#define OFF_ARP_SPA     (ETH_HDR_LEN + ARP_CONST_HDR_LEN + ETH_ADDR_LEN)
+#define OFF_ARP_DPA     (OFF_ARP_SPA + IPv4_ADDR_LEN + ETH_ADDR_LEN)
+#define OFF_IP_FRAG     (ETH_HDR_LEN + 6)
+#define OFF_IP_PROTO    (ETH_HDR_LEN + 9)
+#define OFF_IP_SRC      (ETH_HDR_LEN + 12)
+#define OFF_IP_DST      (ETH_HDR_LEN + 16)
+
+/* Jump target placeholder for the final reject instruction */
+#define REJECT          0xff
+
+static int emit(struct snoop *s, ushort code, ulong k, uchar jt, uchar jf);
+static ulong addr2k(const struct netaddr *addr);
+
+/**
+ * @ingroup snoop
+ *
+ * Compile the filter settings of a capture (type, addresses and ports) into
+ * its filter program.  The program accepts matching packets with a capture
+ * length of cap->caplen, or the whole packet if cap->caplen is 0.  Captures
+ * may instead be given a hand-written program by setting cap->prog and
+ * cap->proglen before snoopOpen().
+ * @param s pointer to capture structure
+ * @return OK if compiled successfully, otherwise SYSERR
+ */
+int snoopCompile(struct snoop *s)
+{
+    int arp, skip, reject, i;
+    uchar proto;
+
+    s->proglen = 0;
+
+    /* Packet type */
+    switch (s->type)
+    {
+    case SNOOP_FILTER_ALL:
+        break;
+    case SNOOP_FILTER_ARP:
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_ETHTYPE, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             ETHER_TYPE_ARP, 0, REJECT);
+        break;
+    case SNOOP_FILTER_IPv4:
+    case SNOOP_FILTER_UDP:
+    case SNOOP_FILTER_TCP:
+    case SNOOP_FILTER_ICMP:
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_ETHTYPE, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             ETHER_TYPE_IPv4, 0, REJECT);
+        if (SNOOP_FILTER_IPv4 == s->type)
+        {
+            break;
+        }
+        proto = IPv4_PROTO_ICMP;
+        if (SNOOP_FILTER_UDP == s->type)
+        {
+            proto = IPv4_PROTO_UDP;
+        }
+        else if (SNOOP_FILTER_TCP == s->type)
+        {
+            proto = IPv4_PROTO_TCP;
+        }
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_B | SNOOP_BPF_ABS, OFF_IP_PROTO, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K, proto, 0,
+             REJECT);
+        break;
+    default:
+        return SYSERR;
+    }
+
+    /* Addresses, which may be those of ARP or IPv4 packets */
+    if ((NULL != s->srcaddr.type) || (NULL != s->dstaddr.type))
+    {
+        if (((NULL != s->srcaddr.type) && (IPv4_ADDR_LEN != s->srcaddr.len))
+            || ((NULL != s->dstaddr.type)
+                && (IPv4_ADDR_LEN != s->dstaddr.len)))
+        {
+            return SYSERR;
+        }
+
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_ETHTYPE, 0,
+             0);
+        arp = emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                   ETHER_TYPE_ARP, 0, 0);
+
+        /* ARP over Ethernet with IPv4 protocol addresses */
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_ARP_LENS, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             (ETH_ADDR_LEN << 8) | IPv4_ADDR_LEN, 0, REJECT);
+        if (NULL != s->srcaddr.type)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_W | SNOOP_BPF_ABS, OFF_ARP_SPA,
+                 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 addr2k(&s->srcaddr), 0, REJECT);
+        }
+        if (NULL != s->dstaddr.type)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_W | SNOOP_BPF_ABS, OFF_ARP_DPA,
+                 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 addr2k(&s->dstaddr), 0, REJECT);
+        }
+        skip = emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JA, 0, 0, 0);
+
+        /* IPv4 */
+        if (SYSERR != arp)
+        {
+            s->prog[arp].jf = s->proglen - (arp + 1);
+        }
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             ETHER_TYPE_IPv4, 0, REJECT);
+        if (NULL != s->srcaddr.type)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_W | SNOOP_BPF_ABS, OFF_IP_SRC,
+                 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 addr2k(&s->srcaddr), 0, REJECT);
+        }
+        if (NULL != s->dstaddr.type)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_W | SNOOP_BPF_ABS, OFF_IP_DST,
+                 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 addr2k(&s->dstaddr), 0, REJECT);
+        }
+        if (SYSERR != skip)
+        {
+            s->prog[skip].k = s->proglen - (skip + 1);
+        }
+    }
+
+    /* Ports of unfragmented UDP and TCP packets */
+    if ((0 != s->srcport) || (0 != s->dstport))
+    {
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_ETHTYPE, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             ETHER_TYPE_IPv4, 0, REJECT);
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_B | SNOOP_BPF_ABS, OFF_IP_PROTO, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             IPv4_PROTO_UDP, 1, 0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+             IPv4_PROTO_TCP, 0, REJECT);
+        emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_ABS, OFF_IP_FRAG, 0,
+             0);
+        emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JSET | SNOOP_BPF_K, IPv4_FROFF,
+             REJECT, 0);
+        emit(s, SNOOP_BPF_LDX | SNOOP_BPF_B | SNOOP_BPF_MSH, ETH_HDR_LEN, 0,
+             0);
+        if (0 != s->srcport)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_IND,
+                 ETH_HDR_LEN, 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 s->srcport, 0, REJECT);
+        }
+        if (0 != s->dstport)
+        {
+            emit(s, SNOOP_BPF_LD | SNOOP_BPF_H | SNOOP_BPF_IND,
+                 ETH_HDR_LEN + 2, 0, 0);
+            emit(s, SNOOP_BPF_JMP | SNOOP_BPF_JEQ | SNOOP_BPF_K,
+                 s->dstport, 0, REJECT);
+        }
+    }
+
+    emit(s, SNOOP_BPF_RET | SNOOP_BPF_K,
+         (0 != s->caplen) ? s->caplen : NET_MAX_PKTLEN, 0, 0);
+    reject = emit(s, SNOOP_BPF_RET | SNOOP_BPF_K, 0, 0, 0);
+    if (SYSERR == reject)
+    {
+        s->proglen = 0;
+        return SYSERR;
+    }
+
+    /* Point jumps at the reject instruction */
+    for (i = 0; i < reject; i++)
+    {
+        if (SNOOP_BPF_JMP != SNOOP_BPF_CLASS(s->prog[i].code))
+        {
+            continue;
+        }
+        if (REJECT == s->prog[i].jt)
+        {
+            s->prog[i].jt = reject - (i + 1);
+        }
+        if (REJECT == s->prog[i].jf)
+        {
+            s->prog[i].jf = reject - (i + 1);
+        }
+    }
+
+    return OK;
+}
+
+/*
+ * Append an instruction to the filter program.
+ * @return index of instruction, SYSERR if the program is full
+ */
+static int emit(struct snoop *s, ushort code, ulong k, uchar jt, uchar jf)
+{
+    struct snoopInsn *insn;
+
+    if (s->proglen >= SNOOP_PROG_LEN)
+    {
+        return SYSERR;
+    }
+    insn = &s->prog[s->proglen];
+    insn->code = code;
+    insn->jt = jt;
+    insn->jf = jf;
+    insn->k = k;
+    return s->proglen++;
+}
+
+/*
+ * Convert an IPv4 address to the value of a word load of it.
+ */
+static ulong addr2k(const struct netaddr *addr)
+{
+    return ((ulong)addr->addr[0] << 24) | (addr->addr[1] << 16)
+        | (addr->addr[2] << 8) | addr->addr[3];
+}
@@ -4,204 +4,188 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <stddef.h>
-#include <arp.h>
-#include <ipv4.h>
 #include <network.h>
 #include <snoop.h>
-#include <string.h>
 
 /**
  * @ingroup snoop
  *
- * Determine if a packet matches the filter.
+ * Determine if a packet matches the filter.  If the capture has no filter
+ * program yet, one is compiled from its filter settings first.
  * @return TRUE if packet matches filter, otherwise FALSE
  */
 bool snoopFilter(struct snoop *s, struct packet *pkt)
 {
-    struct etherPkt *ether = NULL;
-    struct arpPkt *arp = NULL;
-    struct ipv4Pkt *ip = NULL;
-
-    /* Packet matches filter if there is no filter */
-    if ((NULL == s->type)
-        && (NULL == s->srcaddr.type) && (NULL == s->srcport)
-        && (NULL == s->dstaddr.type) && (NULL == s->dstport))
-    {
-        return TRUE;
-    }
-
-    /* Ensure packet is valid size, otherwise it can't be filtered */
-    if (pkt->len < ETH_HDR_LEN)
+    if ((0 == s->proglen) && (SYSERR == snoopCompile(s)))
     {
-        /* Packet is too small to have Ethernet header */
         return FALSE;
     }
-    else
-    {
-        ether = (struct etherPkt *)pkt->curr;
-        switch (net2hs(ether->type))
-        {
-        case ETHER_TYPE_ARP:
-            if (pkt->len < (ETH_HDR_LEN + ARP_CONST_HDR_LEN))
-            {
-                /* Packet is too small to have ARP header */
-                return FALSE;
-            }
-            arp = (struct arpPkt *)ether->data;
-            if (pkt->len < (ETH_HDR_LEN + ARP_CONST_HDR_LEN +
-                            (2 * arp->hwalen) + (2 * arp->pralen)))
-            {
-                /* Packet is too small to have ARP header */
-                return FALSE;
-            }
-            break;
-        case ETHER_TYPE_IPv4:
-            if (pkt->len < (ETH_HDR_LEN + IPv4_HDR_LEN))
-            {
-                /* Packet is too small to have IPv4 header */
-                return FALSE;
-            }
-            ip = (struct ipv4Pkt *)ether->data;
-            break;
-        default:
-            /* Don't know how to filter other Ethernet types */
-            return FALSE;
-        }
-    }
+    return (0 != snoopFilterRun(s->prog, s->proglen, pkt->curr, pkt->len));
+}
 
-    /* If code reaches here, the packet is a valid length */
+/**
+ * @ingroup snoop
+ *
+ * Run a filter program over a packet.  Loads outside of the packet and
+ * jumps outside of the program reject the packet, so any program is safe
+ * to run.  Multi-byte loads are in network byte order.
+ * @param prog filter program
+ * @param proglen number of instructions in program
+ * @param data start of packet
+ * @param len length of packet
+ * @return number of bytes of packet to capture, 0 if the packet is rejected
+ */
+uint snoopFilterRun(const struct snoopInsn *prog, uint proglen,
+                    const uchar *data, uint len)
+{
+    const struct snoopInsn *insn;
+    ulong a = 0;
+    ulong x = 0;
+    ulong k, src;
+    uint pc;
 
-    /* Check if packet type matches */
-    if (s->type != NULL)
+    for (pc = 0; pc < proglen; pc++)
     {
-        /* Check Ethernet type */
-        switch (net2hs(ether->type))
+        insn = &prog[pc];
+        switch (SNOOP_BPF_CLASS(insn->code))
         {
-        case ETHER_TYPE_ARP:
-            if (s->type != SNOOP_FILTER_ARP)
-            {
-                return FALSE;
-            }
-            break;
-        case ETHER_TYPE_IPv4:
-            if (s->type != SNOOP_FILTER_IPv4)
+        case SNOOP_BPF_LD:
+        case SNOOP_BPF_LDX:
+            k = insn->k;
+            switch (SNOOP_BPF_MODE(insn->code))
             {
-                /* Check IP protocol */
-                switch (ip->proto)
+            case SNOOP_BPF_IMM:
+                src = k;
+                break;
+            case SNOOP_BPF_LEN:
+                src = len;
+                break;
+            case SNOOP_BPF_MSH:
+                if (k >= len)
+                {
+                    return 0;
+                }
+                src = (data[k] & 0xf) << 2;
+                break;
+            case SNOOP_BPF_IND:
+                k += x;
+                /* fall through */
+            case SNOOP_BPF_ABS:
+                switch (SNOOP_BPF_SIZE(insn->code))
                 {
-                case IPv4_PROTO_UDP:
-                    if (s->type != SNOOP_FILTER_UDP)
+                case SNOOP_BPF_W:
+                    if (k + 4 > len || k + 4 < k)
                     {
-                        return FALSE;
+                        return 0;
                     }
+                    src = ((ulong)data[k] << 24) | (data[k + 1] << 16)
+                        | (data[k + 2] << 8) | data[k + 3];
                     break;
-                case IPv4_PROTO_TCP:
-                    if (s->type != SNOOP_FILTER_TCP)
+                case SNOOP_BPF_H:
+                    if (k + 2 > len || k + 2 < k)
                     {
-                        return FALSE;
+                        return 0;
                     }
+                    src = (data[k] << 8) | data[k + 1];
                     break;
-                case IPv4_PROTO_ICMP:
-                    if (s->type != SNOOP_FILTER_ICMP)
+                case SNOOP_BPF_B:
+                    if (k >= len)
                     {
-                        return FALSE;
+                        return 0;
                     }
+                    src = data[k];
                     break;
                 default:
-                    return FALSE;
+                    return 0;
                 }
+                break;
+            default:
+                return 0;
+            }
+            if (SNOOP_BPF_LD == SNOOP_BPF_CLASS(insn->code))
+            {
+                a = src;
+            }
+            else
+            {
+                x = src;
             }
             break;
-        default:
-            return FALSE;
-        }
-    }
-
-    /* If code reaches here, either there is no type filter 
-     * or the packet matches the type filter */
 
-    /* Check if packet source address matches */
-    if (s->srcaddr.type != NULL)
-    {
-        /* ARP */
-        if (arp != NULL)
-        {
-            if ((s->srcaddr.len != arp->pralen)
-                || (0 != memcmp(&arp->addrs[ARP_ADDR_SPA(arp)],
-                                s->srcaddr.addr, arp->pralen)))
+        case SNOOP_BPF_ALU:
+            src = (SNOOP_BPF_X == SNOOP_BPF_SRC(insn->code)) ? x : insn->k;
+            switch (SNOOP_BPF_OP(insn->code))
             {
-                return FALSE;
+            case SNOOP_BPF_ADD:
+                a += src;
+                break;
+            case SNOOP_BPF_SUB:
+                a -= src;
+                break;
+            case SNOOP_BPF_OR:
+                a |= src;
+                break;
+            case SNOOP_BPF_AND:
+                a &= src;
+                break;
+            case SNOOP_BPF_LSH:
+                a <<= src;
+                break;
+            case SNOOP_BPF_RSH:
+                a >>= src;
+                break;
+            default:
+                return 0;
             }
-        }
-        /* IPv4 */
-        else if (ip != NULL)
-        {
-            if ((s->srcaddr.len != IPv4_ADDR_LEN)
-                || (0 != memcmp(ip->src, s->srcaddr.addr, IPv4_ADDR_LEN)))
+            break;
+
+        case SNOOP_BPF_JMP:
+            src = (SNOOP_BPF_X == SNOOP_BPF_SRC(insn->code)) ? x : insn->k;
+            switch (SNOOP_BPF_OP(insn->code))
             {
-                return FALSE;
+            case SNOOP_BPF_JA:
+                if (insn->k >= proglen - pc)
+                {
+                    return 0;
+                }
+                pc += insn->k;
+                break;
+            case SNOOP_BPF_JEQ:
+                pc += (a == src) ? insn->jt : insn->jf;
+                break;
+            case SNOOP_BPF_JGT:
+                pc += (a > src) ? insn->jt : insn->jf;
+                break;
+            case SNOOP_BPF_JGE:
+                pc += (a >= src) ? insn->jt : insn->jf;
+                break;
+            case SNOOP_BPF_JSET:
+                pc += (a & src) ? insn->jt : insn->jf;
+                break;
+            default:
+                return 0;
             }
-        }
-        /* Unknown */
-        else
-        {
-            return FALSE;
-        }
-    }
+            break;
 
-    /* Check if packet destination address matches */
-    if (s->dstaddr.type != NULL)
-    {
-        /* ARP */
-        if (arp != NULL)
-        {
-            if ((s->dstaddr.len != arp->pralen)
-                || (0 != memcmp(&arp->addrs[ARP_ADDR_DPA(arp)],
-                                s->dstaddr.addr, arp->pralen)))
+        case SNOOP_BPF_RET:
+            return (SNOOP_BPF_A == (insn->code & SNOOP_BPF_A)) ? a : insn->k;
+
+        case SNOOP_BPF_MISC:
+            if (SNOOP_BPF_TXA == SNOOP_BPF_MISCOP(insn->code))
             {
-                return FALSE;
+                a = x;
             }
-        }
-        /* IPv4 */
-        else if (ip != NULL)
-        {
-            if ((s->dstaddr.len != IPv4_ADDR_LEN)
-                || (0 != memcmp(ip->dst, s->dstaddr.addr, IPv4_ADDR_LEN)))
+            else
             {
-                return FALSE;
+                x = a;
             }
-        }
-        /* Unknown */
-        else
-        {
-            return FALSE;
-        }
-    }
-
-    /* Check if packet ports match */
-    if ((s->srcport != NULL) || (s->dstport != NULL))
-    {
-        if (ip == NULL)
-        {
-            /* Only IP packets can be filtered by port */
-            return FALSE;
-        }
+            break;
 
-        switch (ip->proto)
-        {
-            //case IPv4_PROTO_TCP:
-            /* TODO */
-            //      break;
-            //case IPv4_PROTO_UDP:
-            /* TODO */
-            //      break;
-            //case IPv4_PROTO_ICMP:
-            /* TODO */
-            //      break;
         default:
-            return FALSE;
+            return 0;
         }
     }
 
-    return TRUE;
+    /* ran off the end of the program */
+    return 0;
 }
@@ -6,9 +6,12 @@
 #include <stddef.h>
 #include <device.h>
 #include <interrupt.h>
+#include <memory.h>
 #include <network.h>
 #include <snoop.h>
 
+static void snoopRelease(struct snoop *cap);
+
 /**
  * @ingroup snoop
  *
@@ -16,7 +19,8 @@
  * @param cap pointer to capture structure
  * @param name of underlying device, ALL for all network devices
  * @return OK if open was successful, otherwise SYSERR
- * @pre-condition filter settings should already be setup in cap
+ * @pre-condition filter settings, or a filter program, should already be
+ * setup in cap
  */
 int snoopOpen(struct snoop *cap, char *devname)
 {
@@ -38,11 +42,39 @@ int snoopOpen(struct snoop *cap, char *devname)
     cap->nmatch = 0;
     cap->novrn = 0;
 
-    /* Allocated mailbox for queue packets */
-    cap->queue = mailboxAlloc(SNOOP_QLEN);
-    if (SYSERR == (int)cap->queue)
+    /* Compile filter settings, unless given a filter program */
+    if ((0 == cap->proglen) && (SYSERR == snoopCompile(cap)))
+    {
+        SNOOP_TRACE("Failed to compile filter");
+        return SYSERR;
+    }
+
+    /* Allocate ring of slots for captured packets */
+    cap->slotcap = cap->caplen;
+    if ((0 == cap->slotcap) || (cap->slotcap > NET_MAX_PKTLEN))
+    {
+        cap->slotcap = NET_MAX_PKTLEN;
+    }
+    cap->slotlen = (sizeof(struct snoopSlot) + cap->slotcap + 3) & ~3;
+    cap->nslots = SNOOP_QLEN;
+    cap->head = 0;
+    cap->published = 0;
+    cap->tail = 0;
+    cap->ring = memget(cap->nslots * cap->slotlen);
+    if (SYSERR == (int)cap->ring)
+    {
+        SNOOP_TRACE("Failed to allocate capture ring");
+        return SYSERR;
+    }
+    for (i = 0; i < cap->nslots; i++)
+    {
+        ((struct snoopSlot *)(cap->ring + i * cap->slotlen))->full = FALSE;
+    }
+    cap->ready = semcreate(0);
+    if (SYSERR == cap->ready)
     {
-        SNOOP_TRACE("Failed to allocate mailbox");
+        SNOOP_TRACE("Failed to allocate semaphore");
+        memfree(cap->ring, cap->nslots * cap->slotlen);
         return SYSERR;
     }
 
@@ -65,7 +97,7 @@ int snoopOpen(struct snoop *cap, char *devname)
         if (0 == count)
         {
             SNOOP_TRACE("Capture not attached to any interface");
-            mailboxFree(cap->queue);
+            snoopRelease(cap);
             return SYSERR;
         }
         return OK;
@@ -76,7 +108,7 @@ int snoopOpen(struct snoop *cap, char *devname)
     if (SYSERR == devnum)
     {
         SNOOP_TRACE("Invalid device");
-        mailboxFree(cap->queue);
+        snoopRelease(cap);
         return SYSERR;
     }
     im = disable();
@@ -97,6 +129,15 @@ int snoopOpen(struct snoop *cap, char *devname)
     /* No network interface found */
     restore(im);
     SNOOP_TRACE("No network interface found");
-    mailboxFree(cap->queue);
+    snoopRelease(cap);
     return SYSERR;
 }
+
+/*
+ * Free the capture ring and semaphore of a capture that failed to open.
+ */
+static void snoopRelease(struct snoop *cap)
+{
+    semfree(cap->ready);
+    memfree(cap->ring, cap->nslots * cap->slotlen);
+}
@@ -5,16 +5,19 @@
 
 #include <stddef.h>
 #include <snoop.h>
+#include <thread.h>
 
 /**
  * @ingroup snoop
  *
- * Returns a packet captured from a network interface.
+ * Returns a packet captured from a network interface, waiting for one if
+ * the capture ring is empty.  The packet stays in the ring until it is
+ * released with snoopFree(); only one thread may read from a capture.
  * @return a packet if read was successful, otherwise SYSERR
  */
 struct packet *snoopRead(struct snoop *cap)
 {
-    struct packet *pkt;
+    struct snoopSlot *slot;
 
     /* Error check pointers */
     if (NULL == cap)
@@ -22,11 +25,42 @@ struct packet *snoopRead(struct snoop *cap)
         return (struct packet *)SYSERR;
     }
 
-    pkt = (struct packet *)mailboxReceive(cap->queue);
-    if ((SYSERR == (int)pkt) || (NULL == pkt))
+    if (SYSERR == wait(cap->ready))
     {
         return (struct packet *)SYSERR;
     }
 
-    return pkt;
+    /* Slots are published in order, so the oldest one is full */
+    slot = (struct snoopSlot *)(cap->ring
+                                + (cap->tail % cap->nslots) * cap->slotlen);
+    return &slot->pkt;
+}
+
+/**
+ * @ingroup snoop
+ *
+ * Releases the packet returned by the last snoopRead(), making its slot in
+ * the capture ring available again.
+ * @return OK if release was successful, otherwise SYSERR
+ */
+int snoopFree(struct snoop *cap, struct packet *pkt)
+{
+    struct snoopSlot *slot;
+
+    /* Error check pointers */
+    if ((NULL == cap) || (NULL == pkt))
+    {
+        return SYSERR;
+    }
+
+    slot = (struct snoopSlot *)(cap->ring
+                                + (cap->tail % cap->nslots) * cap->slotlen);
+    if ((pkt != &slot->pkt) || !slot->full)
+    {
+        return SYSERR;
+    }
+
+    slot->full = FALSE;
+    cap->tail++;
+    return OK;
 }
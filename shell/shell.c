@@ -7,6 +7,7 @@
 #include <stddef.h>
 #include <ctype.h>
 #include <interrupt.h>
+#include <kexec.h>
 #include <shell.h>
 #include <stdio.h>
 #include <string.h>
@@ -20,6 +21,9 @@
 const struct centry commandtab[] = {
 #if NETHER
     {"arp", FALSE, xsh_arp},
+#endif
+#if HAVE_TESTSUITE
+    {"bench", FALSE, xsh_bench},
 #endif
     {"clear", TRUE, xsh_clear},
     {"date", FALSE, xsh_date},
@@ -37,7 +41,7 @@ const struct centry commandtab[] = {
     {"gpiostat", FALSE, xsh_gpiostat},
 #endif
     {"help", FALSE, xsh_help},
-#if defined(ETH0) || defined(_XINU_PLATFORM_ARM_RPI_)
+#if HAVE_KEXEC
     {"kexec", FALSE, xsh_kexec},
 #endif
     {"kill", TRUE, xsh_kill},
@@ -46,6 +50,7 @@ const struct centry commandtab[] = {
 #endif
     {"memstat", FALSE, xsh_memstat},
     {"memdump", FALSE, xsh_memdump},
+    {"mutexstat", FALSE, xsh_mutexstat},
 #if NETHER
     {"nc", FALSE, xsh_nc},
     {"netdown", FALSE, xsh_netdown},
@@ -58,6 +63,7 @@ const struct centry commandtab[] = {
 #if NVRAM
     {"nvram", FALSE, xsh_nvram},
 #endif
+    {"prof", FALSE, xsh_prof},
     {"ps", FALSE, xsh_ps},
 #if NETHER
     {"ping", FALSE, xsh_ping},
@@ -67,6 +73,9 @@ const struct centry commandtab[] = {
     {"reset", FALSE, xsh_reset},
 #if NETHER
     {"route", FALSE, xsh_route},
+#endif
+#if NRTP
+    {"rtpstat", FALSE, xsh_rtpstat},
 #endif
     {"sleep", TRUE, xsh_sleep},
 #if NETHER
@@ -87,6 +96,7 @@ const struct centry commandtab[] = {
 #if NETHER
     {"timeserver", FALSE, xsh_timeserver},
 #endif
+    {"top", FALSE, xsh_top},
 #if FRAMEBUF
     {"turtle", FALSE, xsh_turtle},
 #endif
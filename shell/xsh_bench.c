@@ -0,0 +1,175 @@
+/**
+ * @file     xsh_bench.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <conf.h>
+
+#if HAVE_TESTSUITE
+
+#include <stddef.h>
+#include <bench.h>
+#include <shell.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void benchItem(int, uint, uint, uint, bool);
+static void usage(char *command);
+
+/**
+ * @ingroup shell
+ *
+ * Shell command (bench) runs microbenchmarks of Xinu primitives and reports
+ * the minimum, median, 99th percentile and maximum cost of each in cycles.
+ * With -m each result is printed as one line of key=value pairs starting
+ * with BENCH, so results can be collected from the console and compared.
+ * @param nargs number of arguments
+ * @param args  array of arguments
+ * @return non-zero value on error
+ */
+shellcmd xsh_bench(int nargs, char *args[])
+{
+    int arg, i, j;
+    uint iters, warmup, batch;
+    bool machine;
+    struct getopt opts;
+
+    if (2 == nargs && 0 == strcmp(args[1], "--help"))
+    {
+        usage(args[0]);
+        return 0;
+    }
+
+    iters = BENCH_ITER;
+    warmup = BENCH_WARMUP;
+    batch = BENCH_BATCH;
+    machine = FALSE;
+
+    opts.optreset = TRUE;
+    while ((arg = getopt(nargs, args, "i:w:b:m", &opts)) != -1)
+    {
+        switch (arg)
+        {
+        case 'i':
+            iters = atoi(opts.optarg);
+            break;
+        case 'w':
+            warmup = atoi(opts.optarg);
+            break;
+        case 'b':
+            batch = atoi(opts.optarg);
+            break;
+        case 'm':
+            machine = TRUE;
+            break;
+        default:
+            usage(args[0]);
+            return 1;
+        }
+    }
+    if (0 == iters || iters > BENCH_MAXITER || 0 == batch)
+    {
+        fprintf(stderr, "Iterations must be between 1 and %d and batch "
+                "at least 1.\n", BENCH_MAXITER);
+        return 1;
+    }
+
+    if (FALSE == machine)
+    {
+        printf("Cycles of %s per operation, %u samples of %u\n",
+               benchcounter, iters, batch);
+        printf("%-16s %10s %10s %10s %10s\n", "Benchmark", "min",
+               "median", "p99", "max");
+    }
+
+    /* No names runs every benchmark */
+    if (opts.optind == nargs)
+    {
+        for (i = 0; i < nbench; i++)
+        {
+            benchItem(i, warmup, iters, batch, machine);
+        }
+        return 0;
+    }
+
+    for (i = opts.optind; i < nargs; i++)
+    {
+        for (j = 0; j < nbench; j++)
+        {
+            if (0 == strcmp(args[i], benchtab[j].name))
+            {
+                break;
+            }
+        }
+        if (j == nbench)
+        {
+            fprintf(stderr, "%s: (%s) No such benchmark.\n", args[0],
+                    args[i]);
+            return 1;
+        }
+        benchItem(j, warmup, iters, batch, machine);
+    }
+
+    return 0;
+}
+
+static void usage(char *command)
+{
+    int i;
+
+    printf("Usage: %s [-m] [-i <iters>] [-w <warmup>] [-b <batch>] "
+           "[<name> ...]\n\n", command);
+    printf("Description:\n");
+    printf("\tBenchmarks of Xinu primitives.\n");
+    printf("Options:\n");
+    printf("\t--help\t\tdisplay this help and exit\n");
+    printf("\t-m\t\tmachine-readable output\n");
+    printf("\t-i <iters>\tnumber of timed samples [%d]\n", BENCH_ITER);
+    printf("\t-w <warmup>\tnumber of untimed operations [%d]\n",
+           BENCH_WARMUP);
+    printf("\t-b <batch>\toperations per timed sample [%d]\n", BENCH_BATCH);
+    printf("\t<name>\t\tif specified, benchmarks to run\n");
+
+    for (i = 0; i < nbench; i++)
+    {
+        printf("%-16s %s\n", benchtab[i].name, benchtab[i].desc);
+    }
+}
+
+static void benchItem(int benchnum, uint warmup, uint iters, uint batch,
+                      bool machine)
+{
+    struct benchcase *bc = &benchtab[benchnum];
+    struct benchresult result;
+
+    if (SYSERR == benchRun(bc, warmup, iters, batch, &result))
+    {
+        if (machine)
+        {
+            printf("BENCH name=%s counter=%s skipped\n", bc->name,
+                   benchcounter);
+        }
+        else
+        {
+            printf("%-16s %10s\n", bc->name, "skipped");
+        }
+        return;
+    }
+
+    if (machine)
+    {
+        printf("BENCH name=%s counter=%s iters=%u batch=%u min=%lu "
+               "median=%lu p99=%lu max=%lu overhead=%lu\n", bc->name,
+               benchcounter, result.iters, result.batch, result.min,
+               result.median, result.p99, result.max, result.overhead);
+    }
+    else
+    {
+        printf("%-16s %10lu %10lu %10lu %10lu\n", bc->name, result.min,
+               result.median, result.p99, result.max);
+    }
+}
+
+#endif /* HAVE_TESTSUITE */
@@ -26,7 +26,8 @@ shellcmd xsh_dumptlb(int nargs, char **args)
     {
         printf("Usage: %s\n\n", args[0]);
         printf("Description:\n");
-        printf("\tDisplays all the data in the TLB\n");
+        printf("\tDisplays all the data in the TLB and counts of\n");
+        printf("\tTLB misses\n");
         printf("Options:\n");
         printf("\t--help\tdisplays this help message then exits\n");
         return 0;
@@ -84,5 +85,9 @@ void dumptlb(void)
 
     /* reset to original asid */
   asm("mtc0 %0, $10": :"r"(asid));
+
+    kprintf("Page size: %d KB\r\n", (1 << PAGE_SHIFT) / 1024);
+    kprintf("Misses: %lu refilled, %lu slow, %lu faults\r\n",
+            tlbrefills, tlbslowmiss, tlbfaults);
 }
 #endif /* USE_TLB */
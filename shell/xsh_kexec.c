@@ -18,8 +18,13 @@
 
 static void usage(const char *command);
 
-static void kexec_from_network(int netdev);
-static void kexec_from_uart(int uartdev);
+static void kexec_from_network(int netdev, bool verify, ulong checksum);
+static void kexec_from_uart(int uartdev, bool verify, ulong checksum);
+static void kexec_staged(struct kexecstage *stage, bool verify,
+                         ulong checksum);
+#if defined(WITH_DHCPC) && NETHER != 0 && HAVE_KEXEC
+static int kexecStageCb(const uchar *data, uint len, void *ctx);
+#endif
 
 /**
  * @ingroup shell
@@ -29,6 +34,8 @@ static void kexec_from_uart(int uartdev);
 shellcmd xsh_kexec(int nargs, char *args[])
 {
     int dev;
+    bool verify = FALSE;
+    ulong checksum = 0;
 
     /* Output help, if '--help' argument was supplied */
     if (2 == nargs && 0 == strcmp(args[1], "--help"))
@@ -37,6 +44,24 @@ shellcmd xsh_kexec(int nargs, char *args[])
         return SHELL_OK;
     }
 
+    /* Optional expected Adler-32 checksum of the new kernel */
+    if (5 == nargs && 0 == strcmp(args[3], "-c"))
+    {
+        const char *hex = args[4];
+
+        if ('0' == hex[0] && ('x' == hex[1] || 'X' == hex[1]))
+        {
+            hex += 2;
+        }
+        if (1 != sscanf(hex, "%lx", &checksum))
+        {
+            fprintf(stderr, "ERROR: invalid checksum \"%s\".\n", args[4]);
+            return SHELL_ERROR;
+        }
+        verify = TRUE;
+        nargs = 3;
+    }
+
     if (3 != nargs)
     {
         fprintf(stderr, "ERROR: Wrong number of arguments.\n");
@@ -60,7 +85,7 @@ shellcmd xsh_kexec(int nargs, char *args[])
                     args[2]);
             return SHELL_ERROR;
         }
-        kexec_from_network(dev);
+        kexec_from_network(dev, verify, checksum);
     }
     else if (0 == strcmp(args[1], "-u"))
     {
@@ -78,7 +103,7 @@ shellcmd xsh_kexec(int nargs, char *args[])
                     args[2]);
             return SHELL_ERROR;
         }
-        kexec_from_uart(dev);
+        kexec_from_uart(dev, verify, checksum);
     }
     else
     {
@@ -91,7 +116,7 @@ shellcmd xsh_kexec(int nargs, char *args[])
 static void usage(const char *command)
 {
         printf(
-"Usage: %s\n\n"
+"Usage: %s (-n <NETDEV>|-u <UARTDEV>) [-c <CHECKSUM>]\n\n"
 "Description:\n"
 "\tLoads and executes a new kernel.\n"
 "Options:\n"
@@ -100,27 +125,26 @@ static void usage(const char *command)
 "\t               interface (if it's up), then use DHCP to get a network\n"
 "\t               address and information about the TFTP server hosting\n"
 "\t               the boot file.  The boot file (new kernel) will then be\n"
-"\t               downloaded using TFTP and executed.\n"
-#ifdef _XINU_PLATFORM_ARM_RPI_
+"\t               downloaded using TFTP directly into a staging area\n"
+"\t               and executed.\n"
 "\t-u <UARTDEV>   Load the new kernel over the specified UART device.\n"
-"\t               This is currently a Raspberry-Pi specific feature\n"
-"\t               and is designed to be used with \"raspbootcom\"\n"
+"\t               This is designed to be used with \"raspbootcom\"\n"
 "\t               running on the other end of the serial connection.\n"
-#endif
+"\t-c <CHECKSUM>  Refuse to execute the new kernel unless its Adler-32\n"
+"\t               checksum (in hexadecimal) matches CHECKSUM.\n"
 "\t--help         display this help and exit\n"
 
         , command);
 }
 
-static void kexec_from_network(int netdev)
+static void kexec_from_network(int netdev, bool verify, ulong checksum)
 {
-#if defined(WITH_DHCPC) && NETHER != 0
+#if defined(WITH_DHCPC) && NETHER != 0 && HAVE_KEXEC
     struct dhcpData data;
     int result;
     const struct netaddr *gatewayptr;
     struct netif *nif;
-    void *kernel;
-    uint size;
+    struct kexecstage stage;
     char str_ip[20];
     char str_mask[20];
     char str_gateway[20];
@@ -175,39 +199,41 @@ static void kexec_from_network(int netdev)
     netaddrsprintf(str_ip, &data.next_server);
     printf("Downloading bootfile \"%s\" from TFTP server %s\n",
            data.bootfile, str_ip);
-    kernel = (void*)tftpGetIntoBuffer(data.bootfile, &nif->ip,
-                                      &data.next_server, &size);
+    if (OK != kexecStageInit(&stage, 0))
+    {
+        fprintf(stderr, "ERROR: Out of memory for staging new kernel.\n");
+        return;
+    }
 
-    if (SYSERR == (int)kernel)
+    /* Each TFTP block is placed straight into the staging area as it
+     * arrives, so the download overlaps staging and checksumming.  */
+    result = tftpGet(data.bootfile, &nif->ip, &data.next_server,
+                     kexecStageCb, &stage);
+    if (OK != result)
     {
         fprintf(stderr, "ERROR: TFTP failed.\n");
+        kexecStageFree(&stage);
         return;
     }
 
-    /* Execute the new kernel.  */
-    printf("Executing new kernel (size=%u)\n", size);
-    sleep(100);  /* Wait just a fraction of a second for printf()s to finish
-                    (no guarantees though).  */
-    kexec(kernel, size);
+    kexec_staged(&stage, verify, checksum);
 
-    fprintf(stderr, "ERROR: kexec() returned!\n");
-
-#else /* WITH_DHCPC && NETHER != 0 */
+#else /* WITH_DHCPC && NETHER != 0 && HAVE_KEXEC */
     fprintf(stderr,
             "ERROR: Network boot is not supported in this configuration.\n"
             "       Please make sure you have enabled one or more network\n"
             "       devices, along with the DHCP and TFTP clients.\n");
-#endif /* !(WITH_DHCPC && NETHER != 0) */
+#endif /* !(WITH_DHCPC && NETHER != 0 && HAVE_KEXEC) */
 }
 
-static void kexec_from_uart(int uartdev)
+static void kexec_from_uart(int uartdev, bool verify, ulong checksum)
 {
-#ifdef _XINU_PLATFORM_ARM_RPI_
+#if HAVE_KEXEC
     irqmask im;
     device *uart;
     ulong size;
-    void *kernel;
-    uchar *p;
+    struct kexecstage stage;
+    uchar c;
     ulong n;
 
     im = disable();
@@ -240,28 +266,71 @@ static void kexec_from_uart(int uartdev)
     kputc('O', uart);
     kputc('K', uart);
 
-    /* Allocate buffer for new kernel.  */
-    kernel = memget(size);
-    if (kernel == (void*)SYSERR)
+    /* Allocate staging area for new kernel.  */
+    if (OK != kexecStageInit(&stage, size))
     {
+        restore(im);
         return;
     }
 
-    /* Load new kernel over the UART, placing it into the buffer.  */
-    p = kernel;
+    /* Load new kernel over the UART, placing it into the staging area.  */
     n = size;
     while (n--)
     {
-        *p++ = kgetc(uart);
+        c = kgetc(uart);
+        kexecStageWrite(&stage, &c, 1);
     }
 
-    /* Execute the new kernel.  */
-    kexec(kernel, size);
-
-    /* The following code should never actually be reached.  */
-    memfree(kernel, size);
     restore(im);
-#else /* _XINU_PLATFORM_ARM_RPI_ */
+
+    /* Execute the new kernel.  */
+    kexec_staged(&stage, verify, checksum);
+#else /* HAVE_KEXEC */
     fprintf(stderr, "ERROR: kexec from UART not supported on this platform.\n");
-#endif /* !_XINU_PLATFORM_ARM_RPI_ */
+#endif /* !HAVE_KEXEC */
 }
+
+/* Verify and execute a completely received kernel image.  Returns only if the
+ * kernel could not be executed, in which case the staging area is freed.  */
+static void kexec_staged(struct kexecstage *stage, bool verify,
+                         ulong checksum)
+{
+    if (OK != kexecStageFinish(stage))
+    {
+        fprintf(stderr, "ERROR: new kernel is empty.\n");
+        kexecStageFree(stage);
+        return;
+    }
+
+    printf("Received new kernel (size=%u, checksum=0x%08lx)\n",
+           stage->len, stage->checksum);
+    if (verify && checksum != stage->checksum)
+    {
+        fprintf(stderr, "ERROR: checksum mismatch (expected 0x%08lx).\n",
+                checksum);
+        kexecStageFree(stage);
+        return;
+    }
+
+#if HAVE_KEXEC
+    /* Execute the new kernel.  */
+    printf("Executing new kernel\n");
+    sleep(100);  /* Wait just a fraction of a second for printf()s to finish
+                    (no guarantees though).  */
+    kexec(stage->base, stage->len);
+
+    fprintf(stderr, "ERROR: kexec() returned!\n");
+#endif
+    kexecStageFree(stage);
+}
+
+#if defined(WITH_DHCPC) && NETHER != 0 && HAVE_KEXEC
+/*
+ * Callback function given to tftpGet() that is passed blocks of TFTP data.
+ * Each block is placed directly into the kexec staging area.
+ */
+static int kexecStageCb(const uchar *data, uint len, void *ctx)
+{
+    return kexecStageWrite((struct kexecstage *)ctx, data, len);
+}
+#endif
@@ -210,6 +210,14 @@ static void printMemUsage(void)
 #endif                          /* UHEAP_SIZE */
     printf("----------------------------\n");
     printf("%10d bytes physical memory\n\n", phys);
+#ifdef UHEAP_SIZE
+    printf("User Heap Page Faults:\n");
+    printf("----------------------------\n");
+    printf("%10lu faults resolved\n", safefaults);
+    printf("%10lu pages touched of %lu demand-zero\n", safezerofills,
+           safezeromaps);
+    printf("%10lu pages copied on write\n\n", safecowcopies);
+#endif                          /* UHEAP_SIZE */
 }
 
 /**
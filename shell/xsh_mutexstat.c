@@ -0,0 +1,76 @@
+/**
+ * @file     xsh_mutexstat.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <kmutex.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @ingroup shell
+ *
+ * Shell command (mutexstat) outputs the kernel mutex table with the number
+ * of acquisitions of each mutex and how many of them spun or blocked.
+ * @param nargs number of arguments in args array
+ * @param args  array of arguments
+ * @return non-zero value on error
+ */
+shellcmd xsh_mutexstat(int nargs, char *args[])
+{
+    struct kmutent *mutptr;
+    tid_typ owner;
+    int i;
+
+    /* Output help, if '--help' argument was supplied */
+    if (nargs == 2 && strcmp(args[1], "--help") == 0)
+    {
+        printf("Usage: %s\n\n", args[0]);
+        printf("Description:\n");
+        printf("\tDisplays kernel mutexes and their contention.\n");
+        printf("Options:\n");
+        printf("\t--help\t display this help and exit\n");
+
+        return 0;
+    }
+
+    /* Check for correct number of arguments */
+    if (nargs > 1)
+    {
+        fprintf(stderr, "%s: too many arguments\n", args[0]);
+        fprintf(stderr, "Try '%s --help' for more information\n",
+                args[0]);
+        return 1;
+    }
+
+    printf("%3s %-16s %5s %10s %10s %10s\n",
+           "ID", "NAME", "OWNER", "LOCKS", "SPUN", "BLOCKED");
+    printf("%3s %-16s %5s %10s %10s %10s\n",
+           "---", "----------------", "-----", "----------",
+           "----------", "----------");
+
+    for (i = 0; i < NKMUTEX; i++)
+    {
+        mutptr = &kmutextab[i];
+        if (KMUTEX_FREE == mutptr->state)
+        {
+            continue;
+        }
+
+        owner = kmutexowner(mutptr);
+        if (BADTID == owner)
+        {
+            printf("%3d %-16s %5s", i, mutptr->name, "-");
+        }
+        else
+        {
+            printf("%3d %-16s %5d", i, mutptr->name, owner);
+        }
+        printf(" %10lu %10lu %10lu\n", mutptr->nlock, mutptr->nspin,
+               mutptr->ncontend);
+    }
+
+    return 0;
+}
@@ -5,20 +5,296 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <date.h>
+#include <string.h>
+#include <ether.h>
+#include <interrupt.h>
+#include <ipv4.h>
+#include <netemu.h>
+#include <network.h>
+
+#if NETEMU
+static void usage(char *command);
+static int emuParse(struct emuRule *rule, int nargs, char *args[]);
+static void emuPrint(int n, struct emuRule *rule);
 
 /**
  * @ingroup shell
  *
- * Shell command (netemu). Allows user to set network emulator options.
+ * Shell command (netemu).  Displays and changes the network emulator rules
+ * applied to routed packets.
  * @param nargs number of arguments
  * @param args  array of arguments
  * @return non-zero value on error
  */
 shellcmd xsh_netemu(int nargs, char *args[])
 {
-    srand(getRdate("192.168.6.10"));
-    return 0;
+    struct emuRule *rule;
+    struct emuRule tmp;
+    irqmask im;
+    int i;
+
+    /* Output help, if '--help' argument was supplied */
+    if (nargs == 2 && strcmp(args[1], "--help") == 0)
+    {
+        usage(args[0]);
+        return OK;
+    }
+
+    if (nargs >= 2 && strcmp(args[1], "add") == 0)
+    {
+        /* Parse into a scratch rule so a bad option leaves the table alone */
+        bzero(&tmp, sizeof(struct emuRule));
+        tmp.burst = ETH_MTU;
+        tmp.limit = EMU_RATE_LIMIT;
+        if (SYSERR == emuParse(&tmp, nargs - 2, &args[2]))
+        {
+            fprintf(stderr, "Try '%s --help' for more information\n",
+                    args[0]);
+            return SYSERR;
+        }
+
+        tmp.state = EMU_USED;
+        tmp.tokens = tmp.burst;
+
+        /* A new rule matches every packet until it is filled in, so routed
+         * packets must not see it before the copy is complete */
+        im = disable();
+        rule = emuAlloc();
+        if (SYSERR == (int)rule)
+        {
+            restore(im);
+            fprintf(stderr, "Emulator rule table is full.\n");
+            return SYSERR;
+        }
+        tmp.last = rule->last;
+        memcpy(rule, &tmp, sizeof(struct emuRule));
+        restore(im);
+        return OK;
+    }
+    else if (nargs == 3 && strcmp(args[1], "del") == 0)
+    {
+        i = atoi(args[2]);
+        if (i < 0 || i >= EMU_NRULES || EMU_USED != emutab[i].state)
+        {
+            fprintf(stderr, "%s is not a valid rule number.\n", args[2]);
+            return SYSERR;
+        }
+        emuFree(&emutab[i]);
+        return OK;
+    }
+    else if (nargs != 1)
+    {
+        fprintf(stderr, "%s: invalid arguments\n", args[0]);
+        fprintf(stderr, "Try '%s --help' for more information\n",
+                args[0]);
+        return SYSERR;
+    }
+
+    for (i = 0; i < EMU_NRULES; i++)
+    {
+        if (EMU_USED == emutab[i].state)
+        {
+            emuPrint(i, &emutab[i]);
+        }
+    }
+    printf("Delay queue overflows: %u\n", emuqfull);
+
+    return OK;
+}
+
+static void usage(char *command)
+{
+    printf("\nUsage: %s [add <OPTIONS>] [del <RULE>]\n\n", command);
+    printf("Description:\n");
+    printf("\tDisplays or changes network emulator rules.  Routed\n");
+    printf("\tpackets are handled by the first rule they match.\n");
+    printf("Match options:\n");
+    printf("\tproto <N>\t\tIPv4 protocol number\n");
+    printf("\tsrc <ADDR> <MASK>\tsource network\n");
+    printf("\tdst <ADDR> <MASK>\tdestination network\n");
+    printf("\tsport <PORT>\t\tUDP/TCP source port\n");
+    printf("\tdport <PORT>\t\tUDP/TCP destination port\n");
+    printf("Impairment options:\n");
+    printf("\tdrop <PCT>\t\tdrop packets\n");
+    printf("\tdup <PCT>\t\tduplicate packets\n");
+    printf("\tcorrupt <PCT>\t\tflip a bit in packets\n");
+    printf("\treorder <PCT> <GAP>\thold back packets for GAP ms\n");
+    printf("\tdelay <MS> [<JITTER>]\tdelay packets\n");
+    printf("\trate <BPS> [<BURST>]\tlimit bandwidth (bytes/sec)\n");
+    printf("\tlimit <MS>\t\tdrop packets delayed longer by rate"
+           " (default %d)\n", EMU_RATE_LIMIT);
+    printf("Options:\n");
+    printf("\tdel <RULE>\t\tdelete rule from table\n");
+    printf("\t--help\t\t\tdisplay this help and exit\n");
+}
+
+/*
+ * Parse rule options of the form "<keyword> <value> [<value>]".
+ */
+static int emuParse(struct emuRule *rule, int nargs, char *args[])
+{
+    int i;
+
+    for (i = 0; i < nargs; i += 2)
+    {
+        if (i + 1 >= nargs)
+        {
+            fprintf(stderr, "Missing value for %s.\n", args[i]);
+            return SYSERR;
+        }
+
+        if (0 == strcmp(args[i], "proto"))
+        {
+            rule->proto = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "src")
+                 || 0 == strcmp(args[i], "dst"))
+        {
+            if (i + 2 >= nargs)
+            {
+                fprintf(stderr, "Missing mask for %s.\n", args[i]);
+                return SYSERR;
+            }
+            if (SYSERR == dot2ipv4(args[i + 1], ('s' == args[i][0])
+                                   ? &rule->src : &rule->dst))
+            {
+                fprintf(stderr, "%s is not a valid IPv4 address.\n",
+                        args[i + 1]);
+                return SYSERR;
+            }
+            if (SYSERR == dot2ipv4(args[i + 2], ('s' == args[i][0])
+                                   ? &rule->srcmask : &rule->dstmask))
+            {
+                fprintf(stderr, "%s is not a valid IPv4 address mask.\n",
+                        args[i + 2]);
+                return SYSERR;
+            }
+            i++;
+        }
+        else if (0 == strcmp(args[i], "sport"))
+        {
+            rule->srcpt = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "dport"))
+        {
+            rule->dstpt = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "drop"))
+        {
+            rule->drop = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "dup"))
+        {
+            rule->duplicate = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "corrupt"))
+        {
+            rule->corrupt = atoi(args[i + 1]);
+        }
+        else if (0 == strcmp(args[i], "reorder"))
+        {
+            if (i + 2 >= nargs)
+            {
+                fprintf(stderr, "Missing gap for reorder.\n");
+                return SYSERR;
+            }
+            rule->reorder = atoi(args[i + 1]);
+            rule->gap = atoi(args[i + 2]);
+            i++;
+        }
+        else if (0 == strcmp(args[i], "delay"))
+        {
+            rule->delay = atoi(args[i + 1]);
+            if (i + 2 < nargs && args[i + 2][0] >= '0'
+                && args[i + 2][0] <= '9')
+            {
+                rule->jitter = atoi(args[i + 2]);
+                i++;
+            }
+        }
+        else if (0 == strcmp(args[i], "rate"))
+        {
+            rule->rate = atoi(args[i + 1]);
+            if (i + 2 < nargs && args[i + 2][0] >= '0'
+                && args[i + 2][0] <= '9')
+            {
+                rule->burst = atoi(args[i + 2]);
+                i++;
+            }
+        }
+        else if (0 == strcmp(args[i], "limit"))
+        {
+            rule->limit = atoi(args[i + 1]);
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s.\n", args[i]);
+            return SYSERR;
+        }
+    }
+
+    if (rule->drop > 100 || rule->duplicate > 100 || rule->corrupt > 100
+        || rule->reorder > 100)
+    {
+        fprintf(stderr, "Percentages must be between 0 and 100.\n");
+        return SYSERR;
+    }
+
+    return OK;
+}
+
+/*
+ * Print a rule with its statistics.
+ */
+static void emuPrint(int n, struct emuRule *rule)
+{
+    char str[20];
+
+    printf("Rule %d:", n);
+    if (EMU_PROTO_ANY != rule->proto)
+    {
+        printf(" proto %d", rule->proto);
+    }
+    if (rule->srcmask.len > 0)
+    {
+        netaddrsprintf(str, &rule->src);
+        printf(" src %s", str);
+        netaddrsprintf(str, &rule->srcmask);
+        printf("/%s", str);
+    }
+    if (rule->dstmask.len > 0)
+    {
+        netaddrsprintf(str, &rule->dst);
+        printf(" dst %s", str);
+        netaddrsprintf(str, &rule->dstmask);
+        printf("/%s", str);
+    }
+    if (EMU_PORT_ANY != rule->srcpt)
+    {
+        printf(" sport %d", rule->srcpt);
+    }
+    if (EMU_PORT_ANY != rule->dstpt)
+    {
+        printf(" dport %d", rule->dstpt);
+    }
+    printf("\n");
+
+    printf("  drop %d%%  dup %d%%  corrupt %d%%  reorder %d%% gap %ums\n",
+           rule->drop, rule->duplicate, rule->corrupt, rule->reorder,
+           rule->gap);
+    printf("  delay %ums jitter %ums", rule->delay, rule->jitter);
+    if (rule->rate > 0)
+    {
+        printf("  rate %u B/s burst %u limit %ums", rule->rate,
+               rule->burst, rule->limit);
+    }
+    printf("\n");
 
+    printf("  matched %u  dropped %u  limited %u  duplicated %u\n",
+           rule->nmatch, rule->ndrop, rule->nlimit, rule->ndup);
+    printf("  corrupted %u  reordered %u  delayed %u\n",
+           rule->ncorrupt, rule->nreorder, rule->ndelay);
 }
+#endif                          /* NETEMU */
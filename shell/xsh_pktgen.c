@@ -7,68 +7,42 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <shell.h>
 
-#include <clock.h>
-#include <ether.h>
 #include <device.h>
-
-#include <ethernet.h>
+#include <ether.h>
 #include <ipv4.h>
-#include <udp.h>
+#include <pktgen.h>
 
 #if NETHER
 /* pktgen defaults */
-#define DEF_INTERVAL 0
+#define DEF_RATE 0
 #define DEF_COUNT 0
 #define DEF_DSTIP "192.168.1.1"
 #define DEF_SRCIP "192.168.1.254"
-#define DEF_DSTPT 1
+#define DEF_DSTPT PKTGEN_SINK_PORT
 #define DEF_SRCPT 65535
 #define DEF_MINLEN 60
-#define DEF_MAXLEN 1518
-
-/* structure with pktgen request and tracking values */
-struct pktgen_info
-{
-    /* device id to use for generator */
-    int dev_id;
-    /* L2 */
-    uchar dstmac[ETH_ADDR_LEN];
-    /* L3 */
-    struct netaddr dstip;
-    struct netaddr srcip;
-    uchar l3_proto;
-    /* L4 */
-    ushort dstpt;
-    ushort srcpt;
-
-    /* other */
-    uint minsize;
-    uint maxsize;
-    uint pktcount;
-    uint interval;
-
-    /* stats */
-    uint start;
-    uint stop;
-    uint tries;
-    uint errors;
-};
-
-thread pktgen(struct pktgen_info *);
+#define DEF_MAXLEN 1514
 
 static void usage(char *prog)
 {
     printf("usage: %s [options] <iface> <dst-mac>\n", prog);
+    printf("       %s stop <stream>\n", prog);
+    printf("       %s sink [-p <port>] <iface> | sink stop\n", prog);
+    printf("       %s [sink]\n", prog);
     printf("\t<iface>        interface to send packets on\n");
     printf("\t<dst-mac>      MAC address to send packets to\n");
+    printf("\tstop <stream>  stop and free a stream\n");
+    printf("\tsink <iface>   count, time and check received packets\n");
+    printf("\twith no arguments show stream or sink statistics\n");
     printf("\n");
     printf("options (and their [defaults]):\n");
     printf("\t-c <count>     number of packets to send [%d]\n",
            DEF_COUNT);
-    printf("\t-i <interval>  milliseconds between packet sends [%d]\n",
-           DEF_INTERVAL);
+    printf("\t-r <rate>      packets per second, 0 for maximum [%d]\n",
+           DEF_RATE);
     printf("\t-h <dst-ip>    destination IP for header [%s]\n",
            DEF_DSTIP);
     printf("\t-H <src-ip>    source IP for header [%s]\n", DEF_SRCIP);
@@ -79,29 +53,176 @@ static void usage(char *prog)
     printf("\t-L <max-length> maximum packet size [%d]\n", DEF_MAXLEN);
 }
 
+static void pktgenStat(void)
+{
+    struct pgStream *pgs;
+    ulong secs;
+    int i;
+
+    for (i = 0; i < PKTGEN_NSTREAM; i++)
+    {
+        pgs = &pgtab[i];
+        if (PKTGEN_FREE == pgs->state)
+        {
+            continue;
+        }
+        secs = ((PKTGEN_RUN == pgs->state) ? pktgenNow() : pgs->stop)
+            - pgs->start;
+        secs = (secs + 500) / 1000;
+        printf("Stream %d: %s, %u packets (%u errors), %u bytes "
+               "in %lu seconds", i,
+               (PKTGEN_RUN == pgs->state) ? "running" : "stopped",
+               pgs->seq, pgs->errors, pgs->bytes, secs);
+        if (secs > 0)
+        {
+            printf(", %lu pps", pgs->seq / secs);
+        }
+        printf("\n");
+    }
+}
+
+static void pktgenSinkStat(void)
+{
+    struct pgFlow *flow;
+    int i, j;
+
+    printf("Sink %s, %u invalid datagrams\n",
+           (PKTGEN_RUN == pgsink.state) ? "running" : "stopped",
+           pgsink.nbad);
+    for (i = 0; i < PKTGEN_NSTREAM; i++)
+    {
+        flow = &pgsink.flows[i];
+        if (0 == flow->nrecv)
+        {
+            continue;
+        }
+        printf("Stream %d: %u received, %u lost, %u reordered\n", i,
+               flow->nrecv, flow->nlost, flow->nreorder);
+        printf("  latency min/avg/max %lu/%lu/%lu ms\n", flow->latmin,
+               flow->lattotal / flow->nrecv, flow->latmax);
+        printf("  histogram (ms):");
+        for (j = 0; j < PKTGEN_NHIST; j++)
+        {
+            if (0 != flow->hist[j])
+            {
+                printf(" %s%u:%u", (PKTGEN_NHIST - 1 == j) ? ">=" : "<",
+                       (PKTGEN_NHIST - 1 == j) ? 1 << (j - 1) : 1 << j,
+                       flow->hist[j]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+static int pktgenSinkCmd(int nargs, char *args[])
+{
+    int arg, dev;
+    ushort port;
+    struct getopt opts;
+
+    if (1 == nargs)
+    {
+        pktgenSinkStat();
+        return 0;
+    }
+    if (2 == nargs && 0 == strcmp(args[1], "stop"))
+    {
+        if (SYSERR == pktgenSinkStop())
+        {
+            fprintf(stderr, "Sink is not running.\n");
+            return 1;
+        }
+        pktgenSinkStat();
+        return 0;
+    }
+
+    port = PKTGEN_SINK_PORT;
+    opts.optreset = TRUE;
+    while ((arg = getopt(nargs, args, "p:", &opts)) != -1)
+    {
+        switch (arg)
+        {
+        case 'p':
+            port = atoi(opts.optarg);
+            break;
+        default:
+            return 1;
+        }
+    }
+    if (opts.optind + 1 != nargs)
+    {
+        return 1;
+    }
+
+    dev = getdev(args[opts.optind]);
+    if (SYSERR == pktgenSinkStart(dev, port))
+    {
+        fprintf(stderr, "Failed to start sink on %s port %d.\n",
+                args[opts.optind], port);
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * @ingroup shell
  *
- * pktgen lets a "user" start up a slightly parameterized packet generator
- * from the shell.  In theory it should be able to saturuate the full 100
- * Mbps, in reality it probably doesn't but it'll try its best.
+ * pktgen lets a "user" start up slightly parameterized packet generator
+ * streams from the shell.  Streams run in the background, each paced to its
+ * own rate, until stopped or their count is reached.  A sink started on the
+ * receiving system reports loss, reordering and latency of the streams.
  * @param nargs number of arguments
  * @param args  array of arguments
  * @return non-zero value on error
  */
 shellcmd xsh_pktgen(int nargs, char *args[])
 {
-    int arg;
-    tid_typ tid;
-    struct pktgen_info info;
-    uint count, interval;
+    int arg, stream;
+    uint count, rate;
     char *prog = args[0];
     char *dstip, *srcip;
     ushort dstpt, srcpt;
     uint minlen, maxlen;
+    uchar dstmac[ETH_ADDR_LEN];
+    struct netaddr dst, src;
+    struct getopt opts;
+
+    if (1 == nargs)
+    {
+        pktgenStat();
+        return 0;
+    }
+    if (2 == nargs && 0 == strcmp(args[1], "--help"))
+    {
+        usage(prog);
+        return 0;
+    }
+    if (3 == nargs && 0 == strcmp(args[1], "stop"))
+    {
+        stream = atoi(args[2]);
+        if (stream < 0 || stream >= PKTGEN_NSTREAM
+            || PKTGEN_FREE == pgtab[stream].state)
+        {
+            fprintf(stderr, "%s is not a valid stream.\n", args[2]);
+            return 1;
+        }
+        pktgenStop(stream);
+        pktgenStat();
+        pktgenFree(stream);
+        return 0;
+    }
+    if (0 == strcmp(args[1], "sink"))
+    {
+        if (0 != pktgenSinkCmd(nargs - 1, args + 1))
+        {
+            usage(prog);
+            return 1;
+        }
+        return 0;
+    }
 
     /* defaults */
-    interval = DEF_INTERVAL;
+    rate = DEF_RATE;
     count = DEF_COUNT;
     dstip = DEF_DSTIP;
     srcip = DEF_SRCIP;
@@ -111,17 +232,16 @@ shellcmd xsh_pktgen(int nargs, char *args[])
     maxlen = DEF_MAXLEN;
 
     /* parse args */
-    struct getopt opts;
     opts.optreset = TRUE;
-    while ((arg = getopt(nargs, args, "c:i:h:H:p:P:l:L:", &opts)) != -1)
+    while ((arg = getopt(nargs, args, "c:r:h:H:p:P:l:L:", &opts)) != -1)
     {
         switch (arg)
         {
         case 'c':
             count = atoi(opts.optarg);
             break;
-        case 'i':
-            interval = atoi(opts.optarg);
+        case 'r':
+            rate = atoi(opts.optarg);
             break;
         case 'h':
             dstip = opts.optarg;
@@ -157,123 +277,38 @@ shellcmd xsh_pktgen(int nargs, char *args[])
     }
 
     /* prep the args */
-    info.dev_id = getdev(args[0]);
-    colon2mac(args[1], info.dstmac);
-
-    dot2ipv4(dstip, &info.dstip);
-    dot2ipv4(srcip, &info.srcip);
-    info.l3_proto = IPv4_PROTO_UDP;
-    info.dstpt = dstpt;
-    info.srcpt = srcpt;
-    info.minsize = minlen;
-    info.maxsize = maxlen;
-    info.pktcount = count;
-    info.interval = interval;
-
-    /* spawn proper pktgen thread */
-    tid = create(pktgen, INITSTK, INITPRIO, "pktgen", 1, &info);
-    ready(tid, RESCHED_NO);
-
-    /* listen for keypress to force stop */
-    printf("Press enter/return to stop.\n");
-    getchar();
-    kill(tid);
-
-    if (0 == info.stop)
+    if (SYSERR == dot2ipv4(dstip, &dst) || SYSERR == dot2ipv4(srcip, &src))
     {
-        info.stop = clktime;
+        fprintf(stderr, "Invalid IPv4 address.\n");
+        return 1;
     }
-
-    /* print some stats about what we just did */
-    printf("Tried to send %d packets (%d errors) over %d seconds.\n",
-           info.tries, info.errors, info.stop - info.start);
-
-    return 0;
-}
-
-thread pktgen(struct pktgen_info *info)
-{
-    struct packet *pkt;
-    uchar *data;
-    struct etherPkt *ethhdr;
-    struct ipv4Pkt *iphdr;
-    struct udpPkt *udphdr;
-
-    /* start the clock */
-    info->start = clktime;
-    info->stop = 0;
-    info->tries = 0;
-    info->errors = 0;
-
-    while (info->pktcount == 0 || info->tries < info->pktcount)
+    if (minlen < PKTGEN_MINLEN || maxlen > PKTGEN_MAXLEN || minlen > maxlen)
     {
-        /* update the counter */
-        info->tries += 1;
-
-        /* prepare the packet */
-        pkt = netGetbuf();
-        if (SYSERR == (int)pkt)
-        {
-            info->errors += 1;
-            continue;
-        }
-
-        /* take some liberties with headers (ETH, IP, UDP) */
-        pkt->len =
-            info->minsize +
-            ((info->tries - 1) % (info->maxsize - info->minsize));
-        pkt->curr -= (pkt->len + 03) & ~03;
-
-        /* push on headers one-by-one */
-        data = pkt->curr;
-
-        /* Ethernet */
-        ethhdr = (struct etherPkt *)data;
-        memcpy(ethhdr->dst, info->dstmac, ETH_ADDR_LEN);
-        control(info->dev_id, ETH_CTRL_GET_MAC, (long)ethhdr->src, NULL);
-        ethhdr->type = ETHER_TYPE_IPv4;
-        data += sizeof(*ethhdr);
-
-        /* IP */
-        iphdr = (struct ipv4Pkt *)data;
-        // this looks magic, it is not.
-        iphdr->ver_ihl = (IPv4_VERSION << 4) | (sizeof(*iphdr) >> 2);;
-        iphdr->tos = IPv4_TOS_ROUTINE;
-        iphdr->len = hs2net(pkt->len - sizeof(*ethhdr));
-        iphdr->id = 0;
-        iphdr->flags_froff = 0;
-        iphdr->ttl = IPv4_TTL;
-        iphdr->proto = info->l3_proto;
-        iphdr->chksum = 0;
-        memcpy(iphdr->src, info->srcip.addr, IPv4_ADDR_LEN);
-        memcpy(iphdr->dst, info->dstip.addr, IPv4_ADDR_LEN);
-        iphdr->chksum = netChksum(iphdr, IPv4_HDR_LEN);
-        data += sizeof(*iphdr);
-
-        if (IPv4_PROTO_UDP == info->l3_proto)
-        {
-            /* UDP */
-            udphdr = (struct udpPkt *)data;
-            udphdr->srcPort = hs2net(info->srcpt);
-            udphdr->dstPort = hs2net(info->dstpt);
-            udphdr->len =
-                hs2net(pkt->len - sizeof(*ethhdr) - sizeof(*iphdr));
-            udphdr->chksum = 0;
-            data += sizeof(*udphdr);
-        }
+        fprintf(stderr, "Packet sizes must be between %d and %d.\n",
+                (int)PKTGEN_MINLEN, PKTGEN_MAXLEN);
+        return 1;
+    }
+    colon2mac(args[1], dstmac);
 
-        /* send the packet -- don't care about routing, right to the ether! */
-        if (SYSERR == write(info->dev_id, pkt->curr, pkt->len))
-        {
-            /* count the errors */
-            info->errors += 1;
-        }
-        netFreebuf(pkt);
-        sleep(info->interval);
+    stream = pktgenAlloc();
+    if (SYSERR == stream)
+    {
+        fprintf(stderr, "All %d streams are in use.\n", PKTGEN_NSTREAM);
+        return 1;
     }
+    pgtab[stream].dev = getdev(args[0]);
+    pgtab[stream].minlen = minlen;
+    pgtab[stream].maxlen = maxlen;
+    pgtab[stream].rate = rate;
+    pgtab[stream].count = count;
 
-    /* stop the clock */
-    info->stop = clktime;
+    if (SYSERR == pktgenStart(stream, dstmac, &src, &dst, srcpt, dstpt))
+    {
+        fprintf(stderr, "Failed to start stream on %s.\n", args[0]);
+        pktgenFree(stream);
+        return 1;
+    }
+    printf("Started stream %d.\n", stream);
 
     return 0;
 }
@@ -0,0 +1,123 @@
+/**
+ * @file     xsh_prof.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <clock.h>
+#include <profile.h>
+#include <shell.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void profDump(void);
+static int profCompare(const void *a, const void *b);
+static void usage(char *command);
+
+/**
+ * @ingroup shell
+ *
+ * Shell command (prof) starts and stops the sampling profiler and dumps the
+ * samples it took.  The dump lists each distinct address and thread with
+ * the number of samples that hit it, one per line starting with PROF, for
+ * compile/scripts/flatprof to resolve against xinu.map.
+ * @param nargs number of arguments in args array
+ * @param args  array of arguments
+ * @return non-zero value on error
+ */
+shellcmd xsh_prof(int nargs, char *args[])
+{
+    int interval;
+
+    if (2 == nargs && 0 == strcmp(args[1], "--help"))
+    {
+        usage(args[0]);
+        return 0;
+    }
+
+    if (2 <= nargs && 0 == strcmp(args[1], "start"))
+    {
+        interval = 1;
+        if (3 == nargs)
+        {
+            interval = atoi(args[2]);
+        }
+        if (nargs > 3 || SYSERR == profstart(interval))
+        {
+            usage(args[0]);
+            return 1;
+        }
+        printf("Profiling every %d tick(s), %d samples kept.\n", interval,
+               PROF_NSAMPLE);
+        return 0;
+    }
+    if (2 == nargs && 0 == strcmp(args[1], "stop"))
+    {
+        profstop();
+        printf("Profiler stopped, %lu samples taken.\n", profcount);
+        return 0;
+    }
+    if (2 == nargs && 0 == strcmp(args[1], "dump"))
+    {
+        profDump();
+        return 0;
+    }
+
+    usage(args[0]);
+    return 1;
+}
+
+/*
+ * Stop the profiler, then sort the samples so equal addresses are adjacent
+ * and print each run with its count.
+ */
+static void profDump(void)
+{
+    uint nsample, i, count;
+
+    profstop();
+    nsample = (profcount < PROF_NSAMPLE) ? profcount : PROF_NSAMPLE;
+    qsort(proftab, nsample, sizeof(struct profent), profCompare);
+
+    printf("PROF begin hz=%d interval=%u samples=%u taken=%lu\n",
+           CLKTICKS_PER_SEC, profinterval, nsample, profcount);
+    for (i = 0; i < nsample; i += count)
+    {
+        for (count = 1; i + count < nsample
+             && proftab[i + count].pc == proftab[i].pc
+             && proftab[i + count].tid == proftab[i].tid; count++)
+        {
+        }
+        printf("PROF 0x%08lX %d %u\n", proftab[i].pc, proftab[i].tid,
+               count);
+    }
+    printf("PROF end\n");
+}
+
+static int profCompare(const void *a, const void *b)
+{
+    const struct profent *x = a;
+    const struct profent *y = b;
+
+    if (x->pc != y->pc)
+    {
+        return (x->pc > y->pc) - (x->pc < y->pc);
+    }
+    return x->tid - y->tid;
+}
+
+static void usage(char *command)
+{
+    printf("Usage: %s start [<ticks>] | stop | dump\n\n", command);
+    printf("Description:\n");
+    printf("\tSamples the address interrupted by the clock to find where\n");
+    printf("\tprocessor time goes.\n");
+    printf("Options:\n");
+    printf("\t--help\t\tdisplay this help and exit\n");
+    printf("\tstart <ticks>\tdiscard old samples and take one every\n");
+    printf("\t\t\t<ticks> clock ticks [1]\n");
+    printf("\tstop\t\tstop taking samples\n");
+    printf("\tdump\t\tstop and print the samples for flatprof\n");
+}
@@ -1,15 +1,16 @@
-/*
+/**
  * @file     xsh_rtpstat.c
  *
  */
-/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
 
 #include <stddef.h>
+#include <interrupt.h>
 #include <stdio.h>
 #include <string.h>
-#include <network.h>
 #include <rtp.h>
 
+#if NRTP
 static void rtpStat(struct rtp *);
 
 /**
@@ -22,7 +23,6 @@ static void rtpStat(struct rtp *);
  */
 shellcmd xsh_rtpstat(int nargs, char *args[])
 {
-
     int i;
 
     /* Output help, if '--help' argument was supplied */
@@ -30,7 +30,7 @@ shellcmd xsh_rtpstat(int nargs, char *args[])
     {
         printf("Usage: %s\n\n", args[0]);
         printf("Description:\n");
-        printf("\tDisplays RTP device information\n");
+        printf("\tDisplays the statistics of each RTP stream\n");
         printf("Options:\n");
         printf("\t--help\tdisplay this help and exit\n");
         return OK;
@@ -45,44 +45,56 @@ shellcmd xsh_rtpstat(int nargs, char *args[])
         return SYSERR;
     }
 
-#if NRTP
     for (i = 0; i < NRTP; i++)
     {
         rtpStat(&rtptab[i]);
     }
-#else
-    i = 0;
-    rtpStat(NULL);
-#endif
 
     return OK;
 }
 
 static void rtpStat(struct rtp *rtpptr)
 {
-    device *pdev;
-    char strA[20];
+    struct rtp rtp;
+    long lost;
+    irqmask im;
 
-    if (NULL == rtpptr)
-    {
-        return;
-    }
+    /* Copy the statistics so they are printed consistent */
+    im = disable();
+    memcpy(&rtp, rtpptr, sizeof(rtp));
+    restore(im);
 
-    /* Skip interface if not allocated */
-    if (rtpptr->state != RTP_OPEN)
+    /* Skip device if not open */
+    if (RTP_OPEN != rtp.state)
     {
         return;
     }
 
-    /* Setup pointer to underlying device */
-    pdev = rtpptr->dev;
-    printf("%-10s ", pdev->name);
+    printf("%-10s ", rtp.dev->name);
+    printf("Over %s, RTCP over %s, playout delay %u ms\n",
+           rtp.udpptr->dev->name,
+           (NULL == rtp.rtcpptr) ? "none" : rtp.rtcpptr->dev->name,
+           rtp.delay);
 
-    /* Connection details */
-    printf("RTP Version: \n" + RTP_VERSION);
-    printf("Local  Port: %-5d\n", rtpptr->localpt);
-    printf("           ");
-    printf("Remote Port: %-5d\n", rtpptr->remotept);
+    /* Our stream, and what the remote end reports about it */
+    printf("           Sent     SSRC 0x%08X: %lu packets, %lu octets\n",
+           rtp.ssrc, rtp.sentpkts, rtp.sentoctets);
+    printf("                    Remote reports %u lost (%u/256), ",
+           rtp.rlost, rtp.rfraction);
+    printf("jitter %u ms, round trip %u ms\n",
+           rtp.rjitter / RTP_TSPERMS, rtp.rtt);
 
-    //TODO Handle RTCP Info Output when RTCP is ready
+    /* The remote stream */
+    if (!rtp.rvalid)
+    {
+        printf("           Received nothing\n");
+        return;
+    }
+    lost = rtpExpected(&rtp) - rtp.received;
+    printf("           Received SSRC 0x%08X: %lu packets, %ld lost, ",
+           rtp.rssrc, rtp.received, lost);
+    printf("jitter %u ms\n", (rtp.jitter >> 4) / RTP_TSPERMS);
+    printf("                    %d held, %lu late, %lu duplicate, "
+           "%lu overrun\n", rtp.icount, rtp.late, rtp.dups, rtp.overruns);
 }
+#endif /* NRTP */
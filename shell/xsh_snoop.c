@@ -47,12 +47,12 @@ static void usage(char *command)
         ("\t-da\tCapture only packets whose destination IPv4 address\n");
     printf("\t\tis ADDR.\n");
     printf
-        ("\t-dp\tCapture only packets whose destination port is PORT.\n");
-    printf("\t\tThis is ignored if -t UDP or TCP is not specified.\n");
+        ("\t-dp\tCapture only UDP and TCP packets whose destination\n");
+    printf("\t\tport is PORT.\n");
     printf("\t-sa\tCapture only packets whose source IPv4 address\n");
     printf("\t\tis ADDR.\n");
-    printf("\t-sp\tCapture only packets whose source port is PORT.\n");
-    printf("\t\tThis is ignored if -t UDP or TCP is not specified.\n");
+    printf("\t-sp\tCapture only UDP and TCP packets whose source port\n");
+    printf("\t\tis PORT.\n");
     printf
         ("\t-t\tCapture only packets of type TYPE.  Valid values for\n");
     printf("\t\ttype are: ARP, ICMP, IPv4, TCP, UDP.\n");
@@ -82,7 +82,7 @@ static thread snoop(struct snoop *cap, uint count, char dump,
         }
         cap->nprint++;
         snoopPrint(pkt, dump, verbose);
-        netFreebuf(pkt);
+        snoopFree(cap, pkt);
         count--;
     }
 
@@ -9,11 +9,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <tar.h>
+#include <device.h>
 
 extern int _binary_data_mytar_tar_start;
 
-#define NFILES     5
-#define BUFFERSIZE 8096
+#define NFILES     32
+
+static struct tarindex *tarindex = NULL;
 
 void tarHelp(char *command);
 
@@ -27,11 +29,10 @@ void tarHelp(char *command);
  */
 shellcmd xsh_tar(int nargs, char *args[])
 {
-    int i, size, totalsize;
-    char filelist[NFILES][TAR_FILENAME_LEN];
-    char data[BUFFERSIZE];
+    int i, size;
+    struct tarentry *filelist[NFILES];
+    struct tarentry *file;
     struct tar *archive;
-    struct tar *file;
 
 #if USE_TAR
     archive = (struct tar *)&_binary_data_mytar_tar_start;
@@ -39,7 +40,7 @@ shellcmd xsh_tar(int nargs, char *args[])
     return SYSERR;
 #endif
 
-    if (nargs != 2)
+    if (nargs < 2 || nargs > 3)
     {
         tarHelp(args[0]);
         return 1;
@@ -51,28 +52,50 @@ shellcmd xsh_tar(int nargs, char *args[])
         return 0;
     }
 
+    /* parse the archive once; later commands use the index */
+    if (NULL == tarindex)
+    {
+        tarindex = tarIndexCreate(archive);
+        if (NULL == tarindex)
+        {
+            fprintf(stderr, "Out of memory indexing archive.\n");
+            return 1;
+        }
+    }
+
     if (0 == strcmp(args[1], "ls"))
     {
-        size = tarListFiles(archive, (char *)filelist, NFILES);
+        size = tarIndexDir(tarindex, (3 == nargs) ? args[2] : "",
+                           filelist, NFILES);
+
+        for (i = 0; i < size; i++)
+        {
+            printf("%s '%s' %d bytes\n",
+                   (TAR_LINK_DIR == filelist[i]->typeflag) ? "dir: " :
+                   "file:", filelist[i]->name, filelist[i]->size);
+        }
+
+        return 0;
+    }
+
+    if (0 == strcmp(args[1], "find") && 3 == nargs)
+    {
+        size = tarIndexPrefix(tarindex, args[2], filelist, NFILES);
 
         for (i = 0; i < size; i++)
         {
-            printf("file: '%s'\n", filelist[i]);
+            printf("file: '%s'\n", filelist[i]->name);
         }
 
         return 0;
     }
 
-    file = tarGetFile(archive, args[1]);
+    file = tarIndexLookup(tarindex, args[1]);
 
     if (file != NULL)
     {
-        totalsize = tarGetFilesize(file);
-        printf("File '%s' is %d bytes.\n", args[1], totalsize);
-        bzero(data, BUFFERSIZE);
-        tarGetData(file, data, BUFFERSIZE - 1);
-        data[BUFFERSIZE - 1] = '\0';
-        printf("%s", data);
+        printf("File '%s' is %d bytes.\n", file->name, file->size);
+        write(stdout, tarIndexData(tarindex, file), file->size);
     }
     else
     {
@@ -85,11 +108,12 @@ shellcmd xsh_tar(int nargs, char *args[])
 
 void tarHelp(char *command)
 {
-    printf("Usage: %s (ls|<FILENAME>)\n\n", command);
+    printf("Usage: %s (ls [DIR]|find <PREFIX>|<FILENAME>)\n\n", command);
     printf("Description:\n");
     printf("\tDump contents of a tar file\n");
     printf("Options:\n");
-    printf("\tls\t\tdisplay listing of files in tar file\n");
+    printf("\tls [DIR]\tdisplay listing of files in tar file directory\n");
+    printf("\tfind <PREFIX>\tdisplay files whose path begins with PREFIX\n");
     printf("\t<FILENAME>\tfilename within tar file to display\n");
     printf("\t--help\t\tdisplay this help screen\n");
 }
@@ -0,0 +1,204 @@
+/**
+ * @file     xsh_top.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <shell.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread.h>
+
+#define TOP_DELAY   1           /**< default seconds between refreshes */
+#define TOP_COUNT   10          /**< default number of refreshes       */
+
+/** Processor time of one thread over a refresh interval. */
+struct topent
+{
+    tid_typ tid;                /**< thread id, or BADTID for interrupts */
+    uint64_t delta;             /**< cycles used during the interval     */
+};
+
+static void topSnapshot(uint64_t *cycles, uint64_t *irq);
+static int topCompare(const void *a, const void *b);
+static ulong topPercent(uint64_t part, uint64_t whole);
+static void usage(char *command);
+
+/**
+ * @ingroup shell
+ *
+ * Shell command (top) periodically displays the threads that used the most
+ * processor time since the last refresh, with their context switch counts.
+ * @param nargs number of arguments in args array
+ * @param args  array of arguments
+ * @return non-zero value on error
+ */
+shellcmd xsh_top(int nargs, char *args[])
+{
+    uint64_t last[NTHREAD], now[NTHREAD];
+    uint64_t lastirq, nowirq, total;
+    struct topent ent[NTHREAD + 1];
+    struct thrent *thrptr;
+    int arg, delay, count, nent, i;
+    ulong pct;
+    struct getopt opts;
+
+    /* readable names for PR* status in thread.h */
+    static const char * const pstnams[] = {
+        "curr ", "free ", "ready", "recv ",
+        "sleep", "susp ", "wait ", "rtim ", "migr "
+    };
+
+    if (2 == nargs && 0 == strcmp(args[1], "--help"))
+    {
+        usage(args[0]);
+        return 0;
+    }
+
+    delay = TOP_DELAY;
+    count = TOP_COUNT;
+
+    opts.optreset = TRUE;
+    while ((arg = getopt(nargs, args, "d:n:", &opts)) != -1)
+    {
+        switch (arg)
+        {
+        case 'd':
+            delay = atoi(opts.optarg);
+            break;
+        case 'n':
+            count = atoi(opts.optarg);
+            break;
+        default:
+            usage(args[0]);
+            return 1;
+        }
+    }
+    if (opts.optind != nargs || delay < 1 || count < 1)
+    {
+        usage(args[0]);
+        return 1;
+    }
+
+    topSnapshot(last, &lastirq);
+    while (count-- > 0)
+    {
+        sleep(delay * 1000);
+        topSnapshot(now, &nowirq);
+
+        /* Work out each thread's share of the interval.  A slot reused by
+         * a new thread starts again from zero.  */
+        nent = 0;
+        total = nowirq - lastirq;
+        ent[nent].tid = BADTID;
+        ent[nent].delta = nowirq - lastirq;
+        nent++;
+        for (i = 0; i < NTHREAD; i++)
+        {
+            if (THRFREE == thrtab[i].state)
+            {
+                continue;
+            }
+            ent[nent].tid = i;
+            ent[nent].delta = (now[i] >= last[i]) ? now[i] - last[i] : now[i];
+            total += ent[nent].delta;
+            nent++;
+        }
+        qsort(ent, nent, sizeof(struct topent), topCompare);
+
+        printf("\033[2J\033[H");
+        printf("top - %d threads, %lu interrupts, every %d s\n\n",
+               thrcount, irqcount, delay);
+        printf("%3s %-16s %5s %4s %6s %10s %10s %10s\n",
+               "TID", "NAME", "STATE", "PRIO", "%CPU", "SWITCHES",
+               "BLOCKED", "PREEMPTED");
+        printf("%3s %-16s %5s %4s %6s %10s %10s %10s\n",
+               "---", "----------------", "-----", "----", "------",
+               "----------", "----------", "----------");
+        for (i = 0; i < nent; i++)
+        {
+            pct = topPercent(ent[i].delta, total);
+            if (BADTID == ent[i].tid)
+            {
+                printf("%3s %-16s %5s %4s %4lu.%lu\n", "-", "(interrupts)",
+                       "", "", pct / 10, pct % 10);
+                continue;
+            }
+            thrptr = &thrtab[ent[i].tid];
+            if (THRFREE == thrptr->state)
+            {
+                continue;
+            }
+            printf("%3d %-16s %s %4d %4lu.%lu %10lu %10lu %10lu\n",
+                   ent[i].tid, thrptr->name,
+                   pstnams[(int)thrptr->state - 1], thrptr->prio,
+                   pct / 10, pct % 10, thrptr->nswitch, thrptr->nvolun,
+                   thrptr->ninvol);
+        }
+
+        memcpy(last, now, sizeof(last));
+        lastirq = nowirq;
+    }
+
+    return 0;
+}
+
+/*
+ * Copy the processor time of every thread and of the interrupt handlers,
+ * first bringing the running thread's time up to date.
+ */
+static void topSnapshot(uint64_t *cycles, uint64_t *irq)
+{
+    irqmask im;
+    int i;
+
+    im = disable();
+    cpuaccount();
+    for (i = 0; i < NTHREAD; i++)
+    {
+        cycles[i] = thrtab[i].cpucycles;
+    }
+    *irq = irqcycles;
+    restore(im);
+}
+
+/* Sort busiest first.  */
+static int topCompare(const void *a, const void *b)
+{
+    uint64_t x = ((const struct topent *)a)->delta;
+    uint64_t y = ((const struct topent *)b)->delta;
+
+    return (x < y) - (x > y);
+}
+
+/*
+ * Return @part as tenths of a percent of @whole.  Both are scaled down to
+ * fit 32-bit arithmetic first, since not every platform links the 64-bit
+ * division routines.
+ */
+static ulong topPercent(uint64_t part, uint64_t whole)
+{
+    while (whole > 0x3FFFFF)
+    {
+        part >>= 1;
+        whole >>= 1;
+    }
+    if (0 == whole)
+    {
+        return 0;
+    }
+    return ((ulong)part * 1000) / (ulong)whole;
+}
+
+static void usage(char *command)
+{
+    printf("Usage: %s [-d <seconds>] [-n <count>]\n\n", command);
+    printf("Description:\n");
+    printf("\tDisplays the threads using the most processor time.\n");
+    printf("Options:\n");
+    printf("\t--help\t\tdisplay this help and exit\n");
+    printf("\t-d <seconds>\tseconds between refreshes [%d]\n", TOP_DELAY);
+    printf("\t-n <count>\tnumber of refreshes [%d]\n", TOP_COUNT);
+}
@@ -17,6 +17,7 @@
 #include <thread.h>
 #include <clock.h>
 #include <dsp.h>
+#include <limits.h>
 #include <uart.h>
 #include <rtp.h>
 
@@ -31,6 +32,7 @@
 #define MODE_IP       3
 #define CHECK_BASIC   1
 #define CHECK_SEQ     2
+#define CHECK_RTP     3
 #define NCTRLCHAR     3
 #define TOG_SAMP      1
 #define T_NAME_SEND   "voip-send"
@@ -67,6 +69,9 @@ shellcmd xsh_voip(int nargs, char *args[])
 {
     int i, rxPort = UDP_PORT, txPort = UDP_PORT;
     ushort uart = NULL, udpRx = NULL, udpTx = NULL;
+#ifdef NRTP
+    ushort rtpRx = NULL, rtpTx = NULL;
+#endif
     ushort mode = MODE_SERIAL, check = CHECK_BASIC;
     register struct thrent *thrptr;
     struct netaddr *localhost;
@@ -87,7 +92,7 @@ shellcmd xsh_voip(int nargs, char *args[])
     else if (nargs == 2 && strcmp(args[1], "--help") == 0)
     {
         printf
-            ("\nUsage: %s [-p <rx port> <tx port>] [-s] [serial] [localhost] [IP address]\n",
+            ("\nUsage: %s [-p <rx port> <tx port>] [-s] [-r] [serial] [localhost] [IP address]\n",
              args[0]);
         printf("Description:\n");
         printf("\tUses the second serial port and the network to ");
@@ -97,6 +102,10 @@ shellcmd xsh_voip(int nargs, char *args[])
         printf
             ("\t-p\t\tSpecify UDP receive and transmit port numbers.\n");
         printf("\t-s\t\tEmbed sequence information in each packet.\n");
+#ifdef NRTP
+        printf("\t-r\t\tSend RTP and play out received audio in ");
+        printf("timestamp order.\n");
+#endif
         printf("\tserial\t\tOperate in serial loopback mode.\n");
         printf("\tlocalhost\tOperate in network loopback mode.\n");
         printf("\tIP address\tSend and receive from this IP address.\n");
@@ -110,6 +119,12 @@ shellcmd xsh_voip(int nargs, char *args[])
             {
                 check = CHECK_SEQ;
             }
+#ifdef NRTP
+            else if (strcmp(args[i], "-r") == 0)
+            {
+                check = CHECK_RTP;
+            }
+#endif
             else if (strcmp(args[i], "-t") == 0)
             {
                 im = disable();
@@ -304,6 +319,33 @@ shellcmd xsh_voip(int nargs, char *args[])
               ((void *)basic_receive, INITSTK, 20, T_NAME_RECV, 2,
                uart, udpRx), RESCHED_YES);
         break;
+#ifdef NRTP
+    case CHECK_RTP:
+        /* Carry the audio in RTP on the UDP devices */
+        rtpRx = rtpAlloc();
+        if ((SYSERR == (short)rtpRx) || (SYSERR == open(rtpRx, udpRx)))
+        {
+            fprintf(stderr, "Failed to open RTP device.\n");
+            return SYSERR;
+        }
+        rtpTx = rtpRx;
+        if (udpRx != udpTx)
+        {
+            rtpTx = rtpAlloc();
+            if ((SYSERR == (short)rtpTx) || (SYSERR == open(rtpTx, udpTx)))
+            {
+                fprintf(stderr, "Failed to open RTP device.\n");
+                return SYSERR;
+            }
+        }
+        ready(create
+              ((void *)basic_send, INITSTK, 20, T_NAME_SEND, 2, uart,
+               rtpTx), RESCHED_YES);
+        ready(create
+              ((void *)basic_receive, INITSTK, 20, T_NAME_RECV, 2,
+               uart, rtpRx), RESCHED_YES);
+        break;
+#endif                          /* NRTP */
     case CHECK_SEQ:
 #ifdef NUDP
         control(udpRx, UDP_CTRL_SETFLAG, UDP_FLAG_NOBLOCK, NULL);
@@ -383,8 +425,9 @@ thread basic_receive(ushort uart, ushort udp)
     uint len = 0;
     uchar buf[BUF_SIZE];
 #ifdef ECHO
-    int i, j = 0;
+    int i, j = 0, sample;
     uint value[5 * BUF_SIZE];
+    short linear[BUF_SIZE];
 #endif
 
     while (TRUE)
@@ -395,15 +438,26 @@ thread basic_receive(ushort uart, ushort udp)
         if (len > 0)
         {
 #ifdef ECHO
-            /* Echo audio effect */
+            /* Echo audio effect, converting the whole packet at once */
+            ulawDecode(linear, buf, len);
             for (i = 0; i < len; i++)
             {
                 value[j] =
                     value[(j + BUF_SIZE) % (5 * BUF_SIZE)] * 4 / 5 +
-                    ulaw2linear(buf[i]) / 64 + 512;
-                buf[i] = linear2ulaw((value[j] - 512) * 64);
+                    linear[i] / 64 + 512;
+                sample = ((int)value[j] - 512) * 64;
+                if (sample > SHRT_MAX)
+                {
+                    sample = SHRT_MAX;
+                }
+                else if (sample < SHRT_MIN)
+                {
+                    sample = SHRT_MIN;
+                }
+                linear[i] = sample;
                 j = (j + 1) % (5 * BUF_SIZE);
             }
+            ulawEncode(buf, linear, len);
 #endif
 
             /* Write to the serial device */
@@ -6,6 +6,10 @@
  * @ingroup system
  * @brief Open, close, read, and write to devices
  *
+ * @defgroup kmutexes Kernel Mutexes
+ * @ingroup system
+ * @brief Mutexes with atomic fast paths for short critical sections
+ *
  * @defgroup memory_mgmt Memory Management
  * @ingroup system
  * @brief Allocate and free heap or buffer pool memory
@@ -29,4 +33,8 @@
  * @defgroup threads Threads
  * @ingroup system
  * @brief Thread functions
+ *
+ * @defgroup workpool Work Pool
+ * @ingroup system
+ * @brief Run functions on a pool of worker threads
  */
@@ -0,0 +1,109 @@
+/**
+ * @file kexec.c
+ *
+ * ARM implementation of kexec().  A platform including this file must define
+ * KEXEC_LOAD_ADDR, the address at which its kernels are linked to run.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <interrupt.h>
+#include <kernel.h>
+#include <kexec.h>
+#include <mmu.h>
+#include <string.h>
+
+#ifndef KEXEC_LOAD_ADDR
+#  error "KEXEC_LOAD_ADDR must be defined by the platform"
+#endif
+
+/* The below array contains a stub of ARM instructions used to copy the
+ * new kernel into its final location, then pass control to it.
+ *
+ * This stub is hard-coded as an array because it needs to be copied to a
+ * location in which it cannot be overwritten by itself while copying the new
+ * kernel.  Therefore, its size needs to be known and it needs to be fully
+ * relocatable (which in theory the assembler does not guarantee).
+ *
+ * The copy moves KEXEC_COPY_UNIT (32) bytes per iteration with an 8-register
+ * load/store multiple.  Because each block is fully loaded before it is
+ * stored, the copy is safe even if the new kernel overlaps its final location,
+ * provided it was placed at a higher address (which is always the case for
+ * images staged in the heap).
+ *
+ * Arguments are:
+ *
+ * r0:  pointer to new kernel
+ * r1:  size of new kernel in 32-byte blocks (nonzero)
+ * r2:  pointer to ARM boot tags (preserved in r2 for convenience of new kernel)
+ */
+
+/*00000000 <copy_kernel>:*/
+  /* 0:   e59f4014    ldr     r4, [pc, #20]     ; 1c <load_addr>     */
+  /* 4:   e8b00fe8    ldmia   r0!, {r3, r5-r11}                      */
+  /* 8:   e8a40fe8    stmia   r4!, {r3, r5-r11}                      */
+  /* c:   e2511001    subs    r1, r1, #1                             */
+  /*10:   1afffffb    bne     4 <copy_kernel+0x4>                    */
+  /*14:   e59ff000    ldr     pc, [pc, #0]      ; 1c <load_addr>     */
+  /*18:   e1a00000    nop                                            */
+  /*1c:   KEXEC_LOAD_ADDR                                            */
+static const ulong copy_kernel[] = {
+    0xe59f4014,
+    0xe8b00fe8,
+    0xe8a40fe8,
+    0xe2511001,
+    0x1afffffb,
+    0xe59ff000,
+    0xe1a00000,
+    KEXEC_LOAD_ADDR,
+};
+
+#define COPY_KERNEL_ADDR ((void*)(KEXEC_LOAD_ADDR - sizeof(copy_kernel)))
+
+/**
+ * Kernel execute - Transfer control to a new kernel.
+ *
+ * This is the ARM implementation.  In this implementation, the new kernel must
+ * be valid for the platform, including being linked to run at and having an
+ * entry point at address ::KEXEC_LOAD_ADDR.
+ *
+ * @param kernel
+ *      Pointer to the new kernel image loaded anywhere in memory.  Up to
+ *      ::KEXEC_COPY_UNIT - 1 bytes past the end of the image may be read, so
+ *      images staged with kexecStageFinish() are padded accordingly.
+ * @param size
+ *      Size of the new kernel image in bytes.
+ *
+ * @return
+ *      ::SYSERR if @p size is 0.  Otherwise this function never returns.  If it
+ *      somehow does, then something has gone horribly wrong.
+ */
+syscall kexec(const void *kernel, uint size)
+{
+    irqmask im;
+
+    if (0 == size)
+    {
+        return SYSERR;
+    }
+
+    im = disable();
+
+    /* Copy the assembly stub into a safe location.  */
+    memcpy(COPY_KERNEL_ADDR, copy_kernel, sizeof(copy_kernel));
+
+    /* Write everything back to memory and return to the reset state of the
+     * MMU and caches, which is what the new kernel expects.  This also makes
+     * the stub just copied visible to instruction fetches.  */
+    mmu_disable();
+
+    /* Enter the assembly stub to copy the new kernel into its final location,
+     * then pass control to it.  */
+    extern void *atags_ptr;
+    (( void (*)(const void *, ulong, void *))(COPY_KERNEL_ADDR))
+                (kernel, (size + KEXEC_COPY_UNIT - 1) / KEXEC_COPY_UNIT,
+                 atags_ptr);
+
+    /* Control should never reach here.  */
+    restore(im);
+    return SYSERR;
+}
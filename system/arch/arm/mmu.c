@@ -0,0 +1,194 @@
+/**
+ * @file mmu.c
+ *
+ * ARM MMU set up and L1 cache maintenance.  The address space is identity
+ * mapped with 1 MB sections: RAM is cached, the platform's peripheral window
+ * is device memory, and everything else (such as memory owned by a GPU) is
+ * uncached normal memory.  A platform including this file must define
+ * MMU_DEVICE_BASE and MMU_DEVICE_SIZE, the physical range of its
+ * peripherals.
+ *
+ * Devices that use DMA do not see the L1 data cache, so drivers must clean
+ * a buffer before a device reads it and invalidate it before reading what a
+ * device wrote.  The range functions work on whole cache lines, so a DMA
+ * buffer should not share a cache line with data the processor writes while
+ * the transfer is in progress.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <compiler.h>
+#include <mmu.h>
+#include <platform.h>
+
+#if !defined(MMU_DEVICE_BASE) || !defined(MMU_DEVICE_SIZE)
+#  error "MMU_DEVICE_BASE and MMU_DEVICE_SIZE must be defined by the platform"
+#endif
+
+/** First-level translation table, which must be aligned to 16 KB.  */
+static ulong mmu_table[MMU_NSECTION] __aligned(16384);
+
+/* Data synchronization barrier: wait for cache and memory operations to
+ * complete.  */
+static inline void dsb(void)
+{
+    asm volatile ("mcr p15, 0, %0, c7, c10, 4"::"r" (0):"memory");
+}
+
+/* Flush the prefetch buffer, so instructions after this one are fetched
+ * under the new translation and cache settings.  */
+static inline void isb(void)
+{
+    asm volatile ("mcr p15, 0, %0, c7, c5, 4"::"r" (0):"memory");
+}
+
+/**
+ * Build an identity-mapped translation table, then enable the MMU, the L1
+ * instruction and data caches, and branch prediction.  Called once from
+ * platforminit() after ::platform.maxaddr is known.
+ */
+void mmu_init(void)
+{
+    ulong i, addr, ramend, ctrl;
+
+    ramend = ((ulong)platform.maxaddr + MMU_SECTION_SIZE - 1)
+        & ~(MMU_SECTION_SIZE - 1);
+    for (i = 0; i < MMU_NSECTION; i++)
+    {
+        addr = i * MMU_SECTION_SIZE;
+        if (addr < ramend)
+        {
+            mmu_table[i] = addr | MMU_MEM_CACHED;
+        }
+        else if (addr >= MMU_DEVICE_BASE
+                 && addr - MMU_DEVICE_BASE < MMU_DEVICE_SIZE)
+        {
+            mmu_table[i] = addr | MMU_MEM_DEVICE;
+        }
+        else
+        {
+            mmu_table[i] = addr | MMU_MEM_UNCACHED;
+        }
+    }
+
+    /* Start from empty caches and TLBs.  */
+    asm volatile ("mcr p15, 0, %0, c7, c7, 0"::"r" (0));
+    asm volatile ("mcr p15, 0, %0, c8, c7, 0"::"r" (0));
+    dsb();
+
+    /* Domain 0 is a client, so the access permissions above are checked.
+     * Translate every address through TTBR0.  */
+    asm volatile ("mcr p15, 0, %0, c3, c0, 0"::"r" (1));
+    asm volatile ("mcr p15, 0, %0, c2, c0, 2"::"r" (0));
+    asm volatile ("mcr p15, 0, %0, c2, c0, 0"::"r" (mmu_table):"memory");
+
+    asm volatile ("mrc p15, 0, %0, c1, c0, 0":"=r" (ctrl));
+    ctrl |= CTRL_MMU | CTRL_DCACHE | CTRL_BRANCH | CTRL_ICACHE | CTRL_XP;
+    asm volatile ("mcr p15, 0, %0, c1, c0, 0"::"r" (ctrl):"memory");
+    isb();
+}
+
+/**
+ * Write back all dirty data, then turn off the caches and the MMU.  Used
+ * before handing the processor to code that expects the reset state, such
+ * as a kernel started by kexec().  Interrupts must be disabled.
+ */
+void mmu_disable(void)
+{
+    ulong ctrl;
+
+    /* Clean and invalidate the entire data cache, then invalidate the
+     * instruction cache and branch predictor.  */
+    asm volatile ("mcr p15, 0, %0, c7, c14, 0"::"r" (0):"memory");
+    asm volatile ("mcr p15, 0, %0, c7, c5, 0"::"r" (0));
+    asm volatile ("mcr p15, 0, %0, c7, c5, 6"::"r" (0));
+    dsb();
+
+    asm volatile ("mrc p15, 0, %0, c1, c0, 0":"=r" (ctrl));
+    ctrl &= ~(CTRL_MMU | CTRL_DCACHE | CTRL_BRANCH | CTRL_ICACHE);
+    asm volatile ("mcr p15, 0, %0, c1, c0, 0"::"r" (ctrl):"memory");
+    isb();
+
+    asm volatile ("mcr p15, 0, %0, c8, c7, 0"::"r" (0));
+    dsb();
+}
+
+/**
+ * Write back any dirty data cache lines holding part of a buffer, so a
+ * device reading it by DMA sees what the processor wrote.
+ *
+ * @param addr
+ *      start of the buffer
+ * @param len
+ *      length of the buffer in bytes
+ */
+void dcache_clean(const void *addr, uint len)
+{
+    ulong line, end;
+
+    end = (ulong)addr + len;
+    for (line = (ulong)addr & ~(CACHE_LINE_SIZE - 1); line < end;
+         line += CACHE_LINE_SIZE)
+    {
+        asm volatile ("mcr p15, 0, %0, c7, c10, 1"::"r" (line):"memory");
+    }
+    dsb();
+}
+
+/**
+ * Discard the data cache lines holding part of a buffer, so the processor
+ * reads what a device wrote to it by DMA.  Dirty data in those lines is
+ * lost.
+ *
+ * @param addr
+ *      start of the buffer
+ * @param len
+ *      length of the buffer in bytes
+ */
+void dcache_invalidate(void *addr, uint len)
+{
+    ulong line, end;
+
+    end = (ulong)addr + len;
+    for (line = (ulong)addr & ~(CACHE_LINE_SIZE - 1); line < end;
+         line += CACHE_LINE_SIZE)
+    {
+        asm volatile ("mcr p15, 0, %0, c7, c6, 1"::"r" (line):"memory");
+    }
+    dsb();
+}
+
+/**
+ * Write back and then discard the data cache lines holding part of a
+ * buffer.  Used before a device writes a buffer by DMA, so no dirty line
+ * can later be written back over the incoming data.
+ *
+ * @param addr
+ *      start of the buffer
+ * @param len
+ *      length of the buffer in bytes
+ */
+void dcache_flush(const void *addr, uint len)
+{
+    ulong line, end;
+
+    end = (ulong)addr + len;
+    for (line = (ulong)addr & ~(CACHE_LINE_SIZE - 1); line < end;
+         line += CACHE_LINE_SIZE)
+    {
+        asm volatile ("mcr p15, 0, %0, c7, c14, 1"::"r" (line):"memory");
+    }
+    dsb();
+}
+
+/**
+ * Discard the whole instruction cache and the branch predictor, after
+ * writing instructions to memory.  The data cache lines holding the new
+ * instructions must be cleaned first.
+ */
+void icache_invalidate(void)
+{
+    asm volatile ("mcr p15, 0, %0, c7, c5, 0"::"r" (0):"memory");
+    asm volatile ("mcr p15, 0, %0, c7, c5, 6"::"r" (0));
+    dsb();
+    isb();
+}
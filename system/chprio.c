@@ -9,7 +9,8 @@
 /**
  * @ingroup threads
  *
- * Change the scheduling priority of a thread
+ * Change the scheduling priority of a thread.  A thread holding mutexes keeps
+ * any higher priority it inherited through them.
  * @param tid target thread
  * @param newprio new priority
  * @return old priority of thread
@@ -27,8 +28,9 @@ syscall chprio(tid_typ tid, int newprio)
         return SYSERR;
     }
     thrptr = &thrtab[tid];
-    oldprio = thrptr->prio;
-    thrptr->prio = newprio;
+    oldprio = thrptr->basprio;
+    thrptr->basprio = newprio;
+    priorecompute(tid);
     restore(im);
     return oldprio;
 }
@@ -8,6 +8,7 @@
 #include <clock.h>
 #include <thread.h>
 #include <platform.h>
+#include <profile.h>
 
 #if RTCLOCK
 
@@ -29,6 +30,12 @@ interrupt clkhandler(void)
     /* Another clock tick passes. */
     clkticks++;
 
+    /* Sample the interrupted address if the profiler is running. */
+    if (profiling)
+    {
+        profsample();
+    }
+
     /* Update global second counter. */
     if (CLKTICKS_PER_SEC == clkticks)
     {
@@ -0,0 +1,97 @@
+/**
+ * @file cpuacct.c
+ *
+ * Accounting of processor time to threads and to interrupt handlers.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <clock.h>
+#include <thread.h>
+
+uint64_t irqcycles;             /* cycles spent in interrupt handlers */
+ulong irqcount;                 /* number of interrupts taken         */
+ulong irqpc;                    /* address the last interrupt hit     */
+
+#if NCPU > 1
+#define cpustamp (cpuself()->cpustamp)
+#else
+int irqnest;                    /* >0 while in an interrupt handler   */
+static ulong cpustamp;          /* cycle count when last accounted    */
+#endif
+
+/**
+ * @ingroup threads
+ *
+ * Read the counter used for processor time accounting.  This is the time
+ * stamp counter on x86 and the platform timer elsewhere.  Only the
+ * difference between two readings is meaningful; the counter may wrap.
+ *
+ * @return current value of the counter
+ */
+ulong cyclecount(void)
+{
+#ifdef _XINU_PLATFORM_X86_
+    ulong count;
+
+    asm volatile ("rdtsc":"=a" (count)::"edx");
+    return count;
+#else
+    return clkcount();
+#endif
+}
+
+/**
+ * @ingroup threads
+ *
+ * Charge the cycles since the last call to the interrupt handlers if one is
+ * running, otherwise to the current thread.  This is called by resched() on
+ * every clock tick, so the counter cannot wrap between calls.  Interrupts
+ * must be disabled.
+ */
+void cpuaccount(void)
+{
+    ulong now;
+
+    now = cyclecount();
+    if (irqnest > 0)
+    {
+        irqcycles += now - cpustamp;
+    }
+    else
+    {
+        thrtab[thrcurrent].cpucycles += now - cpustamp;
+    }
+    cpustamp = now;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Note the start of an interrupt handler.  Called by the interrupt
+ * dispatcher with interrupts disabled.  On a multiprocessor the handler
+ * runs holding the kernel lock.
+ */
+void irqenter(void)
+{
+#if NCPU > 1
+    kernlock();
+#endif
+    cpuaccount();
+    irqnest++;
+    irqcount++;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Note the end of an interrupt handler.  Called by the interrupt dispatcher
+ * with interrupts disabled.
+ */
+void irqexit(void)
+{
+    cpuaccount();
+    irqnest--;
+#if NCPU > 1
+    kernunlock();
+#endif
+}
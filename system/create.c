@@ -8,6 +8,9 @@
 #include <thread.h>
 
 static int thrnew(void);
+static tid_typ thrcreate(void *procaddr, uint ssize, int priority,
+                         uint msgdepth, const char *name, int nargs,
+                         va_list ap);
 
 /**
  * @ingroup threads
@@ -32,12 +35,62 @@ static int thrnew(void);
  */
 tid_typ create(void *procaddr, uint ssize, int priority,
                const char *name, int nargs, ...)
+{
+    tid_typ tid;                /* new thread ID                       */
+    va_list ap;                 /* list of thread arguments            */
+
+    va_start(ap, nargs);
+    tid = thrcreate(procaddr, ssize, priority, MSGQDEPTH, name, nargs, ap);
+    va_end(ap);
+    return tid;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Create a thread that can hold several messages.  Sends to a thread
+ * created by create() fail while it has a message waiting; sends to this
+ * thread only fail once @p msgdepth messages are waiting.
+ *
+ * @param procaddr
+ *      procedure address
+ * @param ssize
+ *      stack size in bytes
+ * @param priority
+ *      thread priority (0 is lowest priority)
+ * @param msgdepth
+ *      number of messages the thread's message queue holds
+ * @param name
+ *      name of the thread, used for debugging
+ * @param nargs
+ *      number of arguments that follow
+ * @param ...
+ *      arguments to pass to thread procedure
+ * @return
+ *      the new thread's thread id, or ::SYSERR if a new thread could not be
+ *      created (not enough memory or thread entries).
+ */
+tid_typ createq(void *procaddr, uint ssize, int priority, uint msgdepth,
+                const char *name, int nargs, ...)
+{
+    tid_typ tid;                /* new thread ID                       */
+    va_list ap;                 /* list of thread arguments            */
+
+    va_start(ap, nargs);
+    tid = thrcreate(procaddr, ssize, priority, msgdepth, name, nargs, ap);
+    va_end(ap);
+    return tid;
+}
+
+static tid_typ thrcreate(void *procaddr, uint ssize, int priority,
+                         uint msgdepth, const char *name, int nargs,
+                         va_list ap)
 {
     irqmask im;                 /* saved interrupt state               */
     ulong *saddr;               /* stack address                       */
+    struct msgent *msgq;        /* message queue storage               */
     tid_typ tid;                /* new thread ID                       */
     struct thrent *thrptr;      /* pointer to new thread control block */
-    va_list ap;                 /* list of thread arguments            */
 
     im = disable();
 
@@ -54,10 +107,31 @@ tid_typ create(void *procaddr, uint ssize, int priority,
         return SYSERR;
     }
 
+    /* Allocate message queue, unless it fits in the thread entry.  */
+    if (msgdepth < MSGQDEPTH)
+    {
+        msgdepth = MSGQDEPTH;
+    }
+    msgq = NULL;
+    if (msgdepth > MSGQDEPTH)
+    {
+        msgq = memget(msgdepth * sizeof(struct msgent));
+        if (SYSERR == (int)msgq)
+        {
+            stkfree(saddr, ssize);
+            restore(im);
+            return SYSERR;
+        }
+    }
+
     /* Allocate new thread ID.  */
     tid = thrnew();
     if (SYSERR == (int)tid)
     {
+        if (NULL != msgq)
+        {
+            memfree(msgq, msgdepth * sizeof(struct msgent));
+        }
         stkfree(saddr, ssize);
         restore(im);
         return SYSERR;
@@ -69,13 +143,23 @@ tid_typ create(void *procaddr, uint ssize, int priority,
 
     thrptr->state = THRSUSP;
     thrptr->prio = priority;
+    thrptr->basprio = priority;
     thrptr->stkbase = saddr;
     thrptr->stklen = ssize;
     strlcpy(thrptr->name, name, TNMLEN);
     thrptr->parent = gettid();
-    thrptr->hasmsg = FALSE;
+    thrptr->msgq = (NULL != msgq) ? msgq : &thrptr->msgslot;
+    thrptr->msgmax = msgdepth;
+    thrptr->msghead = 0;
+    thrptr->msgcount = 0;
     thrptr->memlist.next = NULL;
     thrptr->memlist.length = 0;
+    thrptr->cpucycles = 0;
+    thrptr->nswitch = 0;
+    thrptr->nvolun = 0;
+    thrptr->ninvol = 0;
+    thrptr->cpu = thrtab[thrcurrent].cpu;
+    thrptr->fpuctx = NULL;
 
     /* Set up default file descriptors.  */
     thrptr->fdesc[0] = CONSOLE; /* stdin  is console */
@@ -84,9 +168,7 @@ tid_typ create(void *procaddr, uint ssize, int priority,
 
     /* Set up new thread's stack with context record and arguments.
      * Architecture-specific.  */
-    va_start(ap, nargs);
     thrptr->stkptr = setupStack(saddr, procaddr, INITRET, nargs, ap);
-    va_end(ap);
 
     /* Restore interrupts and return new thread TID.  */
     restore(im);
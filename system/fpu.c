@@ -0,0 +1,169 @@
+/**
+ * @file fpu.c
+ *
+ * Lazy switching of floating point state.  Each processor remembers which
+ * thread's registers its floating point unit holds and leaves the unit
+ * disabled for every other thread.  A thread's first floating point
+ * instruction after being switched to traps to fputrap(), which moves the
+ * owner's registers out to memory and the thread's in.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <fpu.h>
+#include <interrupt.h>
+#include <memory.h>
+#include <stdio.h>
+#include <thread.h>
+
+#if USE_FPU
+
+#if !(NCPU > 1)
+tid_typ fpuowner;               /* thread whose state is in the unit  */
+#endif
+ulong fputraps;                 /* first uses that trapped            */
+
+/* Owner of the unit of processor cpu */
+#if NCPU > 1
+#define cpufpuowner(cpu) (cputab[(cpu)].fpu)
+#else
+#define cpufpuowner(cpu) (fpuowner)
+#endif
+
+/* Bytes allocated for a saved context, enough to align it */
+#define FPU_CTXALLOC (FPU_CTXSIZE + FPU_CTXALIGN - 1)
+
+/**
+ * @ingroup threads
+ *
+ * Set up the floating point unit of the running processor, owned by no
+ * thread and disabled, so the first thread to use it traps.
+ */
+void fpuinit(void)
+{
+    fpuSetup();
+    fpuowner = BADTID;
+    fpuDisable();
+}
+
+/**
+ * @ingroup threads
+ *
+ * Enable the floating point unit for the thread about to be switched to
+ * only if its registers are already loaded.  Called by resched().
+ * @param tid thread being switched to
+ */
+void fpuswitch(tid_typ tid)
+{
+    if (tid == fpuowner)
+    {
+        fpuEnable();
+    }
+    else
+    {
+        fpuDisable();
+    }
+}
+
+/**
+ * @ingroup threads
+ *
+ * Give the floating point unit to the current thread, which just tried to
+ * use it.  The registers of the previous owner are saved in its context.
+ * A thread starts with the registers as fpuReset() leaves them; the memory
+ * to save them in is allocated then.  Called from the platform's trap for
+ * a disabled floating point unit.
+ */
+void fputrap(void)
+{
+    struct thrent *thrptr;
+    irqmask im;
+
+    im = disable();
+    fputraps++;
+    fpuEnable();
+    if (thrcurrent == fpuowner)
+    {
+        restore(im);
+        return;
+    }
+    if (BADTID != fpuowner)
+    {
+        fpuSave(fpuarea(thrtab[fpuowner].fpuctx));
+        fpuowner = BADTID;
+    }
+
+    thrptr = &thrtab[thrcurrent];
+    if (NULL == thrptr->fpuctx)
+    {
+        thrptr->fpuctx = memget(FPU_CTXALLOC);
+        if (SYSERR == (int)thrptr->fpuctx)
+        {
+            thrptr->fpuctx = NULL;
+            kprintf("No memory for floating point state of thread %d\r\n",
+                    thrcurrent);
+            kill(thrcurrent);
+            restore(im);
+            return;
+        }
+        fpuReset();
+    }
+    else
+    {
+        fpuRestore(fpuarea(thrptr->fpuctx));
+    }
+    fpuowner = thrcurrent;
+    restore(im);
+}
+
+/**
+ * @ingroup threads
+ *
+ * Move the floating point registers of a thread that is not running out
+ * of the unit of its processor, so it can be bound to another.  Interrupts
+ * must be disabled.
+ * @param tid target thread
+ * @return OK on success, SYSERR if the registers are held by the unit of
+ *         another processor
+ */
+syscall fpuflush(tid_typ tid)
+{
+    struct thrent *thrptr = &thrtab[tid];
+
+    if (tid != cpufpuowner(thrptr->cpu))
+    {
+        return OK;
+    }
+    if (thrptr->cpu != getcpu())
+    {
+        return SYSERR;
+    }
+    fpuEnable();
+    fpuSave(fpuarea(thrptr->fpuctx));
+    fpuowner = BADTID;
+    fpuDisable();
+    return OK;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Forget the floating point state of a thread that is being killed.
+ * Interrupts must be disabled.
+ * @param tid target thread
+ */
+void fpufree(tid_typ tid)
+{
+    struct thrent *thrptr = &thrtab[tid];
+
+    if (tid == cpufpuowner(thrptr->cpu))
+    {
+        cpufpuowner(thrptr->cpu) = BADTID;
+    }
+    if (NULL != thrptr->fpuctx)
+    {
+        memfree(thrptr->fpuctx, FPU_CTXALLOC);
+        thrptr->fpuctx = NULL;
+    }
+}
+
+#endif                          /* USE_FPU */
@@ -10,6 +10,7 @@
 #include <backplane.h>
 #include <clock.h>
 #include <device.h>
+#include <fpu.h>
 #include <gpio.h>
 #include <memory.h>
 #include <bufpool.h>
@@ -19,6 +20,7 @@
 #include <queue.h>
 #include <semaphore.h>
 #include <monitor.h>
+#include <kmutex.h>
 #include <mailbox.h>
 #include <network.h>
 #include <nvram.h>
@@ -28,6 +30,7 @@
 #include <syscall.h>
 #include <safemem.h>
 #include <platform.h>
+#include <workpool.h>
 
 #ifdef WITH_USB
 #  include <usb_subsystem.h>
@@ -41,13 +44,18 @@ static int sysinit(void);       /* intializes system structures        */
 struct thrent thrtab[NTHREAD];  /* Thread table                   */
 struct sement semtab[NSEM];     /* Semaphore table                */
 struct monent montab[NMON];     /* Monitor table                  */
-qid_typ readylist;              /* List of READY threads          */
+struct kmutent kmutextab[NKMUTEX]; /* Kernel mutex table             */
 struct memblock memlist;        /* List of free memory blocks     */
 struct bfpentry bfptab[NPOOL];  /* List of memory buffer pools    */
+#if !(NCPU > 1)
+qid_typ readylist;              /* List of READY threads          */
+#endif
 
 /* Active system status */
 int thrcount;                   /* Number of live user threads         */
+#if !(NCPU > 1)
 tid_typ thrcurrent;             /* Id of currently running thread      */
+#endif
 
 /* Params set by startup.S */
 void *memheap;                  /* Bottom of heap (top of O/S stack)   */
@@ -76,6 +84,11 @@ void nulluser(void)
     /* Enable interrupts  */
     enable();
 
+#if NCPU > 1
+    /* Start the other processors  */
+    smpinit();
+#endif
+
     /* Spawn the main thread  */
     ready(create(main, INITSTK, INITPRIO, "MAIN", 0), RESCHED_YES);
 
@@ -120,14 +133,28 @@ static int sysinit(void)
     thrptr = &thrtab[NULLTHREAD];
     thrptr->state = THRCURR;
     thrptr->prio = 0;
+    thrptr->basprio = 0;
     strlcpy(thrptr->name, "prnull", TNMLEN);
     thrptr->stkbase = (void *)&_end;
     thrptr->stklen = (ulong)memheap - (ulong)&_end;
     thrptr->stkptr = 0;
     thrptr->memlist.next = NULL;
     thrptr->memlist.length = 0;
+    thrptr->msgq = &thrptr->msgslot;
+    thrptr->msgmax = MSGQDEPTH;
+    thrptr->msghead = 0;
+    thrptr->msgcount = 0;
+    thrptr->cpucycles = 0;
+    thrptr->nswitch = 0;
+    thrptr->nvolun = 0;
+    thrptr->ninvol = 0;
+    thrptr->cpu = 0;
+    thrptr->fpuctx = NULL;
     thrcurrent = NULLTHREAD;
 
+    /* Floating point registers are loaded on first use */
+    fpuinit();
+
     /* Initialize semaphores */
     for (i = 0; i < NSEM; i++)
     {
@@ -141,6 +168,12 @@ static int sysinit(void)
         montab[i].state = MFREE;
     }
 
+    /* Initialize kernel mutexes */
+    for (i = 0; i < NKMUTEX; i++)
+    {
+        kmutextab[i].state = KMUTEX_FREE;
+    }
+
     /* Initialize buffer pools */
     for (i = 0; i < NPOOL; i++)
     {
@@ -148,7 +181,14 @@ static int sysinit(void)
     }
 
     /* initialize thread ready list */
+#if NCPU > 1
+    for (i = 0; i < NCPU; i++)
+    {
+        cpureadylist(i) = queinit();
+    }
+#else
     readylist = queinit();
+#endif
 
 #if SB_BUS
     backplaneInit(NULL);
@@ -190,6 +230,11 @@ static int sysinit(void)
     mailboxInit();
 #endif
 
+#if NWORK
+    /* initialize work pool */
+    workInit();
+#endif
+
 #if NDEVS
     for (i = 0; i < NDEVS; i++)
     {
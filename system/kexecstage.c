@@ -0,0 +1,195 @@
+/**
+ * @file kexecstage.c
+ *
+ * Staging of a kernel image for kexec() while it is still being received.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <interrupt.h>
+#include <kexec.h>
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADLER_MOD  65521        /* largest prime below 2^16            */
+#define ADLER_NMAX 5552         /* bytes summed before sums can overflow */
+
+/**
+ * @ingroup misc
+ *
+ * Prepare a staging area for a kernel image.
+ *
+ * The staging area is a single contiguous block laid out exactly as the image
+ * will be copied by kexec(), so data can be written into it as it arrives and
+ * executed in place without first being gathered into another buffer.
+ *
+ * @param stage
+ *      Staging area to initialize.
+ * @param maxlen
+ *      Maximum length of the image in bytes, or 0 if unknown.  If 0, the
+ *      largest free memory block is used, less ::KEXEC_STAGE_RESERVE bytes.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR if memory could not be allocated.
+ */
+syscall kexecStageInit(struct kexecstage *stage, uint maxlen)
+{
+    struct memblock *block;
+    irqmask im;
+
+    if (0 == maxlen)
+    {
+        im = disable();
+        for (block = memlist.next; NULL != block; block = block->next)
+        {
+            if (block->length > maxlen)
+            {
+                maxlen = block->length;
+            }
+        }
+        restore(im);
+        if (maxlen <= KEXEC_STAGE_RESERVE)
+        {
+            return SYSERR;
+        }
+        maxlen -= KEXEC_STAGE_RESERVE;
+    }
+
+    /* leave room to pad the image out to a whole copy unit */
+    maxlen = (maxlen + KEXEC_COPY_UNIT - 1) & ~(KEXEC_COPY_UNIT - 1);
+    stage->base = memget(maxlen);
+    if (SYSERR == (int)stage->base)
+    {
+        stage->base = NULL;
+        return SYSERR;
+    }
+    stage->len = 0;
+    stage->maxlen = maxlen;
+    stage->checksum = 1;        /* initial Adler-32 value */
+    return OK;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Append data to a staged kernel image, updating the image checksum.
+ *
+ * @param stage
+ *      Staging area initialized by kexecStageInit().
+ * @param data
+ *      Next bytes of the image.
+ * @param len
+ *      Number of bytes in @p data.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR if the staging area is full.
+ */
+syscall kexecStageWrite(struct kexecstage *stage, const void *data, uint len)
+{
+    if (len > stage->maxlen - stage->len)
+    {
+        return SYSERR;
+    }
+    memcpy(stage->base + stage->len, data, len);
+    stage->checksum = kexecChecksum(stage->checksum,
+                                    stage->base + stage->len, len);
+    stage->len += len;
+    return OK;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Finish staging a kernel image.  The image is zero-padded to a whole number
+ * of ::KEXEC_COPY_UNIT blocks and any unused memory at the end of the staging
+ * area is released.  Afterwards the image can be passed to kexec() as
+ * kexec(stage->base, stage->len).
+ *
+ * @param stage
+ *      Staging area holding a complete image.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR if no data was staged.
+ */
+syscall kexecStageFinish(struct kexecstage *stage)
+{
+    uint padded, used;
+
+    if (0 == stage->len)
+    {
+        return SYSERR;
+    }
+
+    padded = (stage->len + KEXEC_COPY_UNIT - 1) & ~(KEXEC_COPY_UNIT - 1);
+    bzero(stage->base + stage->len, padded - stage->len);
+
+    used = (uint)roundmb(padded);
+    if (used < stage->maxlen)
+    {
+        memfree(stage->base + used, stage->maxlen - used);
+        stage->maxlen = used;
+    }
+    return OK;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Release a staging area, e.g. after a failed download.
+ *
+ * @param stage
+ *      Staging area initialized by kexecStageInit().
+ *
+ * @return
+ *      ::OK on success; ::SYSERR if the staging area was not allocated.
+ */
+syscall kexecStageFree(struct kexecstage *stage)
+{
+    syscall result;
+
+    if (NULL == stage->base)
+    {
+        return SYSERR;
+    }
+    result = memfree(stage->base, stage->maxlen);
+    stage->base = NULL;
+    return result;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Update an Adler-32 checksum with more data.  Start with a checksum of 1.
+ * The result matches that of zlib's adler32(), so images can be checked
+ * against a value computed on the host.
+ *
+ * @param checksum
+ *      Checksum of all preceding data.
+ * @param data
+ *      Data to add to the checksum.
+ * @param len
+ *      Number of bytes in @p data.
+ *
+ * @return
+ *      The updated checksum.
+ */
+ulong kexecChecksum(ulong checksum, const uchar *data, uint len)
+{
+    ulong a = checksum & 0xffff;
+    ulong b = (checksum >> 16) & 0xffff;
+    uint n;
+
+    while (len > 0)
+    {
+        n = (len < ADLER_NMAX) ? len : ADLER_NMAX;
+        len -= n;
+        while (n--)
+        {
+            a += *data++;
+            b += a;
+        }
+        a %= ADLER_MOD;
+        b %= ADLER_MOD;
+    }
+    return (b << 16) | a;
+}
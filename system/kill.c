@@ -5,6 +5,7 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <thread.h>
+#include <fpu.h>
 #include <queue.h>
 #include <memory.h>
 #include <safemem.h>
@@ -21,6 +22,8 @@ extern void xdone(void);
 syscall kill(tid_typ tid)
 {
     register struct thrent *thrptr;     /* thread control block */
+    tid_typ owner;              /* owner of mutex thread waits on */
+    int i;
     irqmask im;
 
     im = disable();
@@ -30,6 +33,14 @@ syscall kill(tid_typ tid)
         return SYSERR;
     }
     thrptr = &thrtab[tid];
+#if NCPU > 1
+    /* a thread running on another processor cannot be stopped from here */
+    if ((THRCURR == thrptr->state) && (tid != thrcurrent))
+    {
+        restore(im);
+        return SYSERR;
+    }
+#endif
 
     if (--thrcount <= 1)
     {
@@ -39,11 +50,31 @@ syscall kill(tid_typ tid)
 #ifdef UHEAP_SIZE
     /* reclaim used memory regions */
     memRegionReclaim(tid);
+    safeAsidFree(tid);
 #endif                          /* UHEAP_SIZE */
 
     send(thrptr->parent, tid);
 
     stkfree(thrptr->stkbase, thrptr->stklen);
+    fpufree(tid);
+    if (thrptr->msgq != &thrptr->msgslot)
+    {
+        memfree(thrptr->msgq, thrptr->msgmax * sizeof(struct msgent));
+    }
+
+    /* mutexes held by the thread are left without an owner */
+    for (i = 0; i < NSEM; i++)
+    {
+        if (semtab[i].mutex && (tid == semtab[i].owner))
+        {
+            semtab[i].owner = BADTID;
+        }
+    }
+    owner = BADTID;
+    if ((THRWAIT == thrptr->state) && semtab[thrptr->sem].mutex)
+    {
+        owner = semtab[thrptr->sem].owner;
+    }
 
     switch (thrptr->state)
     {
@@ -65,6 +96,9 @@ syscall kill(tid_typ tid)
         thrptr->state = THRFREE;
     }
 
+    /* the owner no longer inherits the priority of the killed thread */
+    priorecompute(owner);
+
     restore(im);
     return OK;
 }
@@ -0,0 +1,76 @@
+/**
+ * @file kmutexcreate.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <kmutex.h>
+#include <string.h>
+
+static kmutex kmutexalloc(void);
+
+/**
+ * @ingroup kmutexes
+ *
+ * Create and initialize a new kernel mutex.
+ *
+ * @param name
+ *      Name of the mutex, shown by the mutexstat shell command.
+ *
+ * @return
+ *      On success, returns the new kernel mutex.  On failure (system is out of
+ *      kernel mutexes or semaphores), returns ::SYSERR.
+ */
+kmutex kmutexcreate(const char *name)
+{
+    irqmask im;
+    kmutex m;
+    struct kmutent *mutptr;
+
+    im = disable();
+
+    m = kmutexalloc();
+    if (SYSERR != m)
+    {
+        mutptr = &kmutextab[m];
+        mutptr->lock = 0;
+        mutptr->nlock = 0;
+        mutptr->ncontend = 0;
+        mutptr->nspin = 0;
+        strlcpy(mutptr->name, name, KMUTEX_NMLEN);
+
+        /* Waiters block on a mutex semaphore, which lends their priority to
+         * the owner.  Its count is 0 because the owner never waits on it. */
+        mutptr->sem = semcreate(0);
+        if (SYSERR == mutptr->sem)
+        {
+            mutptr->state = KMUTEX_FREE;
+            m = SYSERR;
+        }
+        else
+        {
+            semtab[mutptr->sem].mutex = TRUE;
+        }
+    }
+
+    restore(im);
+    return m;
+}
+
+/* Returns the index of an unused kernel mutex table entry, or SYSERR if none
+ * are available.  */
+static kmutex kmutexalloc(void)
+{
+    int i;
+    static int nextmutex = 0;
+
+    for (i = 0; i < NKMUTEX; i++)
+    {
+        nextmutex = (nextmutex + 1) % NKMUTEX;
+        if (KMUTEX_FREE == kmutextab[nextmutex].state)
+        {
+            kmutextab[nextmutex].state = KMUTEX_USED;
+            return nextmutex;
+        }
+    }
+    return SYSERR;
+}
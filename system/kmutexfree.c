@@ -0,0 +1,36 @@
+/**
+ * @file kmutexfree.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <kmutex.h>
+
+/**
+ * @ingroup kmutexes
+ *
+ * Free a kernel mutex.  Threads still waiting to lock it are released.
+ *
+ * @param m
+ *      The kernel mutex to free.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR on failure (@p m did not specify a valid,
+ *      allocated kernel mutex).
+ */
+syscall kmutexfree(kmutex m)
+{
+    irqmask im;
+
+    im = disable();
+    if (isbadkmutex(m))
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    semfree(kmutextab[m].sem);
+    kmutextab[m].state = KMUTEX_FREE;
+
+    restore(im);
+    return OK;
+}
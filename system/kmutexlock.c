@@ -0,0 +1,98 @@
+/**
+ * @file kmutexlock.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <atomic.h>
+#include <kmutex.h>
+
+/**
+ * @ingroup kmutexes
+ *
+ * Lock a kernel mutex.
+ *
+ * An unlocked mutex is claimed with a single compare-and-swap and without
+ * disabling interrupts.  The claim stores the owner in the mutex's lock word,
+ * so a contending thread always knows whom to lend its priority to.  If the
+ * mutex is held by a thread running on another processor, the caller spins
+ * for up to ::KMUTEX_SPIN iterations in the expectation that it is released
+ * soon; on a uniprocessor the owner cannot be running, so the caller instead
+ * blocks at once.  A blocked caller lends its priority to the owner until it
+ * gets the mutex.
+ *
+ * Kernel mutexes are not recursive, and must be unlocked by the thread that
+ * locked them.
+ *
+ * @param m
+ *      The kernel mutex to lock.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR on failure (@p m did not specify a valid,
+ *      allocated kernel mutex, the current thread already owns it, or it was
+ *      freed while waiting).
+ */
+syscall kmutexlock(kmutex m)
+{
+    struct kmutent *mutptr;
+    tid_typ owner;
+    irqmask im;
+    int spins, lock;
+
+    if (isbadkmutex(m))
+    {
+        return SYSERR;
+    }
+    mutptr = &kmutextab[m];
+    if (thrcurrent == kmutexowner(mutptr))
+    {
+        return SYSERR;
+    }
+
+    /* spin only while the owner is running elsewhere */
+    for (spins = 0; spins < KMUTEX_SPIN && 0 != mutptr->lock; spins++)
+    {
+        owner = kmutexowner(mutptr);
+        if (isbadtid(owner) || (THRCURR != thrtab[owner].state)
+            || (thrcurrent == owner))
+        {
+            break;
+        }
+    }
+
+    /* fast path: the mutex was free */
+    if (0 == atomicCas(&mutptr->lock, 0, thrcurrent + 1))
+    {
+        mutptr->nlock++;
+        if (spins > 0)
+        {
+            mutptr->nspin++;
+        }
+        return OK;
+    }
+
+    /* slow path: count this thread as a waiter and block until the owner
+     * hands over the mutex.  Waiters are counted and queued with interrupts
+     * disabled, so kmutexunlock() always finds them on the queue. */
+    im = disable();
+    lock = atomicAdd(&mutptr->lock, KMUTEX_WAITER);
+    if (0 == (lock & KMUTEX_OWNER))
+    {
+        /* released before this thread was counted; take it instead */
+        atomicAdd(&mutptr->lock, thrcurrent + 1 - KMUTEX_WAITER);
+        restore(im);
+        mutptr->nlock++;
+        return OK;
+    }
+    semtab[mutptr->sem].owner = (lock & KMUTEX_OWNER) - 1;
+    wait(mutptr->sem);
+    if (KMUTEX_FREE == mutptr->state)
+    {
+        restore(im);
+        return SYSERR;
+    }
+    restore(im);
+
+    mutptr->nlock++;
+    mutptr->ncontend++;
+    return OK;
+}
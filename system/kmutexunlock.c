@@ -0,0 +1,66 @@
+/**
+ * @file kmutexunlock.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <atomic.h>
+#include <kmutex.h>
+#include <queue.h>
+
+/**
+ * @ingroup kmutexes
+ *
+ * Unlock a kernel mutex.
+ *
+ * If no other thread is waiting for the mutex, it is released with a single
+ * compare-and-swap and without disabling interrupts.  Otherwise it is handed
+ * to the highest priority waiting thread, which becomes the owner before it
+ * runs, and any priority the current thread inherited from the waiters is
+ * dropped.
+ *
+ * @param m
+ *      The kernel mutex to unlock.
+ *
+ * @return
+ *      ::OK on success; ::SYSERR on failure (@p m did not specify a valid,
+ *      allocated kernel mutex owned by the current thread).
+ */
+syscall kmutexunlock(kmutex m)
+{
+    struct kmutent *mutptr;
+    qid_typ q;
+    irqmask im;
+
+    if (isbadkmutex(m))
+    {
+        return SYSERR;
+    }
+    mutptr = &kmutextab[m];
+    if (thrcurrent != kmutexowner(mutptr))
+    {
+        return SYSERR;
+    }
+
+    /* fast path: nobody is waiting */
+    if (thrcurrent + 1 == atomicCas(&mutptr->lock, thrcurrent + 1, 0))
+    {
+        return OK;
+    }
+
+    /* slow path: hand over to the waiter signal() will release.  Lockers
+     * only change a held lock word with interrupts disabled. */
+    im = disable();
+    q = semtab[mutptr->sem].queue;
+    if (isempty(q))
+    {
+        /* the counted waiters were killed */
+        mutptr->lock = 0;
+        restore(im);
+        return OK;
+    }
+    atomicAdd(&mutptr->lock, firstid(q) - thrcurrent - KMUTEX_WAITER);
+    semtab[mutptr->sem].owner = thrcurrent;
+    signal(mutptr->sem);
+    restore(im);
+    return OK;
+}
@@ -36,9 +36,10 @@ monitor moncreate(void)
         monptr->owner = NOOWNER;
         monptr->count = 0;
 
-        /* Initialize the monitor's semaphore with a count of 1, allowing one
-         * thread to acquire the monitor.  */
-        monptr->sem = semcreate(1);
+        /* Initialize the monitor's semaphore as a mutex, allowing one thread
+         * to acquire the monitor and lending the priority of threads waiting
+         * to lock it to the owner.  */
+        monptr->sem = mutexcreate(0);
         if (SYSERR == monptr->sem)
         {
             monptr->state = MFREE;
@@ -0,0 +1,120 @@
+/**
+ * @file msgqueue.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <clock.h>
+#include <thread.h>
+
+/**
+ * @ingroup threads
+ *
+ * Append a message to a thread's message queue and start the thread if it
+ * is waiting for a message.
+ *
+ * @param tid
+ *      thread id of recipient
+ * @param ent
+ *      message to deposit
+ * @return
+ *      OK on success, SYSERR if @p tid is not a valid thread or its message
+ *      queue is full
+ */
+syscall msgput(tid_typ tid, const struct msgent *ent)
+{
+    register struct thrent *thrptr;
+    irqmask im;
+
+    im = disable();
+    if (isbadtid(tid))
+    {
+        restore(im);
+        return SYSERR;
+    }
+    thrptr = &thrtab[tid];
+    if (thrptr->msgcount >= thrptr->msgmax)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    /* deposit message at the tail of the queue */
+    thrptr->msgq[(thrptr->msghead + thrptr->msgcount) % thrptr->msgmax] =
+        *ent;
+    thrptr->msgcount++;
+
+    /* if receiver waits, start it */
+    if (THRRECV == thrptr->state)
+    {
+        ready(tid, RESCHED_YES);
+    }
+    else if (THRTMOUT == thrptr->state)
+    {
+        unsleep(tid);
+        ready(tid, RESCHED_YES);
+    }
+    restore(im);
+    return OK;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Remove the oldest message from the current thread's message queue,
+ * waiting for one if the queue is empty.
+ *
+ * @param timed
+ *      TRUE to give up after @p maxwait ticks, FALSE to wait indefinitely
+ * @param maxwait
+ *      ticks to wait before timeout
+ * @param ent
+ *      filled in with the message
+ * @return
+ *      OK if a message was received, TIMEOUT if the wait timed out, or
+ *      SYSERR if the wait could not be timed
+ */
+syscall msgtake(bool timed, int maxwait, struct msgent *ent)
+{
+    register struct thrent *thrptr;
+    irqmask im;
+
+    im = disable();
+    thrptr = &thrtab[thrcurrent];
+    if (0 == thrptr->msgcount)
+    {
+        if (!timed)
+        {
+            thrptr->state = THRRECV;
+            resched();
+        }
+        else
+        {
+#if RTCLOCK
+            if (SYSERR == insertd(thrcurrent, sleepq, maxwait))
+            {
+                restore(im);
+                return SYSERR;
+            }
+            thrptr->state = THRTMOUT;
+            resched();
+#else
+            restore(im);
+            return SYSERR;
+#endif
+        }
+    }
+
+    if (0 == thrptr->msgcount)
+    {
+        restore(im);
+        return TIMEOUT;
+    }
+
+    /* retrieve message from the head of the queue */
+    *ent = thrptr->msgq[thrptr->msghead];
+    thrptr->msghead = (thrptr->msghead + 1) % thrptr->msgmax;
+    thrptr->msgcount--;
+    restore(im);
+    return OK;
+}
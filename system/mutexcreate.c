@@ -0,0 +1,44 @@
+/**
+ * @file mutexcreate.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <semaphore.h>
+#include <interrupt.h>
+
+/**
+ * @ingroup semaphores
+ *
+ * Creates a mutex, a semaphore with an initial count of 1 that records which
+ * thread holds it.  A thread that waits on a held mutex lends its priority to
+ * the holder until the holder signals the mutex.
+ *
+ * @param ceiling
+ *      Priority ceiling of the mutex.  If positive, a thread holding the mutex
+ *      runs at no less than this priority.  Pass 0 for priority inheritance
+ *      alone.
+ *
+ * @return
+ *      On success, returns the new mutex; otherwise returns ::SYSERR.  The new
+ *      mutex must be freed with semfree() when no longer needed.
+ */
+semaphore mutexcreate(int ceiling)
+{
+    semaphore sem;
+    irqmask im;
+
+    if (ceiling < 0)
+    {
+        return SYSERR;
+    }
+
+    im = disable();
+    sem = semcreate(1);
+    if (SYSERR != sem)
+    {
+        semtab[sem].mutex = TRUE;
+        semtab[sem].ceiling = ceiling;
+    }
+    restore(im);
+    return sem;
+}
@@ -0,0 +1,3 @@
+/* QEMU loads kernels for the Versatile PB at address 0x10000.  */
+#define KEXEC_LOAD_ADDR 0x10000
+#include <system/arch/arm/kexec.c>
@@ -0,0 +1,4 @@
+/* The Versatile PB peripherals occupy 256 MB starting at 0x10000000.  */
+#define MMU_DEVICE_BASE 0x10000000
+#define MMU_DEVICE_SIZE 0x10000000
+#include <system/arch/arm/mmu.c>
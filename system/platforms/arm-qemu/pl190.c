@@ -18,6 +18,7 @@
 
 #include <interrupt.h>
 #include <stdint.h>
+#include <thread.h>
 
 static volatile struct {
     uint32_t VICIRQSTATUS;            /* +0x000 */
@@ -74,6 +75,7 @@ void dispatch(void)
 {
     uint32_t status = regs->VICIRQSTATUS;
 
+    irqenter();
     do
     {
         uint irq = 31 - __builtin_clz(status);
@@ -81,4 +83,5 @@ void dispatch(void)
         status ^= 1U << irq;
     }
     while (status);
+    irqexit();
 }
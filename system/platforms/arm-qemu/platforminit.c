@@ -6,6 +6,7 @@
 /* TODO:  The ARM boot tags (atags) parsing could be shared with the
  * Raspberry Pi port.  */
 
+#include <mmu.h>
 #include <platform.h>
 #include <string.h>
 #include <stdint.h>
@@ -121,6 +122,7 @@ int platforminit(void)
     platform.serial_low = 0;   /* Used only if serial # not found in atags */
     platform.serial_high = 0;  /* Used only if serial # not found in atags */
     parse_atag_list();
+    mmu_init();
     sp804_init();
     return OK;
 }
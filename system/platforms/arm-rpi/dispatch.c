@@ -17,6 +17,7 @@
 #include <interrupt.h>
 #include <kernel.h>
 #include <stddef.h>
+#include <thread.h>
 #include "bcm2835.h"
 
 /** Layout of the BCM2835 interrupt controller's registers. */
@@ -127,6 +128,7 @@ void dispatch(void)
 {
     uint i;
 
+    irqenter();
     for (i = 0; i < 3; i++)
     {
         uint mask = arm_enabled_irqs[i];
@@ -137,6 +139,7 @@ void dispatch(void)
             check_irq_pending(bit + (i << 5));
         }
     }
+    irqexit();
 }
 
 /**
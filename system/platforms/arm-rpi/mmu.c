@@ -0,0 +1,5 @@
+/* The BCM2835 peripherals occupy 16 MB starting at PERIPHERALS_BASE.  */
+#include "bcm2835.h"
+#define MMU_DEVICE_BASE PERIPHERALS_BASE
+#define MMU_DEVICE_SIZE 0x01000000
+#include <system/arch/arm/mmu.c>
@@ -3,6 +3,7 @@
  */
 /* Embedded Xinu, Copyright (C) 2009, 2013.  All rights reserved. */
 
+#include <mmu.h>
 #include <platform.h>
 #include <string.h>
 #include "bcm2835.h"
@@ -116,6 +117,7 @@ int platforminit(void)
     platform.serial_low = 0;   /* Used only if serial # not found in atags */
     platform.serial_high = 0;  /* Used only if serial # not found in atags */
     parse_atag_list();
+    mmu_init();
     bcm2835_power_init();
     return OK;
 }
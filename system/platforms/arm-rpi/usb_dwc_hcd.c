@@ -70,6 +70,7 @@
 
 #include <interrupt.h>
 #include <mailbox.h>
+#include <mmu.h>
 #include <string.h>
 #include <thread.h>
 #include <usb_core_driver.h>
@@ -85,6 +86,9 @@
 /** Determines whether a pointer is word-aligned or not.  */
 #define IS_WORD_ALIGNED(ptr) ((ulong)(ptr) % sizeof(ulong) == 0)
 
+/** Determines whether a pointer or length is a whole number of cache lines. */
+#define IS_LINE_ALIGNED(n) ((ulong)(n) % CACHE_LINE_SIZE == 0)
+
 /** Pointer to the memory-mapped registers of the Synopsys DesignWare Hi-Speed
  * USB 2.0 OTG Controller.  */
 static volatile struct dwc_regs * const regs = (void*)DWC_REGS_BASE;
@@ -160,7 +164,11 @@ static struct usb_xfer_request *channel_pending_xfers[DWC_NUM_CHANNELS];
 
 /** Aligned buffers for DMA.  */
 static uint8_t aligned_bufs[DWC_NUM_CHANNELS][WORD_ALIGN(USB_MAX_PACKET_SIZE)]
-                                __aligned(4);
+                                __aligned(CACHE_LINE_SIZE);
+
+/** Whether the transfer on each channel goes through its aligned buffer
+ * rather than directly to or from the request's data.  */
+static bool channel_bounced[DWC_NUM_CHANNELS];
 
 /* Find index of first set bit in a nonzero word.  */
 static inline ulong first_set_bit(ulong word)
@@ -251,10 +259,10 @@ dwc_soft_reset(void)
  * Set up the DWC OTG USB Host Controller for DMA (direct memory access).  This
  * makes it possible for the Host Controller to directly access in-memory
  * buffers when performing USB transfers.  Beware: all buffers accessed with DMA
- * must be 4-byte-aligned.  Furthermore, if the L1 data cache is enabled, then
- * it must be explicitly flushed to maintain cache coherency since it is
- * internal to the ARM processor.  (This is not currently handled by this driver
- * because Xinu does not enable the L1 data cache.)
+ * must be 4-byte-aligned.  Furthermore, since the L1 data cache is internal to
+ * the ARM processor, dwc_channel_start_xfer() cleans or flushes each buffer
+ * before a transfer and the channel halted interrupt handler invalidates the
+ * data received.
  */
 static void
 dwc_setup_dma_mode(void)
@@ -825,6 +833,7 @@ dwc_channel_start_xfer(uint chan, struct usb_xfer_request *req)
     union dwc_host_channel_split_control split_control;
     union dwc_host_channel_transfer transfer;
     void *data;
+    void *dma_buf;
 
     chanptr = &regs->host_channels[chan];
     characteristics.val = 0;
@@ -984,19 +993,28 @@ dwc_channel_start_xfer(uint chan, struct usb_xfer_request *req)
         }
     }
 
-    /* Set up DMA buffer.  */
-    if (IS_WORD_ALIGNED(data))
+    /* Set up DMA buffer.  Data to receive is discarded from the data cache
+     * a whole line at a time, so receiving directly into the destination is
+     * only safe if it covers whole cache lines; otherwise a partial line
+     * shared with other data would lose the CPU's writes to that data.  */
+    if (IS_WORD_ALIGNED(data) &&
+        (characteristics.endpoint_direction == USB_DIRECTION_OUT ||
+         (IS_LINE_ALIGNED(data) && IS_LINE_ALIGNED(transfer.size))))
     {
-        /* Can DMA directly from source or to destination if word-aligned.  */
+        /* Can DMA directly from source or to destination.  */
+        dma_buf = data;
         chanptr->dma_address = (uint32_t)data;
+        channel_bounced[chan] = FALSE;
     }
     else
     {
         /* Need to use alternate buffer for DMA, since the actual source or
-         * destination is not word-aligned.  If the attempted transfer size
+         * destination is not suitably aligned.  If the attempted transfer size
          * overflows this alternate buffer, cap it to the greatest number of
          * whole packets that fit.  */
+        dma_buf = aligned_bufs[chan];
         chanptr->dma_address = (uint32_t)aligned_bufs[chan];
+        channel_bounced[chan] = TRUE;
         if (transfer.size > sizeof(aligned_bufs[chan]))
         {
             transfer.size = sizeof(aligned_bufs[chan]) -
@@ -1055,6 +1073,19 @@ dwc_channel_start_xfer(uint chan, struct usb_xfer_request *req)
                   split_control.split_enable,
                   req->complete_split);
 
+    /* The Host Controller reads and writes memory directly, not through the
+     * L1 data cache.  Write back data it is about to send.  For data it is
+     * about to receive, also discard the cached copy so that no dirty line
+     * is later written back over the data received.  */
+    if (characteristics.endpoint_direction == USB_DIRECTION_OUT)
+    {
+        dcache_clean(dma_buf, transfer.size);
+    }
+    else
+    {
+        dcache_flush(dma_buf, transfer.size);
+    }
+
     /* Actually program the registers of the appropriate channel.  */
     chanptr->characteristics = characteristics;
     chanptr->split_control   = split_control;
@@ -1247,9 +1278,18 @@ dwc_handle_normal_channel_halted(struct usb_xfer_request *req, uint chan,
              * impossible to determine the length of short packets...)  */
             bytes_transferred = req->attempted_bytes_remaining -
                                 chanptr->transfer.size;
-            /* Copy data from DMA buffer if needed */
-            if (!IS_WORD_ALIGNED(req->cur_data_ptr))
+            /* Discard any lines of the DMA buffer fetched into the data
+             * cache while the transfer was in progress, then copy data from
+             * DMA buffer if needed */
+            if (!channel_bounced[chan])
+            {
+                dcache_invalidate(req->cur_data_ptr, bytes_transferred);
+            }
+            else
             {
+                dcache_invalidate(&aligned_bufs[chan][req->attempted_size -
+                                            req->attempted_bytes_remaining],
+                                  bytes_transferred);
                 memcpy(req->cur_data_ptr,
                        &aligned_bufs[chan][req->attempted_size -
                                            req->attempted_bytes_remaining],
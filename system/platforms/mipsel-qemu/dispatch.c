@@ -10,6 +10,7 @@
 #include <mips.h>
 #include "pic8259.h"
 #include <stdio.h>
+#include <thread.h>
 
 char *interrupts[] = {
     "Software interrupt request 0",
@@ -98,7 +99,10 @@ void dispatch(long cause, long *frame)
     im = disable();             /* Disable interrupts for duration of handler */
     exlreset();                 /* Reset system-wide exception bit */
 
+    irqpc = frame[IRQREC_EPC / sizeof(long)];
+    irqenter();
     (*handler) ();              /* Call device-specific handler */
+    irqexit();
 
     exlset();                   /* Set system-wide exception bit */
     restore(im);
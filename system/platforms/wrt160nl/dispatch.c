@@ -10,6 +10,7 @@
 #include <mips.h>
 #include "ar9130.h"
 #include <stdio.h>
+#include <thread.h>
 
 char *interrupts[] = {
     "Software interrupt request 0",
@@ -79,7 +80,10 @@ void dispatch(long cause, long *frame)
     im = disable();             /* Disable interrupts for duration of handler */
     exlreset();                 /* Reset system-wide exception bit */
 
+    irqpc = frame[IRQREC_EPC / sizeof(long)];
+    irqenter();
     (*handler) ();              /* Call device-specific handler */
+    irqexit();
 
     exlset();                   /* Set system-wide exception bit */
     restore(im);
@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include <mips.h>
 #include <stdio.h>
+#include <thread.h>
 
 const char *interrupts[] = {
     "Software interrupt request 0",
@@ -56,7 +57,10 @@ void dispatch(long cause, long *frame)
     im = disable();             /* Disable interrupts for duration of handler */
     exlreset();                 /* Reset system-wide exception bit */
 
+    irqpc = frame[IRQREC_EPC / sizeof(long)];
+    irqenter();
     (*handler) ();              /* Call device-specific handler */
+    irqexit();
 
     exlset();                   /* Set system-wide exception bit */
     restore(im);
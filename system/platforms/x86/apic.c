@@ -0,0 +1,100 @@
+/**
+ * @file apic.c
+ *
+ * Local APIC setup, timer and interprocessor interrupts.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <kernel.h>
+#include <clock.h>
+#include <smp.h>
+#include "apic.h"
+
+#if NCPU > 1
+
+/**
+ * Enable the local APIC of the running processor with its timer stopped.
+ * The boot processor keeps taking 8259 interrupts through LINT0; the others
+ * take only what the local APICs send them.
+ * @param boot TRUE on the boot processor
+ */
+void lapicInit(bool boot)
+{
+    lapicWrite(LAPIC_SVR, LAPIC_SVR_ENABLE | LAPIC_SPURIOUS_VECTOR);
+    lapicWrite(LAPIC_TPR, 0);
+    lapicWrite(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED | LAPIC_TIMER_VECTOR);
+    if (boot)
+    {
+        lapicWrite(LAPIC_LVT_LINT0, LAPIC_DM_EXTINT);
+        lapicWrite(LAPIC_LVT_LINT1, LAPIC_DM_NMI);
+    }
+    else
+    {
+        lapicWrite(LAPIC_LVT_LINT0, LAPIC_LVT_MASKED);
+        lapicWrite(LAPIC_LVT_LINT1, LAPIC_LVT_MASKED);
+    }
+    lapicEoi();
+}
+
+/**
+ * @return local APIC id of the running processor
+ */
+uint lapicId(void)
+{
+    return lapicRead(LAPIC_ID) >> 24;
+}
+
+/**
+ * Measure the local APIC timer against the system clock.  The clock must be
+ * running, so interrupts must be enabled.
+ * @return timer counts in one clock tick
+ */
+ulong lapicCalibrate(void)
+{
+    ulong start, count;
+    uint i;
+
+    lapicWrite(LAPIC_TDCR, LAPIC_TDCR_DIV16);
+
+    /* start counting on a tick boundary */
+    start = clkticks;
+    while (clkticks == start)
+        ;
+    lapicWrite(LAPIC_TICR, 0xFFFFFFFF);
+    for (i = 0; i < LAPIC_CALIBRATE_TICKS; i++)
+    {
+        start = clkticks;
+        while (clkticks == start)
+            ;
+    }
+    count = 0xFFFFFFFF - lapicRead(LAPIC_TCCR);
+    lapicWrite(LAPIC_TICR, 0);
+
+    return count / LAPIC_CALIBRATE_TICKS;
+}
+
+/**
+ * Interrupt the running processor periodically on LAPIC_TIMER_VECTOR.
+ * @param count timer counts between interrupts
+ */
+void lapicTimer(ulong count)
+{
+    lapicWrite(LAPIC_TDCR, LAPIC_TDCR_DIV16);
+    lapicWrite(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | LAPIC_TIMER_VECTOR);
+    lapicWrite(LAPIC_TICR, count);
+}
+
+/**
+ * Send an interprocessor interrupt.
+ * @param apicid local APIC id of the target, ignored by shorthands
+ * @param icr    delivery mode, vector and shorthand
+ */
+void lapicIpi(uint apicid, ulong icr)
+{
+    while (lapicRead(LAPIC_ICRLO) & LAPIC_ICR_PENDING)
+        ;
+    lapicWrite(LAPIC_ICRHI, apicid << 24);
+    lapicWrite(LAPIC_ICRLO, icr);
+}
+
+#endif                          /* NCPU > 1 */
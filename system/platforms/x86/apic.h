@@ -0,0 +1,77 @@
+/**
+ * @file apic.h
+ *
+ * Local APIC of each x86 processor.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#ifndef _APIC_H_
+#define _APIC_H_
+
+#include <stddef.h>
+
+/* Every processor sees its own local APIC at the same address. */
+#define LAPIC_BASE          0xFEE00000
+
+/* local APIC register offsets */
+#define LAPIC_ID            0x020   /**< local APIC id                  */
+#define LAPIC_TPR           0x080   /**< task priority                  */
+#define LAPIC_EOI           0x0B0   /**< end of interrupt               */
+#define LAPIC_SVR           0x0F0   /**< spurious interrupt vector      */
+#define LAPIC_ICRLO         0x300   /**< interrupt command, low word    */
+#define LAPIC_ICRHI         0x310   /**< interrupt command, high word   */
+#define LAPIC_LVT_TIMER     0x320   /**< timer vector                   */
+#define LAPIC_LVT_LINT0     0x350   /**< local interrupt 0 vector       */
+#define LAPIC_LVT_LINT1     0x360   /**< local interrupt 1 vector       */
+#define LAPIC_TICR          0x380   /**< timer initial count            */
+#define LAPIC_TCCR          0x390   /**< timer current count            */
+#define LAPIC_TDCR          0x3E0   /**< timer divide configuration     */
+
+/* register bits */
+#define LAPIC_SVR_ENABLE    0x00000100
+#define LAPIC_LVT_MASKED    0x00010000
+#define LAPIC_TIMER_PERIODIC 0x00020000
+#define LAPIC_TDCR_DIV16    0x00000003
+#define LAPIC_DM_NMI        0x00000400
+#define LAPIC_DM_EXTINT     0x00000700
+#define LAPIC_ICR_INIT      0x00000500
+#define LAPIC_ICR_STARTUP   0x00000600
+#define LAPIC_ICR_PENDING   0x00001000
+#define LAPIC_ICR_ASSERT    0x00004000
+#define LAPIC_ICR_LEVEL     0x00008000
+#define LAPIC_ICR_OTHERS    0x000C0000
+
+/* Vectors above those of the 8259s, in one priority class. */
+#define LAPIC_TIMER_VECTOR   0x30
+#define LAPIC_RESCHED_VECTOR 0x31
+#define LAPIC_SPURIOUS_VECTOR 0x3F
+
+/** Clock ticks counted to measure the local APIC timer */
+#define LAPIC_CALIBRATE_TICKS 10
+
+static inline ulong lapicRead(uint reg)
+{
+    return *(volatile ulong *)(LAPIC_BASE + reg);
+}
+
+static inline void lapicWrite(uint reg, ulong val)
+{
+    *(volatile ulong *)(LAPIC_BASE + reg) = val;
+}
+
+/**
+ * Acknowledge the interrupt being handled.  Handlers do this first, as
+ * clkhandler() does for the 8259, since they may reschedule.
+ */
+static inline void lapicEoi(void)
+{
+    lapicWrite(LAPIC_EOI, 0);
+}
+
+void lapicInit(bool);
+uint lapicId(void);
+ulong lapicCalibrate(void);
+void lapicTimer(ulong);
+void lapicIpi(uint, ulong);
+
+#endif                          /* _APIC_H_ */
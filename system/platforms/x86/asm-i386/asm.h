@@ -2,7 +2,7 @@
 
 #define	NBPG    4096
 
-#define	NID     48
+#define	NID     64
 #define	NGD     8
 
 #define	IRQBASE 32   /* base ivec for IRQ0 */
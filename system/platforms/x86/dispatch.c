@@ -1,6 +1,7 @@
 #include <kernel.h>
 #include <interrupt.h>
 #include <segment.h>
+#include <thread.h>
 
 extern void clockintr(void);
 extern void xtrap(int, int *);
@@ -12,7 +13,9 @@ void dispatch(int exc_num, int *stack_ptr)
     if ( exctab[exc_num] != NULL )
     {
         /* execute handler */
+        irqenter();
         (*exctab[exc_num])();
+        irqexit();
     }
     else
     {
@@ -6,6 +6,7 @@
 #include <queue.h>
 #include <interrupt.h>
 #include <conf.h>
+#include <asm-i386/icu.h>
 
 /*#define STKTRACE*/
 /*#define REGDUMP*/
@@ -75,5 +76,10 @@ void set_handler(int exc_num, interrupt (*handler)(void))
         /* enable the interrupt in the global IR mask */
         exc_num -= 32;
         girmask = (short)(girmask & ~(1 << exc_num));
+#if NCPU > 1
+        /* restore() leaves the 8259s alone on a multiprocessor */
+        outb(IMR1, girmask & 0xff);
+        outb(IMR2, (girmask >> 8) & 0xff);
+#endif
     }
 }
@@ -12,6 +12,7 @@
 
 #include <stddef.h>
 
+#define	IDT_FPU  7 /* device (floating point) not available */
 #define	IRQBASE 32 /* base ivec for IRQ0                  */
 #define IRQ0     0 /* programmable interval timer         */
 #define IRQ1     1 /* keyboard controller                 */
@@ -26,7 +27,7 @@
 #define	IGDT_INTR	14	/* interrupt gate IDT descriptor  */
 #define	IGDT_TRAPG	15	/* Trap Gate                      */
 
-#define	NID  48
+#define	NID  64
 
 #ifndef __ASSEMBLER__
 
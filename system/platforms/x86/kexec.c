@@ -0,0 +1,93 @@
+/**
+ * @file kexec.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <interrupt.h>
+#include <kernel.h>
+#include <kexec.h>
+#include <smp.h>
+#include <string.h>
+
+/** Address at which x86 kernels are linked to run (see ld.script).  */
+#define KEXEC_LOAD_ADDR 0x00100000
+
+/* The below array contains a stub of x86 instructions used to copy the new
+ * kernel into its final location, then pass control to it.  As on ARM, it is
+ * hard-coded so that it can be copied somewhere it will not overwrite itself.
+ * The copy is a single "rep movsl", which the processor performs in large
+ * chunks and which, copying forward, is safe even if the new kernel overlaps
+ * its final location from a higher address.
+ *
+ * Arguments (cdecl, on the stack) are:
+ *
+ *  4(%esp):  pointer to new kernel
+ *  8(%esp):  size of new kernel in 32-bit words
+ */
+
+/*00000000 <copy_kernel>:*/
+  /* 0:   8b 74 24 04       mov    0x4(%esp),%esi   */
+  /* 4:   8b 4c 24 08       mov    0x8(%esp),%ecx   */
+  /* 8:   bf 00 00 10 00    mov    $0x100000,%edi   */
+  /* d:   fc                cld                     */
+  /* e:   f3 a5             rep movsl               */
+  /*10:   b8 00 00 10 00    mov    $0x100000,%eax   */
+  /*15:   ff e0             jmp    *%eax            */
+static const uchar copy_kernel[] = {
+    0x8b, 0x74, 0x24, 0x04,
+    0x8b, 0x4c, 0x24, 0x08,
+    0xbf, 0x00, 0x00, 0x10, 0x00,
+    0xfc,
+    0xf3, 0xa5,
+    0xb8, 0x00, 0x00, 0x10, 0x00,
+    0xff, 0xe0,
+};
+
+/* Conventional memory below the kernel that nothing else uses once booted.  */
+#define COPY_KERNEL_ADDR ((void*)0x7000)
+
+/**
+ * Kernel execute - Transfer control to a new kernel.
+ *
+ * This is the x86 implementation.  In this implementation, the new kernel must
+ * be a flat binary linked to run at and having an entry point at address
+ * 0x100000, as produced by the x86 build.
+ *
+ * @param kernel
+ *      Pointer to the new kernel image loaded anywhere in memory.
+ * @param size
+ *      Size of the new kernel image in bytes.
+ *
+ * @return
+ *      ::SYSERR if @p size is 0.  Otherwise this function never returns.  If it
+ *      somehow does, then something has gone horribly wrong.
+ */
+syscall kexec(const void *kernel, uint size)
+{
+    irqmask im;
+
+    if (0 == size)
+    {
+        return SYSERR;
+    }
+
+    im = disable();
+
+#if NCPU > 1
+    /* The other processors must not run old kernel text while it is
+     * overwritten.  */
+    smpstop();
+#endif
+
+    /* Copy the assembly stub into a safe location.  */
+    memcpy(COPY_KERNEL_ADDR, copy_kernel, sizeof(copy_kernel));
+
+    /* Enter the assembly stub to copy the new kernel into its final location,
+     * then pass control to it.  */
+    (( void (*)(const void *, ulong))(COPY_KERNEL_ADDR))
+                (kernel, (size + 3) / 4);
+
+    /* Control should never reach here.  */
+    restore(im);
+    return SYSERR;
+}
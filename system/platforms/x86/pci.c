@@ -0,0 +1,104 @@
+/**
+ * @file pci.c
+ *
+ * PCI configuration space access for the x86.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <conf.h>
+#include <interrupt.h>
+#include <pci.h>
+
+/**
+ * Read a register from the configuration space of a PCI function.
+ * @param bdf     bus, device and function, built with PCI_BDF()
+ * @param offset  offset of the register in configuration space
+ * @param width   width of the register in bytes (1, 2 or 4)
+ * @return the register's value
+ */
+ulong pciConfigRead(ulong bdf, uint offset, uint width)
+{
+    irqmask im;
+    ulong value;
+
+    im = disable();
+    outl(PCI_CONFIG_ADDR, PCI_CONFIG_ENABLE | bdf | (offset & 0xFC));
+    value = (ulong)inl(PCI_CONFIG_DATA) >> ((offset & 3) * 8);
+    restore(im);
+
+    if (width < 4)
+    {
+        value &= (1UL << (width * 8)) - 1;
+    }
+    return value;
+}
+
+/**
+ * Write a register in the configuration space of a PCI function.
+ * @param bdf     bus, device and function, built with PCI_BDF()
+ * @param offset  offset of the register in configuration space
+ * @param width   width of the register in bytes (1, 2 or 4)
+ * @param value   value to write
+ */
+void pciConfigWrite(ulong bdf, uint offset, uint width, ulong value)
+{
+    irqmask im;
+    ulong mask, shift;
+
+    im = disable();
+    outl(PCI_CONFIG_ADDR, PCI_CONFIG_ENABLE | bdf | (offset & 0xFC));
+    if (width < 4)
+    {
+        /* Merge narrower registers into the dword that holds them.  */
+        shift = (offset & 3) * 8;
+        mask = ((1UL << (width * 8)) - 1) << shift;
+        value = ((ulong)inl(PCI_CONFIG_DATA) & ~mask)
+            | ((value << shift) & mask);
+    }
+    outl(PCI_CONFIG_DATA, value);
+    restore(im);
+}
+
+/**
+ * Find a PCI function by vendor and device id.
+ * @param vendor  vendor id to look for
+ * @param device  device id to look for
+ * @param index   number of matching functions to skip
+ * @param bdf     set to the bus, device and function of the match
+ * @return OK if the function was found, otherwise SYSERR
+ */
+syscall pciFindDevice(ushort vendor, ushort device, uint index, ulong *bdf)
+{
+    uint bus, dev, func, nfunc;
+    ulong id;
+
+    for (bus = 0; bus < PCI_NBUS; bus++)
+    {
+        for (dev = 0; dev < PCI_NDEV; dev++)
+        {
+            nfunc = 1;
+            for (func = 0; func < nfunc; func++)
+            {
+                id = pciConfigRead(PCI_BDF(bus, dev, func), PCI_VENDOR_ID, 4);
+                if (0xFFFF == (id & 0xFFFF))
+                {
+                    continue;
+                }
+                if (0 == func
+                    && (pciConfigRead(PCI_BDF(bus, dev, 0),
+                                      PCI_HEADER_TYPE, 1) & PCI_HEADER_MULTI))
+                {
+                    nfunc = PCI_NFUNC;
+                }
+                if ((id & 0xFFFF) == vendor && (id >> 16) == device
+                    && 0 == index--)
+                {
+                    *bdf = PCI_BDF(bus, dev, func);
+                    return OK;
+                }
+            }
+        }
+    }
+    return SYSERR;
+}
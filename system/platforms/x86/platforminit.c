@@ -5,6 +5,7 @@
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
 #include <kernel.h>
+#include <fpu.h>
 #include <mips.h>
 #include <platform.h>
 #include <uart.h>
@@ -19,10 +20,14 @@ extern struct platform platform;        /* Platform specific configuration */
 
 /* prototypes */
 void lidt(void);
+#if NCPU > 1
+void smpcpuinit(uint);
+#endif
 
 /* interrupt variables */
 extern short girmask;
 extern long defevec[];
+extern void fpuTrap(void);
 extern struct segtr idtr;
 extern struct idt idt[NID];
 
@@ -34,6 +39,11 @@ int platforminit(void)
 {
     int i;
 
+#if NCPU > 1
+    /* disable() finds the processor's state through %fs   */
+    smpcpuinit(0);
+#endif
+
     /* Setup platform data                                 */
     strlcpy(platform.name, "Intel x86", PLT_STRMAX);
     platform.maxaddr = (void *)0x1000000;
@@ -63,6 +73,11 @@ int platforminit(void)
     {
         set_evec(i, (long)defevec[i]);
     }
+#if USE_FPU
+    /* Floating point use while the unit is disabled switches threads' */
+    /* registers instead of being a fatal trap                         */
+    set_evec(IDT_FPU, (long)fpuTrap);
+#endif
 
     /* girmask masks bus interrupts with default handler   */
     girmask = 0xfffb;
@@ -6,6 +6,10 @@
 #include <platform.h>
 #include <thread.h>
 
+#if NCPU > 1
+extern void smpthrstart(void);
+#endif
+
 /** Set up the context record and arguments on the stack for a new thread
  * (x86 version)  */
 void *setupStack(void *stackaddr, void *procaddr,
@@ -26,6 +30,10 @@ void *setupStack(void *stackaddr, void *procaddr,
 
     *--saddr     = (ulong)INITRET;
     *--saddr     = (ulong)procaddr;
+#if NCPU > 1
+    /* first release the kernel lock resched() held for the thread */
+    *--saddr     = (ulong)smpthrstart;
+#endif
     *--saddr     = savsp;
     savsp        = (ulong)saddr;
 
@@ -0,0 +1,401 @@
+/**
+ * @file smp.c
+ *
+ * Symmetric multiprocessing on x86: per-processor state, the kernel lock
+ * and starting the application processors.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <kernel.h>
+#include <clock.h>
+#include <fpu.h>
+#include <interrupt.h>
+#include <queue.h>
+#include <smp.h>
+#include <string.h>
+#include <thread.h>
+#include <asm-i386/icu.h>
+#include "apic.h"
+#include "segment.h"
+
+#if NCPU > 1
+
+/* Each processor finds its cputab entry through %fs, which selects a
+ * segment based at the entry.  The GDT has room for four of them.  */
+#define SEG_CPU0        4
+#if NCPU > NSEGS - SEG_CPU0
+#error "x86 supports at most four processors"
+#endif
+
+#define EFLAGS_IF       0x200   /* interrupt enable flag              */
+#define SMP_IDLE_STK    1024    /* stack size of an idle thread       */
+#define SMP_BOOT_WAIT   10      /* ticks to wait after the INIT IPI   */
+#define SMP_BOOT_TIMEOUT 100    /* ticks to wait for processors       */
+
+extern void ctxsw(void *, void *, uchar);
+extern short girmask;
+
+/* Real mode startup code in smpboot.S and the values it reads. */
+extern char smpboot[], smpbootend[];
+extern ulong smpbootstk, smpbootnstk;
+
+struct cpuent cputab[NCPU];     /* Processor table                    */
+volatile uint ncpu = 1;         /* Processors online                  */
+
+/* Kernel lock.  Only the owner changes its depth in cputab.  */
+static volatile int klocked;    /* nonzero while a processor holds it */
+static volatile int kowner = -1; /* index of that processor           */
+
+static ulong lapictick;         /* local APIC timer counts per tick   */
+static ulong apstack[NCPU - 1][SMPBOOT_STKSIZE / sizeof(ulong)];
+
+void smpcpuinit(uint);
+void apmain(uint);
+static thread smpidle(void);
+static interrupt smptimer(void);
+static interrupt smpipi(void);
+static interrupt smpspurious(void);
+static void smpwait(uint);
+
+static inline int xchg(volatile int *ptr, int val)
+{
+    asm volatile ("xchgl %0, %1":"+r" (val), "+m"(*ptr)::"memory");
+    return val;
+}
+
+/**
+ * @ingroup threads
+ *
+ * @return processor table entry of the running processor
+ */
+struct cpuent *cpuself(void)
+{
+    struct cpuent *cpuptr;
+
+    asm volatile ("movl %%fs:0, %0":"=r" (cpuptr));
+    return cpuptr;
+}
+
+/**
+ * @ingroup threads
+ *
+ * @return index of the running processor; the boot processor is 0
+ */
+uint getcpu(void)
+{
+    return cpuself()->index;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Take the kernel lock, spinning while another processor holds it.  A
+ * processor may take it again while holding it.  Interrupts must be
+ * disabled.
+ */
+void kernlock(void)
+{
+    struct cpuent *cpuptr = cpuself();
+
+    if (kowner == cpuptr->index)
+    {
+        cpuptr->lockdepth++;
+        return;
+    }
+    while (xchg(&klocked, 1))
+    {
+        while (klocked)
+        {
+            asm volatile ("pause");
+        }
+    }
+    kowner = cpuptr->index;
+    cpuptr->lockdepth = 1;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Undo one kernlock(), releasing the lock when it was the first.
+ */
+void kernunlock(void)
+{
+    struct cpuent *cpuptr = cpuself();
+
+    if (--cpuptr->lockdepth > 0)
+    {
+        return;
+    }
+    kowner = -1;
+    asm volatile ("":::"memory");
+    klocked = 0;
+}
+
+/**
+ * Disable interrupts on this processor and take the kernel lock, so no
+ * other processor runs kernel code either.  This replaces the version in
+ * intr.S, which masks the 8259s shared by all processors.
+ * @return whether interrupts were enabled
+ */
+irqmask disable(void)
+{
+    ulong flags;
+
+    asm volatile ("pushfl; popl %0; cli":"=r" (flags)::"memory");
+    kernlock();
+    return flags & EFLAGS_IF;
+}
+
+/**
+ * Undo a disable().
+ * @param im value returned by the matching disable()
+ * @return @p im
+ */
+irqmask restore(irqmask im)
+{
+    kernunlock();
+    if (im & EFLAGS_IF)
+    {
+        asm volatile ("sti":::"memory");
+    }
+    return im;
+}
+
+/**
+ * Enable interrupts on this processor, dropping the kernel lock if it is
+ * held.  The boot processor also unmasks the interrupts that have handlers.
+ * @return interrupt enable flag
+ */
+irqmask enable(void)
+{
+    struct cpuent *cpuptr;
+
+    asm volatile ("cli":::"memory");
+    cpuptr = cpuself();
+    if (kowner == cpuptr->index)
+    {
+        cpuptr->lockdepth = 1;
+        kernunlock();
+    }
+    if (0 == cpuptr->index)
+    {
+        outb(IMR1, girmask & 0xff);
+        outb(IMR2, (girmask >> 8) & 0xff);
+    }
+    asm volatile ("sti":::"memory");
+    return EFLAGS_IF;
+}
+
+/**
+ * First code of every new thread.  setupStack() places it between ctxsw()
+ * and the thread procedure, so it returns into the procedure.  The thread
+ * starts with interrupts off, holding the kernel lock for the resched()
+ * that switched to it.
+ */
+void smpthrstart(void)
+{
+    cpuself()->lockdepth = 1;
+    restore(EFLAGS_IF);
+}
+
+/**
+ * Point %fs of the running processor at its processor table entry.  The
+ * boot processor does this first thing in platforminit().
+ * @param cpu index of the running processor
+ */
+void smpcpuinit(uint cpu)
+{
+    struct cpuent *cpuptr = &cputab[cpu];
+
+    cpuptr->self = cpuptr;
+    cpuptr->index = cpu;
+    insertseg(SEG_CPU0 + cpu, (int)cpuptr, sizeof(struct cpuent) - 1,
+              SEG_DATA_KERNEL);
+    asm volatile ("movw %w0, %%fs"::"r" ((SEG_CPU0 + cpu) << 3));
+}
+
+/**
+ * @ingroup threads
+ *
+ * Start the application processors.  Each runs the threads bound to it
+ * with setcpu(), preempted by its local APIC timer, and an idle thread when
+ * none is ready.  Processors that do not start in time are left offline.
+ * Called by the null thread with interrupts enabled.
+ */
+void smpinit(void)
+{
+    struct cpuent *cpuptr;
+    tid_typ tid;
+    uint i, t;
+
+    cpuptr = &cputab[0];
+    lapicInit(TRUE);
+    cpuptr->apicid = lapicId();
+    cpuptr->idle = NULLTHREAD;
+    cpuptr->state = CPU_ONLINE;
+
+    set_handler(LAPIC_TIMER_VECTOR, smptimer);
+    set_handler(LAPIC_RESCHED_VECTOR, smpipi);
+    set_handler(LAPIC_SPURIOUS_VECTOR, smpspurious);
+    lapictick = lapicCalibrate();
+
+    /* Idle threads count as the null thread does.  */
+    for (i = 1; i < NCPU; i++)
+    {
+        tid = create(smpidle, SMP_IDLE_STK, 0, "prnull", 0);
+        if (SYSERR == tid)
+        {
+            break;
+        }
+        thrtab[tid].cpu = i;
+        cputab[i].idle = tid;
+        thrcount--;
+    }
+
+    /* The startup IPI starts a processor in real mode at a page below
+     * 1MB.  Processors take a stack each in the order they get there.  */
+    smpbootstk = (ulong)apstack;
+    smpbootnstk = i - 1;
+    memcpy((void *)SMPBOOT_ADDR, smpboot, smpbootend - smpboot);
+
+    lapicIpi(0, LAPIC_ICR_OTHERS | LAPIC_ICR_LEVEL | LAPIC_ICR_ASSERT
+             | LAPIC_ICR_INIT);
+    smpwait(SMP_BOOT_WAIT);
+    for (i = 0; i < 2; i++)
+    {
+        lapicIpi(0, LAPIC_ICR_OTHERS | LAPIC_ICR_ASSERT
+                 | LAPIC_ICR_STARTUP | (SMPBOOT_ADDR >> 12));
+        smpwait(1);
+    }
+
+    for (t = 0; (t < SMP_BOOT_TIMEOUT) && (ncpu < NCPU); t++)
+    {
+        smpwait(1);
+    }
+}
+
+/**
+ * @ingroup threads
+ *
+ * Stop the application processors before another kernel is copied over
+ * this one.  Each is sent an INIT, as smpinit() does, which resets the
+ * processor and its local APIC, timer included, to wait for a startup
+ * IPI; this works even while one spins in kernlock().  Called with
+ * interrupts disabled on the processor that keeps running.
+ */
+void smpstop(void)
+{
+    uint i;
+
+    /* this processor's local APIC timer stops too */
+    lapicWrite(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED | LAPIC_TIMER_VECTOR);
+    lapicWrite(LAPIC_TICR, 0);
+
+    lapicIpi(0, LAPIC_ICR_OTHERS | LAPIC_ICR_LEVEL | LAPIC_ICR_ASSERT
+             | LAPIC_ICR_INIT);
+    while (lapicRead(LAPIC_ICRLO) & LAPIC_ICR_PENDING)
+        ;
+
+    for (i = 0; i < NCPU; i++)
+    {
+        if (i != getcpu())
+        {
+            cputab[i].state = CPU_OFFLINE;
+        }
+    }
+    ncpu = 1;
+}
+
+/**
+ * C entry point of an application processor, called by smpboot.S on the
+ * processor's startup stack.  The processor gives up that stack for its
+ * idle thread and never returns.
+ * @param cpu index of the processor
+ */
+void apmain(uint cpu)
+{
+    struct cpuent *cpuptr;
+    void *bootsp;
+
+    smpcpuinit(cpu);
+    cpuptr = &cputab[cpu];
+    lapicInit(FALSE);
+    cpuptr->apicid = lapicId();
+    fpuinit();
+
+    disable();
+    cpuptr->curtid = cpuptr->idle;
+    thrtab[cpuptr->idle].state = THRCURR;
+    cpuptr->cpustamp = cyclecount();
+    cpuptr->state = CPU_ONLINE;
+    ncpu++;
+    lapicTimer(lapictick);
+
+    ctxsw(&bootsp, &thrtab[cpuptr->idle].stkptr, cpuptr->idle & 0xff);
+}
+
+/**
+ * @ingroup threads
+ *
+ * Ask a processor to look at its ready list.
+ * @param cpu index of the processor
+ */
+void smpresched(uint cpu)
+{
+    lapicIpi(cputab[cpu].apicid, LAPIC_RESCHED_VECTOR);
+}
+
+/*
+ * Idle thread of an application processor.
+ */
+static thread smpidle(void)
+{
+    while (TRUE)
+    {
+        pause();
+    }
+    return OK;
+}
+
+/*
+ * Local APIC timer interrupt: preempt the running thread.
+ */
+static interrupt smptimer(void)
+{
+    lapicEoi();
+    resched();
+}
+
+/*
+ * Reschedule request from another processor.
+ */
+static interrupt smpipi(void)
+{
+    lapicEoi();
+    cpuself()->nipi++;
+    resched();
+}
+
+/*
+ * Spurious local APIC interrupts are not acknowledged.
+ */
+static interrupt smpspurious(void)
+{
+}
+
+/*
+ * Wait for some clock ticks.  Interrupts must be enabled.
+ */
+static void smpwait(uint ticks)
+{
+    ulong start;
+
+    while (ticks-- > 0)
+    {
+        start = clkticks;
+        while (clkticks == start)
+            ;
+    }
+}
+
+#endif                          /* NCPU > 1 */
@@ -0,0 +1,122 @@
+/**
+ * @file prioinherit.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <thread.h>
+#include <queue.h>
+
+static void prioset(tid_typ tid, int prio);
+
+/**
+ * @ingroup threads
+ *
+ * Lend a priority to the owner of a mutex that a thread is about to wait on.
+ * If the owner is itself waiting on a mutex, the priority is passed along to
+ * that mutex's owner, and so on.  Interrupts must be disabled.
+ *
+ * @param owner
+ *      thread that holds the mutex
+ * @param prio
+ *      priority of the waiting thread
+ */
+void prioinherit(tid_typ owner, int prio)
+{
+    struct thrent *thrptr;
+    int n;
+
+    for (n = 0; n < NTHREAD && !isbadtid(owner); n++)
+    {
+        thrptr = &thrtab[owner];
+        if (thrptr->prio >= prio)
+        {
+            break;
+        }
+        prioset(owner, prio);
+        if ((THRWAIT != thrptr->state) || !semtab[thrptr->sem].mutex)
+        {
+            break;
+        }
+        owner = semtab[thrptr->sem].owner;
+    }
+}
+
+/**
+ * @ingroup threads
+ *
+ * Recompute the effective priority of a thread after the set of mutexes it
+ * holds, or the threads waiting on them, has changed.  The effective
+ * priority is the highest of the thread's own priority, the ceilings of the
+ * mutexes it holds, and the priorities of the threads waiting on them.  A
+ * change is passed along to the owner of any mutex the thread waits on.
+ * Interrupts must be disabled.
+ *
+ * @param tid
+ *      thread to recompute
+ */
+void priorecompute(tid_typ tid)
+{
+    struct thrent *thrptr;
+    struct sement *semptr;
+    int prio, i, n;
+
+    for (n = 0; n < NTHREAD && !isbadtid(tid); n++)
+    {
+        thrptr = &thrtab[tid];
+        prio = thrptr->basprio;
+
+        for (i = 0; i < NSEM; i++)
+        {
+            semptr = &semtab[i];
+            if ((SUSED == semptr->state) && semptr->mutex
+                && (tid == semptr->owner) && (semptr->ceiling > prio))
+            {
+                prio = semptr->ceiling;
+            }
+        }
+        for (i = 0; i < NTHREAD; i++)
+        {
+            if ((i != tid) && (THRWAIT == thrtab[i].state)
+                && semtab[thrtab[i].sem].mutex
+                && (tid == semtab[thrtab[i].sem].owner)
+                && (thrtab[i].prio > prio))
+            {
+                prio = thrtab[i].prio;
+            }
+        }
+
+        if (prio == thrptr->prio)
+        {
+            break;
+        }
+        prioset(tid, prio);
+        if ((THRWAIT != thrptr->state) || !semtab[thrptr->sem].mutex)
+        {
+            break;
+        }
+        tid = semtab[thrptr->sem].owner;
+    }
+}
+
+/*
+ * Change the effective priority of a thread, keeping the ready list and
+ * mutex wait queues sorted.  A waiter signal() has already dequeued is not
+ * moved.
+ */
+static void prioset(tid_typ tid, int prio)
+{
+    struct thrent *thrptr = &thrtab[tid];
+
+    thrptr->prio = prio;
+    if (THRREADY == thrptr->state)
+    {
+        getitem(tid);
+        insert(tid, cpureadylist(thrptr->cpu), prio);
+    }
+    else if ((THRWAIT == thrptr->state) && semtab[thrptr->sem].mutex
+             && (EMPTY != quetab[tid].next))
+    {
+        getitem(tid);
+        insert(tid, semtab[thrptr->sem].queue, prio);
+    }
+}
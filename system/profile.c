@@ -0,0 +1,89 @@
+/**
+ * @file profile.c
+ *
+ * Statistical sampling profiler.  The clock interrupt records the address
+ * it interrupted and the running thread into a ring buffer, which the
+ * prof shell command prints for a host-side script to resolve against the
+ * linker map.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <interrupt.h>
+#include <profile.h>
+#include <thread.h>
+
+struct profent proftab[PROF_NSAMPLE];
+bool profiling;
+uint profinterval;
+uint profhead;
+ulong profcount;
+
+static uint proftick;           /* ticks since the last sample */
+
+/**
+ * @ingroup threads
+ *
+ * Start profiling, discarding any samples already taken.
+ *
+ * @param interval
+ *      number of clock ticks between samples
+ *
+ * @return OK if profiling started, SYSERR if @p interval is 0
+ */
+syscall profstart(uint interval)
+{
+    irqmask im;
+
+    if (0 == interval)
+    {
+        return SYSERR;
+    }
+
+    im = disable();
+    profhead = 0;
+    profcount = 0;
+    proftick = 0;
+    profinterval = interval;
+    profiling = TRUE;
+    restore(im);
+    return OK;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Stop profiling.  The samples taken stay in ::proftab until the next
+ * profstart().
+ *
+ * @return OK
+ */
+syscall profstop(void)
+{
+    profiling = FALSE;
+    return OK;
+}
+
+/**
+ * @ingroup threads
+ *
+ * Record a sample of the interrupted address and the running thread.  This
+ * is called by the clock interrupt handler on every tick while profiling,
+ * with interrupts disabled.  Once the ring buffer is full the oldest
+ * samples are overwritten.
+ */
+void profsample(void)
+{
+    struct profent *ent;
+
+    if (++proftick < profinterval)
+    {
+        return;
+    }
+    proftick = 0;
+
+    ent = &proftab[profhead];
+    ent->pc = irqpc;
+    ent->tid = thrcurrent;
+    profhead = (profhead + 1) % PROF_NSAMPLE;
+    profcount++;
+}
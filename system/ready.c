@@ -27,7 +27,19 @@ int ready(tid_typ tid, bool resch)
     thrptr = &thrtab[tid];
     thrptr->state = THRREADY;
 
-    insert(tid, readylist, thrptr->prio);
+    insert(tid, cpureadylist(thrptr->cpu), thrptr->prio);
+
+#if NCPU > 1
+    /* Another processor only looks at its ready list when told to.  */
+    if (thrptr->cpu != getcpu())
+    {
+        if (thrptr->prio > thrtab[cputab[thrptr->cpu].curtid].prio)
+        {
+            smpresched(thrptr->cpu);
+        }
+        return OK;
+    }
+#endif
 
     if (resch == RESCHED_YES)
     {
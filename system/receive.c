@@ -14,19 +14,8 @@
  */
 message receive(void)
 {
-    register struct thrent *thrptr;
-    irqmask im;
-    message msg;
+    struct msgent ent;
 
-    im = disable();
-    thrptr = &thrtab[thrcurrent];
-    if (FALSE == thrptr->hasmsg)
-    {                           /* if no message, wait for one */
-        thrptr->state = THRRECV;
-        resched();
-    }
-    msg = thrptr->msg;          /* retrieve message                */
-    thrptr->hasmsg = FALSE;     /* reset message flag              */
-    restore(im);
-    return msg;
+    msgtake(FALSE, 0, &ent);
+    return ent.msg;
 }
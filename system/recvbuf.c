@@ -0,0 +1,43 @@
+/**
+ * @file recvbuf.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <thread.h>
+
+/**
+ * @ingroup threads
+ *
+ * Wait for a message and return it along with its type.  A buffer sent with
+ * sendbuf() is now owned by the caller.  A message from send() has type
+ * ::MSGWORD, its word in @p buf and a length of 0.
+ *
+ * @param type
+ *      filled in with the type of the message, may be NULL
+ * @param buf
+ *      filled in with the buffer, may be NULL
+ * @param len
+ *      filled in with the length of the buffer, may be NULL
+ * @return
+ *      OK
+ */
+syscall recvbuf(int *type, void **buf, uint *len)
+{
+    struct msgent ent;
+
+    msgtake(FALSE, 0, &ent);
+    if (NULL != type)
+    {
+        *type = ent.type;
+    }
+    if (NULL != buf)
+    {
+        *buf = (MSGWORD == ent.type) ? (void *)ent.msg : ent.buf;
+    }
+    if (NULL != len)
+    {
+        *len = ent.len;
+    }
+    return OK;
+}
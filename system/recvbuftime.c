@@ -0,0 +1,54 @@
+/**
+ * @file recvbuftime.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <thread.h>
+
+/**
+ * @ingroup threads
+ *
+ * Wait for a message like recvbuf(), giving up after a timeout like
+ * recvtime().
+ *
+ * @param maxwait
+ *      ticks to wait before timeout
+ * @param type
+ *      filled in with the type of the message, may be NULL
+ * @param buf
+ *      filled in with the buffer, may be NULL
+ * @param len
+ *      filled in with the length of the buffer, may be NULL
+ * @return
+ *      OK if a message was received, TIMEOUT if none arrived in time, or
+ *      SYSERR if the wait could not be timed
+ */
+syscall recvbuftime(int maxwait, int *type, void **buf, uint *len)
+{
+    struct msgent ent;
+    int result;
+
+    if (maxwait < 0)
+    {
+        return SYSERR;
+    }
+    result = msgtake(TRUE, maxwait, &ent);
+    if (OK != result)
+    {
+        return result;
+    }
+    if (NULL != type)
+    {
+        *type = ent.type;
+    }
+    if (NULL != buf)
+    {
+        *buf = (MSGWORD == ent.type) ? (void *)ent.msg : ent.buf;
+    }
+    if (NULL != len)
+    {
+        *len = ent.len;
+    }
+    return OK;
+}
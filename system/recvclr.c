@@ -9,8 +9,9 @@
 /**
  * @ingroup threads
  *
- * Clear messages, return waiting message (if any)
- * @return msg if available, NOMSG if no message
+ * Clear messages, return waiting message (if any).  Every queued message is
+ * discarded, including buffers sent with sendbuf().
+ * @return oldest msg if available, NOMSG if no message
  */
 message recvclr(void)
 {
@@ -20,15 +21,16 @@ message recvclr(void)
 
     im = disable();
     thrptr = &thrtab[thrcurrent];
-    if (thrptr->hasmsg)
+    if (thrptr->msgcount > 0)
     {
-        msg = thrptr->msg;
+        msg = thrptr->msgq[thrptr->msghead].msg;
     }                           /* retrieve message       */
     else
     {
         msg = NOMSG;
     }
-    thrptr->hasmsg = FALSE;     /* reset message flag   */
+    thrptr->msghead = 0;        /* empty message queue  */
+    thrptr->msgcount = 0;
     restore(im);
     return msg;
 }
@@ -4,10 +4,8 @@
  */
 /* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
 
-#include <conf.h>
 #include <stddef.h>
 #include <thread.h>
-#include <clock.h>
 
 /**
  * @ingroup threads
@@ -18,41 +16,17 @@
  */
 message recvtime(int maxwait)
 {
-    register struct thrent *thrptr;
-    irqmask im;
-    message msg;
+    struct msgent ent;
+    int result;
 
     if (maxwait < 0)
     {
         return SYSERR;
     }
-    im = disable();
-    thrptr = &thrtab[thrcurrent];
-    if (FALSE == thrptr->hasmsg)
+    result = msgtake(TRUE, maxwait, &ent);
+    if (OK != result)
     {
-#if RTCLOCK
-        if (SYSERR == insertd(thrcurrent, sleepq, maxwait))
-        {
-            restore(im);
-            return SYSERR;
-        }
-        thrtab[thrcurrent].state = THRTMOUT;
-        resched();
-#else
-        restore(im);
-        return SYSERR;
-#endif
-    }
-
-    if (thrptr->hasmsg)
-    {
-        msg = thrptr->msg;      /* retrieve message              */
-        thrptr->hasmsg = FALSE; /* reset message flag            */
-    }
-    else
-    {
-        msg = TIMEOUT;
+        return result;
     }
-    restore(im);
-    return msg;
+    return ent.msg;
 }
@@ -6,11 +6,17 @@
 
 #include <thread.h>
 #include <clock.h>
+#include <fpu.h>
 #include <queue.h>
 #include <memory.h>
+#ifdef UHEAP_SIZE
+#include <safemem.h>
+#endif
 
 extern void ctxsw(void *, void *, uchar);
+#if !(NCPU > 1)
 int resdefer;                   /* >0 if rescheduling deferred */
+#endif
 
 /**
  * @ingroup threads
@@ -26,6 +32,10 @@ int resched(void)
     uchar asid;                 /* address space identifier */
     struct thrent *throld;      /* old thread entry */
     struct thrent *thrnew;      /* new thread entry */
+    int nest;                   /* interrupt nesting of old thread */
+#if NCPU > 1
+    int depth;                  /* kernel lock depth of old thread */
+#endif
 
     if (resdefer > 0)
     {                           /* if deferred, increase count & return */
@@ -37,6 +47,9 @@ int resched(void)
 
     throld->intmask = disable();
 
+    /* charge the time since the last reschedule to the old thread */
+    cpuaccount();
+
     if (THRCURR == throld->state)
     {
         if (nonempty(readylist) && (throld->prio > firstkey(readylist)))
@@ -53,11 +66,45 @@ int resched(void)
     thrnew = &thrtab[thrcurrent];
     thrnew->state = THRCURR;
 
+    if (thrnew != throld)
+    {
+        thrnew->nswitch++;
+        if (THRREADY == throld->state)
+        {
+            throld->ninvol++;
+        }
+        else
+        {
+            throld->nvolun++;
+        }
+    }
+
+    /* An interrupt handler that reschedules finishes only when the old
+     * thread resumes, so the new thread starts outside any handler.  */
+    nest = irqnest;
+    irqnest = 0;
+#if NCPU > 1
+    /* The kernel lock passes to the new thread, which unwinds its own
+     * nesting of it.  */
+    depth = cpuself()->lockdepth;
+#endif
+
+    /* the new thread traps on floating point unless its registers are
+     * still loaded */
+    fpuswitch(thrcurrent);
+
     /* change address space identifier to thread id */
     asid = thrcurrent & 0xff;
+#ifdef UHEAP_SIZE
+    asidcurr = asidtab[thrcurrent];
+#endif
     ctxsw(&throld->stkptr, &thrnew->stkptr, asid);
 
     /* old thread returns here when resumed */
+#if NCPU > 1
+    cpuself()->lockdepth = depth;
+#endif
+    irqnest = nest;
     restore(throld->intmask);
     return OK;
 }
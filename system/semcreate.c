@@ -5,6 +5,7 @@
 
 #include <semaphore.h>
 #include <interrupt.h>
+#include <thread.h>
 
 static semaphore semalloc(void);
 
@@ -38,6 +39,9 @@ semaphore semcreate(int count)
     if (SYSERR != sem)      /* If semaphore was allocated, set count.  */
     {
         semtab[sem].count = count;
+        semtab[sem].mutex = FALSE;
+        semtab[sem].owner = BADTID;
+        semtab[sem].ceiling = 0;
     }
     /* Restore interrupts and return either the semaphore or SYSERR.  */
     restore(im);
@@ -0,0 +1,46 @@
+/**
+ * @file semtake.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <semaphore.h>
+#include <interrupt.h>
+
+/**
+ * @ingroup semaphores
+ *
+ * Wait on a semaphore up to @p count times, but only as many times as it can
+ * be waited on without blocking.  This lets a caller claim several units of
+ * a counted resource at once.
+ *
+ * @param sem
+ *      Semaphore to take from.
+ * @param count
+ *      Most units to take, which must not be negative.
+ *
+ * @return
+ *      On success, returns the number of units taken, from 0 to @p count;
+ *      otherwise returns ::SYSERR.  This function can only fail if @p sem did
+ *      not specify a valid semaphore or if @p count was negative.
+ */
+syscall semtake(semaphore sem, int count)
+{
+    register struct sement *semptr;
+    irqmask im;
+
+    im = disable();
+    if (isbadsem(sem) || (count < 0))
+    {
+        restore(im);
+        return SYSERR;
+    }
+    semptr = &semtab[sem];
+    if (semptr->count < count)
+    {
+        count = (semptr->count > 0) ? semptr->count : 0;
+    }
+    semptr->count -= count;
+    restore(im);
+    return count;
+}
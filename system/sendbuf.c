@@ -0,0 +1,42 @@
+/**
+ * @file sendbuf.c
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <thread.h>
+
+/**
+ * @ingroup threads
+ *
+ * Hand a buffer to another thread without copying it.  On success the
+ * recipient owns the buffer and is responsible for freeing it; on failure
+ * the caller still owns it.  Buffers still queued when the recipient is
+ * killed or calls recvclr() are not freed.
+ *
+ * @param tid
+ *      thread id of recipient
+ * @param type
+ *      type of the message, chosen by the caller; must not be ::MSGWORD
+ * @param buf
+ *      buffer to hand over
+ * @param len
+ *      length of the buffer in bytes
+ * @return
+ *      OK on success, SYSERR on failure or if the recipient's message queue
+ *      is full
+ */
+syscall sendbuf(tid_typ tid, int type, void *buf, uint len)
+{
+    struct msgent ent;
+
+    if (MSGWORD == type)
+    {
+        return SYSERR;
+    }
+    ent.type = type;
+    ent.msg = (message)buf;
+    ent.buf = buf;
+    ent.len = len;
+    return msgput(tid, &ent);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file setcpu.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <thread.h>
+#include <fpu.h>
+#include <queue.h>
+
+/**
+ * @ingroup threads
+ *
+ * Bind a thread to a processor.  Threads run on the processor of the thread
+ * that created them until moved with this call, which is usually made
+ * between create() and ready().  A thread cannot be moved while running,
+ * nor while the floating point unit of another processor holds its
+ * registers.
+ * @param tid target thread
+ * @param cpu index of a processor that is online
+ * @return OK on success, SYSERR otherwise
+ */
+syscall setcpu(tid_typ tid, uint cpu)
+{
+    register struct thrent *thrptr;     /* thread control block */
+    irqmask im;
+
+    im = disable();
+    if (isbadtid(tid) || (NULLTHREAD == tid) || (cpu >= ncpu))
+    {
+        restore(im);
+        return SYSERR;
+    }
+    thrptr = &thrtab[tid];
+    if ((THRCURR == thrptr->state) || (SYSERR == fpuflush(tid)))
+    {
+        restore(im);
+        return SYSERR;
+    }
+    if (THRREADY == thrptr->state)
+    {
+        getitem(tid);
+        thrptr->cpu = cpu;
+        ready(tid, RESCHED_NO);
+    }
+    else
+    {
+        thrptr->cpu = cpu;
+    }
+    restore(im);
+    return OK;
+}
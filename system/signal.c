@@ -11,6 +11,9 @@
  *
  * Signal a semaphore, releasing up to one waiting thread.
  *
+ * Signaling a mutex passes ownership to the released thread, if any, and
+ * drops any priority the previous owner inherited through the mutex.
+ *
  * signal() may reschedule the currently running thread.  As a result, signal()
  * should not be called from non-reentrant interrupt handlers unless ::resdefer
  * is set to a positive value at the start of the interrupt handler.
@@ -25,6 +28,8 @@
 syscall signal(semaphore sem)
 {
     register struct sement *semptr;
+    tid_typ owner, tid;
+    int prio;
     irqmask im;
 
     im = disable();
@@ -34,9 +39,36 @@ syscall signal(semaphore sem)
         return SYSERR;
     }
     semptr = &semtab[sem];
+    tid = BADTID;
     if ((semptr->count++) < 0)
     {
-        ready(dequeue(semptr->queue), RESCHED_YES);
+        tid = dequeue(semptr->queue);
+    }
+
+    if (semptr->mutex)
+    {
+        owner = semptr->owner;
+        semptr->owner = tid;
+        prio = 0;
+        if (!isbadtid(owner) && (thrtab[owner].prio != thrtab[owner].basprio))
+        {
+            prio = thrtab[owner].prio;
+            priorecompute(owner);
+        }
+        if (BADTID != tid)
+        {
+            priorecompute(tid);
+        }
+        else if ((thrcurrent == owner) && (thrtab[owner].prio < prio))
+        {
+            /* a higher priority thread may be ready after the drop */
+            resched();
+        }
+    }
+
+    if (BADTID != tid)
+    {
+        ready(tid, RESCHED_YES);
     }
     restore(im);
     return OK;
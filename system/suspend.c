@@ -27,7 +27,8 @@ syscall suspend(tid_typ tid)
         return SYSERR;
     }
     thrptr = &thrtab[tid];
-    if ((thrptr->state != THRCURR) && (thrptr->state != THRREADY))
+    if (((thrptr->state != THRCURR) && (thrptr->state != THRREADY))
+        || ((THRCURR == thrptr->state) && (tid != thrcurrent)))
     {
         restore(im);
         return SYSERR;
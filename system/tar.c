@@ -7,8 +7,6 @@
 #include <tar.h>
 #include <string.h>
 
-int tarFilesize(char *octalsize);
-
 /**
  * @ingroup misc
  *
@@ -46,7 +44,7 @@ int tarListFiles(struct tar *archive, char *filelist, int nentries)
         /* determine where the next file is located */
         filesize = tarFilesize(file->filesize);
 
-        pos += roundtar(sizeof(struct tar) + filesize);
+        pos += TAR_BLOCK_SIZE + roundtar(filesize);
     }
 
     return entries;
@@ -87,7 +85,7 @@ struct tar *tarGetFile(struct tar *archive, char *filename)
         /* determine where the next file is located */
         filesize = tarFilesize(file->filesize);
 
-        pos += roundtar(sizeof(struct tar) + filesize);
+        pos += TAR_BLOCK_SIZE + roundtar(filesize);
     }
 
     return (struct tar *)NULL;
@@ -121,19 +119,12 @@ int tarGetData(struct tar *file, char *buffer, uint size)
     int filesize;
     char *data;
 
-    /* point to data section of file */
-    data = file->type.data;
+    /* point to data section of file, which follows the header block */
+    data = (char *)file + TAR_BLOCK_SIZE;
 
     /* determine the file size (stored in octal string) */
     filesize = tarFilesize(file->filesize);
 
-    /* is the file ustar format? */
-    if (0 == strncmp((void *)&(file->type.ustar.isustar), "ustar", 5))
-    {
-        /* update data pointer and file size */
-        data = file->type.ustar.data;
-    }
-
     /* check bounds */
     if (size > filesize)
     {
@@ -150,7 +141,8 @@ int tarGetData(struct tar *file, char *buffer, uint size)
  * @ingroup misc
  *
  * Decode the filesize of a tar file.  Filesize is stored as an octal
- * string.
+ * string, possibly padded with leading spaces and terminated early by a
+ * space or NUL.
  * @param octalsize string holding size stored in octal
  * @return size of file
  */
@@ -162,6 +154,14 @@ int tarFilesize(char *octalsize)
     size = 0;
     for (i = 0; i < (TAR_FILESIZE_LEN - 1); i++)
     {
+        if (' ' == octalsize[i] && 0 == size)
+        {
+            continue;
+        }
+        if (octalsize[i] < '0' || octalsize[i] > '7')
+        {
+            break;
+        }
         size *= TAR_FILESIZE_BASE;
         size += (octalsize[i] - '0');
     }
@@ -0,0 +1,361 @@
+/**
+ * @file     tarindex.c
+ *
+ * Index of a tar archive for constant-time member lookup.  The archive is
+ * parsed once by tarIndexCreate(); lookups by name, by prefix, or by
+ * directory then never touch the archive headers again, and member data is
+ * returned as a pointer into the archive rather than copied.
+ */
+/* Embedded Xinu, Copyright (C) 2009.  All rights reserved. */
+
+#include <stddef.h>
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tar.h>
+
+static int tarPath(struct tar *file, char *path);
+static int tarNormalize(const char *name, const char **start);
+static uint tarHash(const char *name, uint len);
+static int tarCompare(const void *a, const void *b);
+static int tarLowerBound(struct tarindex *index, const char *prefix,
+                         uint len);
+
+/**
+ * @ingroup misc
+ *
+ * Build an index of a tar archive.  Each member is recorded with its full
+ * path name (ustar prefix joined to the file name, leading "./" and
+ * trailing '/' removed), the offset of its header and its data size.
+ * @param archive pointer to archive data
+ * @return pointer to index, or NULL if out of memory
+ */
+struct tarindex *tarIndexCreate(struct tar *archive)
+{
+    char path[TAR_PATH_LEN + 1];
+    uint pos, count, namebytes, length;
+    int len, i;
+    struct tar *file;
+    struct tarindex *index;
+    struct tarentry *entry;
+    char *names;
+
+    /* first pass: size the index */
+    pos = 0;
+    count = 0;
+    namebytes = 0;
+    while (1)
+    {
+        file = (struct tar *)&(((char *)archive)[pos]);
+        if (0x00 == file->filename[0])
+        {
+            break;
+        }
+        len = tarPath(file, path);
+        if (len > 0)
+        {
+            count++;
+            namebytes += len + 1;
+        }
+        pos += TAR_BLOCK_SIZE + roundtar(tarFilesize(file->filesize));
+    }
+
+    length = sizeof(struct tarindex) + count * sizeof(struct tarentry)
+        + namebytes;
+    index = memget(length);
+    if (SYSERR == (int)index)
+    {
+        return NULL;
+    }
+
+    index->archive = archive;
+    index->nentries = count;
+    index->length = length;
+    index->entries = (struct tarentry *)(index + 1);
+    names = (char *)(index->entries + count);
+    for (i = 0; i < TAR_NHASH; i++)
+    {
+        index->hash[i] = NULL;
+    }
+
+    /* second pass: record every member */
+    pos = 0;
+    entry = index->entries;
+    while (entry < index->entries + count)
+    {
+        file = (struct tar *)&(((char *)archive)[pos]);
+        len = tarPath(file, path);
+        if (len > 0)
+        {
+            memcpy(names, path, len + 1);
+            entry->name = names;
+            entry->namelen = len;
+            entry->offset = pos;
+            entry->size = tarFilesize(file->filesize);
+            entry->typeflag = file->typeflag;
+            names += len + 1;
+            entry++;
+        }
+        pos += TAR_BLOCK_SIZE + roundtar(tarFilesize(file->filesize));
+    }
+
+    /* sort for prefix lookups, then chain sorted entries by hash */
+    qsort(index->entries, count, sizeof(struct tarentry), tarCompare);
+    for (i = count - 1; i >= 0; i--)
+    {
+        entry = &index->entries[i];
+        len = tarHash(entry->name, entry->namelen);
+        entry->next = index->hash[len];
+        index->hash[len] = entry;
+    }
+
+    return index;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Free an index built by tarIndexCreate().  The archive itself is untouched.
+ * @param index index to free
+ * @return OK on success, SYSERR on failure
+ */
+syscall tarIndexFree(struct tarindex *index)
+{
+    if (NULL == index)
+    {
+        return SYSERR;
+    }
+    return memfree(index, index->length);
+}
+
+/**
+ * @ingroup misc
+ *
+ * Look up an archive member by its full path name.
+ * @param index index of archive
+ * @param name path name of member, e.g. "www/img/logo.png"
+ * @return pointer to index entry, or NULL if no such member
+ */
+struct tarentry *tarIndexLookup(struct tarindex *index, const char *name)
+{
+    struct tarentry *entry;
+    int len;
+
+    len = tarNormalize(name, &name);
+    for (entry = index->hash[tarHash(name, len)]; NULL != entry;
+         entry = entry->next)
+    {
+        if (entry->namelen == len
+            && 0 == strncmp(entry->name, name, len))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Find all archive members whose path name begins with a prefix.  Entries
+ * are returned in name order.
+ * @param index index of archive
+ * @param prefix leading characters of path names to match
+ * @param list array to store matching entries in
+ * @param nentries number of entries in list array
+ * @return number of entries stored in list
+ */
+int tarIndexPrefix(struct tarindex *index, const char *prefix,
+                   struct tarentry **list, int nentries)
+{
+    int i, found;
+    uint len;
+
+    len = strnlen(prefix, TAR_PATH_LEN);
+    found = 0;
+    for (i = tarLowerBound(index, prefix, len);
+         i < index->nentries && found < nentries; i++)
+    {
+        if (0 != strncmp(index->entries[i].name, prefix, len))
+        {
+            break;
+        }
+        list[found++] = &index->entries[i];
+    }
+    return found;
+}
+
+/**
+ * @ingroup misc
+ *
+ * List the members directly inside a directory of the archive.  Members of
+ * nested subdirectories are not returned, but the subdirectories themselves
+ * are.
+ * @param index index of archive
+ * @param dir path name of directory, or "" for the top of the archive
+ * @param list array to store matching entries in
+ * @param nentries number of entries in list array
+ * @return number of entries stored in list
+ */
+int tarIndexDir(struct tarindex *index, const char *dir,
+                struct tarentry **list, int nentries)
+{
+    char prefix[TAR_PATH_LEN + 2];
+    struct tarentry *entry;
+    int i, found;
+    uint len;
+
+    len = tarNormalize(dir, &dir);
+    memcpy(prefix, dir, len);
+    if (len > 0)
+    {
+        prefix[len++] = '/';
+    }
+    prefix[len] = '\0';
+
+    found = 0;
+    for (i = tarLowerBound(index, prefix, len);
+         i < index->nentries && found < nentries; i++)
+    {
+        entry = &index->entries[i];
+        if (0 != strncmp(entry->name, prefix, len))
+        {
+            break;
+        }
+        if (NULL == strchr(entry->name + len, '/'))
+        {
+            list[found++] = entry;
+        }
+    }
+    return found;
+}
+
+/**
+ * @ingroup misc
+ *
+ * Get a pointer to the data of an archive member.  The data is not copied;
+ * the pointer refers directly into the archive and is valid for
+ * entry->size bytes.
+ * @param index index of archive
+ * @param entry entry returned by a lookup on index
+ * @return pointer to member data
+ */
+void *tarIndexData(struct tarindex *index, struct tarentry *entry)
+{
+    return (char *)index->archive + entry->offset + TAR_BLOCK_SIZE;
+}
+
+/**
+ * Build the normalized full path name of an archive member.
+ * @param file pointer to tar header of member
+ * @param path buffer of at least TAR_PATH_LEN + 1 bytes
+ * @return length of path name (0 if it names the archive root)
+ */
+static int tarPath(struct tar *file, char *path)
+{
+    char joined[TAR_PATH_LEN + 1];
+    const char *start;
+    uint len, plen;
+
+    len = 0;
+    if (0 == strncmp(file->type.ustar.isustar, "ustar", 5))
+    {
+        plen = strnlen(file->type.ustar.fileprefix, TAR_PREFIX_LEN);
+        if (plen > 0)
+        {
+            memcpy(joined, file->type.ustar.fileprefix, plen);
+            joined[plen] = '/';
+            len = plen + 1;
+        }
+    }
+    plen = strnlen(file->filename, TAR_FILENAME_LEN);
+    memcpy(joined + len, file->filename, plen);
+    joined[len + plen] = '\0';
+
+    len = tarNormalize(joined, &start);
+    memcpy(path, start, len);
+    path[len] = '\0';
+    return len;
+}
+
+/**
+ * Strip leading "./" and '/' components and trailing '/' from a name.
+ * @param name name to normalize
+ * @param start set to first significant character of name
+ * @return length of normalized name
+ */
+static int tarNormalize(const char *name, const char **start)
+{
+    uint len;
+
+    while ('/' == name[0] || ('.' == name[0] && '/' == name[1]))
+    {
+        name += ('/' == name[0]) ? 1 : 2;
+    }
+    len = strnlen(name, TAR_PATH_LEN);
+    while (len > 0 && '/' == name[len - 1])
+    {
+        len--;
+    }
+    if (1 == len && '.' == name[0])
+    {
+        len = 0;
+    }
+    *start = name;
+    return len;
+}
+
+/**
+ * Hash a path name into a hash chain number.
+ * @param name path name
+ * @param len length of path name
+ * @return chain number between 0 and TAR_NHASH - 1
+ */
+static uint tarHash(const char *name, uint len)
+{
+    uint hash = 5381;
+
+    while (len-- > 0)
+    {
+        hash = (hash << 5) + hash + (uchar)*name++;
+    }
+    return hash % TAR_NHASH;
+}
+
+/**
+ * Order index entries by path name.
+ */
+static int tarCompare(const void *a, const void *b)
+{
+    return strncmp(((const struct tarentry *)a)->name,
+                   ((const struct tarentry *)b)->name, TAR_PATH_LEN);
+}
+
+/**
+ * Find the first sorted entry whose name is not less than a prefix.
+ * @param index index of archive
+ * @param prefix prefix to search for
+ * @param len length of prefix
+ * @return position of first candidate entry
+ */
+static int tarLowerBound(struct tarindex *index, const char *prefix,
+                         uint len)
+{
+    int lo, hi, mid;
+
+    lo = 0;
+    hi = index->nentries;
+    while (lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if (strncmp(index->entries[mid].name, prefix, len) < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
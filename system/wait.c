@@ -16,6 +16,13 @@
  * will be put to sleep until the semaphore is signaled with signal() or
  * signaln(), or freed with semfree().
  *
+ * If the semaphore is a mutex, the current thread becomes its owner.  While
+ * it waits, the owner runs at no less than the priority of the current
+ * thread, so a lower priority thread holding the mutex cannot be held off
+ * indefinitely by threads of intermediate priority.  Threads waiting on a
+ * mutex are queued by priority, so the highest priority waiter acquires it
+ * next.
+ *
  * @param sem
  *      Semaphore to wait on.
  *
@@ -41,9 +48,26 @@ syscall wait(semaphore sem)
     {
         thrptr->state = THRWAIT;
         thrptr->sem = sem;
-        enqueue(thrcurrent, semptr->queue);
+        if (semptr->mutex)
+        {
+            /* the highest priority waiter gets the mutex next */
+            insert(thrcurrent, semptr->queue, thrptr->prio);
+            prioinherit(semptr->owner, thrptr->prio);
+        }
+        else
+        {
+            enqueue(thrcurrent, semptr->queue);
+        }
         resched();
     }
+    else if (semptr->mutex)
+    {
+        semptr->owner = thrcurrent;
+        if (semptr->ceiling > thrptr->prio)
+        {
+            thrptr->prio = semptr->ceiling;
+        }
+    }
     restore(im);
     return OK;
 }
@@ -0,0 +1,275 @@
+/**
+ * @file workpool.c
+ *
+ * A pool of worker threads with a deque each.  Work submitted by a worker
+ * goes on its own deque, where it is likely to be run next by the same
+ * worker; other work is dealt to the workers in turn.  A worker with an
+ * empty deque steals the oldest work from another.  Workers are created
+ * as work arrives, until NWORKER exist, so work that blocks for a long
+ * time does not hold up the rest.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <workpool.h>
+
+struct workent worktab[NWORK];
+struct workerent workertab[NWORKER];
+
+static semaphore workavail;     /* count of queued work               */
+static uint nworker;            /* workers created                    */
+static uint nidle;              /* workers not running work           */
+static uint nqueued;            /* work waiting in deques             */
+static uint nextworker;         /* deque given the next work          */
+
+static thread worker(uint);
+static void workFree(future);
+
+/**
+ * @ingroup workpool
+ *
+ * Initialize the work pool.  No worker threads exist until work is
+ * submitted.
+ * @return OK on success, SYSERR if no semaphore is left
+ */
+syscall workInit(void)
+{
+    uint i;
+
+    for (i = 0; i < NWORK; i++)
+    {
+        worktab[i].state = WORK_FREE;
+    }
+    nworker = 0;
+    nidle = 0;
+    nqueued = 0;
+    nextworker = 0;
+    workavail = semcreate(0);
+    if (SYSERR == workavail)
+    {
+        return SYSERR;
+    }
+    return OK;
+}
+
+/**
+ * @ingroup workpool
+ *
+ * Submit a function to be run by a worker thread.
+ * @param func function to run
+ * @param arg  argument passed to @p func
+ * @return future to pass to workJoin() or workDetach(), or SYSERR if the
+ *         work table is full or no worker can be started
+ */
+future workSubmit(int (*func) (void *), void *arg)
+{
+    struct workent *wrkptr;
+    struct workerent *wkrptr;
+    char name[TNMLEN];
+    future f;
+    tid_typ tid;
+    uint i;
+    irqmask im;
+
+    im = disable();
+    for (f = 0; f < NWORK; f++)
+    {
+        if (WORK_FREE == worktab[f].state)
+        {
+            break;
+        }
+    }
+    if (NWORK == f)
+    {
+        restore(im);
+        return SYSERR;
+    }
+    wrkptr = &worktab[f];
+    wrkptr->done = semcreate(0);
+    if (SYSERR == wrkptr->done)
+    {
+        restore(im);
+        return SYSERR;
+    }
+
+    /* Start another worker if every idle one already has work.  */
+    if ((nidle <= nqueued) && (nworker < NWORKER))
+    {
+        sprintf(name, "worker%02d", nworker);
+        tid = create((void *)worker, WORKER_STK, WORKER_PRIO, name, 1,
+                     nworker);
+        if (SYSERR != tid)
+        {
+            workertab[nworker].tid = tid;
+            workertab[nworker].top = 0;
+            workertab[nworker].bottom = 0;
+            setcpu(tid, nworker % ncpu);
+            nworker++;
+            nidle++;
+            ready(tid, RESCHED_NO);
+        }
+    }
+    if (0 == nworker)
+    {
+        semfree(wrkptr->done);
+        restore(im);
+        return SYSERR;
+    }
+
+    wrkptr->state = WORK_QUEUED;
+    wrkptr->detached = FALSE;
+    wrkptr->func = func;
+    wrkptr->arg = arg;
+
+    /* A worker keeps the work it submits; other work is dealt out.  */
+    for (i = 0; i < nworker; i++)
+    {
+        if (workertab[i].tid == gettid())
+        {
+            break;
+        }
+    }
+    if (i == nworker)
+    {
+        i = nextworker++ % nworker;
+    }
+    wkrptr = &workertab[i];
+    wkrptr->deque[wkrptr->bottom++ % NWORK] = f;
+    nqueued++;
+
+    signal(workavail);
+    restore(im);
+    return f;
+}
+
+/**
+ * @ingroup workpool
+ *
+ * Wait for submitted work to finish and release it.
+ * @param f future returned by workSubmit()
+ * @return value returned by the work function, or SYSERR if @p f is not
+ *         work that can be joined
+ */
+int workJoin(future f)
+{
+    struct workent *wrkptr;
+    int result;
+    irqmask im;
+
+    im = disable();
+    if ((f < 0) || (f >= NWORK) || (WORK_FREE == worktab[f].state)
+        || worktab[f].detached)
+    {
+        restore(im);
+        return SYSERR;
+    }
+    wrkptr = &worktab[f];
+    wait(wrkptr->done);
+    result = wrkptr->result;
+    workFree(f);
+    restore(im);
+    return result;
+}
+
+/**
+ * @ingroup workpool
+ *
+ * Give up waiting for submitted work.  It is released when it finishes.
+ * @param f future returned by workSubmit()
+ * @return OK on success, SYSERR if @p f is not work that can be detached
+ */
+syscall workDetach(future f)
+{
+    struct workent *wrkptr;
+    irqmask im;
+
+    im = disable();
+    if ((f < 0) || (f >= NWORK) || (WORK_FREE == worktab[f].state)
+        || worktab[f].detached)
+    {
+        restore(im);
+        return SYSERR;
+    }
+    wrkptr = &worktab[f];
+    if (WORK_DONE == wrkptr->state)
+    {
+        workFree(f);
+    }
+    else
+    {
+        wrkptr->detached = TRUE;
+    }
+    restore(im);
+    return OK;
+}
+
+/*
+ * Worker thread: run work from its own deque, newest first, or else the
+ * oldest work of another worker.  The workavail count guarantees some
+ * deque holds work.
+ */
+static thread worker(uint self)
+{
+    struct workerent *wkrptr;
+    struct workent *wrkptr;
+    future f;
+    uint i;
+    irqmask im;
+    int result;
+
+    while (TRUE)
+    {
+        wait(workavail);
+
+        im = disable();
+        wkrptr = &workertab[self];
+        if (wkrptr->top != wkrptr->bottom)
+        {
+            f = wkrptr->deque[--wkrptr->bottom % NWORK];
+        }
+        else
+        {
+            for (i = (self + 1) % nworker;; i = (i + 1) % nworker)
+            {
+                wkrptr = &workertab[i];
+                if (wkrptr->top != wkrptr->bottom)
+                {
+                    break;
+                }
+            }
+            f = wkrptr->deque[wkrptr->top++ % NWORK];
+        }
+        nqueued--;
+        nidle--;
+        wrkptr = &worktab[f];
+        wrkptr->state = WORK_RUNNING;
+        restore(im);
+
+        result = (*wrkptr->func) (wrkptr->arg);
+
+        im = disable();
+        nidle++;
+        wrkptr->result = result;
+        if (wrkptr->detached)
+        {
+            workFree(f);
+        }
+        else
+        {
+            wrkptr->state = WORK_DONE;
+            signal(wrkptr->done);
+        }
+        restore(im);
+    }
+    return OK;
+}
+
+/*
+ * Release a work table entry.  Interrupts must be disabled.
+ */
+static void workFree(future f)
+{
+    semfree(worktab[f].done);
+    worktab[f].state = WORK_FREE;
+}
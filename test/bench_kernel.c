@@ -0,0 +1,130 @@
+/**
+ * @file bench_kernel.c
+ *
+ * Benchmarks of the thread, semaphore, message and memory primitives.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <bufpool.h>
+#include <kmutex.h>
+#include <memory.h>
+#include <semaphore.h>
+#include <thread.h>
+
+#define BENCH_MEMLEN    64      /**< bytes allocated by memget benchmark */
+#define BENCH_BUFLEN    64      /**< size of buffers in bufget benchmark */
+#define BENCH_NBUF      4       /**< number of buffers in bufget pool    */
+
+static tid_typ partner;
+static semaphore sem;
+static kmutex mutex;
+static int pool;
+
+static thread benchYield(void)
+{
+    while (TRUE)
+    {
+        yield();
+    }
+    return OK;
+}
+
+/**
+ * Create a thread at the same priority as the benchmark that yields the
+ * processor straight back, so each yield() is two context switches.
+ */
+syscall bench_reschedSetup(void)
+{
+    partner = create((void *)benchYield, INITSTK, getprio(gettid()),
+                     "benchYield", 0);
+    if (SYSERR == partner)
+    {
+        return SYSERR;
+    }
+    return ready(partner, RESCHED_NO);
+}
+
+void bench_resched(void)
+{
+    yield();
+}
+
+void bench_reschedTeardown(void)
+{
+    kill(partner);
+}
+
+syscall bench_semaphoreSetup(void)
+{
+    sem = semcreate(0);
+    if (SYSERR == sem)
+    {
+        return SYSERR;
+    }
+    return OK;
+}
+
+void bench_semaphore(void)
+{
+    signal(sem);
+    wait(sem);
+}
+
+void bench_semaphoreTeardown(void)
+{
+    semfree(sem);
+}
+
+syscall bench_kmutexSetup(void)
+{
+    mutex = kmutexcreate("bench");
+    if (SYSERR == mutex)
+    {
+        return SYSERR;
+    }
+    return OK;
+}
+
+void bench_kmutex(void)
+{
+    kmutexlock(mutex);
+    kmutexunlock(mutex);
+}
+
+void bench_kmutexTeardown(void)
+{
+    kmutexfree(mutex);
+}
+
+void bench_message(void)
+{
+    send(gettid(), 0);
+    receive();
+}
+
+void bench_memget(void)
+{
+    memfree(memget(BENCH_MEMLEN), BENCH_MEMLEN);
+}
+
+syscall bench_bufgetSetup(void)
+{
+    pool = bfpalloc(BENCH_BUFLEN, BENCH_NBUF);
+    if (SYSERR == pool)
+    {
+        return SYSERR;
+    }
+    return OK;
+}
+
+void bench_bufget(void)
+{
+    buffree(bufget(pool));
+}
+
+void bench_bufgetTeardown(void)
+{
+    bfpfree(pool);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file bench_net.c
+ *
+ * Benchmark of sending frames through the network interface layer.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <device.h>
+#include <ethloop.h>
+#include <ipv4.h>
+#include <network.h>
+#include <string.h>
+#include <thread.h>
+
+#ifndef NETHLOOP
+#  define NETHLOOP 0
+#endif
+
+#if NETHER && NETHLOOP
+#define BENCH_PKTLEN    64      /**< payload of benchmark frames */
+
+static struct packet *pkt;
+static struct netaddr hw;
+static uchar frame[ELOOP_BUFSIZE];
+
+/**
+ * Bring up an interface on the loopback Ethernet device.  Its receive
+ * threads are killed so each frame sent is read straight back.
+ */
+syscall bench_netSendSetup(void)
+{
+    struct netaddr ip, mask;
+    struct netif *netptr;
+    int i;
+
+    ip.type = NETADDR_IPv4;
+    ip.len = IPv4_ADDR_LEN;
+    ip.addr[0] = 192;
+    ip.addr[1] = 168;
+    ip.addr[2] = 1;
+    ip.addr[3] = 6;
+    mask.type = NETADDR_IPv4;
+    mask.len = IPv4_ADDR_LEN;
+    mask.addr[0] = 255;
+    mask.addr[1] = 255;
+    mask.addr[2] = 255;
+    mask.addr[3] = 0;
+
+    hw.type = NETADDR_ETHERNET;
+    hw.len = ETH_ADDR_LEN;
+    memset(hw.addr, 0xff, ETH_ADDR_LEN);
+
+    if (SYSERR == open(ELOOP))
+    {
+        return SYSERR;
+    }
+    if (SYSERR == netUp(ELOOP, &ip, &mask, NULL))
+    {
+        close(ELOOP);
+        return SYSERR;
+    }
+    netptr = netLookup(ELOOP);
+    for (i = 0; i < NET_NTHR; i++)
+    {
+        kill(netptr->recvthr[i]);
+        netptr->recvthr[i] = BADTID;
+    }
+
+    pkt = netGetbuf();
+    if (SYSERR == (int)pkt)
+    {
+        netDown(ELOOP);
+        close(ELOOP);
+        return SYSERR;
+    }
+    pkt->nif = netptr;
+    return OK;
+}
+
+void bench_netSend(void)
+{
+    pkt->len = BENCH_PKTLEN;
+    pkt->curr = pkt->data + NET_MAX_PKTLEN - BENCH_PKTLEN;
+    netSend(pkt, &hw, NULL, ETHER_TYPE_IPv4);
+    read(ELOOP, frame, ELOOP_BUFSIZE);
+}
+
+void bench_netSendTeardown(void)
+{
+    netFreebuf(pkt);
+    netDown(ELOOP);
+    close(ELOOP);
+}
+
+#else /* NETHER && NETHLOOP */
+
+syscall bench_netSendSetup(void)
+{
+    return SYSERR;
+}
+
+void bench_netSend(void)
+{
+}
+
+void bench_netSendTeardown(void)
+{
+}
+
+#endif /* !(NETHER && NETHLOOP) */
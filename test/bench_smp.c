@@ -0,0 +1,147 @@
+/**
+ * @file bench_smp.c
+ *
+ * Benchmarks of how processor-bound work scales with the processors online.
+ * Each operation splits the same amount of work between worker threads
+ * bound one to a processor, so running the parallel benchmark under
+ * qemu -smp 1 to 4 shows the speedup.  The serial benchmark does the work
+ * on one processor for comparison within one run.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <semaphore.h>
+#include <thread.h>
+
+#define BENCH_SMPWORK   65536   /**< loop iterations in one operation */
+#define BENCH_SMPSTK    1024    /**< stack size of a worker           */
+
+/**
+ * One worker thread, padded to a cache line so workers on different
+ * processors do not share one.
+ */
+struct benchworker
+{
+    semaphore start;            /**< signaled to start a share of work  */
+    uint iters;                 /**< share of work, 0 to exit           */
+    ulong result;               /**< keeps the work from being removed  */
+    uchar pad[52];
+};
+
+static struct benchworker workers[NCPU];
+static uint nworkers;
+static semaphore done;
+
+static thread benchSmpWorker(struct benchworker *w)
+{
+    ulong x;
+    uint i;
+
+    while (TRUE)
+    {
+        wait(w->start);
+        if (0 == w->iters)
+        {
+            break;
+        }
+        x = w->result;
+        for (i = 0; i < w->iters; i++)
+        {
+            x = x * 1103515245 + 12345;
+        }
+        w->result = x;
+        signal(done);
+    }
+    signal(done);
+    return OK;
+}
+
+/*
+ * Start n workers, worker i on processor i, that share BENCH_SMPWORK.
+ */
+static syscall benchSmpSetup(uint n)
+{
+    struct benchworker *w;
+    tid_typ tid;
+
+    done = semcreate(0);
+    if (SYSERR == done)
+    {
+        return SYSERR;
+    }
+    for (nworkers = 0; nworkers < n; nworkers++)
+    {
+        w = &workers[nworkers];
+        w->iters = BENCH_SMPWORK / n;
+        w->result = nworkers;
+        w->start = semcreate(0);
+        if (SYSERR == w->start)
+        {
+            break;
+        }
+        tid = create((void *)benchSmpWorker, BENCH_SMPSTK,
+                     getprio(gettid()), "benchSmp", 1, w);
+        if (SYSERR == tid)
+        {
+            semfree(w->start);
+            break;
+        }
+        setcpu(tid, nworkers);
+        ready(tid, RESCHED_NO);
+    }
+    if (nworkers < n)
+    {
+        bench_smpTeardown();
+        return SYSERR;
+    }
+    return OK;
+}
+
+syscall bench_smpSerialSetup(void)
+{
+    return benchSmpSetup(1);
+}
+
+syscall bench_smpParallelSetup(void)
+{
+    return benchSmpSetup(ncpu);
+}
+
+void bench_smp(void)
+{
+    uint i;
+
+    for (i = 0; i < nworkers; i++)
+    {
+        signal(workers[i].start);
+    }
+    for (i = 0; i < nworkers; i++)
+    {
+        wait(done);
+    }
+}
+
+/**
+ * Workers exit by themselves, as one may still be running on another
+ * processor, where kill() cannot reach it.
+ */
+void bench_smpTeardown(void)
+{
+    uint i;
+
+    for (i = 0; i < nworkers; i++)
+    {
+        workers[i].iters = 0;
+        signal(workers[i].start);
+    }
+    for (i = 0; i < nworkers; i++)
+    {
+        wait(done);
+    }
+    for (i = 0; i < nworkers; i++)
+    {
+        semfree(workers[i].start);
+    }
+    semfree(done);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_sort.c
+ *
+ * Benchmarks of the sorting routines of the C library on sorted, reversed
+ * and random input.  Each operation copies the input into a work array and
+ * sorts it, so the cost of the copy is included.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_SORTLEN   256     /**< elements sorted by each operation */
+
+static uint *input;
+static uint *work;
+
+static int benchSortCompare(const void *a, const void *b)
+{
+    uint x = *(const uint *)a;
+    uint y = *(const uint *)b;
+
+    return (x > y) - (x < y);
+}
+
+static syscall benchSortAlloc(void)
+{
+    input = memget(BENCH_SORTLEN * sizeof(uint));
+    if (SYSERR == (int)input)
+    {
+        return SYSERR;
+    }
+    work = memget(BENCH_SORTLEN * sizeof(uint));
+    if (SYSERR == (int)work)
+    {
+        memfree(input, BENCH_SORTLEN * sizeof(uint));
+        return SYSERR;
+    }
+    return OK;
+}
+
+syscall bench_sortSortedSetup(void)
+{
+    uint i;
+
+    if (SYSERR == benchSortAlloc())
+    {
+        return SYSERR;
+    }
+    for (i = 0; i < BENCH_SORTLEN; i++)
+    {
+        input[i] = i;
+    }
+    return OK;
+}
+
+syscall bench_sortReversedSetup(void)
+{
+    uint i;
+
+    if (SYSERR == benchSortAlloc())
+    {
+        return SYSERR;
+    }
+    for (i = 0; i < BENCH_SORTLEN; i++)
+    {
+        input[i] = BENCH_SORTLEN - i;
+    }
+    return OK;
+}
+
+syscall bench_sortRandomSetup(void)
+{
+    uint i;
+
+    if (SYSERR == benchSortAlloc())
+    {
+        return SYSERR;
+    }
+    srand(1);
+    for (i = 0; i < BENCH_SORTLEN; i++)
+    {
+        input[i] = rand();
+    }
+    return OK;
+}
+
+void bench_qsort(void)
+{
+    memcpy(work, input, BENCH_SORTLEN * sizeof(uint));
+    qsort(work, BENCH_SORTLEN, sizeof(uint), benchSortCompare);
+}
+
+void bench_mergesort(void)
+{
+    memcpy(work, input, BENCH_SORTLEN * sizeof(uint));
+    mergesort(work, BENCH_SORTLEN, sizeof(uint), benchSortCompare);
+}
+
+void bench_sortTeardown(void)
+{
+    memfree(work, BENCH_SORTLEN * sizeof(uint));
+    memfree(input, BENCH_SORTLEN * sizeof(uint));
+}
@@ -0,0 +1,54 @@
+/**
+ * @file bench_ulaw.c
+ *
+ * Benchmarks of ulaw conversion of one 20 ms packet of 8 kHz audio, the
+ * unit xsh_voip and the RTP device move.  To turn cycles per operation
+ * into samples per second, divide ::BENCH_ULAWLEN times the counter
+ * frequency by it.  The scalar benchmark converts the same packet a sample
+ * at a time with linear2ulaw(), for comparison with the bulk routines.
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <dsp.h>
+#include <stdlib.h>
+
+#define BENCH_ULAWLEN   160     /**< samples converted by each operation */
+
+static short linear[BENCH_ULAWLEN];
+static uchar ulaw[BENCH_ULAWLEN];
+
+/* Fill the packet with random samples over the whole range */
+syscall bench_ulawSetup(void)
+{
+    uint i;
+
+    srand(1);
+    for (i = 0; i < BENCH_ULAWLEN; i++)
+    {
+        linear[i] = rand() * 2 - RAND_MAX;
+    }
+    ulawEncode(ulaw, linear, BENCH_ULAWLEN);
+    return OK;
+}
+
+void bench_ulawEncode(void)
+{
+    ulawEncode(ulaw, linear, BENCH_ULAWLEN);
+}
+
+void bench_ulawDecode(void)
+{
+    ulawDecode(linear, ulaw, BENCH_ULAWLEN);
+}
+
+void bench_ulawScalar(void)
+{
+    uint i;
+
+    for (i = 0; i < BENCH_ULAWLEN; i++)
+    {
+        ulaw[i] = linear2ulaw(linear[i]);
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file benchhelper.c
+ *
+ */
+/* Embedded Xinu, Copyright (C) 2013.  All rights reserved. */
+
+#include <stddef.h>
+#include <bench.h>
+#include <clock.h>
+#include <memory.h>
+#include <stdlib.h>
+
+/**< table of benchmarks */
+struct benchcase benchtab[] = {
+    {"resched", "context switch round trip", bench_reschedSetup,
+     bench_resched, bench_reschedTeardown},
+    {"semaphore", "signal() then wait()", bench_semaphoreSetup,
+     bench_semaphore, bench_semaphoreTeardown},
+    {"kmutex", "kmutexlock() then kmutexunlock()", bench_kmutexSetup,
+     bench_kmutex, bench_kmutexTeardown},
+    {"message", "send() then receive()", NULL, bench_message, NULL},
+    {"memget", "memget() then memfree() of 64 bytes", NULL, bench_memget,
+     NULL},
+    {"bufget", "bufget() then buffree()", bench_bufgetSetup, bench_bufget,
+     bench_bufgetTeardown},
+    {"qsort-sorted", "qsort() of 256 sorted uints", bench_sortSortedSetup,
+     bench_qsort, bench_sortTeardown},
+    {"qsort-reversed", "qsort() of 256 reversed uints",
+     bench_sortReversedSetup, bench_qsort, bench_sortTeardown},
+    {"qsort-random", "qsort() of 256 random uints", bench_sortRandomSetup,
+     bench_qsort, bench_sortTeardown},
+    {"mergesort-random", "mergesort() of 256 random uints",
+     bench_sortRandomSetup, bench_mergesort, bench_sortTeardown},
+    {"smp-serial", "65536 multiply-adds on one processor",
+     bench_smpSerialSetup, bench_smp, bench_smpTeardown},
+    {"smp-parallel", "65536 multiply-adds split across processors",
+     bench_smpParallelSetup, bench_smp, bench_smpTeardown},
+    {"netsend", "netSend() and read back over ethloop",
+     bench_netSendSetup, bench_netSend, bench_netSendTeardown},
+    {"ulaw-encode", "ulawEncode() of 160 samples", bench_ulawSetup,
+     bench_ulawEncode, NULL},
+    {"ulaw-decode", "ulawDecode() of 160 samples", bench_ulawSetup,
+     bench_ulawDecode, NULL},
+    {"ulaw-scalar", "linear2ulaw() of 160 samples", bench_ulawSetup,
+     bench_ulawScalar, NULL},
+};
+
+int nbench = sizeof(benchtab) / sizeof(struct benchcase);
+
+/* Cycle counter of each platform, falling back to the system timer */
+#if defined(_XINU_ARCH_X86_)
+const char benchcounter[] = "tsc";
+#elif defined(_XINU_ARCH_MIPS_)
+const char benchcounter[] = "cp0count";
+#elif defined(_XINU_PLATFORM_ARM_RPI_)
+const char benchcounter[] = "ccnt";
+#else
+const char benchcounter[] = "clkcount";
+#endif
+
+static int benchCompare(const void *a, const void *b);
+
+/**
+ * Start the cycle counter if the platform requires it.  On the ARM1176 the
+ * cycle counter of the performance monitor is enabled and reset.
+ */
+void benchCycleInit(void)
+{
+#if defined(_XINU_PLATFORM_ARM_RPI_)
+    /* PMNC: enable counters (E) and reset the cycle counter (C) */
+    asm volatile ("mcr p15, 0, %0, c15, c12, 0"::"r" (0x5));
+#endif
+}
+
+/**
+ * Read the cycle counter.  Only the difference between two readings is
+ * meaningful; the counter may wrap.
+ * @return current value of the cycle counter
+ */
+ulong benchCycles(void)
+{
+    ulong count;
+
+#if defined(_XINU_ARCH_X86_)
+    asm volatile ("rdtsc":"=a" (count)::"edx");
+#elif defined(_XINU_ARCH_MIPS_)
+    asm volatile ("mfc0 %0, $9":"=r" (count));
+#elif defined(_XINU_PLATFORM_ARM_RPI_)
+    asm volatile ("mrc p15, 0, %0, c15, c12, 1":"=r" (count));
+#else
+    count = clkcount();
+#endif
+
+    return count;
+}
+
+/**
+ * Run a benchmark.  After setup the operation is run for a number of warm-up
+ * iterations, then each timed sample runs it batch times in a row, which
+ * lets coarse counters time short operations.
+ * @param bc benchmark to run
+ * @param warmup number of untimed iterations
+ * @param iters number of timed samples, at most BENCH_MAXITER
+ * @param batch number of operations per sample
+ * @param result filled in with the results of the benchmark
+ * @return OK if the benchmark ran, otherwise SYSERR
+ */
+syscall benchRun(const struct benchcase *bc, uint warmup, uint iters,
+                 uint batch, struct benchresult *result)
+{
+    ulong *samples;
+    ulong start, delta;
+    uint i, j;
+
+    if ((NULL == bc) || (NULL == result) || (0 == iters)
+        || (iters > BENCH_MAXITER) || (0 == batch))
+    {
+        return SYSERR;
+    }
+
+    samples = memget(iters * sizeof(ulong));
+    if (SYSERR == (int)samples)
+    {
+        return SYSERR;
+    }
+
+    if ((NULL != bc->setup) && (SYSERR == bc->setup()))
+    {
+        memfree(samples, iters * sizeof(ulong));
+        return SYSERR;
+    }
+
+    /* Cost of reading the counter, taken out of every sample */
+    benchCycleInit();
+    result->overhead = (ulong)-1;
+    for (i = 0; i < BENCH_WARMUP; i++)
+    {
+        start = benchCycles();
+        delta = benchCycles() - start;
+        if (delta < result->overhead)
+        {
+            result->overhead = delta;
+        }
+    }
+
+    for (i = 0; i < warmup; i++)
+    {
+        bc->op();
+    }
+
+    for (i = 0; i < iters; i++)
+    {
+        start = benchCycles();
+        for (j = 0; j < batch; j++)
+        {
+            bc->op();
+        }
+        delta = benchCycles() - start;
+        delta = (delta > result->overhead) ? delta - result->overhead : 0;
+        samples[i] = delta / batch;
+    }
+
+    if (NULL != bc->teardown)
+    {
+        bc->teardown();
+    }
+
+    qsort(samples, iters, sizeof(ulong), benchCompare);
+    result->iters = iters;
+    result->batch = batch;
+    result->min = samples[0];
+    result->median = samples[iters / 2];
+    result->p99 = samples[(iters * 99) / 100];
+    result->max = samples[iters - 1];
+
+    memfree(samples, iters * sizeof(ulong));
+    return OK;
+}
+
+static int benchCompare(const void *a, const void *b)
+{
+    ulong x = *(const ulong *)a;
+    ulong y = *(const ulong *)b;
+
+    return (x > y) - (x < y);
+}
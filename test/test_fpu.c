@@ -0,0 +1,111 @@
+#include <stddef.h>
+#include <fpu.h>
+#include <stdio.h>
+#include <testsuite.h>
+#include <thread.h>
+
+#define FPU_NTHR    3           /**< threads sharing the unit           */
+#define FPU_ROUNDS  50          /**< times each thread yields           */
+#define FPU_SPIN    1000000     /**< additions between clock preemptions */
+
+static semaphore fpudone;
+static volatile bool fpuok[FPU_NTHR];
+
+/*
+ * Yield to the other threads between floating point operations, so each
+ * switch back traps, then add in a loop long enough for the clock to
+ * preempt it while the sum is in a register.  The other threads do the
+ * same with different values.  All sums are exact in a double.
+ */
+static thread fpuworker(int n)
+{
+    volatile double acc;
+    double step, sum;
+    int i;
+
+    step = 0.5 + n;
+    acc = 0.0;
+    for (i = 0; i < FPU_ROUNDS; i++)
+    {
+        acc += step;
+        yield();
+    }
+
+    sum = 0.0;
+    for (i = 0; i < FPU_SPIN; i++)
+    {
+        sum += step;
+    }
+
+    fpuok[n] = (acc == step * FPU_ROUNDS) && (sum == step * FPU_SPIN);
+    signal(fpudone);
+    return OK;
+}
+
+thread test_fpu(bool verbose)
+{
+    bool passed = TRUE;
+    tid_typ tid[FPU_NTHR];
+#if USE_FPU
+    ulong traps;
+#endif
+    int i;
+
+    fpudone = semcreate(0);
+    if (SYSERR == fpudone)
+    {
+        testFail(TRUE, "no semaphore");
+        return OK;
+    }
+#if USE_FPU
+    traps = fputraps;
+#endif
+
+    testPrint(verbose, "Threads keep their floating point registers");
+    for (i = 0; i < FPU_NTHR; i++)
+    {
+        fpuok[i] = FALSE;
+        tid[i] = create((void *)fpuworker, INITSTK, getprio(gettid()),
+                        "fpuworker", 1, i);
+    }
+    for (i = 0; i < FPU_NTHR; i++)
+    {
+        if (SYSERR != tid[i])
+        {
+            ready(tid[i], RESCHED_NO);
+        }
+    }
+    for (i = 0; i < FPU_NTHR; i++)
+    {
+        if (SYSERR != tid[i])
+        {
+            wait(fpudone);
+        }
+    }
+    for (i = 0; i < FPU_NTHR; i++)
+    {
+        if ((SYSERR == tid[i]) || !fpuok[i])
+        {
+            passed = FALSE;
+        }
+    }
+    failif(!passed, "a thread's result was corrupted");
+
+#if USE_FPU
+    testPrint(verbose, "Switching threads traps on first use");
+    failif(fputraps == traps, "no floating point traps taken");
+#endif
+
+    semfree(fpudone);
+
+    /* always print out the overall tests status */
+    if (passed)
+    {
+        testPass(TRUE, "");
+    }
+    else
+    {
+        testFail(TRUE, "");
+    }
+    return OK;
+}
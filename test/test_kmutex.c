@@ -0,0 +1,132 @@
+#include <stddef.h>
+#include <thread.h>
+#include <kmutex.h>
+#include <atomic.h>
+#include <stdio.h>
+#include <testsuite.h>
+
+#define PRIO_LOW    10
+#define PRIO_MED    15
+#define PRIO_HIGH   20
+#define NWORKERS    3
+#define NROUNDS     50
+
+#if NSEM
+static volatile int order[2];
+static volatile int norder;
+static volatile tid_typ seenowner;
+static volatile int counter;
+static volatile int finished;
+
+static void kmutexWaiter(kmutex m, int id)
+{
+    if (OK == kmutexlock(m))
+    {
+        seenowner = kmutexowner(&kmutextab[m]);
+        order[norder++] = id;
+        kmutexunlock(m);
+    }
+}
+
+static void kmutexWorker(kmutex m)
+{
+    int i, v;
+
+    for (i = 0; i < NROUNDS; i++)
+    {
+        kmutexlock(m);
+        v = counter;
+        yield();
+        counter = v + 1;
+        kmutexunlock(m);
+    }
+    atomicAdd(&finished, 1);
+}
+#endif
+
+/**
+ * Tests locking, contention and priority inheritance of kernel mutexes.
+ */
+thread test_kmutex(bool verbose)
+{
+#if NSEM
+    bool passed = TRUE;
+    kmutex m;
+    tid_typ w;
+    int baseprio, i;
+
+    baseprio = getprio(gettid());
+    m = kmutexcreate("test");
+    if (SYSERR == (int)m)
+    {
+        testFail(verbose, "no kernel mutexes");
+        return OK;
+    }
+
+    testPrint(verbose, "Uncontended lock and unlock");
+    failif((OK != kmutexlock(m))
+           || (gettid() != kmutexowner(&kmutextab[m]))
+           || (SYSERR != kmutexlock(m)) || (OK != kmutexunlock(m))
+           || (BADTID != kmutexowner(&kmutextab[m]))
+           || (SYSERR != kmutexunlock(m)), "");
+
+    /* A waiter lends its priority to the owner, which hands the mutex over
+     * to the highest priority waiter on unlock. */
+    chprio(gettid(), PRIO_LOW);
+    norder = 0;
+    seenowner = BADTID;
+    kmutexlock(m);
+    w = create((void *)kmutexWaiter, INITSTK, PRIO_MED, "KMUTEX-MED", 2, m,
+               1);
+    ready(w, RESCHED_YES);
+    ready(create((void *)kmutexWaiter, INITSTK, PRIO_HIGH, "KMUTEX-HIGH",
+                 2, m, 2), RESCHED_YES);
+
+    testPrint(verbose, "Inherit priority of waiters");
+    failif((PRIO_HIGH != getprio(gettid())) || (0 != norder), "");
+
+    testPrint(verbose, "Hand over to highest priority waiter");
+    kmutexunlock(m);
+    failif((2 != norder) || (2 != order[0]) || (1 != order[1])
+           || (w != seenowner)
+           || (BADTID != kmutexowner(&kmutextab[m])), "");
+
+    testPrint(verbose, "Restore priority on unlock");
+    failif(PRIO_LOW != getprio(gettid()), "");
+    chprio(gettid(), baseprio);
+
+    /* Equal priority threads yield while holding the mutex, so the others
+     * block on it. */
+    testPrint(verbose, "Mutual exclusion under contention");
+    counter = 0;
+    finished = 0;
+    for (i = 0; i < NWORKERS; i++)
+    {
+        ready(create((void *)kmutexWorker, INITSTK, baseprio,
+                     "KMUTEX-WORK", 1, m), RESCHED_NO);
+    }
+    while (finished < NWORKERS)
+    {
+        sleep(10);
+    }
+    failif((NWORKERS * NROUNDS != counter)
+           || (BADTID != kmutexowner(&kmutextab[m]))
+           || (0 == kmutextab[m].ncontend), "");
+
+    kmutexfree(m);
+    recvclr();
+
+    if (TRUE == passed)
+    {
+        testPass(TRUE, "");
+    }
+    else
+    {
+        testFail(TRUE, "");
+    }
+
+#else /* NSEM */
+    testSkip(TRUE, "");
+#endif /* NSEM == 0 */
+    return OK;
+}
@@ -27,6 +27,7 @@ thread test_libStdio(bool verbose)
     bool passed = TRUE;
     int ret;
     char *pret;
+    char iobuf[16];
 
     ret = open(LOOP0);
     failif(ret == SYSERR, "failed to open loopback device");
@@ -204,6 +205,37 @@ thread test_libStdio(bool verbose)
     failif(75 != d || 75 != o || 75 != x || 75 != c ||
             0 != strncmp(s, "ABC", 3), "");
 
+    /* setvbuf, fflush */
+    testPrint(verbose, "setvbuf: line buffering");
+    ret = setvbuf(LOOP0, iobuf, _IOLBF, sizeof(iobuf));
+    failif(ret != 0, "setvbuf failed to set line buffering");
+    fputs("abc", LOOP0);
+    ret = read(LOOP0, str, 4);
+    failif(ret > 0, "line-buffered output written before newline");
+    fputc('\n', LOOP0);
+    ret = read(LOOP0, str, 4);
+    failif((ret != 4) || (0 != strncmp(str, "abc\n", 4)),
+           "line-buffered output not written at newline");
+
+    testPrint(verbose, "setvbuf: full buffering");
+    ret = setvbuf(LOOP0, iobuf, _IOFBF, sizeof(iobuf));
+    failif(ret != 0, "setvbuf failed to set full buffering");
+    fprintf(LOOP0, "%d\n", 42);
+    ret = read(LOOP0, str, 3);
+    failif(ret > 0, "fully-buffered output written before flush");
+    fprintf(LOOP0, "%s", "0123456789ABCDEF");
+    ret = read(LOOP0, str, 16);
+    failif((ret != 16) || (0 != strncmp(str, "42\n0123456789ABC", 16)),
+           "fully-buffered output not written when buffer filled");
+    ret = fflush(LOOP0);
+    failif(ret != 0, "fflush failed");
+    ret = read(LOOP0, str, 3);
+    failif((ret != 3) || (0 != strncmp(str, "DEF", 3)),
+           "fflush did not write buffered output");
+    ret = setvbuf(LOOP0, NULL, _IONBF, 0);
+    failif((ret != 0) || (_IONBF != _iobtab[LOOP0].mode),
+           "setvbuf failed to remove buffering");
+
     /* More detailed fprintf tests */
     passed = do_detailed_fprintf_tests(verbose, passed);
 
@@ -40,6 +40,34 @@ static int cmp_uints(const void *p1, const void *p2)
     }
 }
 
+struct keyed
+{
+    uint key;
+    uint order;
+};
+
+static int cmp_keys(const void *p1, const void *p2)
+{
+    const struct keyed *k1 = p1;
+    const struct keyed *k2 = p2;
+
+    return (k1->key > k2->key) - (k1->key < k2->key);
+}
+
+static bool sorted_uints(const uint *array, uint len)
+{
+    uint j;
+
+    for (j = 1; j < len; j++)
+    {
+        if (array[j - 1] > array[j])
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
 /**
  * Tests the stdlib.h header in the Xinu Standard Library.
  * @return OK when testing is complete
@@ -142,6 +170,84 @@ thread test_libStdlib(bool verbose)
     testPrint(verbose, "Quicksort (random arrays)");
     failif(!all_sorted, "failed to sort random arrays");
 
+    /* Sorted, reversed and constant input used to take quadratic time and
+     * recurse once per element.  */
+    {
+        uint array[500];
+        uint j;
+
+        testPrint(verbose, "Quicksort (sorted, reversed, equal)");
+        for (j = 0; j < 500; j++)
+        {
+            array[j] = j;
+        }
+        qsort(array, 500, sizeof(array[0]), cmp_uints);
+        all_sorted = sorted_uints(array, 500);
+        for (j = 0; j < 500; j++)
+        {
+            array[j] = 500 - j;
+        }
+        qsort(array, 500, sizeof(array[0]), cmp_uints);
+        all_sorted = all_sorted && sorted_uints(array, 500)
+            && (1 == array[0]);
+        for (j = 0; j < 500; j++)
+        {
+            array[j] = (j % 2) ? 7 : 3;
+        }
+        qsort(array, 500, sizeof(array[0]), cmp_uints);
+        all_sorted = all_sorted && sorted_uints(array, 500)
+            && (3 == array[249]) && (7 == array[250]);
+        failif(!all_sorted, "");
+
+        testPrint(verbose, "Binary search");
+        for (j = 0; j < 500; j++)
+        {
+            array[j] = 2 * j;
+        }
+        j = 358;
+        all_sorted = (&array[179] ==
+                      bsearch(&j, array, 500, sizeof(array[0]), cmp_uints));
+        j = 0;
+        all_sorted = all_sorted && (&array[0] ==
+                                    bsearch(&j, array, 500, sizeof(array[0]),
+                                            cmp_uints));
+        j = 998;
+        all_sorted = all_sorted && (&array[499] ==
+                                    bsearch(&j, array, 500, sizeof(array[0]),
+                                            cmp_uints));
+        j = 359;
+        all_sorted = all_sorted
+            && (NULL == bsearch(&j, array, 500, sizeof(array[0]), cmp_uints))
+            && (NULL == bsearch(&j, array, 0, sizeof(array[0]), cmp_uints));
+        failif(!all_sorted, "");
+    }
+
+    /* Merge sort must keep equal elements in their original order.  */
+    {
+        struct keyed array[100];
+        uint j;
+
+        testPrint(verbose, "Merge sort (stable)");
+        srand(2);
+        for (j = 0; j < 100; j++)
+        {
+            array[j].key = rand() % 8;
+            array[j].order = j;
+        }
+        all_sorted = (0 == mergesort(array, 100, sizeof(array[0]),
+                                     cmp_keys));
+        for (j = 1; j < 100; j++)
+        {
+            if ((array[j - 1].key > array[j].key)
+                || ((array[j - 1].key == array[j].key)
+                    && (array[j - 1].order > array[j].order)))
+            {
+                all_sorted = FALSE;
+            }
+        }
+        failif(!all_sorted, "");
+    }
+
     /* malloc (in test_umemory.c) */
 
     if (passed)
@@ -6,10 +6,16 @@
 #include <limits.h>
 #include <interrupt.h>
 #include <thread.h>
+#include <clock.h>
+
+#define TPUT_MSGS   4096        /**< messages streamed by throughput test */
+#define TPUT_BATCH  16          /**< messages per batched send or receive */
 
 /* function prototypes */
 static int producer(mailbox);
 static int consumer(mailbox);
+static int streamer(mailbox);
+static bool throughput(mailbox, bool, const char *);
 
 thread test_mailbox(bool verbose)
 {
@@ -255,6 +261,113 @@ thread test_mailbox(bool verbose)
 
     mailboxFree(testbox1);
 
+    /* Test single-producer, single-consumer mailboxes */
+    testPrint(verbose, "Allocate SPSC mailbox");
+
+    testbox1 = mailboxAllocSpsc(5);
+    pmbox = &mboxtab[testbox1];
+
+    if (SYSERR == (uint)testbox1)
+    {
+        passed = FALSE;
+        testFail(verbose, "allocating SPSC mailbox results in SYSERR");
+    }
+    else if ((pmbox->max != 8) || (pmbox->mode != MAILBOX_SPSC))
+    {
+        passed = FALSE;
+        testFail(verbose, "size not rounded up to a power of two");
+    }
+    else
+    {
+        testPass(verbose, "");
+    }
+
+    testPrint(verbose, "Batched SPSC send and receive");
+    {
+        int out[6] = { 10, 11, 12, 13, 14, 15 };
+        int in[8];
+
+        if ((SYSERR == mailboxSendBatch(testbox1, out, 6))
+            || (6 != mailboxCount(testbox1))
+            || (4 != mailboxReceiveBatch(testbox1, in, 4))
+            || (SYSERR == mailboxSendBatch(testbox1, out, 6))
+            || (14 != mailboxReceive(testbox1))
+            || (SYSERR == mailboxSend(testbox1, 16))
+            || (8 != mailboxReceiveBatch(testbox1, in + 0, 8)))
+        {
+            passed = FALSE;
+            testFail(verbose, "batched transfer failed");
+        }
+        else if ((15 != in[0]) || (10 != in[1]) || (15 != in[6])
+                 || (16 != in[7]) || (0 != mailboxCount(testbox1)))
+        {
+            passed = FALSE;
+            testFail(verbose, "messages out of order across ring wrap");
+        }
+        else
+        {
+            testPass(verbose, "");
+        }
+    }
+
+    testPrint(verbose, "Wait on empty SPSC mailbox");
+
+    consumertid =
+        create((void *)consumer, INITSTK, prio + 1, "consumer", 1,
+               testbox1);
+    ready(consumertid, RESCHED_YES);
+
+    if (thrtab[consumertid].state != THRWAIT)
+    {
+        passed = FALSE;
+        testFail(verbose, "consumer did not wait on empty mailbox");
+    }
+    else
+    {
+        mailboxSend(testbox1, 1);
+        mailboxSend(testbox1, 2);
+        mailboxSend(testbox1, 3);
+        if ((THRFREE != thrtab[consumertid].state)
+            || (0 != mailboxCount(testbox1)))
+        {
+            passed = FALSE;
+            testFail(verbose, "consumer not woken by sender");
+        }
+        else
+        {
+            testPass(verbose, "");
+        }
+    }
+    if (THRFREE != thrtab[consumertid].state)
+    {
+        kill(consumertid);
+    }
+
+    mailboxFree(testbox1);
+
+    /* Stream messages through both kinds of mailbox */
+    testPrint(verbose, "MPMC mailbox throughput");
+    if (throughput(mailboxAlloc(TPUT_BATCH * 2), verbose, "MPMC"))
+    {
+        testPass(verbose, "");
+    }
+    else
+    {
+        passed = FALSE;
+        testFail(verbose, "stream lost or reordered messages");
+    }
+
+    testPrint(verbose, "SPSC mailbox throughput");
+    if (throughput(mailboxAllocSpsc(TPUT_BATCH * 2), verbose, "SPSC"))
+    {
+        testPass(verbose, "");
+    }
+    else
+    {
+        passed = FALSE;
+        testFail(verbose, "stream lost or reordered messages");
+    }
+
     /* Final report */
     if (TRUE == passed)
     {
@@ -293,4 +406,85 @@ thread consumer(mailbox box)
 
     return OK;
 }
+
+thread streamer(mailbox box)
+{
+    int msgs[TPUT_BATCH];
+    int i, j;
+
+    for (i = 0; i < TPUT_MSGS; i += TPUT_BATCH)
+    {
+        for (j = 0; j < TPUT_BATCH; j++)
+        {
+            msgs[j] = i + j;
+        }
+        if (SYSERR == mailboxSendBatch(box, msgs, TPUT_BATCH))
+        {
+            break;
+        }
+    }
+
+    return OK;
+}
+
+/**
+ * Stream TPUT_MSGS messages from a producer thread through a mailbox in
+ * batches, checking that they arrive in order, then free the mailbox.
+ */
+static bool throughput(mailbox box, bool verbose, const char *name)
+{
+    int msgs[TPUT_BATCH];
+    int next, got, i;
+    ulong start, ms;
+    tid_typ tid;
+
+    if (SYSERR == box)
+    {
+        return FALSE;
+    }
+
+    tid = create((void *)streamer, INITSTK, getprio(gettid()), "streamer",
+                 1, box);
+    if (SYSERR == tid)
+    {
+        mailboxFree(box);
+        return FALSE;
+    }
+
+    start = clktime * CLKTICKS_PER_SEC + clkticks;
+    ready(tid, RESCHED_NO);
+    for (next = 0; next < TPUT_MSGS; next += got)
+    {
+        got = mailboxReceiveBatch(box, msgs, TPUT_BATCH);
+        if (SYSERR == got)
+        {
+            break;
+        }
+        for (i = 0; i < got; i++)
+        {
+            if (msgs[i] != next + i)
+            {
+                got = SYSERR;
+                break;
+            }
+        }
+        if (SYSERR == got)
+        {
+            break;
+        }
+    }
+    ms = clktime * CLKTICKS_PER_SEC + clkticks - start;
+
+    if (verbose && (TPUT_MSGS == next))
+    {
+        printf("\n\t%s: %d messages in %lu ms", name, next, ms);
+    }
+
+    mailboxFree(box);
+    if (THRFREE != thrtab[tid].state)
+    {
+        kill(tid);
+    }
+    return (TPUT_MSGS == next);
+}
 #endif
@@ -1,13 +1,17 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <thread.h>
 #include <testsuite.h>
 #include <clock.h>
 #include <interrupt.h>
 #include <thread.h>
 
+#define QDEPTH  4
+
 static thread recvthread(bool);
+static thread queuethread(tid_typ);
 
 /* test_messagePass -- Creates two threads; a receiver and a sender.  
  * Each testing send, receive, receive clear, and receive timeout. 
@@ -17,6 +21,10 @@ thread test_messagePass(bool verbose)
 {
     bool passed = TRUE;
     tid_typ recvtid;
+    int type;
+    void *buf;
+    uint len;
+    static char data[] = "zero-copy";
 
     recvclr();
 
@@ -116,6 +124,60 @@ thread test_messagePass(bool verbose)
         }
     }
 
+    /* Queued messages */
+    testPrint(verbose, "Queue of messages");
+    recvtid = createq((void *)queuethread, INITSTK, getprio(gettid()) + 1,
+                      QDEPTH, "queuethread", 1, gettid());
+    if (SYSERR == recvtid)
+    {
+        passed = FALSE;
+        testFail(verbose, "\nunable to create queueing thread");
+    }
+    else
+    {
+        /* The receiver is suspended, so messages pile up in its queue */
+        if ((OK != send(recvtid, 1)) || (OK != send(recvtid, 2))
+            || (OK != sendbuf(recvtid, 7, data, sizeof(data)))
+            || (OK != send(recvtid, 4)) || (SYSERR != send(recvtid, 5)))
+        {
+            passed = FALSE;
+            testFail(verbose, "\nqueue did not hold exactly its depth");
+            kill(recvtid);
+        }
+        else
+        {
+            recvclr();
+            ready(recvtid, RESCHED_YES);
+            if (OK != recvbuftime(100, &type, &buf, &len))
+            {
+                passed = FALSE;
+                testFail(verbose, "\nno reply from queueing thread");
+            }
+            else if ((MSGWORD != type) || ((void *)OK != buf) || (0 != len))
+            {
+                passed = FALSE;
+                testFail(verbose, "\nmessages out of order or corrupt");
+            }
+            else
+            {
+                testPass(verbose, "");
+            }
+        }
+    }
+
+    /* Receive timeout of buffer messages */
+    testPrint(verbose, "Receive buffer timeout");
+    recvclr();
+    if (TIMEOUT == recvbuftime(1, &type, &buf, &len))
+    {
+        testPass(verbose, "");
+    }
+    else
+    {
+        passed = FALSE;
+        testFail(verbose, "\nrecvbuftime() did not return TIMEOUT");
+    }
+
     if (passed)
     {
         testPass(TRUE, "");
@@ -143,3 +205,30 @@ static thread recvthread(bool verbose)
 
     return SYSERR;
 }
+
+/* Check the queued messages and report the result to the parent thread */
+static thread queuethread(tid_typ parent)
+{
+    int type;
+    void *buf;
+    uint len;
+    int result = OK;
+
+    if ((1 != receive()) || (2 != recvtime(0)))
+    {
+        result = SYSERR;
+    }
+    recvbuf(&type, &buf, &len);
+    if ((7 != type) || (0 != strcmp(buf, "zero-copy")) || (10 != len))
+    {
+        result = SYSERR;
+    }
+    recvbuf(&type, &buf, &len);
+    if ((MSGWORD != type) || ((void *)4 != buf) || (NOMSG != recvclr()))
+    {
+        result = SYSERR;
+    }
+
+    send(parent, result);
+    return OK;
+}
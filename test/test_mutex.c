@@ -0,0 +1,174 @@
+#include <stddef.h>
+#include <thread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <testsuite.h>
+
+#define PRIO_LOW    10
+#define PRIO_MED    15
+#define PRIO_HIGH   20
+#define PRIO_TOP    25
+#define PRIO_CEIL   40
+#define MED_SPINS   1000000
+
+#if NSEM
+static volatile bool go;
+static volatile bool highdone;
+static volatile ulong medspins;
+static volatile ulong spinsatacquire;
+static volatile int lowprio;
+
+static void lowHolder(semaphore m)
+{
+    wait(m);
+    while (!go)
+        ;
+    lowprio = getprio(gettid());
+    signal(m);
+}
+
+static void mediumSpinner(void)
+{
+    while (!highdone && medspins < MED_SPINS)
+    {
+        medspins++;
+    }
+}
+
+static void highWaiter(semaphore m)
+{
+    wait(m);
+    spinsatacquire = medspins;
+    highdone = TRUE;
+    signal(m);
+}
+
+static volatile int order[2];
+static volatile int norder;
+
+static void orderWaiter(semaphore m, int id)
+{
+    wait(m);
+    order[norder++] = id;
+    signal(m);
+}
+
+/* Queue a medium then a high priority waiter on a mutex held by the caller,
+ * optionally raise the medium one while it waits, then release the mutex. */
+static void waitOrder(semaphore m, int raise)
+{
+    tid_typ w;
+
+    norder = 0;
+    wait(m);
+    w = create((void *)orderWaiter, INITSTK, PRIO_MED, "MUTEX-ORD", 2, m, 1);
+    ready(w, RESCHED_YES);
+    ready(create((void *)orderWaiter, INITSTK, PRIO_HIGH, "MUTEX-ORD", 2,
+                 m, 2), RESCHED_YES);
+    if (raise)
+    {
+        chprio(w, raise);
+    }
+    signal(m);
+}
+#endif
+
+/**
+ * Tests priority inheritance and priority ceilings of mutexes.
+ */
+thread test_mutex(bool verbose)
+{
+#if NSEM
+    bool passed = TRUE;
+    semaphore a, b;
+    tid_typ low, med, high, top;
+    int baseprio, done;
+
+    baseprio = getprio(gettid());
+
+    /* A low priority holder must run before a spinning medium priority
+     * thread once a high priority thread waits for the mutex. */
+    testPrint(verbose, "Bounded priority inversion");
+    a = mutexcreate(0);
+    go = FALSE;
+    highdone = FALSE;
+    medspins = 0;
+    spinsatacquire = MED_SPINS;
+    lowprio = 0;
+    low = create((void *)lowHolder, INITSTK, PRIO_LOW, "MUTEX-LOW", 1, a);
+    ready(low, RESCHED_NO);
+    sleep(10);
+    med = create((void *)mediumSpinner, INITSTK, PRIO_MED, "MUTEX-MED", 0);
+    high = create((void *)highWaiter, INITSTK, PRIO_HIGH, "MUTEX-HIGH",
+                  1, a);
+    ready(med, RESCHED_NO);
+    ready(high, RESCHED_NO);
+    go = TRUE;
+    for (done = 0; done < 3;)
+    {
+        tid_typ tid = receive();
+        if (tid == low || tid == med || tid == high)
+        {
+            done++;
+        }
+    }
+    failif((0 != spinsatacquire) || (PRIO_HIGH != lowprio), "");
+    semfree(a);
+
+    /* Nested mutexes keep the highest remaining inherited priority */
+    a = mutexcreate(0);
+    b = mutexcreate(0);
+    chprio(gettid(), PRIO_LOW);
+    wait(a);
+    wait(b);
+    high = create((void *)highWaiter, INITSTK, PRIO_HIGH, "MUTEX-HIGH",
+                  1, a);
+    ready(high, RESCHED_YES);
+    top = create((void *)highWaiter, INITSTK, PRIO_TOP, "MUTEX-TOP", 1, b);
+    ready(top, RESCHED_YES);
+
+    testPrint(verbose, "Inherit priority of highest waiter");
+    failif(PRIO_TOP != getprio(gettid()), "");
+
+    testPrint(verbose, "Restore priority on inner unlock");
+    signal(b);
+    failif(PRIO_HIGH != getprio(gettid()), "");
+
+    testPrint(verbose, "Restore priority on outer unlock");
+    signal(a);
+    failif(PRIO_LOW != getprio(gettid()), "");
+
+    testPrint(verbose, "Highest priority waiter acquires first");
+    waitOrder(a, 0);
+    failif((2 != norder) || (2 != order[0]) || (1 != order[1]), "");
+
+    testPrint(verbose, "Requeue waiter whose priority changes");
+    waitOrder(a, PRIO_TOP);
+    failif((2 != norder) || (1 != order[0]) || (2 != order[1]), "");
+
+    chprio(gettid(), baseprio);
+    semfree(a);
+    semfree(b);
+
+    testPrint(verbose, "Priority ceiling");
+    a = mutexcreate(PRIO_CEIL);
+    wait(a);
+    done = getprio(gettid());
+    signal(a);
+    failif((PRIO_CEIL != done) || (baseprio != getprio(gettid())), "");
+    semfree(a);
+
+    if (TRUE == passed)
+    {
+        testPass(TRUE, "");
+    }
+    else
+    {
+        testFail(TRUE, "");
+    }
+
+#else /* NSEM */
+    testSkip(TRUE, "");
+#endif /* NSEM == 0 */
+    return OK;
+}
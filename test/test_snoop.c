@@ -112,6 +112,21 @@ thread test_snoop(bool verbose)
     cap.type = SNOOP_FILTER_ARP;
     failif((7 != filterTest(&cap, pktA)), "");
 
+    /* Filter address, for ARP and IPv4 packets */
+    testPrint(verbose, "Filter address");
+    bzero(&cap, sizeof(struct snoop));
+    cap.caplen = USHRT_MAX;
+    dot2ipv4("192.168.6.6", &cap.srcaddr);
+    failif((9 != filterTest(&cap, pktA)), "");
+
+    /* Filter port */
+    testPrint(verbose, "Filter type and port");
+    bzero(&cap, sizeof(struct snoop));
+    cap.caplen = USHRT_MAX;
+    cap.type = SNOOP_FILTER_UDP;
+    cap.srcport = 502;
+    failif((6 != filterTest(&cap, pktA)), "");
+
     /* Test open */
     testPrint(verbose, "Open capture (bad params)");
     bzero(&cap, sizeof(struct snoop));
@@ -220,11 +235,13 @@ thread test_snoop(bool verbose)
     pktA->curr = pktA->data;
     cap.caplen = USHRT_MAX;
     cap.type = SNOOP_FILTER_IPv4;
+    snoopCompile(&cap);
     failif(((SYSERR == snoopCapture(&cap, pktA))
-            || (0 != cap.nmatch) || (mailboxCount(cap.queue) > 0)), "");
+            || (0 != cap.nmatch) || (cap.head != cap.tail)), "");
 
     testPrint(verbose, "Capture match");
     cap.type = SNOOP_FILTER_ALL;
+    snoopCompile(&cap);
     if (SYSERR == snoopCapture(&cap, pktA))
     {
         failif(TRUE, "Returned SYSERR");
@@ -233,16 +250,32 @@ thread test_snoop(bool verbose)
     {
         failif(TRUE, "Packet did not match");
     }
-    else if (mailboxCount(cap.queue) != 1)
+    else if (cap.head - cap.tail != 1)
     {
         failif(TRUE, "Packet not enqueued");
     }
     else
     {
-        pktB = (struct packet *)mailboxReceive(cap.queue);
-        failif((0 !=
-                memcmp(pktB->data, pktA->data, phdr.caplen)),
+        pktB = snoopRead(&cap);
+        failif(((SYSERR == (int)pktB) || (phdr.caplen != pktB->len)
+                || (0 != memcmp(pktB->data, pktA->data, phdr.caplen))),
                "Dequeued packet doesn't match");
+        failif((SYSERR == snoopFree(&cap, pktB)), "Packet not released");
+    }
+
+    testPrint(verbose, "Capture snap length");
+    cap.caplen = ETH_HDR_LEN;
+    snoopCompile(&cap);
+    if (SYSERR == snoopCapture(&cap, pktA))
+    {
+        failif(TRUE, "Returned SYSERR");
+    }
+    else
+    {
+        pktB = snoopRead(&cap);
+        failif(((SYSERR == (int)pktB) || (ETH_HDR_LEN != pktB->len)),
+               "Packet not truncated");
+        snoopFree(&cap, pktB);
     }
 
     testPrint(verbose, "Capture overrun");
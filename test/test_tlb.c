@@ -50,6 +50,8 @@ thread test_tlb(bool verbose)
     int user_data[2];           /* data as stored in KUSEG */
     int *ptr[2], *kseg_ptr;     /* memory pointers         */
     tid_typ id_vio;             /* thread id of violator   */
+    ulong faults;               /* violations before test  */
+    ulong fills;                /* zero fills before test  */
 
     /* grab enough memory to cause two faults */
     kseg_ptr = (int *)malloc(TEST_LENGTH);
@@ -65,6 +67,14 @@ thread test_tlb(bool verbose)
     /* Set up pointers for an even and odd page */
     ptr[1] = (int *)((uint)ptr[0] + (3 * PAGE_SIZE));
 
+    /* Pages after the first are zeroed when user space first touches them,
+     * losing what the kernel wrote there */
+    testPrint(verbose, "Demand-zero page reads as zero");
+    *(ptr[1]) = FAULT_DATA;
+    fills = safezerofills;
+    failif((0 != *(int *)((uint)ptr[1] & PMEM_MASK))
+           || (safezerofills == fills), "Page not zeroed on first touch");
+
     /* Set data to known values and store them for comparison */
     *(ptr[0]) = kseg_data[0] = EVN_DATA1;
     *(ptr[1]) = kseg_data[1] = ODD_DATA1;
@@ -96,6 +106,7 @@ thread test_tlb(bool verbose)
            "Could not write USEG data");
 
     /* attempt to cause a memory protection violation */
+    faults = tlbfaults;
     testPrint(verbose, "Memory protection violation");
     ready(id_vio =
           create((void *)tlb_violator, INITSTK,
@@ -105,6 +116,7 @@ thread test_tlb(bool verbose)
     /* if we get back here, the violator was killed */
     failif((EVN_DATA2 != *(ptr[0]) || (thrtab[id_vio].state != THRFREE)),
            "Violator wrote and ran");
+    failif(tlbfaults == faults, "violation not counted");
 
     /* free the pages */
     free(kseg_ptr);
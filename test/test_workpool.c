@@ -0,0 +1,125 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <testsuite.h>
+#include <interrupt.h>
+#include <thread.h>
+#include <workpool.h>
+
+#define TEST_NJOBS  16          /**< work submitted at once             */
+#define TEST_SPLIT  4           /**< leaves of the nested work; joining
+                                     workers block, so keep it small    */
+
+#if NWORK
+static int square(void *);
+static int split(void *);
+static int tally(void *);
+
+static volatile int detachedruns;
+#endif
+
+thread test_workpool(bool verbose)
+{
+#if NWORK
+    bool passed = TRUE;
+    future work[TEST_NJOBS];
+    int i, sum;
+
+    /* Results come back through the futures they were submitted with */
+    testPrint(verbose, "Submit and join work");
+    for (i = 0; i < TEST_NJOBS; i++)
+    {
+        work[i] = workSubmit(square, (void *)i);
+    }
+    sum = 0;
+    for (i = 0; i < TEST_NJOBS; i++)
+    {
+        if (SYSERR == work[i] || workJoin(work[i]) != i * i)
+        {
+            sum = SYSERR;
+        }
+    }
+    failif(SYSERR == sum, "work returned the wrong result");
+
+    /* Joined work is released */
+    testPrint(verbose, "Join released work");
+    failif(SYSERR != workJoin(work[0]), "joined released work");
+
+    /* Work submitted by a worker, joined from a worker */
+    testPrint(verbose, "Submit work from work");
+    work[0] = workSubmit(split, (void *)TEST_SPLIT);
+    failif(SYSERR == work[0] || workJoin(work[0]) != TEST_SPLIT,
+           "nested work returned the wrong result");
+
+    /* Detached work runs and releases itself */
+    testPrint(verbose, "Detach work");
+    detachedruns = 0;
+    for (i = 0; i < TEST_NJOBS; i++)
+    {
+        work[i] = workSubmit(tally, NULL);
+        if (SYSERR == work[i] || SYSERR == workDetach(work[i]))
+        {
+            break;
+        }
+    }
+    while (detachedruns < i)
+    {
+        yield();
+    }
+    failif(i < TEST_NJOBS || SYSERR != workJoin(work[0]),
+           "detached work was not released");
+
+    /* always print out the overall tests status */
+    if (passed)
+    {
+        testPass(TRUE, "");
+    }
+    else
+    {
+        testFail(TRUE, "");
+    }
+#else
+    testSkip(TRUE, "");
+#endif
+    return OK;
+}
+
+#if NWORK
+static int square(void *arg)
+{
+    int n = (int)arg;
+
+    return n * n;
+}
+
+/*
+ * Count to n by splitting it in half until it is 1.  The halves go on the
+ * deque of the worker running this, where another worker may steal one.
+ */
+static int split(void *arg)
+{
+    int n = (int)arg;
+    future low, high;
+
+    if (n <= 1)
+    {
+        return n;
+    }
+    low = workSubmit(split, (void *)(n / 2));
+    high = workSubmit(split, (void *)(n - n / 2));
+    if (SYSERR == low || SYSERR == high)
+    {
+        return SYSERR;
+    }
+    return workJoin(low) + workJoin(high);
+}
+
+static int tally(void *arg)
+{
+    irqmask im;
+
+    im = disable();
+    detachedruns++;
+    restore(im);
+    return OK;
+}
+#endif
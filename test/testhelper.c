@@ -12,6 +12,8 @@ struct testcase testtab[] = {
     {"Multiple Semaphores", test_semaphore2},
     {"Counting Semaphores", test_semaphore3},
     {"Killing Semaphores", test_semaphore4},
+    {"Mutex Priority Inheritance", test_mutex},
+    {"Kernel Mutexes", test_kmutex},
     {"Process Queues", test_procQueue},
     {"Delta Queues", test_deltaQueue},
     {"Standard Input/Output", test_libStdio},
@@ -26,6 +28,8 @@ struct testcase testtab[] = {
     {"System", test_system},
     {"Message Passing", test_messagePass},
     {"Mailbox", test_mailbox},
+    {"Work Pool", test_workpool},
+    {"Floating Point Switching", test_fpu},
     {"Ethernet Driver", test_ether},
     {"Ethernet Loopback Driver", test_ethloop},
     {"Network Addresses", test_netaddr},